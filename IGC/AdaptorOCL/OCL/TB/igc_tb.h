@@ -30,6 +30,12 @@ public:
 
     virtual bool FreeAllocations(STB_TranslateOutputArgs* pOutputArgs);
 
+    // Compute the tiered compilation ticket of the given input, see
+    // TC::GetTieredCompilationTicket
+    bool GetTieredCompilationTicket(
+        const STB_TranslateInputArgs* pInputArgs,
+        uint64_t* pTicket);
+
 protected:
     CIGCTranslationBlock() = default;
 
@@ -441,7 +441,8 @@ bool CGen8OpenCLProgramBase::dumpElfKernelMapFile(IGC::CodeGenContext* Ctx)
 }
 
 bool CGen8OpenCLProgram::GetZEBinary(
-    llvm::raw_pwrite_stream& programBinary,
+    std::unique_ptr<char[]>& programBinary,
+    uint64_t& programBinarySize,
     unsigned pointerSizeInBytes,
     const char* spv, uint32_t spvSize,
     const char* metrics, uint32_t metricsSize,
@@ -528,6 +529,20 @@ bool CGen8OpenCLProgram::GetZEBinary(
             }
         }
 
+        // Codegen statistics of every SIMD variant compiled for the kernel,
+        // including the ones not selected for the binary
+        std::vector<std::string> kernelStats;
+        std::string kernelStatsName;
+        for (auto shader : { simd8Shader, simd16Shader, simd32Shader })
+        {
+            if (shader && !shader->ProgramOutput()->m_KernelStats.empty())
+            {
+                kernelStats.push_back(shader->ProgramOutput()->m_KernelStats);
+                kernelStatsName = shader->m_kernelInfo.m_kernelName;
+            }
+        }
+        zebuilder.addKernelStats(kernelStatsName, kernelStats);
+
         for (auto kernel : kernelVec)
         {
             IGC::SProgramOutput* pOutput = kernel->ProgramOutput();
@@ -759,7 +774,12 @@ bool CGen8OpenCLProgram::GetZEBinary(
         }
     }
 
-    zebuilder.getBinaryObject(programBinary);
+    programBinarySize = zebuilder.getBinaryObjectSize();
+    programBinary.reset(new char[programBinarySize]);
+    uint64_t written = zebuilder.getBinaryObject(
+        (uint8_t*)programBinary.get(), programBinarySize);
+    IGC_ASSERT(written == programBinarySize);
+    IGC_UNUSED(written);
     return retValue;
 }
 
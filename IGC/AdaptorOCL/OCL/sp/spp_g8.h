@@ -108,8 +108,11 @@ public:
 
     /// getZEBinary - create and get ZE Binary
     /// if spv and spvSize are given, a .spv section will be created in the output ZEBinary
+    /// The binary is laid out first and then written into programBinary,
+    /// allocated (new[]) with its final size programBinarySize
     bool GetZEBinary(
-        llvm::raw_pwrite_stream& programBinary,
+        std::unique_ptr<char[]>& programBinary,
+        uint64_t& programBinarySize,
         unsigned pointerSizeInBytes,
         const char* spv,          uint32_t spvSize,
         const char* metrics,      uint32_t metricsSize,
@@ -11,6 +11,7 @@ SPDX-License-Identifier: MIT
 #include "Compiler/CodeGenPublic.h"
 
 #include "common/LLVMWarningsPush.hpp"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/MC/MCELFObjectWriter.h"
 #include "common/LLVMWarningsPop.hpp"
@@ -40,6 +41,7 @@ ZEBinaryBuilder::ZEBinaryBuilder(
     metadata.maxHwRevisionId = plat.usRevId;
     metadata.generatorId = TargetMetadata::GeneratorId::IGC;
     mBuilder.setTargetMetadata(metadata);
+    mBuilder.setZEInfoBinaryFormat(IGC_IS_FLAG_ENABLED(EnableZEInfoBinaryFormat));
 
     addProgramScopeInfo(programInfo);
 
@@ -73,7 +75,11 @@ void ZEBinaryBuilder::createKernel(
     const std::vector<NamedVISAAsm>& visaasm,
     bool isProgramDebuggable)
 {
+    // Debug info refers to the kernel text by kernel, do not share text
+    // sections for debuggable programs
     ZEELFObjectBuilder::SectionID textID =
+        (IGC_IS_FLAG_ENABLED(EnableZEBinaryKernelDedup) && !isProgramDebuggable) ?
+        addKernelBinaryOrAlias(annotations, rawIsaBinary, rawIsaBinarySize) :
         addKernelBinary(annotations.m_kernelName, rawIsaBinary, rawIsaBinarySize);
     addKernelSymbols(textID, annotations);
     addKernelRelocations(textID, annotations);
@@ -112,6 +118,12 @@ void ZEBinaryBuilder::createKernel(
         addKernelDebugEnv(annotations, layout, zeKernel);
 }
 
+void ZEBinaryBuilder::addKernelStats(const std::string& kernel,
+                                     const std::vector<std::string>& stats)
+{
+    mBuilder.addSectionKernelStats(kernel, stats);
+}
+
 void ZEBinaryBuilder::addGlobalHostAccessInfo(const SOpenCLProgramInfo& annotations)
 {
     for (auto& info : annotations.m_zebinGlobalHostAccessTable)
@@ -289,6 +301,47 @@ ZEELFObjectBuilder::SectionID ZEBinaryBuilder::addKernelBinary(const std::string
         kernelBinarySize, mHWCaps.InstructionCachePrefetchSize, sizeof(DWORD));
 }
 
+ZEELFObjectBuilder::SectionID ZEBinaryBuilder::addKernelBinaryOrAlias(
+    const SOpenCLKernelInfo& annotations,
+    const char* kernelBinary, unsigned int kernelBinarySize)
+{
+    const SKernelProgram& program = annotations.m_kernelProgram;
+    const SProgramOutput* output = nullptr;
+    switch (annotations.m_executionEnvironment.CompiledSIMDSize) {
+    case 8:  output = &(program.simd8); break;
+    case 16: output = &(program.simd16); break;
+    case 32: output = &(program.simd32); break;
+    default: output = &(program.simd1); break;
+    }
+
+    // Function symbols defined in the kernel text are global and must be
+    // unique, such a text section cannot be shared
+    if (!output->m_symbols.function.empty())
+        return addKernelBinary(annotations.m_kernelName, kernelBinary, kernelBinarySize);
+
+    // The relocations are applied per text section, so identical text with
+    // different relocations are different kernels
+    std::string relocs;
+    llvm::raw_string_ostream os(relocs);
+    for (const auto& reloc : output->m_relocs)
+        os << reloc.r_type << ':' << reloc.r_offset << ':' << reloc.r_symbol << ';';
+    os.flush();
+
+    llvm::StringRef binary(kernelBinary, kernelBinarySize);
+    uint64_t hash = llvm::hash_combine(binary, relocs);
+    auto range = mKernelTexts.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        const KernelText& text = it->second;
+        if (text.binary == binary && text.relocs == relocs)
+            return mBuilder.addSectionTextAlias(annotations.m_kernelName, text.sectID);
+    }
+
+    ZEELFObjectBuilder::SectionID textID =
+        addKernelBinary(annotations.m_kernelName, kernelBinary, kernelBinarySize);
+    mKernelTexts.emplace(hash, KernelText{ binary, std::move(relocs), textID });
+    return textID;
+}
+
 void ZEBinaryBuilder::addPayloadArgsAndBTI(
     const SOpenCLKernelInfo& annotations,
     zeInfoKernel& zeinfoKernel)
@@ -876,19 +929,43 @@ void ZEBinaryBuilder::addElfSections(void* elfBin, size_t elfSize)
     }
 }
 
-void ZEBinaryBuilder::getBinaryObject(llvm::raw_pwrite_stream& os)
+void ZEBinaryBuilder::addZEInfoSection()
 {
-    if (!mZEInfoBuilder.empty())
+    // ze_info is the last section added, once the object is complete
+    if (!mZEInfoAdded && !mZEInfoBuilder.empty())
         mBuilder.addSectionZEInfo(mZEInfoBuilder.getZEInfoContainer());
+    mZEInfoAdded = true;
+}
+
+void ZEBinaryBuilder::getBinaryObject(llvm::raw_pwrite_stream& os)
+{
+    addZEInfoSection();
     mBuilder.finalize(os);
 }
 
+uint64_t ZEBinaryBuilder::getBinaryObjectSize()
+{
+    addZEInfoSection();
+    return mBuilder.getBinarySize();
+}
+
+uint64_t ZEBinaryBuilder::getBinaryObject(uint8_t* buffer, uint64_t bufferSize)
+{
+    addZEInfoSection();
+    return mBuilder.finalize(buffer, bufferSize);
+}
+
 void ZEBinaryBuilder::getBinaryObject(Util::BinaryStream& outputStream)
 {
-    llvm::SmallVector<char, 64> buf;
-    llvm::raw_svector_ostream llvm_os(buf);
-    getBinaryObject(llvm_os);
-    outputStream.Write(buf.data(), buf.size());
+    // Util::BinaryStream cannot be written in place: lay the object out,
+    // write it into a buffer of its final size and append that with a
+    // single Write
+    uint64_t size = getBinaryObjectSize();
+    std::unique_ptr<uint8_t[]> buf(new uint8_t[size]);
+    uint64_t written = getBinaryObject(buf.get(), size);
+    IGC_ASSERT(written == size);
+    IGC_UNUSED(written);
+    outputStream.Write((const char*)buf.get(), (std::streamsize)written);
 }
 
 void ZEBinaryBuilder::printBinaryObject(const std::string& filename)
@@ -8,6 +8,8 @@ SPDX-License-Identifier: MIT
 
 #pragma once
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include <ZEELFObjectBuilder.hpp>
 #include "sp_g8.h"
@@ -66,6 +68,12 @@ public:
         const std::vector<NamedVISAAsm>& visaasm,
         bool isProgramDebuggable);
 
+    /// add the codegen statistics of a kernel, one JSON object per compiled
+    /// SIMD variant, as NT_INTELGT_KERNEL_STATS notes of the
+    /// .note.intelgt.metrics.<kernel> section
+    void addKernelStats(const std::string& kernel,
+                        const std::vector<std::string>& stats);
+
     // getElfSymbol - find a symbol name in ELF binary and return a symbol entry
     // that will later be transformed to ZE binary format
     void getElfSymbol(CLElfLib::CElfReader* elfReader, const unsigned int symtabIdx, llvm::ELF::Elf64_Sym& symtabEntry,
@@ -77,8 +85,16 @@ public:
     /// getBinaryObject - get the final ze object
     void getBinaryObject(llvm::raw_pwrite_stream& os);
 
+    /// getBinaryObjectSize - lay out the final object and return its size,
+    /// the size of the buffer getBinaryObject(uint8_t*, uint64_t) needs
+    uint64_t getBinaryObjectSize();
+
+    /// getBinaryObject - write the final object laid out by
+    /// getBinaryObjectSize straight into the given buffer
+    /// return the number of written bytes, or 0 if the buffer is too small
+    uint64_t getBinaryObject(uint8_t* buffer, uint64_t bufferSize);
+
     // getBinaryObject - write the final object into given Util::BinaryStream
-    // Avoid using this function, which has extra buffer copy
     void getBinaryObject(Util::BinaryStream& outputStream);
 
     void printBinaryObject(const std::string& filename);
@@ -123,6 +139,12 @@ private:
         const std::string& kernelName, const char* kernelBinary,
         unsigned int kernelBinarySize);
 
+    /// add gen binary, or an alias of an already added text section if there
+    /// is one with identical binary and relocations
+    zebin::ZEELFObjectBuilder::SectionID addKernelBinaryOrAlias(
+        const IGC::SOpenCLKernelInfo& annotations, const char* kernelBinary,
+        unsigned int kernelBinarySize);
+
     /// add user attributes (kernel attributes)
     void addUserAttributes(const IGC::SOpenCLKernelInfo& annotations,
                            zebin::zeInfoKernel& zeinfoKernel);
@@ -217,6 +239,9 @@ private:
     /// add global_host_access_table section to .ze_info
     void addGlobalHostAccessInfo(const IGC::SOpenCLProgramInfo& annotations);
 
+    /// add .ze_info section to mBuilder if not added yet
+    void addZEInfoSection();
+
 private:
     // mBuilder - Builder of a ZE ELF object
     zebin::ZEELFObjectBuilder mBuilder;
@@ -225,6 +250,10 @@ private:
     // be added into ZEELFObjectBuilder as .ze_info section
     zebin::ZEInfoBuilder mZEInfoBuilder;
 
+    // mZEInfoAdded - the ze_info section has been added to mBuilder, which
+    // happens once, when the first final object is written or laid out
+    bool mZEInfoAdded = false;
+
     const PLATFORM mPlatform;
     G6HWC::SMediaHardwareCapabilities mHWCaps;
 
@@ -233,6 +262,15 @@ private:
     zebin::ZEELFObjectBuilder::SectionID mGlobalConstSectID = -1;
     zebin::ZEELFObjectBuilder::SectionID mConstStringSectID = -1;
     zebin::ZEELFObjectBuilder::SectionID mGlobalSectID = -1;
+
+    /// kernel text sections added so far, keyed by the hash of their binary
+    /// and relocations. Used by addKernelBinaryOrAlias.
+    struct KernelText {
+        llvm::StringRef binary;
+        std::string relocs;
+        zebin::ZEELFObjectBuilder::SectionID sectID;
+    };
+    std::unordered_multimap<uint64_t, KernelText> mKernelTexts;
 };
 
 // a helper function to get ZE image type from a OCL image type
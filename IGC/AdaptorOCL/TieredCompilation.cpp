@@ -0,0 +1,308 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "AdaptorOCL/TieredCompilation.hpp"
+#include "common/secure_mem.h"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#include "Probe/Assertion.h"
+
+using namespace TC;
+
+TieredCompilation& TieredCompilation::get()
+{
+    // Intentionally leaked, see the class comment.
+    static TieredCompilation* instance = new TieredCompilation();
+    return *instance;
+}
+
+void TieredCompilation::acquire()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_numUsers;
+}
+
+void TieredCompilation::release()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        IGC_ASSERT(m_numUsers > 0);
+        if (--m_numUsers > 0)
+        {
+            return;
+        }
+    }
+    stop();
+}
+
+// Keep the library loaded until the process exits, for a worker that is
+// detached in the middle of a job. Nothing to do when the compiler is
+// linked into the executable.
+static void pinLibrary()
+{
+    static const bool pinned = []() {
+#if defined(_WIN32)
+        HMODULE module = nullptr;
+        return GetModuleHandleExA(
+            GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_PIN,
+            reinterpret_cast<LPCSTR>(&pinLibrary), &module) != FALSE;
+#else
+        Dl_info info;
+        if (dladdr(reinterpret_cast<void*>(&pinLibrary), &info) == 0 || !info.dli_fname)
+        {
+            return false;
+        }
+        // The handle is never closed. dlopen fails for the executable.
+        return dlopen(info.dli_fname, RTLD_LAZY | RTLD_NOLOAD | RTLD_NODELETE) != nullptr;
+#endif
+    }();
+    (void)pinned;
+}
+
+void TieredCompilation::stop()
+{
+    std::thread worker;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // Queued jobs are dropped and the running one is abandoned: its
+        // worker drops the result when it is done.
+        ++m_generation;
+        m_jobs.clear();
+        worker = std::move(m_worker);
+
+        // Forget the dropped jobs, so that their inputs can be scheduled
+        // again.
+        for (auto it = m_entries.begin(); it != m_entries.end();)
+        {
+            if (it->second.state == EntryState::Pending)
+            {
+                it = m_entries.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        m_order.erase(
+            std::remove_if(m_order.begin(), m_order.end(),
+                [this](Ticket ticket) { return m_entries.count(ticket) == 0; }),
+            m_order.end());
+    }
+    m_cv.notify_all();
+    if (worker.joinable())
+    {
+        pinLibrary();
+        worker.detach();
+    }
+}
+
+void TieredCompilation::setCacheSize(size_t maxEntries)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_maxEntries = maxEntries;
+}
+
+TieredCompilation::Request::Request(const STB_TranslateInputArgs* pInputArgs)
+{
+    if (pInputArgs->pInput)
+        input.assign(pInputArgs->pInput, pInputArgs->pInput + pInputArgs->InputSize);
+    if (pInputArgs->pOptions)
+        options.assign(pInputArgs->pOptions, pInputArgs->OptionsSize);
+    if (pInputArgs->pInternalOptions)
+        internalOptions.assign(pInputArgs->pInternalOptions, pInputArgs->InternalOptionsSize);
+    if (pInputArgs->SpecConstantsSize > 0)
+    {
+        specConstantsIds.assign(pInputArgs->pSpecConstantsIds,
+            pInputArgs->pSpecConstantsIds + pInputArgs->SpecConstantsSize);
+        specConstantsValues.assign(pInputArgs->pSpecConstantsValues,
+            pInputArgs->pSpecConstantsValues + pInputArgs->SpecConstantsSize);
+    }
+    for (uint32_t i = 0; i < pInputArgs->NumVISAAsmsToLink; ++i)
+        visaAsms.emplace_back(pInputArgs->pVISAAsmToLinkArray[i]);
+    for (uint32_t i = 0; i < pInputArgs->NumDirectCallFunctions; ++i)
+        directCallFunctions.emplace_back(pInputArgs->pDirectCallFunctions[i]);
+
+    for (const auto& s : visaAsms)
+        visaAsmPtrs.push_back(s.c_str());
+    for (const auto& s : directCallFunctions)
+        directCallFunctionPtrs.push_back(s.c_str());
+
+    args.pInput = input.empty() ? nullptr : input.data();
+    args.InputSize = static_cast<uint32_t>(input.size());
+    // options are passed with their size, keep the original null pointers
+    args.pOptions = pInputArgs->pOptions ? options.c_str() : nullptr;
+    args.OptionsSize = pInputArgs->OptionsSize;
+    args.pInternalOptions = pInputArgs->pInternalOptions ? internalOptions.c_str() : nullptr;
+    args.InternalOptionsSize = pInputArgs->InternalOptionsSize;
+    args.CompileTimeStatisticsEnable = pInputArgs->CompileTimeStatisticsEnable;
+    args.pSpecConstantsIds = specConstantsIds.empty() ? nullptr : specConstantsIds.data();
+    args.pSpecConstantsValues = specConstantsValues.empty() ? nullptr : specConstantsValues.data();
+    args.SpecConstantsSize = pInputArgs->SpecConstantsSize;
+    args.pVISAAsmToLinkArray = visaAsmPtrs.empty() ? nullptr : visaAsmPtrs.data();
+    args.NumVISAAsmsToLink = static_cast<uint32_t>(visaAsmPtrs.size());
+    args.pDirectCallFunctions = directCallFunctionPtrs.empty() ? nullptr : directCallFunctionPtrs.data();
+    args.NumDirectCallFunctions = static_cast<uint32_t>(directCallFunctionPtrs.size());
+}
+
+bool TieredCompilation::takeOptimized(Ticket ticket, STB_TranslateOutputArgs& outputArgs)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(ticket);
+    if (it == m_entries.end() || it->second.state != EntryState::Ready)
+    {
+        return false;
+    }
+
+    const Entry& entry = it->second;
+    // Buffers are released by the caller with delete[], like the ones from
+    // TranslateBuild.
+    outputArgs.OutputSize = static_cast<uint32_t>(entry.binary.size());
+    outputArgs.pOutput = new char[entry.binary.size()];
+    memcpy_s(outputArgs.pOutput, entry.binary.size(), entry.binary.data(), entry.binary.size());
+    if (!entry.debugData.empty())
+    {
+        outputArgs.DebugDataSize = static_cast<uint32_t>(entry.debugData.size());
+        outputArgs.pDebugData = new char[entry.debugData.size()];
+        memcpy_s(outputArgs.pDebugData, entry.debugData.size(), entry.debugData.data(), entry.debugData.size());
+    }
+    return true;
+}
+
+bool TieredCompilation::hasFailed(Ticket ticket)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(ticket);
+    return it != m_entries.end() && it->second.state == EntryState::Failed;
+}
+
+bool TieredCompilation::schedule(
+    Ticket ticket,
+    const STB_TranslateInputArgs* pInputArgs,
+    CompileFn compile)
+{
+    std::unique_ptr<Request> request(new Request(pInputArgs));
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_entries.count(ticket) != 0)
+        {
+            return false;
+        }
+        m_entries[ticket];
+        m_order.push_back(ticket);
+        evict();
+
+        m_jobs.push_back(Job{ ticket, std::move(request), std::move(compile) });
+        if (!m_worker.joinable())
+        {
+            m_worker = std::thread(&TieredCompilation::run, this, m_generation);
+        }
+    }
+    m_cv.notify_one();
+    return true;
+}
+
+void TieredCompilation::setCallback(Callback callback)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_callback = std::move(callback);
+}
+
+// Drop the oldest finished entries once the cache holds more than
+// m_maxEntries binaries. Pending entries are kept, the worker still has to
+// fill them.
+void TieredCompilation::evict()
+{
+    size_t numChecked = 0;
+    while (m_entries.size() > m_maxEntries && numChecked < m_order.size())
+    {
+        Ticket oldest = m_order.front();
+        m_order.pop_front();
+        auto it = m_entries.find(oldest);
+        IGC_ASSERT(it != m_entries.end());
+        if (it->second.state == EntryState::Pending)
+        {
+            m_order.push_back(oldest);
+            ++numChecked;
+            continue;
+        }
+        m_entries.erase(it);
+    }
+}
+
+void TieredCompilation::run(uint64_t generation)
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [&]() { return m_generation != generation || !m_jobs.empty(); });
+            if (m_generation != generation)
+            {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        STB_TranslateOutputArgs outputArgs;
+        bool success = job.compile(&job.request->args, &outputArgs);
+
+        Callback callback;
+        bool abandoned = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            // The entry of an abandoned job is gone, and the ticket may
+            // already be scheduled again.
+            abandoned = m_generation != generation;
+            if (!abandoned)
+            {
+                auto it = m_entries.find(job.ticket);
+                IGC_ASSERT(it != m_entries.end());
+                Entry& entry = it->second;
+                if (success && outputArgs.pOutput != nullptr)
+                {
+                    entry.state = EntryState::Ready;
+                    entry.binary.assign(outputArgs.pOutput, outputArgs.pOutput + outputArgs.OutputSize);
+                    if (outputArgs.pDebugData)
+                    {
+                        entry.debugData.assign(outputArgs.pDebugData,
+                            outputArgs.pDebugData + outputArgs.DebugDataSize);
+                    }
+                    callback = m_callback;
+                }
+                else
+                {
+                    // The stage 1 binary stays in use, don't try again.
+                    entry.state = EntryState::Failed;
+                }
+            }
+        }
+
+        if (callback)
+        {
+            callback(job.ticket, outputArgs);
+        }
+
+        delete[] outputArgs.pOutput;
+        delete[] outputArgs.pDebugData;
+        delete[] outputArgs.pErrorString;
+
+        if (abandoned)
+        {
+            return;
+        }
+    }
+}
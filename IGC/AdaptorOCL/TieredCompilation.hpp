@@ -0,0 +1,153 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include "AdaptorOCL/TranslationBlock.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace TC
+{
+    /*
+    Tiered compilation of OpenCL programs.
+
+    When EnableOCLTieredCompilation is set, TranslateBuildSPMD first produces a
+    stage 1 binary (FLAG_CG_STAGE1_FASTEST_COMPILE: no global optimizations,
+    FastCompileRA, no retry) and returns it to the runtime right away. The same
+    input is then queued here and compiled again with the default flow on a
+    background worker. The optimized binary is stored in the cache under the
+    ticket of the input, so that the next build of the same program returns it
+    directly, and is also handed to the registered callback, if any.
+
+    The queue and the cache don't depend on the rest of the compiler: which
+    inputs are tiered, how they are identified and how they are compiled is
+    decided by the translation block (see TranslateBuildSPMD).
+
+    The instance is never destroyed. The worker is started by the first
+    scheduled job and let go when the last translation block using tiered
+    compilation releases it. The release doesn't wait for the job the worker
+    is compiling: the worker is detached, finishes that job in the
+    background, drops its result and exits. Before that, the library is
+    pinned, so that it is not unloaded under the detached worker. The worker
+    is never joined, also not from a static destructor, which on Windows
+    would run under the loader lock and deadlock.
+    */
+    class TieredCompilation
+    {
+    public:
+        using Ticket = uint64_t;
+
+        // Compile function used by the worker: compiles the given input with
+        // the full optimization flow and fills the given output.
+        using CompileFn = std::function<bool(
+            const STB_TranslateInputArgs*, STB_TranslateOutputArgs*)>;
+
+        // Called on the worker thread once the optimized binary of the ticket
+        // is available. The output is only valid for the duration of the call.
+        using Callback = std::function<void(
+            Ticket, const STB_TranslateOutputArgs&)>;
+
+        static TieredCompilation& get();
+
+        // acquire/release - register a user (a translation block) of tiered
+        // compilation. When the last user releases it, queued jobs are
+        // dropped and the running one is abandoned; release doesn't wait
+        // for it.
+        void acquire();
+        void release();
+
+        // setCacheSize - max number of optimized binaries kept in the cache
+        void setCacheSize(size_t maxEntries);
+
+        // takeOptimized - if the optimized binary of the ticket is ready, copy
+        // it into the output and return true.
+        bool takeOptimized(Ticket ticket, STB_TranslateOutputArgs& outputArgs);
+
+        // hasFailed - return true if the optimized compilation of the ticket
+        // failed; such inputs are compiled with the full flow right away.
+        bool hasFailed(Ticket ticket);
+
+        // schedule - queue the optimized compilation of the given input. The
+        // input is copied, the caller's buffers do not need to outlive the
+        // call. Return false if the ticket is already pending or compiled.
+        bool schedule(
+            Ticket ticket,
+            const STB_TranslateInputArgs* pInputArgs,
+            CompileFn compile);
+
+        void setCallback(Callback callback);
+
+    private:
+        TieredCompilation() = default;
+        TieredCompilation(const TieredCompilation&) = delete;
+        TieredCompilation& operator=(const TieredCompilation&) = delete;
+
+        // Owned copy of STB_TranslateInputArgs
+        struct Request
+        {
+            Request(const STB_TranslateInputArgs* pInputArgs);
+            Request(const Request&) = delete;
+            Request& operator=(const Request&) = delete;
+
+            std::vector<char> input;
+            std::string options;
+            std::string internalOptions;
+            std::vector<uint32_t> specConstantsIds;
+            std::vector<uint64_t> specConstantsValues;
+            std::vector<std::string> visaAsms;
+            std::vector<const char*> visaAsmPtrs;
+            std::vector<std::string> directCallFunctions;
+            std::vector<const char*> directCallFunctionPtrs;
+            STB_TranslateInputArgs args;
+        };
+
+        struct Job
+        {
+            Ticket ticket;
+            std::unique_ptr<Request> request;
+            CompileFn compile;
+        };
+
+        enum class EntryState { Pending, Ready, Failed };
+
+        struct Entry
+        {
+            EntryState state = EntryState::Pending;
+            std::vector<char> binary;
+            std::vector<char> debugData;
+        };
+
+        void run(uint64_t generation);
+        void evict();
+        void stop();
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::deque<Job> m_jobs;
+        std::unordered_map<Ticket, Entry> m_entries;
+        // insertion order of m_entries, used for eviction
+        std::deque<Ticket> m_order;
+        Callback m_callback;
+        std::thread m_worker;
+        // bumped by stop, a worker of an older generation exits
+        uint64_t m_generation = 0;
+        size_t m_maxEntries = 64;
+        unsigned m_numUsers = 0;
+    };
+} // namespace TC
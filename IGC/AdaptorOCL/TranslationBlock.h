@@ -38,15 +38,30 @@ static const uint32_t STB_MAX_ERROR_STRING_SIZE = 1024UL;
 // Forward prototyping
 struct STB_RegisterArgs;
 struct STB_CreateArgs;
+struct STB_TranslateInputArgs;
+struct STB_TranslateOutputArgs;
 class  CTranslationBlock;
 
+// Called from the tiered compilation worker once the optimized binary of the
+// given ticket is available. The output is only valid for the duration of
+// the call.
+typedef void (TRANSLATION_BLOCK_CALLING_CONV *PFNTIEREDCOMPILATIONCALLBACK)(void* pUserData, uint64_t ticket, const STB_TranslateOutputArgs* pOutputArgs);
+
 extern "C" TRANSLATION_BLOCK_API void TRANSLATION_BLOCK_CALLING_CONV Register(STB_RegisterArgs* pRegisterArgs);
 extern "C" TRANSLATION_BLOCK_API CTranslationBlock* TRANSLATION_BLOCK_CALLING_CONV Create(STB_CreateArgs* pCreateArgs);
 extern "C" TRANSLATION_BLOCK_API void TRANSLATION_BLOCK_CALLING_CONV Delete(CTranslationBlock* pBlock);
 
+// Tiered compilation (only exported by translation blocks supporting it):
+// GetTieredCompilationTicket returns false if the given input is not tiered,
+// otherwise the ticket its optimized binary will be reported with.
+extern "C" TRANSLATION_BLOCK_API bool TRANSLATION_BLOCK_CALLING_CONV GetTieredCompilationTicket(CTranslationBlock* pBlock, const STB_TranslateInputArgs* pInputArgs, uint64_t* pTicket);
+extern "C" TRANSLATION_BLOCK_API void TRANSLATION_BLOCK_CALLING_CONV SetTieredCompilationCallback(PFNTIEREDCOMPILATIONCALLBACK pfnCallback, void* pUserData);
+
 typedef void (TRANSLATION_BLOCK_CALLING_CONV *PFNREGISTER)(STB_RegisterArgs* pRegisterArgs);
 typedef CTranslationBlock* (TRANSLATION_BLOCK_CALLING_CONV *PFNCREATE)(STB_CreateArgs* pCreateArgs);
 typedef void (TRANSLATION_BLOCK_CALLING_CONV *PFNDELETE)(CTranslationBlock* pBlock);
+typedef bool (TRANSLATION_BLOCK_CALLING_CONV *PFNGETTIEREDCOMPILATIONTICKET)(CTranslationBlock* pBlock, const STB_TranslateInputArgs* pInputArgs, uint64_t* pTicket);
+typedef void (TRANSLATION_BLOCK_CALLING_CONV *PFNSETTIEREDCOMPILATIONCALLBACK)(PFNTIEREDCOMPILATIONCALLBACK pfnCallback, void* pUserData);
 
 #undef TRANSLATION_BLOCK_CALLING_CONV
 
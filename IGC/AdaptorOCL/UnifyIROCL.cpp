@@ -297,6 +297,9 @@ static void CommonOCLBasedPasses(
     CompilerOpts.EmitZeBinVISASections =
         pContext->m_InternalOptions.EmitZeBinVISASections;
 
+    CompilerOpts.EmitZeBinKernelStats =
+        pContext->m_InternalOptions.EmitZeBinKernelStats;
+
     CompilerOpts.FP64GenEmulationEnabled =
         pContext->m_InternalOptions.EnableFP64GenEmu;
 
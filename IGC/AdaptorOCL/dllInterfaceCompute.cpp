@@ -9,6 +9,7 @@ SPDX-License-Identifier: MIT
 #include "IGC/common/StringMacros.hpp"
 #include "common/LLVMWarningsPush.hpp"
 #include "llvm/Config/llvm-config.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/Support/ScaledNumber.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Process.h"
@@ -27,6 +28,7 @@ SPDX-License-Identifier: MIT
 
 #include "AdaptorOCL/UnifyIROCL.hpp"
 #include "AdaptorOCL/DriverInfoOCL.hpp"
+#include "AdaptorOCL/TieredCompilation.hpp"
 
 #include "Compiler/CISACodeGen/OpenCLKernelCodeGen.hpp"
 #include "Compiler/MetaDataApi/IGCMetaDataHelper.h"
@@ -210,6 +212,64 @@ static bool IsDeviceBinaryFormat(const TB_DATA_FORMAT& format)
         || (format == TB_DATA_FORMAT_NON_COHERENT_DEVICE_BINARY);
 }
 
+// isTierable - stage 1 is only used for plain compilations; debug,
+// instrumentation and vISA-only requests always take the full flow.
+static bool isTierable(const STB_TranslateInputArgs* pInputArgs)
+{
+    if (pInputArgs == nullptr ||
+        pInputArgs->GTPinInput != nullptr ||
+        pInputArgs->TracingOptionsCount != 0)
+    {
+        return false;
+    }
+
+    IGC::OpenCLProgramContext::InternalOptions internalOptions(pInputArgs);
+    // Debugger expects the binary it was given to stay the one that runs, and
+    // vISA-only output is linked by the caller, not executed.
+    return !internalOptions.KernelDebugEnable &&
+           !internalOptions.EmitVisaOnly &&
+           !internalOptions.FailOnSpill;
+}
+
+// getTieredTicket - identify the given compilation request. Two requests get
+// the same ticket only if they produce the same binary.
+static TieredCompilation::Ticket getTieredTicket(
+    const STB_TranslateInputArgs* pInputArgs,
+    TB_DATA_FORMAT inputDataFormat,
+    const IGC::CPlatform& platform,
+    QWORD inputHash)
+{
+    auto str = [](const char* s, uint32_t size) {
+        return s ? llvm::StringRef(s, size) : llvm::StringRef();
+    };
+
+    llvm::hash_code hash = llvm::hash_combine(
+        inputHash,
+        llvm::hash_value(str(pInputArgs->pOptions, pInputArgs->OptionsSize)),
+        llvm::hash_value(str(pInputArgs->pInternalOptions, pInputArgs->InternalOptionsSize)),
+        static_cast<unsigned>(inputDataFormat),
+        static_cast<unsigned>(platform.GetProductFamily()),
+        platform.GetDeviceId(),
+        platform.GetRevId());
+
+    for (uint32_t i = 0; i < pInputArgs->SpecConstantsSize; ++i)
+    {
+        hash = llvm::hash_combine(hash,
+            pInputArgs->pSpecConstantsIds[i], pInputArgs->pSpecConstantsValues[i]);
+    }
+    for (uint32_t i = 0; i < pInputArgs->NumVISAAsmsToLink; ++i)
+    {
+        hash = llvm::hash_combine(hash,
+            llvm::hash_value(llvm::StringRef(pInputArgs->pVISAAsmToLinkArray[i])));
+    }
+    for (uint32_t i = 0; i < pInputArgs->NumDirectCallFunctions; ++i)
+    {
+        hash = llvm::hash_combine(hash,
+            llvm::hash_value(llvm::StringRef(pInputArgs->pDirectCallFunctions[i])));
+    }
+    return static_cast<TieredCompilation::Ticket>(static_cast<size_t>(hash));
+}
+
 bool CIGCTranslationBlock::Create(
     const STB_CreateArgs* pCreateArgs,
     CIGCTranslationBlock*& pTranslationBlock)
@@ -220,6 +280,9 @@ bool CIGCTranslationBlock::Create(
         return false;
     }
 
+    // Delete releases it on failure as well
+    TieredCompilation::get().acquire();
+
     bool success = pTranslationBlock->Initialize(pCreateArgs);
     if (!success)
     {
@@ -231,9 +294,53 @@ bool CIGCTranslationBlock::Create(
 void CIGCTranslationBlock::Delete(
     CIGCTranslationBlock* pTranslationBlock)
 {
+    if (pTranslationBlock)
+    {
+        // lets the tiered compilation worker go with the last translation
+        // block, without waiting for the job it is compiling
+        TieredCompilation::get().release();
+    }
     delete pTranslationBlock;
 }
 
+bool ComputeTieredCompilationTicket(
+    const STB_TranslateInputArgs* pInputArgs,
+    TB_DATA_FORMAT inputDataFormat,
+    const IGC::CPlatform& IGCPlatform,
+    uint64_t* pTicket)
+{
+    if (pInputArgs == nullptr || pTicket == nullptr ||
+        inputDataFormat == TB_DATA_FORMAT_ELF ||
+        IGC_IS_FLAG_DISABLED(EnableOCLTieredCompilation) ||
+        !isTierable(pInputArgs))
+    {
+        return false;
+    }
+    // VC compilations are not tiered, see TranslateBuild
+    if (pInputArgs->pOptions && (strstr(pInputArgs->pOptions, "-vc-codegen") ||
+                                 strstr(pInputArgs->pOptions, "-cmc")))
+    {
+        return false;
+    }
+
+    ShaderHash inputShHash = ShaderHashOCL(reinterpret_cast<const UINT*>(pInputArgs->pInput),
+                                           pInputArgs->InputSize / 4);
+    *pTicket = getTieredTicket(
+        pInputArgs, inputDataFormat, IGCPlatform, inputShHash.getAsmHash());
+    return true;
+}
+
+bool CIGCTranslationBlock::GetTieredCompilationTicket(
+    const STB_TranslateInputArgs* pInputArgs,
+    uint64_t* pTicket)
+{
+    LoadRegistryKeys();
+
+    IGC::CPlatform IGCPlatform(m_Platform);
+    return ComputeTieredCompilationTicket(
+        pInputArgs, m_DataFormatInput, IGCPlatform, pTicket);
+}
+
 bool CIGCTranslationBlock::Translate(
     const STB_TranslateInputArgs* pInputArgs,
     STB_TranslateOutputArgs* pOutputArgs)
@@ -1090,13 +1197,16 @@ static void WriteSpecConstantsDump(
                    hash, "_specconst.txt");
 }
 
-bool TranslateBuildSPMD(
+// cgFlag selects between the default flow (FLAG_CG_ALL_SIMDS) and the stage 1
+// fast compilation used by tiered compilation (FLAG_CG_STAGE1_FASTEST_COMPILE).
+static bool TranslateBuildSPMDImpl(
     const STB_TranslateInputArgs* pInputArgs,
     STB_TranslateOutputArgs* pOutputArgs,
     TB_DATA_FORMAT inputDataFormatTemp,
     const IGC::CPlatform& IGCPlatform,
     float profilingTimerResolution,
-    const ShaderHash& inputShHash)
+    const ShaderHash& inputShHash,
+    CG_FLAG_t cgFlag)
 {
     // This part of code is a critical-section for threads,
     // due static LLVM object which handles options.
@@ -1201,9 +1311,12 @@ bool TranslateBuildSPMD(
         DumpShaderFile(pOutputFolder, outputstr.str().c_str(), outputstr.str().size(), hash, "_cmd.txt");
     }
 
-    if (!ParseInput(pKernelModule, pInputArgs, pOutputArgs, *llvmContext, inputDataFormatTemp))
     {
-        return false;
+        vISA::CompileTraceScope traceScope("IGC", "ParseInput");
+        if (!ParseInput(pKernelModule, pInputArgs, pOutputArgs, *llvmContext, inputDataFormatTemp))
+        {
+            return false;
+        }
     }
     CDriverInfoOCLNEO driverInfoOCL;
     IGC::CDriverInfo* driverInfo = &driverInfoOCL;
@@ -1244,6 +1357,7 @@ bool TranslateBuildSPMD(
 
     oclContext.hash = inputShHash;
     oclContext.annotater = nullptr;
+    oclContext.m_CgFlag = cgFlag;
 
     // Set default denorm.
     // Note that those values have been set to FLOAT_DENORM_FLUSH_TO_ZERO
@@ -1261,7 +1375,16 @@ bool TranslateBuildSPMD(
                          IGC_IS_FLAG_ENABLED(CompileOneAtTime);
     // set retry manager
     bool retry = false;
-    oclContext.m_retryManager.Enable();
+    if (IsStage1FastestCompile(oclContext.m_CgFlag, oclContext.m_StagingCtx))
+    {
+        // stage 1 binary is replaced by the optimized one, don't spend time
+        // on recompiling it
+        oclContext.m_retryManager.Disable();
+    }
+    else
+    {
+        oclContext.m_retryManager.Enable();
+    }
     do
     {
         llvm::TinyPtrVector<const llvm::Function*> kernelFunctions;
@@ -1533,8 +1656,6 @@ bool TranslateBuildSPMD(
     else
     {
         // ze binary foramt
-        llvm::SmallVector<char, 64> buf;
-        llvm::raw_svector_ostream llvm_os(buf);
         const bool excludeIRFromZEBinary = IGC_IS_FLAG_ENABLED(ExcludeIRFromZEBinary) || oclContext.getModuleMetaData()->compOpt.ExcludeIRFromZEBinary;
         const char* spv_data = nullptr;
         uint32_t spv_size = 0;
@@ -1548,13 +1669,14 @@ bool TranslateBuildSPMD(
         size_t metricDataSize = oclContext.metrics.getMetricDataSize();
         auto metricData = reinterpret_cast<const char*>(oclContext.metrics.getMetricData());
 
-        oclContext.m_programOutput.GetZEBinary(llvm_os, pointerSizeInBytes,
+        // the binary is written straight into the output allocation
+        std::unique_ptr<char[]> zeBinary;
+        uint64_t zeBinarySize = 0;
+        oclContext.m_programOutput.GetZEBinary(zeBinary, zeBinarySize, pointerSizeInBytes,
             spv_data, spv_size, metricData, metricDataSize, pInputArgs->pOptions, pInputArgs->OptionsSize);
 
-        // FIXME: try to avoid memory copy here
-        binarySize = buf.size();
-        binaryOutput = new char[binarySize];
-        memcpy_s(binaryOutput, binarySize, buf.data(), buf.size());
+        binarySize = static_cast<int>(zeBinarySize);
+        binaryOutput = zeBinary.release();
     }
 
     if (IGC_IS_FLAG_ENABLED(ShaderDumpEnable))
@@ -1579,6 +1701,7 @@ bool TranslateBuildSPMD(
     }
 
     COMPILER_TIME_END(&oclContext, TIME_TOTAL);
+    vISA::CompileTrace::flush();
 
     COMPILER_TIME_PRINT(&oclContext, ShaderType::OPENCL_SHADER, oclContext.hash);
 
@@ -1587,6 +1710,64 @@ bool TranslateBuildSPMD(
     return true;
 }
 
+bool TranslateBuildSPMD(
+    const STB_TranslateInputArgs* pInputArgs,
+    STB_TranslateOutputArgs* pOutputArgs,
+    TB_DATA_FORMAT inputDataFormatTemp,
+    const IGC::CPlatform& IGCPlatform,
+    float profilingTimerResolution,
+    const ShaderHash& inputShHash)
+{
+    if (IGC_IS_FLAG_DISABLED(EnableOCLTieredCompilation) ||
+        !isTierable(pInputArgs))
+    {
+        return TranslateBuildSPMDImpl(pInputArgs, pOutputArgs, inputDataFormatTemp,
+            IGCPlatform, profilingTimerResolution, inputShHash, FLAG_CG_ALL_SIMDS);
+    }
+
+    TieredCompilation& tiered = TieredCompilation::get();
+    tiered.setCacheSize(IGC_GET_FLAG_VALUE(OCLTieredCompilationCacheSize));
+    TieredCompilation::Ticket ticket = getTieredTicket(
+        pInputArgs, inputDataFormatTemp, IGCPlatform, inputShHash.getAsmHash());
+
+    // The optimized binary of this input is already available.
+    if (tiered.takeOptimized(ticket, *pOutputArgs))
+    {
+        return true;
+    }
+
+    if (!tiered.hasFailed(ticket))
+    {
+        STB_TranslateOutputArgs stage1OutputArgs;
+        if (TranslateBuildSPMDImpl(pInputArgs, &stage1OutputArgs, inputDataFormatTemp,
+                IGCPlatform, profilingTimerResolution, inputShHash, FLAG_CG_STAGE1_FASTEST_COMPILE))
+        {
+            *pOutputArgs = stage1OutputArgs;
+
+            IGC::CPlatform platform = IGCPlatform;
+            // The optimized compilation dumps under its own name (_nos<ticket>),
+            // so it doesn't overwrite the dumps of the stage 1 binary.
+            ShaderHash optimizedShHash = inputShHash;
+            optimizedShHash.nosHash = ticket;
+            tiered.schedule(ticket, pInputArgs,
+                [=](const STB_TranslateInputArgs* pArgs, STB_TranslateOutputArgs* pOutArgs)
+                {
+                    return TranslateBuildSPMDImpl(pArgs, pOutArgs, inputDataFormatTemp,
+                        platform, profilingTimerResolution, optimizedShHash, FLAG_CG_ALL_SIMDS);
+                });
+            return true;
+        }
+        // Stage 1 may fail where the default flow succeeds (e.g. no retry),
+        // fall back to it.
+        delete[] stage1OutputArgs.pOutput;
+        delete[] stage1OutputArgs.pDebugData;
+        delete[] stage1OutputArgs.pErrorString;
+    }
+
+    return TranslateBuildSPMDImpl(pInputArgs, pOutputArgs, inputDataFormatTemp,
+        IGCPlatform, profilingTimerResolution, inputShHash, FLAG_CG_ALL_SIMDS);
+}
+
 #if defined(IGC_VC_ENABLED)
 bool TranslateBuildVC(
     const STB_TranslateInputArgs* pInputArgs,
@@ -1755,4 +1936,33 @@ TRANSLATION_BLOCK_API void Delete(CTranslationBlock* pTranslationBlock)
     CIGCTranslationBlock::Delete(pIGCTranslationBlock);
 }
 
+TRANSLATION_BLOCK_API bool GetTieredCompilationTicket(
+    CTranslationBlock* pTranslationBlock,
+    const STB_TranslateInputArgs* pInputArgs,
+    uint64_t* pTicket)
+{
+    CIGCTranslationBlock*  pIGCTranslationBlock =
+        static_cast<CIGCTranslationBlock*>(pTranslationBlock);
+
+    return pIGCTranslationBlock &&
+        pIGCTranslationBlock->GetTieredCompilationTicket(pInputArgs, pTicket);
+}
+
+TRANSLATION_BLOCK_API void SetTieredCompilationCallback(
+    PFNTIEREDCOMPILATIONCALLBACK pfnCallback,
+    void* pUserData)
+{
+    if (pfnCallback == nullptr)
+    {
+        TieredCompilation::get().setCallback(nullptr);
+        return;
+    }
+    TieredCompilation::get().setCallback(
+        [pfnCallback, pUserData](TieredCompilation::Ticket ticket,
+                                 const STB_TranslateOutputArgs& outputArgs)
+        {
+            pfnCallback(pUserData, ticket, &outputArgs);
+        });
+}
+
 } // namespace TC
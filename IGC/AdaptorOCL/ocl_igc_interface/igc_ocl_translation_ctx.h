@@ -110,6 +110,33 @@ protected:
                                                   void *gtPinInput);
 };
 
+// Called from the tiered compilation worker once the optimized binary of the
+// given ticket is available. The binary is only valid for the duration of the
+// call.
+using TieredCompilationCallback = void (*)(void *userData, uint64_t ticket,
+                                           const char *binary, uint64_t binarySize,
+                                           const char *debugData, uint64_t debugDataSize);
+
+CIF_DEFINE_INTERFACE_VER_WITH_COMPATIBILITY(IgcOclTranslationCtx, 4, 3) {
+  using IgcOclTranslationCtx<3>::TranslateImpl;
+  using IgcOclTranslationCtx<3>::Translate;
+  CIF_INHERIT_CONSTRUCTOR();
+
+  // Tiered compilation (see EnableOCLTieredCompilation): Translate returns a
+  // quickly compiled binary and the optimized one is compiled in the
+  // background. Return false if the given input is not tiered, otherwise the
+  // ticket the optimized binary of the input is reported with.
+  virtual bool GetTieredCompilationTicketImpl(CIF::Builtins::BufferSimple *src,
+                                              CIF::Builtins::BufferSimple *specConstantsIds,
+                                              CIF::Builtins::BufferSimple *specConstantsValues,
+                                              CIF::Builtins::BufferSimple *options,
+                                              CIF::Builtins::BufferSimple *internalOptions,
+                                              uint64_t *outTicket);
+  // Register the callback receiving the optimized binaries, nullptr to
+  // unregister.
+  virtual void SetTieredCompilationCallbackImpl(TieredCompilationCallback callback, void *userData);
+};
+
 CIF_GENERATE_VERSIONS_LIST_AND_DECLARE_INTERFACE_DEPENDENCIES(IgcOclTranslationCtx, IGC::OclTranslationOutput, CIF::Builtins::Buffer);
 CIF_MARK_LATEST_VERSION(IgcOclTranslationCtxLatest, IgcOclTranslationCtx);
 using IgcOclTranslationCtxTagOCL = IgcOclTranslationCtxLatest; // Note : can tag with different version for
@@ -54,6 +54,22 @@ OclTranslationOutputBase *CIF_GET_INTERFACE_CLASS(IgcOclTranslationCtx, 3)::Tran
     return CIF_GET_PIMPL()->Translate(outVersion, src, specConstantsIds, specConstantsValues, options, internalOptions, tracingOptions, tracingOptionsCount, gtPinInput);
 }
 
+bool CIF_GET_INTERFACE_CLASS(IgcOclTranslationCtx, 4)::GetTieredCompilationTicketImpl(
+                            CIF::Builtins::BufferSimple *src,
+                            CIF::Builtins::BufferSimple *specConstantsIds,
+                            CIF::Builtins::BufferSimple *specConstantsValues,
+                            CIF::Builtins::BufferSimple *options,
+                            CIF::Builtins::BufferSimple *internalOptions,
+                            uint64_t *outTicket) {
+    return CIF_GET_PIMPL()->GetTieredCompilationTicket(src, specConstantsIds, specConstantsValues, options, internalOptions, outTicket);
+}
+
+void CIF_GET_INTERFACE_CLASS(IgcOclTranslationCtx, 4)::SetTieredCompilationCallbackImpl(
+                            TieredCompilationCallback callback,
+                            void *userData) {
+    CIF_GET_PIMPL()->SetTieredCompilationCallback(callback, userData);
+}
+
 }
 
 #include "cif/macros/disable.h"
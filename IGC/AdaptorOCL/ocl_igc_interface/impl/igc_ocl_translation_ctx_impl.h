@@ -21,6 +21,7 @@ SPDX-License-Identifier: MIT
 #include "ocl_igc_interface/impl/ocl_translation_output_impl.h"
 
 #include "AdaptorOCL/OCL/TB/igc_tb.h"
+#include "AdaptorOCL/TieredCompilation.hpp"
 #include "common/debug/Debug.hpp"
 
 #include "cif/macros/enable.h"
@@ -69,6 +70,14 @@ bool TranslateBuildVC(
   float profilingTimerResolution,
   const ShaderHash& inputShHash);
 
+// Ticket the optimized binary of a tiered compilation is reported with,
+// return false if the input is not tiered. Registry keys must be loaded.
+bool ComputeTieredCompilationTicket(
+  const STB_TranslateInputArgs* pInputArgs,
+  TB_DATA_FORMAT inputDataFormat,
+  const IGC::CPlatform &platform,
+  uint64_t* pTicket);
+
 bool ReadSpecConstantsFromSPIRV(
     std::istream &IS,
     std::vector<std::pair<uint32_t, uint32_t>> &OutSCInfo);
@@ -126,6 +135,13 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
                                   CodeType::CodeType_t inType, CodeType::CodeType_t outType)
         : globalState(CIF::Sanity::ToReferenceOrAbort(globalState)), inType(inType), outType(outType)
     {
+        TC::TieredCompilation::get().acquire();
+    }
+
+    CIF_PIMPL_DECLARE_DESTRUCTOR() override{
+        // stops the tiered compilation worker with the last translation
+        // context, before the library can be unloaded
+        TC::TieredCompilation::get().release();
     }
 
     static bool SupportsTranslation(CodeType::CodeType_t inType, CodeType::CodeType_t outType){
@@ -262,55 +278,15 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
         TC::STB_TranslateOutputArgs output;
         CIF::SafeZeroOut(output);
 
-        std::string RegKeysFlagsFromOptions;
-        if (inputArgs.pOptions != nullptr)
-        {
-            const std::string optionsWithFlags = inputArgs.pOptions;
-            std::size_t found = optionsWithFlags.find("-igc_opts");
-            if (found != std::string::npos)
-            {
-                std::size_t foundFirstSingleQuote = optionsWithFlags.find('\'', found);
-                std::size_t foundSecondSingleQuote = optionsWithFlags.find('\'', foundFirstSingleQuote + 1);
-                if (foundFirstSingleQuote != std::string::npos && foundSecondSingleQuote)
-                {
-                    RegKeysFlagsFromOptions = optionsWithFlags.substr(foundFirstSingleQuote + 1, (foundSecondSingleQuote - foundFirstSingleQuote - 1));
-                    RegKeysFlagsFromOptions = RegKeysFlagsFromOptions + ',';
-                }
-            }
-        }
         bool RegFlagNameError = 0;
-        LoadRegistryKeys(RegKeysFlagsFromOptions, &RegFlagNameError);
+        LoadRegistryKeysWithOptions(inputArgs, &RegFlagNameError);
         if(RegFlagNameError) outputInterface->GetImpl()->SetError(TranslationErrorType::Unused, "Invalid registry flag name in -igc_opts, at least one flag has been ignored");
 
         IGC::CPlatform igcPlatform = this->globalState.GetIgcCPlatform();
 
-        // extra ocl options set from regkey
-        const char *extraOptions = IGC_GET_REGKEYSTRING(ExtraOCLOptions);
         std::string combinedOptions;
-        if (extraOptions[0] != '\0')
-        {
-            if (inputArgs.pOptions != nullptr)
-            {
-                combinedOptions = std::string(inputArgs.pOptions) + ' ';
-            }
-            combinedOptions += extraOptions;
-            inputArgs.pOptions = combinedOptions.c_str();
-            inputArgs.OptionsSize = combinedOptions.size();
-        }
-
-        // extra ocl internal options set from regkey
-        const char *extraInternlOptions = IGC_GET_REGKEYSTRING(ExtraOCLInternalOptions);
         std::string combinedInternalOptions;
-        if (extraInternlOptions[0] != '\0')
-        {
-            if (inputArgs.pInternalOptions != nullptr)
-            {
-                combinedInternalOptions = std::string(inputArgs.pInternalOptions) + ' ';
-            }
-            combinedInternalOptions += extraInternlOptions;
-            inputArgs.pInternalOptions = combinedInternalOptions.c_str();
-            inputArgs.InternalOptionsSize = combinedInternalOptions.size();
-        }
+        AddExtraOptions(inputArgs, combinedOptions, combinedInternalOptions);
 
         bool success = false;
         try
@@ -391,6 +367,110 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
         return outputInterface.release();
     }
 
+    bool GetTieredCompilationTicket(CIF::Builtins::BufferSimple *src,
+                                    CIF::Builtins::BufferSimple *specConstantsIds,
+                                    CIF::Builtins::BufferSimple *specConstantsValues,
+                                    CIF::Builtins::BufferSimple *options,
+                                    CIF::Builtins::BufferSimple *internalOptions,
+                                    uint64_t *outTicket) const{
+        if (IGC_State::isDestructed() || src == nullptr || outTicket == nullptr) {
+            return false;
+        }
+
+        // Must match the input arguments Translate builds for the same input
+        TC::STB_TranslateInputArgs inputArgs;
+        inputArgs.pInput = src->GetMemoryWriteable<char>();
+        inputArgs.InputSize = static_cast<uint32_t>(src->GetSizeRaw());
+        if(options != nullptr){
+            inputArgs.pOptions = options->GetMemory<char>();
+            inputArgs.OptionsSize = static_cast<uint32_t>(options->GetSizeRaw());
+        }
+        if(internalOptions != nullptr){
+            inputArgs.pInternalOptions =  internalOptions->GetMemory<char>();
+            inputArgs.InternalOptionsSize = static_cast<uint32_t>(internalOptions->GetSizeRaw());
+        }
+        if(specConstantsIds != nullptr && specConstantsValues != nullptr){
+            inputArgs.pSpecConstantsIds = specConstantsIds->GetMemory<uint32_t>();
+            inputArgs.SpecConstantsSize = static_cast<uint32_t>(specConstantsIds->GetSizeRaw() / sizeof(uint32_t));
+            inputArgs.pSpecConstantsValues = specConstantsValues->GetMemory<uint64_t>();
+        }
+
+        LoadRegistryKeysWithOptions(inputArgs, nullptr);
+
+        std::string combinedOptions;
+        std::string combinedInternalOptions;
+        AddExtraOptions(inputArgs, combinedOptions, combinedInternalOptions);
+
+        return TC::ComputeTieredCompilationTicket(&inputArgs, toLegacyFormat(this->inType),
+                                                  this->globalState.GetIgcCPlatform(), outTicket);
+    }
+
+    void SetTieredCompilationCallback(TieredCompilationCallback callback, void *userData){
+        if (callback == nullptr) {
+            TC::TieredCompilation::get().setCallback(nullptr);
+            return;
+        }
+        TC::TieredCompilation::get().setCallback(
+            [callback, userData](TC::TieredCompilation::Ticket ticket, const TC::STB_TranslateOutputArgs &output) {
+                callback(userData, ticket, output.pOutput, output.OutputSize,
+                         output.pDebugData, output.DebugDataSize);
+            });
+    }
+
+protected:
+    // load the registry keys, including the ones given by -igc_opts
+    static void LoadRegistryKeysWithOptions(const TC::STB_TranslateInputArgs &inputArgs, bool *RegFlagNameError){
+        std::string RegKeysFlagsFromOptions;
+        if (inputArgs.pOptions != nullptr)
+        {
+            const std::string optionsWithFlags = inputArgs.pOptions;
+            std::size_t found = optionsWithFlags.find("-igc_opts");
+            if (found != std::string::npos)
+            {
+                std::size_t foundFirstSingleQuote = optionsWithFlags.find('\'', found);
+                std::size_t foundSecondSingleQuote = optionsWithFlags.find('\'', foundFirstSingleQuote + 1);
+                if (foundFirstSingleQuote != std::string::npos && foundSecondSingleQuote)
+                {
+                    RegKeysFlagsFromOptions = optionsWithFlags.substr(foundFirstSingleQuote + 1, (foundSecondSingleQuote - foundFirstSingleQuote - 1));
+                    RegKeysFlagsFromOptions = RegKeysFlagsFromOptions + ',';
+                }
+            }
+        }
+        LoadRegistryKeys(RegKeysFlagsFromOptions, RegFlagNameError);
+    }
+
+    // append the extra ocl (internal) options set from regkeys, the combined
+    // strings must outlive inputArgs
+    static void AddExtraOptions(TC::STB_TranslateInputArgs &inputArgs,
+                                std::string &combinedOptions,
+                                std::string &combinedInternalOptions){
+        // extra ocl options set from regkey
+        const char *extraOptions = IGC_GET_REGKEYSTRING(ExtraOCLOptions);
+        if (extraOptions[0] != '\0')
+        {
+            if (inputArgs.pOptions != nullptr)
+            {
+                combinedOptions = std::string(inputArgs.pOptions) + ' ';
+            }
+            combinedOptions += extraOptions;
+            inputArgs.pOptions = combinedOptions.c_str();
+            inputArgs.OptionsSize = combinedOptions.size();
+        }
+
+        // extra ocl internal options set from regkey
+        const char *extraInternlOptions = IGC_GET_REGKEYSTRING(ExtraOCLInternalOptions);
+        if (extraInternlOptions[0] != '\0')
+        {
+            if (inputArgs.pInternalOptions != nullptr)
+            {
+                combinedInternalOptions = std::string(inputArgs.pInternalOptions) + ' ';
+            }
+            combinedInternalOptions += extraInternlOptions;
+            inputArgs.pInternalOptions = combinedInternalOptions.c_str();
+            inputArgs.InternalOptionsSize = combinedInternalOptions.size();
+        }
+    }
+
 protected:
     CIF_PIMPL(IgcOclDeviceCtx) &globalState;
     CodeType::CodeType_t inType;
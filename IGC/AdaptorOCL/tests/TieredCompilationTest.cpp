@@ -0,0 +1,297 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// Tests of the two-tier flow of TC::TieredCompilation: the caller returns its
+// stage 1 binary and schedules the optimized compilation, which is reported
+// through the callback and returned by the following builds of the input,
+// and the release of the last user while a job is running.
+
+#include "AdaptorOCL/TieredCompilation.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace TC;
+
+static int numFailures = 0;
+
+#define CHECK(cond)                                                        \
+    do {                                                                   \
+        if (!(cond)) {                                                     \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " \
+                      << #cond << "\n";                                    \
+            ++numFailures;                                                 \
+        }                                                                  \
+    } while (0)
+
+static void setOutput(STB_TranslateOutputArgs* pOutputArgs, const std::string& binary)
+{
+    pOutputArgs->pOutput = new char[binary.size()];
+    memcpy(pOutputArgs->pOutput, binary.data(), binary.size());
+    pOutputArgs->OutputSize = static_cast<uint32_t>(binary.size());
+}
+
+static std::string takeOutput(STB_TranslateOutputArgs& outputArgs)
+{
+    std::string binary(outputArgs.pOutput, outputArgs.OutputSize);
+    delete[] outputArgs.pOutput;
+    delete[] outputArgs.pDebugData;
+    outputArgs = STB_TranslateOutputArgs();
+    return binary;
+}
+
+// Compile function of the optimized tier, the binary is the input prefixed
+// with "opt:". Blocks until the gate is opened.
+struct Gate
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool open = true;
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this]() { return open; });
+    }
+    void set(bool isOpen)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            open = isOpen;
+        }
+        cv.notify_all();
+    }
+};
+
+static TieredCompilation::CompileFn optimizedCompile(Gate& gate)
+{
+    return [&gate](const STB_TranslateInputArgs* pArgs, STB_TranslateOutputArgs* pOutputArgs) {
+        gate.wait();
+        setOutput(pOutputArgs, "opt:" + std::string(pArgs->pInput, pArgs->InputSize));
+        return true;
+    };
+}
+
+// Collects the binaries reported through the callback
+struct Reported
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::pair<TieredCompilation::Ticket, std::string>> binaries;
+
+    bool waitFor(size_t num)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_for(lock, std::chrono::seconds(30),
+            [&]() { return binaries.size() >= num; });
+    }
+};
+
+static bool waitForFailure(TieredCompilation& tiered, TieredCompilation::Ticket ticket)
+{
+    for (int i = 0; i < 3000; ++i)
+    {
+        if (tiered.hasFailed(ticket))
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+static void testTwoTiers(TieredCompilation& tiered, Reported& reported)
+{
+    Gate gate;
+    gate.set(false);
+
+    std::string input = "kernel";
+    STB_TranslateInputArgs inputArgs;
+    inputArgs.pInput = &input[0];
+    inputArgs.InputSize = static_cast<uint32_t>(input.size());
+
+    // first build: the caller returns its stage 1 binary and queues the
+    // optimized compilation
+    STB_TranslateOutputArgs outputArgs;
+    CHECK(!tiered.takeOptimized(1, outputArgs));
+    CHECK(tiered.schedule(1, &inputArgs, optimizedCompile(gate)));
+    // the input is copied by schedule
+    input = "XXXXXX";
+    // already pending
+    CHECK(!tiered.schedule(1, &inputArgs, optimizedCompile(gate)));
+    CHECK(!tiered.takeOptimized(1, outputArgs));
+    CHECK(!tiered.hasFailed(1));
+
+    gate.set(true);
+    CHECK(reported.waitFor(1));
+    {
+        std::lock_guard<std::mutex> lock(reported.mutex);
+        CHECK(reported.binaries.size() == 1);
+        CHECK(reported.binaries[0].first == 1);
+        CHECK(reported.binaries[0].second == "opt:kernel");
+    }
+
+    // next build of the same input gets the optimized binary
+    CHECK(tiered.takeOptimized(1, outputArgs));
+    CHECK(takeOutput(outputArgs) == "opt:kernel");
+    CHECK(!tiered.schedule(1, &inputArgs, optimizedCompile(gate)));
+}
+
+static void testFailure(TieredCompilation& tiered)
+{
+    std::string input = "bad";
+    STB_TranslateInputArgs inputArgs;
+    inputArgs.pInput = &input[0];
+    inputArgs.InputSize = static_cast<uint32_t>(input.size());
+
+    CHECK(tiered.schedule(2, &inputArgs,
+        [](const STB_TranslateInputArgs*, STB_TranslateOutputArgs*) { return false; }));
+    CHECK(waitForFailure(tiered, 2));
+    STB_TranslateOutputArgs outputArgs;
+    CHECK(!tiered.takeOptimized(2, outputArgs));
+    // a failed input is not compiled again
+    CHECK(!tiered.schedule(2, &inputArgs,
+        [](const STB_TranslateInputArgs*, STB_TranslateOutputArgs*) { return false; }));
+}
+
+static void testEviction(TieredCompilation& tiered, Reported& reported)
+{
+    Gate gate;
+    tiered.setCacheSize(1);
+
+    std::string input = "a";
+    STB_TranslateInputArgs inputArgs;
+    inputArgs.pInput = &input[0];
+    inputArgs.InputSize = static_cast<uint32_t>(input.size());
+
+    size_t numReported = reported.binaries.size();
+    CHECK(tiered.schedule(3, &inputArgs, optimizedCompile(gate)));
+    CHECK(reported.waitFor(numReported + 1));
+    CHECK(tiered.schedule(4, &inputArgs, optimizedCompile(gate)));
+    CHECK(reported.waitFor(numReported + 2));
+
+    STB_TranslateOutputArgs outputArgs;
+    CHECK(tiered.takeOptimized(4, outputArgs));
+    takeOutput(outputArgs);
+    // the oldest binary is gone
+    CHECK(!tiered.takeOptimized(3, outputArgs));
+    tiered.setCacheSize(64);
+}
+
+// called with a single user of tiered compilation, which is released
+static void testRelease(TieredCompilation& tiered, Reported& reported)
+{
+    Gate gate;
+    gate.set(false);
+
+    std::string input = "b";
+    STB_TranslateInputArgs inputArgs;
+    inputArgs.pInput = &input[0];
+    inputArgs.InputSize = static_cast<uint32_t>(input.size());
+
+    // compile function of the job that is running during the release
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool started = false;
+    bool returned = false;
+    auto runningCompile = [&](const STB_TranslateInputArgs* pArgs, STB_TranslateOutputArgs* pOutputArgs) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            started = true;
+        }
+        cv.notify_all();
+        bool success = optimizedCompile(gate)(pArgs, pOutputArgs);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            returned = true;
+        }
+        cv.notify_all();
+        return success;
+    };
+
+    size_t numReported = reported.binaries.size();
+    CHECK(tiered.schedule(5, &inputArgs, runningCompile));
+    CHECK(tiered.schedule(6, &inputArgs, optimizedCompile(gate)));
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        CHECK(cv.wait_for(lock, std::chrono::seconds(30), [&]() { return started; }));
+    }
+
+    // the last release doesn't wait for the running job, it abandons it and
+    // drops the queued one
+    std::future<void> released = std::async(std::launch::async, [&tiered]() { tiered.release(); });
+    bool releasedWhileRunning =
+        released.wait_for(std::chrono::seconds(30)) == std::future_status::ready;
+    CHECK(releasedWhileRunning);
+    gate.set(true);
+    released.wait();
+
+    // the abandoned job finishes in the background, its result is dropped
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        CHECK(cv.wait_for(lock, std::chrono::seconds(30), [&]() { return returned; }));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    STB_TranslateOutputArgs outputArgs;
+    CHECK(!tiered.takeOptimized(5, outputArgs));
+    CHECK(!tiered.takeOptimized(6, outputArgs));
+    {
+        std::lock_guard<std::mutex> lock(reported.mutex);
+        CHECK(reported.binaries.size() == numReported);
+    }
+
+    // both inputs can be scheduled again, starting a new worker
+    tiered.acquire();
+    CHECK(tiered.schedule(5, &inputArgs, optimizedCompile(gate)));
+    CHECK(tiered.schedule(6, &inputArgs, optimizedCompile(gate)));
+    CHECK(reported.waitFor(numReported + 2));
+    CHECK(tiered.takeOptimized(5, outputArgs));
+    takeOutput(outputArgs);
+    CHECK(tiered.takeOptimized(6, outputArgs));
+    takeOutput(outputArgs);
+
+    // an idle worker is let go as well
+    tiered.release();
+    tiered.acquire();
+    CHECK(!tiered.schedule(6, &inputArgs, optimizedCompile(gate)));
+    tiered.release();
+}
+
+int main()
+{
+    TieredCompilation& tiered = TieredCompilation::get();
+    tiered.acquire();
+
+    Reported reported;
+    tiered.setCallback([&reported](TieredCompilation::Ticket ticket, const STB_TranslateOutputArgs& outputArgs) {
+        {
+            std::lock_guard<std::mutex> lock(reported.mutex);
+            reported.binaries.emplace_back(ticket, std::string(outputArgs.pOutput, outputArgs.OutputSize));
+        }
+        reported.cv.notify_all();
+    });
+
+    testTwoTiers(tiered, reported);
+    testFailure(tiered);
+    testEviction(tiered, reported);
+    testRelease(tiered, reported);
+
+    tiered.setCallback(nullptr);
+
+    if (numFailures != 0)
+    {
+        std::cerr << numFailures << " tiered compilation checks failed\n";
+        return 1;
+    }
+    std::cout << "tiered compilation tests passed\n";
+    return 0;
+}
@@ -22,7 +22,9 @@ SPDX-License-Identifier: MIT
 #include "inc/common/sku_wa.h"
 #include <llvm/Support/Path.h>
 #include <llvm/ADT/Statistic.h>
+#include <llvm/Support/JSON.h>
 #include <iStdLib/utility.h>
+#include <chrono>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -3933,6 +3935,128 @@ namespace IGC
         }
     }
 
+    // true if the codegen statistics of the compiled kernels have to be kept
+    // in SProgramOutput::m_KernelStats for the ZE binary (c.f.
+    // KernelStatsToJSON)
+    static bool EmitKernelStats(CodeGenContext* context)
+    {
+        return context->enableZEBinary() &&
+            (IGC_IS_FLAG_ENABLED(EmitZeBinKernelStats) ||
+             context->getCompilerOption().EmitZeBinKernelStats);
+    }
+
+    // true if the kernel statistics also get the values that change from one
+    // compile to the next (compile time, compaction cache hits), which makes
+    // the binary non-deterministic
+    static bool EmitKernelStatsTiming()
+    {
+        return IGC_IS_FLAG_ENABLED(EmitZeBinKernelStatsTiming);
+    }
+
+    // The codegen statistics of one compiled kernel variant as a JSON object.
+    // The finalizer statistics use the keys of the vISA .stats.json dumps
+    // (c.f. PERF_STATS::toJSON), the KERNEL_INFO ones are those that
+    // IGCMetric::CollectRegStats reports. compileTimeUs < 0 leaves out the
+    // non-deterministic values.
+    static std::string KernelStatsToJSON(
+        vISA::FINALIZER_INFO* jitInfo, const KERNEL_INFO* kernelInfo,
+        int64_t compileTimeUs)
+    {
+        json::Value perfStats = jitInfo->stats.toJSON();
+        json::Object stats = std::move(*perfStats.getAsObject());
+        stats["isSpill"] = jitInfo->isSpill;
+        stats["numBarriers"] = static_cast<int64_t>(jitInfo->numBarriers);
+        stats["numBBs"] = static_cast<int64_t>(jitInfo->BBNum);
+        if (compileTimeUs >= 0)
+        {
+            stats["compileTimeUs"] = compileTimeUs;
+        }
+        else
+        {
+            // these depend on what the compaction cache held before
+            stats.erase("compactionCacheHits");
+            stats.erase("compactionCacheMisses");
+        }
+        if (kernelInfo)
+        {
+            stats["numReg"] = kernelInfo->numReg;
+            stats["numTmpReg"] = kernelInfo->numTmpReg;
+            stats["bytesOfTmpReg"] = kernelInfo->bytesOfTmpReg;
+            stats["numSpillReg"] = kernelInfo->numSpillReg;
+            stats["numFillReg"] = kernelInfo->numFillReg;
+            stats["percentGRFUsage"] = kernelInfo->precentGRFUsage;
+            stats["countBytesSpilled"] = kernelInfo->spillFills.countBytesSpilled;
+            stats["countSIMD1"] = kernelInfo->countSIMD1;
+            stats["countSIMD2"] = kernelInfo->countSIMD2;
+            stats["countSIMD4"] = kernelInfo->countSIMD4;
+            stats["countSIMD8"] = kernelInfo->countSIMD8;
+            stats["countSIMD16"] = kernelInfo->countSIMD16;
+            stats["countSIMD32"] = kernelInfo->countSIMD32;
+            stats["hasAnyHDCSend"] = kernelInfo->hdcSends.hasAnyHDCSend;
+            stats["hasAnyLSCSend"] = kernelInfo->lscSends.hasAnyLSCSend;
+            // the send counts by message, as in the metrics protobuf
+            if (kernelInfo->lscSends.hasAnyLSCSend)
+            {
+                const LSCSendStats& lsc = kernelInfo->lscSends;
+                stats["lscSends"] = json::Object{
+                    {"countLSC_LOAD", lsc.countLSC_LOAD},
+                    {"countLSC_LOAD_STRIDED", lsc.countLSC_LOAD_STRIDED},
+                    {"countLSC_LOAD_QUAD", lsc.countLSC_LOAD_QUAD},
+                    {"countLSC_LOAD_BLOCK2D", lsc.countLSC_LOAD_BLOCK2D},
+                    {"countLSC_STORE", lsc.countLSC_STORE},
+                    {"countLSC_STORE_STRIDED", lsc.countLSC_STORE_STRIDED},
+                    {"countLSC_STORE_QUAD", lsc.countLSC_STORE_QUAD},
+                    {"countLSC_STORE_BLOCK2D", lsc.countLSC_STORE_BLOCK2D},
+                    {"countLSC_STORE_UNCOMPRESSED", lsc.countLSC_STORE_UNCOMPRESSED}};
+            }
+            if (kernelInfo->hdcSends.hasAnyHDCSend)
+            {
+                const HDCSendStats& hdc = kernelInfo->hdcSends;
+                stats["hdcSends"] = json::Object{
+                    {"countDC_OWORD_BLOCK_READ", hdc.countDC_OWORD_BLOCK_READ},
+                    {"countDC_ALIGNED_OWORD_BLOCK_READ", hdc.countDC_ALIGNED_OWORD_BLOCK_READ},
+                    {"countDC_DWORD_SCATTERED_READ", hdc.countDC_DWORD_SCATTERED_READ},
+                    {"countDC_BYTE_SCATTERED_READ", hdc.countDC_BYTE_SCATTERED_READ},
+                    {"countDC_QWORD_SCATTERED_READ", hdc.countDC_QWORD_SCATTERED_READ},
+                    {"countDC_OWORD_BLOCK_WRITE", hdc.countDC_OWORD_BLOCK_WRITE},
+                    {"countDC_DWORD_SCATTERED_WRITE", hdc.countDC_DWORD_SCATTERED_WRITE},
+                    {"countDC_BYTE_SCATTERED_WRITE", hdc.countDC_BYTE_SCATTERED_WRITE},
+                    {"countDC_QWORD_SCATTERED_WRITE", hdc.countDC_QWORD_SCATTERED_WRITE},
+                    {"countDC1_UNTYPED_SURFACE_READ", hdc.countDC1_UNTYPED_SURFACE_READ},
+                    {"countDC1_MEDIA_BLOCK_READ", hdc.countDC1_MEDIA_BLOCK_READ},
+                    {"countDC1_TYPED_SURFACE_READ", hdc.countDC1_TYPED_SURFACE_READ},
+                    {"countDC1_A64_SCATTERED_READ", hdc.countDC1_A64_SCATTERED_READ},
+                    {"countDC1_A64_UNTYPED_SURFACE_READ", hdc.countDC1_A64_UNTYPED_SURFACE_READ},
+                    {"countDC1_A64_BLOCK_READ", hdc.countDC1_A64_BLOCK_READ},
+                    {"countDC1_UNTYPED_SURFACE_WRITE", hdc.countDC1_UNTYPED_SURFACE_WRITE},
+                    {"countDC1_MEDIA_BLOCK_WRITE", hdc.countDC1_MEDIA_BLOCK_WRITE},
+                    {"countDC1_TYPED_SURFACE_WRITE", hdc.countDC1_TYPED_SURFACE_WRITE},
+                    {"countDC1_A64_BLOCK_WRITE", hdc.countDC1_A64_BLOCK_WRITE},
+                    {"countDC1_A64_UNTYPED_SURFACE_WRITE", hdc.countDC1_A64_UNTYPED_SURFACE_WRITE},
+                    {"countDC1_A64_SCATTERED_WRITE", hdc.countDC1_A64_SCATTERED_WRITE},
+                    {"countDC2_UNTYPED_SURFACE_READ", hdc.countDC2_UNTYPED_SURFACE_READ},
+                    {"countDC2_A64_SCATTERED_READ", hdc.countDC2_A64_SCATTERED_READ},
+                    {"countDC2_A64_UNTYPED_SURFACE_READ", hdc.countDC2_A64_UNTYPED_SURFACE_READ},
+                    {"countDC2_BYTE_SCATTERED_READ", hdc.countDC2_BYTE_SCATTERED_READ},
+                    {"countDC2_UNTYPED_SURFACE_WRITE", hdc.countDC2_UNTYPED_SURFACE_WRITE},
+                    {"countDC2_A64_UNTYPED_SURFACE_WRITE", hdc.countDC2_A64_UNTYPED_SURFACE_WRITE},
+                    {"countDC2_A64_SCATTERED_WRITE", hdc.countDC2_A64_SCATTERED_WRITE},
+                    {"countDC2_BYTE_SCATTERED_WRITE", hdc.countDC2_BYTE_SCATTERED_WRITE},
+                    {"countURB_READ_HWORD", hdc.countURB_READ_HWORD},
+                    {"countURB_READ_OWORD", hdc.countURB_READ_OWORD},
+                    {"countURB_SIMD8_READ", hdc.countURB_SIMD8_READ},
+                    {"countURB_WRITE_HWORD", hdc.countURB_WRITE_HWORD},
+                    {"countURB_WRITE_OWORD", hdc.countURB_WRITE_OWORD},
+                    {"countURB_SIMD8_WRITE", hdc.countURB_SIMD8_WRITE}};
+            }
+        }
+
+        std::string str;
+        raw_string_ostream os(str);
+        os << json::Value(std::move(stats));
+        return os.str();
+    }
+
     void CEncoder::InitVISABuilderOptions(TARGET_PLATFORM VISAPlatform, bool canAbortOnSpill, bool hasStackCall, bool enableVISA_IR)
     {
         CodeGenContext* context = m_program->GetContext();
@@ -4198,6 +4322,13 @@ namespace IGC
             SaveOption(vISA_EmitLocation, true);
         }
 
+        // KERNEL_INFO is a single walk over the final instructions, cheap
+        // enough to collect whenever the kernel stats are emitted
+        if (EmitKernelStats(context))
+        {
+            SaveOption(vISA_GenerateKernelInfo, true);
+        }
+
         if (canAbortOnSpill)
         {
             SaveOption(vISA_AbortOnSpill, true);
@@ -4853,6 +4984,11 @@ namespace IGC
                 SaveOption(vISA_SpillSpaceCompression, false);
                 SaveOption(vISA_LVN, false);
                 SaveOption(vISA_QuickTokenAllocation, true);
+                if (context->type == ShaderType::OPENCL_SHADER)
+                {
+                    // use 1 iteration RA for the stage 1 binary of tiered compilation
+                    SaveOption(vISA_FastCompileRA, true);
+                }
                 if (!context->getModuleMetaData()->compOpt.DisableFastestLinearScan &&
                     !IGC_IS_FLAG_ENABLED(DisableFastestLinearScan))
                 {
@@ -4891,6 +5027,24 @@ namespace IGC
             }
         }
 
+        // Once the compile budget is used up, the expensive vISA phases take
+        // their fast variants right away. Otherwise vISA gets what is left of
+        // the budget and degrades by itself when it runs out.
+        if (context->getCompileBudgetMs() != 0)
+        {
+            uint32_t remainingBudget = context->getRemainingCompileBudgetMs();
+            if (remainingBudget == 0)
+            {
+                SaveOption(vISA_preRA_Schedule, false);
+                SaveOption(vISA_FastCompileRA, true);
+                SaveOption(vISA_QuickTokenAllocation, true);
+            }
+            else
+            {
+                SaveOption(vISA_CompileBudget, remainingBudget);
+            }
+        }
+
         if (context->getModuleMetaData()->compOpt.DisableIncSpillCostAllAddrTaken)
         {
             SaveOption(vISA_IncSpillCostAllAddrTaken, false);
@@ -4921,6 +5075,16 @@ namespace IGC
             SaveOption(vISA_NewSpillCostFunction, true);
         }
 
+        if (IGC_IS_FLAG_ENABLED(SpillCostTrials))
+        {
+            SaveOption(vISA_SpillCostTrials, true);
+        }
+
+        if (IGC_IS_FLAG_ENABLED(FreqSpillCost))
+        {
+            SaveOption(vISA_FreqSpillCost, true);
+        }
+
         // visaasm in ZeBinary will be used for parsing.
         // We need to set GenerateISAASM flag for the builder, because otherwise
         // VISAKernelImpl::generateVariableName will generate non-unique names.
@@ -4952,6 +5116,52 @@ namespace IGC
         return ss.str();
     }
 
+    void CEncoder::BindInlineAsmOperand(const std::string& name, CVariable* var)
+    {
+        IGC_ASSERT(nullptr != var);
+        IGC_ASSERT(!var->IsImmediate());
+        switch (var->GetVarType())
+        {
+        case EVARTYPE_GENERAL:
+            V(vKernel->BindVISAAsmOperand(name.c_str(), GetVISAVariable(var)));
+            break;
+        case EVARTYPE_PREDICATE:
+            V(vKernel->BindVISAAsmOperand(name.c_str(), var->visaPredVariable));
+            break;
+        case EVARTYPE_ADDRESS:
+            V(vKernel->BindVISAAsmOperand(name.c_str(), var->visaAddrVariable));
+            break;
+        case EVARTYPE_SURFACE:
+            V(vKernel->BindVISAAsmOperand(name.c_str(), var->visaSurfVariable));
+            break;
+        case EVARTYPE_SAMPLER:
+            V(vKernel->BindVISAAsmOperand(name.c_str(), var->visaSamplerVariable));
+            break;
+        default:
+            IGC_ASSERT_MESSAGE(0, "Unknown var type");
+            break;
+        }
+    }
+
+    void CEncoder::ParseInlineAsm(const std::string& asmText)
+    {
+        IGC_ASSERT(m_inlineAsmSnippets);
+        if (m_inlineAsmParseError)
+        {
+            // only the first error is reported
+            return;
+        }
+        if (vbuilder->ParseVISAAsmSnippet(vKernel, asmText) != 0)
+        {
+            std::string output;
+            raw_string_ostream S(output);
+            S << "parsing vISA inline assembly failed:\n" << vbuilder->GetCriticalMsg();
+            S.flush();
+            m_program->GetContext()->EmitError(output.c_str(), nullptr);
+            m_inlineAsmParseError = true;
+        }
+    }
+
     // Creates a module/program-unique label prefix.
     // E.g. the 3rd label of the 5th function would be
     // "__4_002".  Ugly, yes, but you shouldn't see it as this is the
@@ -5051,6 +5261,12 @@ namespace IGC
         m_enableVISAdump = false;
         m_nestLevelForcedNoMaskRegion = 0;
         m_hasInlineAsm = hasInlineAsmCall;
+        // Inline assembly is parsed statement by statement into the kernel
+        // being built, unless the whole kernel goes through vISA text anyway.
+        m_inlineAsmSnippets = m_hasInlineAsm && !hasAdditionalVisaAsmToLink &&
+            IGC_IS_FLAG_DISABLED(ReparseKernelForInlineAsm);
+        m_inlineAsmParseError = false;
+        bool asmTextMode = (m_hasInlineAsm && !m_inlineAsmSnippets) || hasAdditionalVisaAsmToLink;
 
         InitLabelMap(m_program->entry);
 
@@ -5062,7 +5278,7 @@ namespace IGC
 
         llvm::SmallVector<const char*, 10> params;
         llvm::SmallVector<std::unique_ptr< char, std::function<void(char*)>>, 10> params2;
-        if (!m_hasInlineAsm)
+        if (!asmTextMode)
         {
             // Asm text writer mode doesnt need dump params
             InitBuildParams(params2);
@@ -5077,10 +5293,12 @@ namespace IGC
             IGC_IS_FLAG_ENABLED(EnableVISASlowpath) ||
             IGC_IS_FLAG_ENABLED(ShaderDumpEnable) ||
             context->getCompilerOption().EmitZeBinVISASections;
-        auto builderMode = m_hasInlineAsm || hasAdditionalVisaAsmToLink ? vISA_ASM_WRITER : vISA_DEFAULT;
+        auto builderMode = asmTextMode ? vISA_ASM_WRITER : vISA_DEFAULT;
 
-        // Build options. If in Debug mode, always enable VISA IR
-        auto builderOpt = (enableVISADump || m_hasInlineAsm || hasAdditionalVisaAsmToLink) ? VISA_BUILDER_BOTH : VISA_BUILDER_GEN;
+        // Build options. If in Debug mode, always enable VISA IR.
+        // Inline assembly is user-written, so keep the vISA IR for it and let
+        // the vISA verifier check it before the finalizer runs.
+        auto builderOpt = (enableVISADump || asmTextMode || m_hasInlineAsm) ? VISA_BUILDER_BOTH : VISA_BUILDER_GEN;
 #if defined(_DEBUG)
         builderOpt = VISA_BUILDER_BOTH;
 #endif
@@ -5845,8 +6063,16 @@ namespace IGC
             }
         }
 
+        if (m_inlineAsmParseError)
+        {
+            COMPILER_TIME_END(m_program->GetContext(), TIME_CG_vISACompile);
+            return;
+        }
+
+        const auto compileStart = std::chrono::steady_clock::now();
+        bool inlineAsmText = m_hasInlineAsm && !m_inlineAsmSnippets;
         // Compile generated VISA text string for inlineAsm
-        if (m_hasInlineAsm || visaAsmOverride || additionalVISAAsmToLink)
+        if (inlineAsmText || visaAsmOverride || additionalVISAAsmToLink)
         {
             llvm::SmallVector<const char*, 10> params;
             llvm::SmallVector<std::unique_ptr< char, std::function<void(char*)>>, 10> params2;
@@ -5894,7 +6120,7 @@ namespace IGC
             else
             {
                 int result = 0;
-                if (m_hasInlineAsm) {
+                if (inlineAsmText) {
                     std::string parseTextFile = GetDumpFileName("inline.visaasm");
                     result = vAsmTextBuilder->ParseVISAText(vbuilder->GetAsmTextStream().str(), parseTextFile);
                 }
@@ -6080,6 +6306,19 @@ namespace IGC
         m_program->m_loopNestedStallCycle = jitInfo->stats.loopNestedStallCycle;
         m_program->m_loopNestedCycle = jitInfo->stats.loopNestedCycle;
 
+        if (EmitKernelStats(context))
+        {
+            int64_t compileTimeUs = -1;
+            if (EmitKernelStatsTiming())
+            {
+                compileTimeUs = static_cast<int64_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - compileStart).count());
+            }
+            pOutput->m_KernelStats = KernelStatsToJSON(
+                jitInfo, vISAstats, compileTimeUs);
+        }
+
         bool isStackCallProgram = m_program->HasStackCalls() || m_program->IsIntelSymbolTableVoidProgram();
         bool noRetry = jitInfo->avoidRetry;
 
@@ -7663,6 +7902,31 @@ namespace IGC
         }
     }
 
+    bool CEncoder::IsSameVISAVariable(CVariable* a, CVariable* b)
+    {
+        IGC_ASSERT(nullptr != a && nullptr != b);
+        if (a->IsImmediate() || b->IsImmediate() || a->GetVarType() != b->GetVarType())
+        {
+            return false;
+        }
+        switch (a->GetVarType())
+        {
+        case EVARTYPE_GENERAL:
+            return GetVISAVariable(a) == GetVISAVariable(b);
+        case EVARTYPE_PREDICATE:
+            return a->visaPredVariable == b->visaPredVariable;
+        case EVARTYPE_ADDRESS:
+            return a->visaAddrVariable == b->visaAddrVariable;
+        case EVARTYPE_SURFACE:
+            return a->visaSurfVariable == b->visaSurfVariable;
+        case EVARTYPE_SAMPLER:
+            return a->visaSamplerVariable == b->visaSamplerVariable;
+        default:
+            IGC_ASSERT_MESSAGE(0, "Unknown var type");
+            return false;
+        }
+    }
+
     std::string CEncoder::GetDumpFileName(std::string extension)
     {
         std::string filename = IGC::Debug::GetDumpName(m_program, extension.c_str());
@@ -496,6 +496,8 @@ namespace IGC
         void AddVISASymbol(std::string& symName, CVariable* cvar);
 
         std::string GetVariableName(CVariable* var);
+        /// \brief True if a and b are mapped to the same vISA variable.
+        bool IsSameVISAVariable(CVariable* a, CVariable* b);
         std::string GetDumpFileName(std::string extension);
 
         bool IsPayloadSectionAsPrimary()    {return vKernel == vPayloadSection;}
@@ -504,6 +506,15 @@ namespace IGC
 
         std::string GetUniqueInlineAsmLabel();
 
+        /// \brief True if inline assembly is parsed into vKernel one asm
+        /// statement at a time, see ParseInlineAsm.
+        bool HasInlineAsmSnippets() const { return m_inlineAsmSnippets; }
+        /// \brief Makes var visible as name to the next ParseInlineAsm.
+        void BindInlineAsmOperand(const std::string& name, CVariable* var);
+        /// \brief Parses the vISA text of one asm statement and appends it
+        /// to vKernel.
+        void ParseInlineAsm(const std::string& asmText);
+
     private:
         // helper functions
         VISA_VectorOpnd* GetSourceOperand(CVariable* var, const SModifier& mod);
@@ -730,6 +741,8 @@ namespace IGC
 
         bool m_enableVISAdump = false;
         bool m_hasInlineAsm = false;
+        bool m_inlineAsmSnippets = false;
+        bool m_inlineAsmParseError = false;
 
         std::vector<VISA_LabelOpnd*> labelMap;
         std::vector<CName> labelNameMap; // parallel to labelMap
@@ -77,6 +77,7 @@ bool DebugInfoPass::runOnModule(llvm::Module& M)
     }
 
     DwarfDISubprogramCache DISPCache;
+    DwarfDITypeCache DITypeCache;
 
     for (auto& currShader : units)
     {
@@ -211,6 +212,8 @@ bool DebugInfoPass::runOnModule(llvm::Module& M)
         });
 
         m_pDebugEmitter->SetDISPCache(&DISPCache);
+        if (IGC_IS_FLAG_ENABLED(EnableDwarfTypeDIECache))
+            m_pDebugEmitter->SetDITypeCache(&DITypeCache);
         for (auto& m : sortedVISAModules)
         {
             m_pDebugEmitter->registerVISA(m.second.second);
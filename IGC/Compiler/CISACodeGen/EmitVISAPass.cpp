@@ -532,6 +532,11 @@ void EmitPass::CreateKernelShaderMap(CodeGenContext* ctx, MetaDataUtils* pMdUtil
 
 bool EmitPass::runOnFunction(llvm::Function& F)
 {
+    // tag the IGC and vISA compile trace spans of this kernel
+    vISA::CompileTraceTag traceTag([&]() {
+        return F.getName().str() + " SIMD" + std::to_string(numLanes(m_SimdMode));
+    });
+
     m_currFuncHasSubroutine = false;
 
     m_pCtx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
@@ -8164,7 +8169,7 @@ void EmitPass::EmitInlineAsm(llvm::CallInst* inst)
             m_encoder->Push();
             opnds[i] = tempMov;
         }
-        // WA: If the operand is an alias of another variable but gets mapped to the same variable name,
+        // WA: If the operand is an alias of another variable but gets mapped to the same vISA variable,
         // we have to copy the alias into another register. This is because regioning info is determined by
         // the user, and two variables that share the base register but reference different regions are not
         // distinguishable to the inline asm string parser. Thus, a variable pointing to a subregion needs
@@ -8172,7 +8177,7 @@ void EmitPass::EmitInlineAsm(llvm::CallInst* inst)
         // TODO: To avoid the extra move, we need to be able to explicity define an alias variable with offset
         // instead of a region within the base value.
         else if (opVar->GetAlias() && opVar->GetAliasOffset() > 0 &&
-            m_encoder->GetVariableName(opVar) == m_encoder->GetVariableName(opVar->GetAlias()))
+            m_encoder->IsSameVISAVariable(opVar, opVar->GetAlias()))
         {
             CVariable* tempMov = m_currShader->GetNewVariable(
                 opVar->GetNumberElement(), opVar->GetType(), EALIGN_GRF, opVar->IsUniform(), "");
@@ -8200,7 +8205,13 @@ void EmitPass::EmitInlineAsm(llvm::CallInst* inst)
         }
     }
 
-    str << endl << "/// Inlined ASM" << endl;
+    // When inline assembly is parsed on its own, the operands are bound to
+    // the snippet under names of their own rather than printed.
+    bool asmSnippet = m_encoder->HasInlineAsmSnippets();
+    std::vector<bool> opndBound(opnds.size(), false);
+
+    if (!asmSnippet)
+        str << endl << "/// Inlined ASM" << endl;
     // Look for variables to replace with the VISA variable
     size_t startPos = 0;
     while (startPos < asmStr.size())
@@ -8226,12 +8237,35 @@ void EmitPass::EmitInlineAsm(llvm::CallInst* inst)
             IGC_ASSERT_MESSAGE(0, "Invalid operand index");
             return;
         }
-        string varName = opnds[val] ? m_encoder->GetVariableName(opnds[val]) : "null";
+        string varName;
+        if (!opnds[val])
+        {
+            varName = "null";
+        }
+        else if (asmSnippet && !opnds[val]->IsImmediate())
+        {
+            varName = "_inline_asm_op" + std::to_string(val);
+            if (!opndBound[val])
+            {
+                m_encoder->BindInlineAsmOperand(varName, opnds[val]);
+                opndBound[val] = true;
+            }
+        }
+        else
+        {
+            varName = m_encoder->GetVariableName(opnds[val]);
+        }
         asmStr.replace(varPos, (idEnd - idStart + 1), varName);
 
         startPos = varPos + varName.size();
     }
 
+    if (asmSnippet)
+    {
+        m_encoder->ParseInlineAsm(asmStr);
+        return;
+    }
+
     str << asmStr;
     if (asmStr.back() != '\n') str << endl;
     str << "/// End Inlined ASM" << endl << endl;
@@ -148,6 +148,15 @@ namespace IGC
         return m_InternalOptions.IntelScratchSpacePrivateMemoryMinimalSizePerThread;
     }
 
+    uint32_t OpenCLProgramContext::getCompileBudgetMs() const
+    {
+        if (m_InternalOptions.CompileBudgetMs != 0)
+        {
+            return m_InternalOptions.CompileBudgetMs;
+        }
+        return CodeGenContext::getCompileBudgetMs();
+    }
+
     void OpenCLProgramContext::failOnSpills()
     {
         if (!m_InternalOptions.FailOnSpill)
@@ -504,6 +513,11 @@ namespace IGC
             {
                 EmitZeBinVISASections = true;
             }
+            // -cl-intel-emit-zebin-kernel-stats, -ze-intel-emit-zebin-kernel-stats
+            else if (suffix.equals("-emit-zebin-kernel-stats"))
+            {
+                EmitZeBinKernelStats = true;
+            }
             // -cl-intel-no-spill
             else if (suffix.equals("-no-spill"))
             {
@@ -632,6 +646,22 @@ namespace IGC
                 Pos = valueEnd;
                 continue;
             }
+            // *-compile-budget-ms <MS>
+            // MS > 0, compile time limit for the program
+            else if (suffix.equals("-compile-budget-ms"))
+            {
+                size_t valueStart = opts.find_first_not_of(' ', ePos + 1);
+                size_t valueEnd = opts.find_first_of(' ', valueStart);
+                llvm::StringRef valueString = opts.substr(valueStart, valueEnd - valueStart);
+
+                CompileBudgetMs = 0;
+                if (valueString.getAsInteger(10, CompileBudgetMs))
+                {
+                    IGC_ASSERT(0);
+                }
+                Pos = valueEnd;
+                continue;
+            }
             else if (suffix.equals("-enable-divergent-barrier-handling"))
             {
                 EnableDivergentBarrierHandling = true;
@@ -3447,6 +3477,7 @@ namespace IGC
             noRetry ||
             optDisable ||
             ctx->m_retryManager.IsLastTry() ||
+            ctx->isCompileBudgetExceeded() ||
             (!ctx->m_retryManager.kernelSkip.empty() &&
              ctx->m_retryManager.kernelSkip.count(pFunc->getName().str())))
         {
@@ -86,6 +86,7 @@ namespace IGC
             bool UseBindlessLegacyMode = true;
             bool ExcludeIRFromZEBinary = false;
             bool EmitZeBinVISASections = false;
+            bool EmitZeBinKernelStats = false;
             bool NoSpill = false;
             bool DisableNoMaskWA = false;
             bool IgnoreBFRounding = false;   // If true, ignore BFloat rounding when folding bf operations
@@ -136,6 +137,9 @@ namespace IGC
             uint32_t IntelPrivateMemoryMinimalSizePerThread = 0;
             uint32_t IntelScratchSpacePrivateMemoryMinimalSizePerThread = 0;
 
+            // Compile-time budget in ms, 0 means no budget
+            uint32_t CompileBudgetMs = 0;
+
             bool EnableDivergentBarrierHandling = false;
             std::optional<bool> EnableZEBinary;
 
@@ -341,6 +345,7 @@ namespace IGC
         int16_t getVectorCoalescingControl() const override;
         uint32_t getPrivateMemoryMinimalSizePerThread() const override;
         uint32_t getIntelScratchSpacePrivateMemoryMinimalSizePerThread() const override;
+        uint32_t getCompileBudgetMs() const override;
         void failOnSpills();
         bool needsDivergentBarrierHandling() const;
         unsigned GetSlmSizePerSubslice();
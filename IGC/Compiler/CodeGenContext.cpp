@@ -777,6 +777,37 @@ namespace IGC
         return 0;
     }
 
+    uint32_t CodeGenContext::getCompileBudgetMs() const
+    {
+        return IGC_GET_FLAG_VALUE(CompileBudgetMs);
+    }
+
+    bool CodeGenContext::isCompileBudgetExceeded()
+    {
+        if (!m_compileBudgetExceeded && getCompileBudgetMs() != 0)
+        {
+            m_compileBudgetExceeded = getRemainingCompileBudgetMs() == 0;
+        }
+        return m_compileBudgetExceeded;
+    }
+
+    uint32_t CodeGenContext::getRemainingCompileBudgetMs()
+    {
+        const uint32_t budget = getCompileBudgetMs();
+        if (budget == 0 || m_compileBudgetExceeded)
+        {
+            return 0;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - m_compileStartTime).count();
+        if (elapsed >= budget)
+        {
+            m_compileBudgetExceeded = true;
+            return 0;
+        }
+        return budget - static_cast<uint32_t>(elapsed);
+    }
+
     bool CodeGenContext::isPOSH() const
     {
         return this->getModule()->getModuleFlag(
@@ -19,6 +19,7 @@ SPDX-License-Identifier: MIT
 // hack
 #include "common/debug/Debug.hpp"
 #include "common/debug/Dump.hpp"
+#include <chrono>
 #include <set>
 #include <string.h>
 #include <sstream>
@@ -136,6 +137,10 @@ namespace IGC
         unsigned int m_numGRFSpillFill = 0;
         using NamedVISAAsm = std::pair<std::string, std::string>; // Pair of name for the section (1st elem) and VISA asm text (2nd elem).
         std::vector<NamedVISAAsm> m_VISAAsm;
+        // Codegen statistics of this variant as a JSON object, emitted into
+        // the .note.intelgt.metrics.<kernel> zebin section; empty if the
+        // output is not a ZE binary or EmitZeBinKernelStats is not set.
+        std::string m_KernelStats;
 
         // Optional statistics
         std::optional<uint64_t> m_NumGRFSpill;
@@ -945,6 +950,12 @@ namespace IGC
         // us to skip loading the offset at BVH::rootNodeOffset.
         std::optional<size_t> BVHFixedOffset;
     private:
+        // Compile-time budget, measured from the creation of the context so
+        // that retries are accounted for as well.
+        const std::chrono::steady_clock::time_point m_compileStartTime =
+            std::chrono::steady_clock::now();
+        bool m_compileBudgetExceeded = false;
+
         //For storing error message
         std::stringstream oclErrorMessage;
         //For storing warning message
@@ -1043,6 +1054,14 @@ namespace IGC
         virtual uint32_t getPrivateMemoryMinimalSizePerThread() const;
         virtual uint32_t getIntelScratchSpacePrivateMemoryMinimalSizePerThread() const;
         virtual bool enableZEBinary() const;
+        // Compile-time budget in ms, 0 if compile time is not bounded.
+        virtual uint32_t getCompileBudgetMs() const;
+        // isCompileBudgetExceeded - return true once the compile budget has
+        // been used up; stays true for the rest of the compilation.
+        bool isCompileBudgetExceeded();
+        // getRemainingCompileBudgetMs - the part of the budget that is left;
+        // 0 if there is no budget or if it is exceeded.
+        uint32_t getRemainingCompileBudgetMs();
         bool isPOSH() const;
 
         unsigned int GetSIMDInfoOffset(SIMDMode simd, ShaderDispatchMode mode)
@@ -0,0 +1,79 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2022 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+;
+; RUN: igc_dwarf_emit -o %t.off %s | FileCheck %s --check-prefix=CHECK-OFF
+; RUN: igc_dwarf_emit -type-die-cache -o %t.on %s | FileCheck %s --check-prefix=CHECK-ON
+; RUN: cmp %t.off.k1.elf %t.on.k1.elf
+; RUN: cmp %t.off.k2.elf %t.on.k2.elf
+; ------------------------------------------------
+; EnableDwarfTypeDIECache
+; ------------------------------------------------
+
+; The DWARF of both kernels is the same with and without the type DIE cache.
+; @k2 instantiates the cached trees of struct S, its pointer and its members'
+; types, and adds the typedef T to the cache.
+
+; CHECK-OFF: k1: {{[0-9]+}} bytes{{$}}
+; CHECK-OFF: k2: {{[0-9]+}} bytes{{$}}
+
+; CHECK-ON: k1: {{[0-9]+}} bytes, 5 cached types
+; CHECK-ON: k2: {{[0-9]+}} bytes, 6 cached types
+
+%struct.S = type { i32, float, [4 x i8] }
+
+define spir_kernel void @k1(%struct.S addrspace(1)* %p, i32 %n) !dbg !10 {
+entry:
+  call void @llvm.dbg.value(metadata %struct.S addrspace(1)* %p, metadata !20, metadata !DIExpression()), !dbg !30
+  call void @llvm.dbg.value(metadata i32 %n, metadata !21, metadata !DIExpression()), !dbg !30
+  %a = add i32 %n, 1, !dbg !31
+  ret void, !dbg !32
+}
+
+define spir_kernel void @k2(%struct.S addrspace(1)* %q, i32 %m) !dbg !40 {
+entry:
+  call void @llvm.dbg.value(metadata %struct.S addrspace(1)* %q, metadata !41, metadata !DIExpression()), !dbg !42
+  call void @llvm.dbg.value(metadata i32 %m, metadata !45, metadata !DIExpression()), !dbg !42
+  ret void, !dbg !42
+}
+
+declare void @llvm.dbg.value(metadata, metadata, metadata)
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_OpenCL, file: !1, producer: "clang", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug)
+!1 = !DIFile(filename: "type-die-cache.cl", directory: "/")
+!3 = !{i32 2, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!10 = distinct !DISubprogram(name: "k1", scope: !1, file: !1, line: 3, type: !11, scopeLine: 3, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0)
+!11 = !DISubroutineType(types: !12)
+!12 = !{null, !13, !16}
+!13 = !DIDerivedType(tag: DW_TAG_pointer_type, baseType: !14, size: 64)
+!14 = !DICompositeType(tag: DW_TAG_structure_type, name: "S", file: !1, line: 1, size: 96, elements: !15)
+!15 = !{!50, !51, !52}
+!16 = !DIBasicType(name: "int", size: 32, encoding: DW_ATE_signed)
+!17 = !DIBasicType(name: "float", size: 32, encoding: DW_ATE_float)
+!18 = !DIBasicType(name: "char", size: 8, encoding: DW_ATE_signed_char)
+!19 = !DICompositeType(tag: DW_TAG_array_type, baseType: !18, size: 32, elements: !53)
+!20 = !DILocalVariable(name: "p", arg: 1, scope: !10, file: !1, line: 3, type: !13)
+!21 = !DILocalVariable(name: "n", arg: 2, scope: !10, file: !1, line: 3, type: !16)
+!30 = !DILocation(line: 3, scope: !10)
+!31 = !DILocation(line: 4, column: 5, scope: !10)
+!32 = !DILocation(line: 5, scope: !10)
+!40 = distinct !DISubprogram(name: "k2", scope: !1, file: !1, line: 7, type: !43, scopeLine: 7, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0)
+!41 = !DILocalVariable(name: "q", arg: 1, scope: !40, file: !1, line: 7, type: !13)
+!42 = !DILocation(line: 8, scope: !40)
+!43 = !DISubroutineType(types: !44)
+!44 = !{null, !13, !46}
+!45 = !DILocalVariable(name: "m", arg: 2, scope: !40, file: !1, line: 7, type: !46)
+!46 = !DIDerivedType(tag: DW_TAG_typedef, name: "T", file: !1, line: 2, baseType: !16)
+!50 = !DIDerivedType(tag: DW_TAG_member, name: "a", scope: !14, file: !1, line: 1, baseType: !16, size: 32)
+!51 = !DIDerivedType(tag: DW_TAG_member, name: "b", scope: !14, file: !1, line: 1, baseType: !17, size: 32, offset: 32)
+!52 = !DIDerivedType(tag: DW_TAG_member, name: "c", scope: !14, file: !1, line: 1, baseType: !19, size: 32, offset: 64)
+!53 = !{!54}
+!54 = !DISubrange(count: 4)
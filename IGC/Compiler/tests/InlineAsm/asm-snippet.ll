@@ -0,0 +1,54 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2022 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+;
+; RUN: not visa_asm_snippet %s | FileCheck %s
+; ------------------------------------------------
+; vISA inline assembly snippets
+; ------------------------------------------------
+; Each snippet is what EmitInlineAsm hands to CEncoder::ParseInlineAsm for one
+; asm statement, with $0 renamed to _inline_asm_op0.
+
+; An instruction on the bound operand.
+; SNIPPET
+; ASM: add (M1, 8) _inline_asm_op0(0,0)<1> _inline_asm_op0(0,0)<1;1,0> 0x1:d
+; CHECK: snippet 0: ok
+
+; A snippet with a declaration of its own.
+; SNIPPET
+; ASM: .decl V_tmp v_type=G type=d num_elts=8 align=GRF
+; ASM: mov (M1, 8) V_tmp(0,0)<1> _inline_asm_op0(0,0)<1;1,0>
+; ASM: mov (M1, 8) _inline_asm_op0(0,0)<1> V_tmp(0,0)<1;1,0>
+; CHECK-NEXT: snippet 1: ok
+
+; The declarations of a snippet are not visible to the next one.
+; SNIPPET
+; ASM: mov (M1, 8) _inline_asm_op0(0,0)<1> V_tmp(0,0)<1;1,0>
+; CHECK-NEXT: snippet 2: failed
+; CHECK-NEXT: near line {{[0-9]+}}: V_tmp: undefined variable
+
+; Undefined operand.
+; SNIPPET
+; ASM: mov (M1, 8) _inline_asm_op1(0,0)<1> _inline_asm_op0(0,0)<1;1,0>
+; CHECK-NEXT: snippet 3: failed
+; CHECK-NEXT: near line {{[0-9]+}}: _inline_asm_op1: undefined variable
+
+; Syntax error.
+; SNIPPET
+; ASM: mov (M1, 8) _inline_asm_op0(0,0)<1>
+; CHECK-NEXT: snippet 4: failed
+; CHECK-NEXT: near line
+
+; The bound operand is still available after a failed snippet.
+; SNIPPET
+; ASM: mov (M1, 8) _inline_asm_op0(0,0)<1> 0x0:d
+; CHECK-NEXT: snippet 5: ok
+
+define void @test_inline_asm(<8 x i32> %a) {
+  %1 = call <8 x i32> asm "add (M1, 8) $0(0,0)<1> $0(0,0)<1;1,0> 0x1:d", "=rw,0"(<8 x i32> %a)
+  ret void
+}
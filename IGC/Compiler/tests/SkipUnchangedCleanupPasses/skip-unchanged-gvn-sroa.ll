@@ -0,0 +1,42 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2022 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+;
+; RUN: igc_skip_unchanged -passes=sroa,gvn,sroa,gvn -S %s | FileCheck %s
+; ------------------------------------------------
+; SkipUnchangedCleanupPasses
+; ------------------------------------------------
+
+; GVN forwards the stored 0 to the index of the GEP in @changed, and only then
+; can SROA promote the alloca: the second SROA has to run on @changed. The
+; second GVN runs on @changed again because the second SROA changed it.
+; @unchanged is skipped by both second runs.
+
+; CHECK: Global Value Numbering: skipped on 1 of 4 functions
+; CHECK: SROA: skipped on 1 of 4 functions
+
+; CHECK-LABEL: define i32 @changed
+; CHECK-NOT:   alloca
+; CHECK:       ret i32 %x
+
+define i32 @changed(i64* %p, i32 %x) {
+  %a = alloca [4 x i32]
+  store i64 0, i64* %p
+  %idx = load i64, i64* %p
+  %q = getelementptr [4 x i32], [4 x i32]* %a, i64 0, i64 %idx
+  store i32 %x, i32* %q
+  %r = load i32, i32* %q
+  ret i32 %r
+}
+
+; CHECK-LABEL: define i32 @unchanged
+; CHECK:       mul i32 %x, 3
+
+define i32 @unchanged(i32 %x) {
+  %a = mul i32 %x, 3
+  ret i32 %a
+}
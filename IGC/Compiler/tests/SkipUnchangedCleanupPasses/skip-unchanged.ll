@@ -0,0 +1,35 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2022 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+;
+; RUN: igc_skip_unchanged -passes=instcombine,instcombine %s | FileCheck %s --check-prefix=CHECK-SKIP
+; RUN: igc_skip_unchanged -passes=instcombine,realign-loads,instcombine %s | FileCheck %s --check-prefix=CHECK-ALIGN
+; RUN: igc_skip_unchanged -passes=instcombine,tag-loads,instcombine %s | FileCheck %s --check-prefix=CHECK-MD
+; ------------------------------------------------
+; SkipUnchangedCleanupPasses
+; ------------------------------------------------
+
+; Nothing changes between the two runs: both functions are skipped the second
+; time.
+; CHECK-SKIP: Combine redundant instructions: skipped on 2 of 4 functions
+
+; Only the alignment of the load in @test_load changes: @test_load runs again.
+; CHECK-ALIGN: Combine redundant instructions: skipped on 1 of 4 functions
+
+; Only the metadata of the load in @test_load changes: @test_load runs again.
+; CHECK-MD: Combine redundant instructions: skipped on 1 of 4 functions
+
+define i32 @test_load(i32* %p) {
+  %a = load i32, i32* %p, align 4
+  %b = add i32 %a, 0
+  ret i32 %b
+}
+
+define i32 @test_arith(i32 %x) {
+  %a = mul i32 %x, 2
+  ret i32 %a
+}
@@ -27,7 +27,7 @@ config.test_format = lit.formats.ShTest(not llvm_config.use_lit_shell)
 config.suffixes = ['.ll']
 
 # excludes: A list of directories  and files to exclude from the testsuite.
-config.excludes = ['CMakeLists.txt']
+config.excludes = ['CMakeLists.txt', 'tools']
 
 # test_source_root: The root path where tests are located.
 config.test_source_root = os.path.dirname(__file__)
@@ -39,8 +39,10 @@ llvm_config.use_default_substitutions()
 
 config.substitutions.append(('%PATH%', config.environment['PATH']))
 
-tool_dirs = [config.igc_opt_dir, config.llvm_tools_dir]
-tools = [ToolSubst('not'), ToolSubst('igc_opt')]
+tool_dirs = [config.igc_opt_dir, config.igc_dwarf_emit_dir, config.igc_skip_unchanged_dir,
+             config.visa_asm_snippet_dir, config.llvm_tools_dir]
+tools = [ToolSubst('not'), ToolSubst('igc_opt'), ToolSubst('igc_dwarf_emit'),
+         ToolSubst('igc_skip_unchanged'), ToolSubst('visa_asm_snippet')]
 
 llvm_config.add_tool_substitutions(tools, tool_dirs)
 
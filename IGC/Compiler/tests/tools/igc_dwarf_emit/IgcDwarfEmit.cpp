@@ -0,0 +1,212 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// igc_dwarf_emit runs the DWARF emitter of IGC over every function with a
+// DISubprogram in a module, the way DebugInfoPass does for the kernels of a
+// program, and writes the resulting ELF files to <prefix>.<function>.elf.
+// The gen binary is a stand-in: each IR instruction is one vISA instruction
+// of 16 bytes, and variables have no location. The DWARF tree, the line
+// table and the type DIEs are the ones of a real compilation.
+// The size of each ELF file is printed, with the number of types in the
+// cache when -type-die-cache is given.
+//
+// Usage: igc_dwarf_emit [-type-die-cache] -o <prefix> <file.ll>
+
+#include "DebugInfo/DwarfDebug.hpp"
+#include "DebugInfo/EmitterOpts.hpp"
+#include "DebugInfo/VISADebugInfo.hpp"
+#include "DebugInfo/VISAIDebugEmitter.hpp"
+#include "DebugInfo/VISAModule.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/IR/DebugInfoMetadata.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IRReader/IRReader.h>
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+static cl::opt<std::string> InputFilename(cl::Positional, cl::desc("<input .ll file>"), cl::Required);
+static cl::opt<std::string> OutputPrefix("o", cl::desc("Prefix of the ELF files"), cl::Required);
+static cl::opt<bool> TypeDIECache("type-die-cache", cl::desc("Share type DIEs between the functions (EnableDwarfTypeDIECache)"));
+
+namespace {
+const unsigned GenInstSize = 16;
+
+// vISA object of a function: one vISA instruction per IR instruction
+class TestVISAModule : public IGC::VISAModule
+{
+public:
+    TestVISAModule(Function* F)
+        : VISAModule(F, true), m_binary(GenInstSize * (F->getInstructionCount() + 1), 0)
+    {
+        SetType(ObjectType::KERNEL);
+    }
+
+    // Emits F, the way EmitPass does.
+    void emit(IGC::IDebugEmitter& Emitter)
+    {
+        Emitter.BeginEncodingMark();
+        for (Instruction& I : instructions(*getFunction()))
+        {
+            Emitter.BeginInstruction(&I);
+            if (!isa<DbgInfoIntrinsic>(I))
+            {
+                ++m_numVISAInsts;
+            }
+            UpdateVisaId();
+            Emitter.EndInstruction(&I);
+        }
+        Emitter.EndEncodingMark();
+    }
+
+    unsigned getNumVISAInsts() const { return m_numVISAInsts; }
+
+    IGC::VISAVariableLocation GetVariableLocation(const Instruction* pInst) const override
+    {
+        return IGC::VISAVariableLocation(this);
+    }
+    void UpdateVisaId() override { SetVISAId(m_numVISAInsts); }
+    void ValidateVisaId() override {}
+    uint16_t GetSIMDSize() const override { return 8; }
+    unsigned getUnpaddedProgramSize() const override { return m_binary.size(); }
+    bool isLineTableOnly() const override { return false; }
+    unsigned getPrivateBaseReg() const override { return 0; }
+    unsigned getGRFSizeInBytes() const override { return 32; }
+    unsigned getNumGRFs() const override { return 128; }
+    unsigned getPointerSize() const override { return 8; }
+    uint64_t getTypeSizeInBits(Type* Ty) const override
+    {
+        return GetModule()->getDataLayout().getTypeSizeInBits(Ty);
+    }
+    void* getPrivateBase() const override { return nullptr; }
+    void setPrivateBase(void*) override {}
+    bool hasPTO() const override { return false; }
+    int getPTOReg() const override { return 0; }
+    int getFPReg() const override { return 0; }
+    uint64_t getFPOffset() const override { return 0; }
+    bool usesSlot1ScratchSpill() const override { return false; }
+    ArrayRef<char> getGenDebug() const override { return {}; }
+    ArrayRef<char> getGenBinary() const override { return m_binary; }
+    StringRef GetVISAFuncName() const override { return getFunction()->getName(); }
+
+private:
+    std::vector<char> m_binary;
+    unsigned m_numVISAInsts = 0;
+};
+
+template <typename T>
+void write(std::vector<char>& Blob, T Value)
+{
+    const char* Bytes = reinterpret_cast<const char*>(&Value);
+    Blob.insert(Blob.end(), Bytes, Bytes + sizeof(T));
+}
+
+// Debug info of vISA for a single compiled object: vISA instruction i
+// starts at gen offset 16 * i, no variables, no subroutines and no frame.
+std::vector<char> makeVISADebugInfo(StringRef Name, unsigned NumVISAInsts)
+{
+    std::vector<char> Blob;
+    write<uint32_t>(Blob, 0xdeadd010); // magic
+    write<uint16_t>(Blob, 1);          // compiled objects
+    write<uint16_t>(Blob, static_cast<uint16_t>(Name.size()));
+    Blob.insert(Blob.end(), Name.begin(), Name.end());
+    write<uint32_t>(Blob, 0);          // reloc offset
+    write<uint32_t>(Blob, 0);          // vISA offsets
+    write<uint32_t>(Blob, NumVISAInsts + 1);
+    for (unsigned i = 0; i <= NumVISAInsts; ++i)
+    {
+        write<uint32_t>(Blob, i);
+        write<uint32_t>(Blob, i * GenInstSize);
+    }
+    write<uint32_t>(Blob, 0);          // variables
+    write<uint16_t>(Blob, 0);          // subroutines
+    write<uint16_t>(Blob, 0);          // frame size
+    write<uint8_t>(Blob, 0);           // BE_FP
+    write<uint8_t>(Blob, 0);           // caller BE_FP
+    write<uint8_t>(Blob, 0);           // return address
+    write<uint16_t>(Blob, 0);          // callee save entries
+    write<uint16_t>(Blob, 0);          // caller save entries
+    return Blob;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    cl::ParseCommandLineOptions(argc, argv, "IGC DWARF emission test driver\n");
+
+    LLVMContext Context;
+    SMDiagnostic Err;
+    std::unique_ptr<Module> M = parseIRFile(InputFilename, Err, Context);
+    if (!M)
+    {
+        Err.print(argv[0], errs());
+        return 1;
+    }
+
+    IGC::DebugEmitterOpts Opts;
+    Opts.DebugEnabled = true;
+    Opts.EmitDebugLoc = true;
+
+    // One cache for all the kernels of the module, like in DebugInfoPass
+    IGC::DwarfDISubprogramCache DISPCache;
+    IGC::DwarfDITypeCache DITypeCache;
+
+    for (Function& F : *M)
+    {
+        if (F.isDeclaration() || !F.getSubprogram())
+            continue;
+
+        auto VM = std::make_unique<TestVISAModule>(&F);
+        TestVISAModule* V = VM.get();
+        IGC::IDebugEmitter* Emitter = IGC::IDebugEmitter::Create();
+        Emitter->Initialize(std::move(VM), Opts);
+        Emitter->SetDISPCache(&DISPCache);
+        if (TypeDIECache)
+            Emitter->SetDITypeCache(&DITypeCache);
+
+        V->emit(*Emitter);
+        std::vector<char> VISADebug = makeVISADebugInfo(F.getName(), V->getNumVISAInsts());
+        IGC::VISADebugInfo VisaDbgInfo(VISADebug.data());
+        std::vector<char> Elf = Emitter->Finalize(true, VisaDbgInfo);
+        const std::string Errors = Emitter->getErrors();
+        IGC::IDebugEmitter::Release(Emitter);
+        if (!Errors.empty())
+        {
+            errs() << argv[0] << ": " << F.getName() << ": " << Errors << "\n";
+            return 1;
+        }
+
+        std::error_code EC;
+        std::string FileName = OutputPrefix + "." + F.getName().str() + ".elf";
+        raw_fd_ostream OS(FileName, EC, sys::fs::OF_None);
+        if (EC)
+        {
+            errs() << argv[0] << ": " << FileName << ": " << EC.message() << "\n";
+            return 1;
+        }
+        OS.write(Elf.data(), Elf.size());
+
+        outs() << F.getName() << ": " << Elf.size() << " bytes";
+        if (TypeDIECache)
+            outs() << ", " << DITypeCache.size() << " cached types";
+        outs() << "\n";
+    }
+    return 0;
+}
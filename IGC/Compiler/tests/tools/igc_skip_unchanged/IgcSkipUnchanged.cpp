@@ -0,0 +1,132 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// igc_skip_unchanged runs a list of LLVM cleanup passes on a module the way
+// IGCPassManager does under SkipUnchangedCleanupPasses, and prints for each
+// pass how many function runs were skipped, and with -S the module after the
+// last step. Two more steps change a function in a way that only the
+// fingerprint can tell:
+//   realign-loads    sets the alignment of every load to 16
+//   tag-loads        adds !nontemporal to every load
+//
+// Usage: igc_skip_unchanged -passes=instcombine,realign-loads,instcombine <file.ll>
+
+#include "common/CleanupPassCache.h"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Metadata.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IRReader/IRReader.h>
+#include <llvm/InitializePasses.h>
+#include <llvm/PassInfo.h>
+#include <llvm/PassRegistry.h>
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvmWrapper/Support/Alignment.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <memory>
+
+using namespace llvm;
+
+static cl::opt<std::string> InputFilename(cl::Positional, cl::desc("<input .ll file>"), cl::Required);
+static cl::opt<std::string> PassList("passes", cl::desc("Comma-separated list of passes to run"), cl::Required);
+static cl::opt<bool> PrintModule("S", cl::desc("Print the module after the last step"));
+
+static void realignLoads(Module& M)
+{
+    for (Function& F : M)
+        for (Instruction& I : instructions(F))
+            if (auto* LI = dyn_cast<LoadInst>(&I))
+                LI->setAlignment(IGCLLVM::getCorrectAlign(16));
+}
+
+static void tagLoads(Module& M)
+{
+    MDNode* Node = MDNode::get(M.getContext(),
+        ConstantAsMetadata::get(ConstantInt::get(Type::getInt32Ty(M.getContext()), 1)));
+    for (Function& F : M)
+        for (Instruction& I : instructions(F))
+            if (isa<LoadInst>(&I))
+                I.setMetadata(LLVMContext::MD_nontemporal, Node);
+}
+
+int main(int argc, char** argv)
+{
+    cl::ParseCommandLineOptions(argc, argv, "IGC SkipUnchangedCleanupPasses test driver\n");
+
+    PassRegistry& Registry = *PassRegistry::getPassRegistry();
+    initializeCore(Registry);
+    initializeAnalysis(Registry);
+    initializeTransformUtils(Registry);
+    initializeScalarOpts(Registry);
+    initializeInstCombine(Registry);
+
+    LLVMContext Context;
+    SMDiagnostic Err;
+    std::unique_ptr<Module> M = parseIRFile(InputFilename, Err, Context);
+    if (!M)
+    {
+        Err.print(argv[0], errs());
+        return 1;
+    }
+
+    IGC::CleanupPassCache Cache;
+    SmallVector<StringRef, 8> Steps;
+    StringRef(PassList).split(Steps, ',', -1, false);
+    for (StringRef Step : Steps)
+    {
+        if (Step == "realign-loads")
+        {
+            realignLoads(*M);
+            continue;
+        }
+        if (Step == "tag-loads")
+        {
+            tagLoads(*M);
+            continue;
+        }
+        const PassInfo* PI = Registry.getPassInfo(Step);
+        if (!PI || !PI->getNormalCtor())
+        {
+            errs() << argv[0] << ": unknown pass " << Step << "\n";
+            return 1;
+        }
+        Pass* P = PI->getNormalCtor()();
+        if (!IGC::isCleanupPass(P))
+        {
+            errs() << argv[0] << ": " << Step << " is not a cleanup pass\n";
+            delete P;
+            return 1;
+        }
+        legacy::PassManager PM;
+        PM.add(IGC::createSkipUnchangedBeginPass(P, Cache));
+        PM.add(P);
+        PM.add(IGC::createSkipUnchangedEndPass(P, Cache));
+        PM.run(*M);
+    }
+
+    for (auto& S : Cache.stats)
+    {
+        outs() << S.first << ": skipped on " << S.second.second << " of "
+               << S.second.first + S.second.second << " functions\n";
+    }
+    if (PrintModule)
+    {
+        M->print(outs(), nullptr);
+    }
+    return 0;
+}
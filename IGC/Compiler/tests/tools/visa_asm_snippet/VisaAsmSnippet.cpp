@@ -0,0 +1,141 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// visa_asm_snippet parses vISA inline assembly snippets the way
+// CEncoder::ParseInlineAsm does, so that the LIT tests can check what the
+// parser accepts and rejects without running the whole of EmitPass.
+//
+// The snippets are read from the comments of the input file:
+//   ; SNIPPET            starts a new snippet
+//   ; ASM: <text>        appends a line of vISA text to the current snippet
+//
+// Every snippet is parsed into the same kernel, with a 8 x d variable bound
+// as _inline_asm_op0 like an asm statement operand. The tool prints
+// "snippet <N>: ok" or "snippet <N>: failed" followed by the parser message
+// and exits with 1 if any snippet failed.
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "visaBuilder_interface.h"
+
+static const struct {
+    const char* name;
+    TARGET_PLATFORM platform;
+} platforms[] = {
+    {"TGLLP", GENX_TGLLP},
+    {"XeHP_SDV", Xe_XeHPSDV},
+    {"DG2", Xe_DG2},
+    {"MTL", Xe_MTL},
+    {"PVC", Xe_PVC},
+};
+
+static std::vector<std::string> readSnippets(std::istream& in)
+{
+    static const char snippetTag[] = "; SNIPPET";
+    static const char asmTag[] = "; ASM:";
+    std::vector<std::string> snippets;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.compare(0, sizeof(snippetTag) - 1, snippetTag) == 0)
+        {
+            snippets.emplace_back();
+        }
+        else if (line.compare(0, sizeof(asmTag) - 1, asmTag) == 0 && !snippets.empty())
+        {
+            snippets.back() += line.substr(sizeof(asmTag) - 1);
+            snippets.back() += "\n";
+        }
+    }
+    return snippets;
+}
+
+int main(int argc, const char** argv)
+{
+    TARGET_PLATFORM platform = Xe_DG2;
+    const char* inputFile = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-platform") == 0 && i + 1 < argc)
+        {
+            const char* name = argv[++i];
+            platform = GENX_NONE;
+            for (const auto& p : platforms)
+            {
+                if (strcmp(p.name, name) == 0)
+                    platform = p.platform;
+            }
+            if (platform == GENX_NONE)
+            {
+                std::cerr << "unknown platform " << name << "\n";
+                return 2;
+            }
+        }
+        else
+        {
+            inputFile = argv[i];
+        }
+    }
+    if (!inputFile)
+    {
+        std::cerr << "usage: visa_asm_snippet [-platform <name>] <file>\n";
+        return 2;
+    }
+
+    std::ifstream in(inputFile);
+    if (!in)
+    {
+        std::cerr << "cannot open " << inputFile << "\n";
+        return 2;
+    }
+    std::vector<std::string> snippets = readSnippets(in);
+
+    // Same builder as CEncoder::InitEncoder uses for kernels with inline asm.
+    VISABuilder* builder = nullptr;
+    VISAKernel* kernel = nullptr;
+    if (vISA::CreateVISABuilder(builder, vISA_DEFAULT, VISA_BUILDER_BOTH, platform,
+            0, nullptr, nullptr) != 0 ||
+        builder->AddKernel(kernel, "visa_asm_snippet") != 0)
+    {
+        std::cerr << "cannot create the vISA kernel\n";
+        return 2;
+    }
+    VISA_GenVar* operand = nullptr;
+    if (kernel->CreateVISAGenVar(operand, "V_op0", 8, ISA_TYPE_D, ALIGN_GRF) != 0)
+    {
+        std::cerr << "cannot create the operand variable\n";
+        return 2;
+    }
+
+    int result = 0;
+    size_t msgEnd = 0;
+    for (size_t i = 0; i < snippets.size(); ++i)
+    {
+        kernel->BindVISAAsmOperand("_inline_asm_op0", operand);
+        if (builder->ParseVISAAsmSnippet(kernel, snippets[i]) == 0)
+        {
+            std::cout << "snippet " << i << ": ok\n";
+            continue;
+        }
+        // The builder keeps the messages of all the snippets.
+        std::string msg = builder->GetCriticalMsg();
+        std::cout << "snippet " << i << ": failed\n" << msg.substr(std::min(msgEnd, msg.size()));
+        msgEnd = msg.size();
+        result = 1;
+    }
+
+    vISA::DestroyVISABuilder(builder);
+    return result;
+}
@@ -234,6 +234,7 @@ static bool isShareableAcrossCUs(const llvm::MDNode *D) {
 /// when the DIE for this MDNode can be shared across CUs. The mappings
 /// will be kept in DwarfDebug for shareable DIEs.
 void CompileUnit::insertDIE(llvm::MDNode *Desc, DIE *D) {
+  DieToMDNodeMap.insert(std::make_pair(D, Desc));
   if (isShareableAcrossCUs(Desc)) {
     DD->insertDIE(Desc, D);
     return;
@@ -749,6 +750,11 @@ IGC::DIE *CompileUnit::getOrCreateTypeDIE(const MDNode *TyNode) {
   if (nullptr != TyDIE)
     return TyDIE;
 
+  // Reuse the tree constructed for this type by another kernel, if any.
+  TyDIE = createCachedTypeDIE(Ty, *ContextDIE);
+  if (nullptr != TyDIE)
+    return TyDIE;
+
   // Create new type.
   TyDIE = createAndAddDIE(Ty->getTag(), *ContextDIE, Ty);
 
@@ -763,9 +769,177 @@ IGC::DIE *CompileUnit::getOrCreateTypeDIE(const MDNode *TyNode) {
     constructTypeDIE(*TyDIE, cast<DIDerivedType>(Ty));
   }
 
+  cacheTypeDIE(Ty, *TyDIE);
   return TyDIE;
 }
 
+/// cacheTypeDIE - Store a copy of the DIE tree constructed for the given
+/// type in the type cache shared by the kernels of the module.
+void CompileUnit::cacheTypeDIE(const DIType *Ty, const DIE &TyDIE) {
+  DwarfDITypeCache *Cache = DD->getDITypeCache();
+  if (!Cache || Cache->isUncacheable(Ty) || Cache->find(Ty))
+    return;
+
+  using CachedValue = DwarfDITypeCache::CachedValue;
+
+  // Number the DIEs of the tree first, so that references between them can
+  // be stored as indices.
+  SmallVector<std::pair<const DIE *, int>, 16> DIEs;
+  llvm::DenseMap<const DIE *, unsigned> LocalIndex;
+  DIEs.push_back(std::make_pair(&TyDIE, -1));
+  for (unsigned i = 0; i != DIEs.size(); ++i) {
+    const DIE *Die = DIEs[i].first;
+    LocalIndex[Die] = i;
+    for (const DIE *Child : Die->getChildren())
+      DIEs.push_back(std::make_pair(Child, (int)i));
+  }
+
+  auto cacheValue = [&](const DIEValue *Value, const DIEAbbrevData &Data,
+                        CachedValue &Cached) {
+    Cached.Attribute = Data.getAttribute();
+    Cached.Form = Data.getForm();
+    switch (Value->getType()) {
+    case DIEValue::isInteger:
+      Cached.Integer = cast<DIEInteger>(Value)->getValue();
+      if (Cached.Attribute == dwarf::DW_AT_decl_file) {
+        // File ids are numbered per DwarfDebug instance.
+        StringRef DirName, FileName;
+        if (!DD->getSourceFile(getUniqueID(), (unsigned)Cached.Integer,
+                               DirName, FileName))
+          return false;
+        Cached.ValueKind = CachedValue::Kind::SourceFile;
+        Cached.Str = DirName.str();
+        Cached.FileName = FileName.str();
+      } else {
+        Cached.ValueKind = CachedValue::Kind::Integer;
+      }
+      return true;
+    case DIEValue::isInlinedString:
+      Cached.ValueKind = CachedValue::Kind::String;
+      Cached.Str = cast<DIEInlinedString>(Value)->getString().str();
+      return true;
+    case DIEValue::isEntry: {
+      const DIE *Entry = cast<DIEEntry>(Value)->getEntry();
+      auto It = LocalIndex.find(Entry);
+      if (It != LocalIndex.end()) {
+        Cached.ValueKind = CachedValue::Kind::LocalRef;
+        Cached.Integer = It->second;
+        return true;
+      }
+      Cached.Ref = dyn_cast_or_null<DIType>(DieToMDNodeMap.lookup(Entry));
+      Cached.ValueKind = CachedValue::Kind::TypeRef;
+      return Cached.Ref != nullptr;
+    }
+    case DIEValue::isBlock: {
+      const DIEBlock *Block = cast<DIEBlock>(Value);
+      const auto &BlockData = Block->getAbbrev().getData();
+      for (unsigned i = 0, e = Block->getValues().size(); i != e; ++i) {
+        const auto *Int = dyn_cast<DIEInteger>(Block->getValues()[i]);
+        if (!Int)
+          return false;
+        Cached.Block.push_back(
+            std::make_pair(BlockData[i].getForm(), Int->getValue()));
+      }
+      Cached.ValueKind = CachedValue::Kind::Block;
+      return true;
+    }
+    default:
+      // Labels, deltas and expressions belong to this emission only.
+      return false;
+    }
+  };
+
+  DwarfDITypeCache::CachedTree Tree;
+  Tree.reserve(DIEs.size());
+  for (const auto &Item : DIEs) {
+    const DIE *Die = Item.first;
+    const MDNode *Node = DieToMDNodeMap.lookup(Die);
+    if (Node && !isa<DIType>(Node)) {
+      Cache->markUncacheable(Ty);
+      return;
+    }
+
+    DwarfDITypeCache::CachedDIE Cached;
+    Cached.Tag = Die->getTag();
+    Cached.Node = cast_or_null<DIType>(Node);
+    Cached.Parent = Item.second;
+    const auto &Data = Die->getAbbrev().getData();
+    Cached.Values.resize(Die->getValues().size());
+    for (unsigned i = 0, e = Die->getValues().size(); i != e; ++i) {
+      if (!cacheValue(Die->getValues()[i], Data[i], Cached.Values[i])) {
+        Cache->markUncacheable(Ty);
+        return;
+      }
+    }
+    Tree.push_back(std::move(Cached));
+  }
+
+  Cache->insert(Ty, std::move(Tree));
+}
+
+/// createCachedTypeDIE - Instantiate the cached DIE tree of the given type
+/// under ContextDIE. Return null if the type is not cached or cannot be
+/// instantiated in this compile unit.
+IGC::DIE *CompileUnit::createCachedTypeDIE(const DIType *Ty, DIE &ContextDIE) {
+  DwarfDITypeCache *Cache = DD->getDITypeCache();
+  const DwarfDITypeCache::CachedTree *Tree = Cache ? Cache->find(Ty) : nullptr;
+  if (!Tree)
+    return nullptr;
+
+  // A node of the tree may already have its DIE in this unit, construct the
+  // type from scratch rather than duplicating the DIE.
+  for (const auto &Cached : *Tree) {
+    if (Cached.Node && getDIE(const_cast<DIType *>(Cached.Node)))
+      return nullptr;
+  }
+
+  // Create all the DIEs (and their mappings) before adding any value. A value
+  // may reference any DIE of the tree and resolving a reference to another
+  // type can get back to this one.
+  SmallVector<DIE *, 16> DIEs;
+  DIEs.reserve(Tree->size());
+  for (const auto &Cached : *Tree) {
+    DIE &Parent = Cached.Parent < 0 ? ContextDIE : *DIEs[Cached.Parent];
+    DIEs.push_back(createAndAddDIE(Cached.Tag, Parent,
+                                   const_cast<DIType *>(Cached.Node)));
+  }
+
+  using Kind = DwarfDITypeCache::CachedValue::Kind;
+  for (unsigned i = 0, e = Tree->size(); i != e; ++i) {
+    DIE *Die = DIEs[i];
+    for (const auto &Value : (*Tree)[i].Values) {
+      switch (Value.ValueKind) {
+      case Kind::Integer:
+        addUInt(Die, Value.Attribute, Value.Form, Value.Integer);
+        break;
+      case Kind::String:
+        addString(Die, Value.Attribute, Value.Str);
+        break;
+      case Kind::SourceFile:
+        addUInt(Die, Value.Attribute, None,
+                DD->getOrCreateSourceID(Value.FileName, Value.Str,
+                                        getUniqueID()));
+        break;
+      case Kind::TypeRef:
+        addDIEEntry(Die, Value.Attribute, getOrCreateTypeDIE(Value.Ref));
+        break;
+      case Kind::LocalRef:
+        addDIEEntry(Die, Value.Attribute, DIEs[Value.Integer]);
+        break;
+      case Kind::Block: {
+        IGC::DIEBlock *Block = new (DIEValueAllocator) IGC::DIEBlock();
+        for (const auto &Item : Value.Block)
+          addUInt(Block, Item.first, Item.second);
+        addBlock(Die, Value.Attribute, Block);
+        break;
+      }
+      }
+    }
+  }
+
+  return DIEs.front();
+}
+
 /// addType - Add a new type attribute to the specified entity.
 void CompileUnit::addType(DIE *Entity, DIType *Ty, dwarf::Attribute Attribute) {
   IGC_ASSERT_MESSAGE(nullptr != Ty, "Trying to add a type that doesn't exist?");
@@ -77,6 +77,10 @@ class CompileUnit {
   /// variables to debug information entries.
   llvm::DenseMap<const llvm::MDNode *, DIE *> MDNodeToDieMap;
 
+  /// DieToMDNodeMap - Reverse of MDNodeToDieMap including the DIEs of the
+  /// type system kept in DwarfDebug.
+  llvm::DenseMap<const DIE *, const llvm::MDNode *> DieToMDNodeMap;
+
   /// MDNodeToDIEEntryMap - Tracks the mapping of unit level debug information
   /// descriptors to debug information entries using a DIEEntry proxy.
   llvm::DenseMap<const llvm::MDNode *, DIEEntry *> MDNodeToDIEEntryMap;
@@ -367,6 +371,15 @@ public:
   /// given llvm::DIType.
   DIE *getOrCreateTypeDIE(const llvm::MDNode *N);
 
+  /// cacheTypeDIE - Store a copy of the DIE tree constructed for the given
+  /// type in the type cache shared by the kernels of the module.
+  void cacheTypeDIE(const llvm::DIType *Ty, const DIE &TyDIE);
+
+  /// createCachedTypeDIE - Instantiate the cached DIE tree of the given type
+  /// under ContextDIE. Return null if the type is not cached or cannot be
+  /// instantiated in this compile unit.
+  DIE *createCachedTypeDIE(const llvm::DIType *Ty, DIE &ContextDIE);
+
   /// getOrCreateContextDIE - Get context owner's DIE.
   DIE *getOrCreateContextDIE(llvm::DIScope *Context);
 
@@ -405,7 +405,7 @@ DwarfDISubprogramCache::findNodes(const std::vector<Function *> &Functions) {
 }
 DwarfDebug::DwarfDebug(StreamEmitter *A, VISAModule *M)
     : Asm(A), EmitSettings(Asm->GetEmitterSettings()), m_pModule(M),
-      DISPCache(nullptr), FirstCU(0),
+      DISPCache(nullptr), DITypeCache(nullptr), FirstCU(0),
       // AbbreviationsSet(InitAbbreviationsSetSize),
       SourceIdMap(DIEValueAllocator), PrevLabel(nullptr), GlobalCUIndexCount(0),
       StringPool(DIEValueAllocator), NextStringPoolNumber(0),
@@ -930,12 +930,25 @@ unsigned DwarfDebug::getOrCreateSourceID(StringRef FileName, StringRef DirName,
   }
 
   FileIDCUMap[CUID] = SrcId;
+  SourceIdToNamePair[std::make_pair(CUID, SrcId)] = item.first->getKey();
   // Print out a .file directive to specify files for .loc directives.
   Asm->EmitDwarfFileDirective(SrcId, DirName, FileName, CUID);
 
   return SrcId;
 }
 
+bool DwarfDebug::getSourceFile(unsigned CUID, unsigned SrcId,
+                               StringRef &DirName, StringRef &FileName) const {
+  auto It = SourceIdToNamePair.find(std::make_pair(CUID, SrcId));
+  if (It == SourceIdToNamePair.end())
+    return false;
+
+  // The key is CUID, directory and file name separated by zero bytes.
+  StringRef DirAndFile = It->second.split('\0').second;
+  std::tie(DirName, FileName) = DirAndFile.split('\0');
+  return true;
+}
+
 // Create new CompileUnit for the given metadata node with tag
 // DW_TAG_compile_unit.
 CompileUnit *DwarfDebug::constructCompileUnit(DICompileUnit *DIUnit) {
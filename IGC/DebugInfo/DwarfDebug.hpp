@@ -43,6 +43,8 @@ See LICENSE.TXT for details.
 
 #include "Probe/Assertion.h"
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace llvm {
 class MCSection;
@@ -264,6 +266,66 @@ public:
   DISubprogramNodes findNodes(const std::vector<llvm::Function *> &Functions);
 };
 
+// DwarfDITypeCache intended to share type DIEs between the kernels (and
+// SIMD variants of a kernel) of a module.
+// Each kernel gets its own DwarfDebug instance which constructs the type
+// DIEs walking the same DIType nodes again, while the constructed trees
+// depend on nothing but the metadata. The cache keeps a copy of the DIE
+// tree constructed for a DIType by the first compile unit. Later compile
+// units instantiate the copy instead of constructing the type again, only
+// the location and range data of a kernel is generated per instance.
+// The copy does not depend on the DwarfDebug instance which created it:
+// references to DIEs of other types are kept as DIType nodes, references
+// inside the tree as DIE indices and DW_AT_decl_file values as file names.
+// Trees with values bound to a particular emission (labels, deltas,
+// expressions) or with DIEs of non-type nodes are not cached.
+class DwarfDITypeCache {
+public:
+  struct CachedValue {
+    enum class Kind { Integer, String, SourceFile, TypeRef, LocalRef, Block };
+    Kind ValueKind = Kind::Integer;
+    llvm::dwarf::Attribute Attribute = (llvm::dwarf::Attribute)0;
+    llvm::dwarf::Form Form = (llvm::dwarf::Form)0;
+    // Integer value or index of the referenced DIE inside the tree.
+    uint64_t Integer = 0;
+    const llvm::DIType *Ref = nullptr;
+    // String value or directory of the source file.
+    std::string Str;
+    std::string FileName;
+    // Forms and values of a block.
+    std::vector<std::pair<llvm::dwarf::Form, uint64_t>> Block;
+  };
+
+  struct CachedDIE {
+    unsigned Tag = 0;
+    // Type node mapped to the DIE, if any.
+    const llvm::DIType *Node = nullptr;
+    // Index of the parent DIE inside the tree, -1 for the root.
+    int Parent = -1;
+    std::vector<CachedValue> Values;
+  };
+
+  // DIEs of a type, parents always precede their children.
+  using CachedTree = std::vector<CachedDIE>;
+
+  const CachedTree *find(const llvm::DIType *Ty) const {
+    auto It = Trees.find(Ty);
+    return It == Trees.end() ? nullptr : &It->second;
+  }
+  void insert(const llvm::DIType *Ty, CachedTree &&Tree) {
+    Trees.emplace(Ty, std::move(Tree));
+  }
+  bool isUncacheable(const llvm::DIType *Ty) const {
+    return Uncacheable.count(Ty) != 0;
+  }
+  void markUncacheable(const llvm::DIType *Ty) { Uncacheable.insert(Ty); }
+  size_t size() const { return Trees.size(); }
+
+private:
+  std::unordered_map<const llvm::DIType *, CachedTree> Trees;
+  std::unordered_set<const llvm::DIType *> Uncacheable;
+};
+
 /// \brief Collects and handles llvm::dwarf debug information.
 class DwarfDebug {
   // Target of Dwarf emission.
@@ -274,6 +336,8 @@ class DwarfDebug {
 
   DwarfDISubprogramCache *DISPCache;
 
+  DwarfDITypeCache *DITypeCache;
+
   // All DIEValues are allocated through this allocator.
   llvm::BumpPtrAllocator DIEValueAllocator;
 
@@ -305,6 +369,9 @@ class DwarfDebug {
   // Source id map, i.e. CUID, source filename and directory,
   // separated by a zero byte, mapped to a unique id.
   llvm::StringMap<unsigned, llvm::BumpPtrAllocator &> SourceIdMap;
+  // Maps CUID and source id back to the key of SourceIdMap.
+  llvm::DenseMap<std::pair<unsigned, unsigned>, llvm::StringRef>
+      SourceIdToNamePair;
 
   // List of all labels used in aranges generation.
   std::vector<SymbolCU> ArangeLabels;
@@ -577,6 +644,8 @@ public:
     return EmitSettings;
   }
   void setDISPCache(DwarfDISubprogramCache *Cache) { DISPCache = Cache; }
+  void setDITypeCache(DwarfDITypeCache *Cache) { DITypeCache = Cache; }
+  DwarfDITypeCache *getDITypeCache() const { return DITypeCache; }
 
   void insertDIE(const llvm::MDNode *TypeMD, DIE *Die) {
     MDTypeNodeToDieMap.insert(std::make_pair(TypeMD, Die));
@@ -617,6 +686,11 @@ public:
   unsigned getOrCreateSourceID(llvm::StringRef DirName,
                                llvm::StringRef FullName, unsigned CUID);
 
+  /// \brief Look up the directory and source file names of the given source
+  /// id. Return false if the id was not created for the given compile unit.
+  bool getSourceFile(unsigned CUID, unsigned SrcId, llvm::StringRef &DirName,
+                     llvm::StringRef &FileName) const;
+
   /// Returns the Dwarf Version.
   unsigned getDwarfVersion() const { return DwarfVersion; }
 
@@ -87,6 +87,62 @@ void IGC::DbgDecoder::VarInfo::print(llvm::raw_ostream &OS) const {
 
 void IGC::DbgDecoder::VarInfo::dump() const { print(llvm::dbgs()); }
 
+const IGC::DbgDecoder::VarInfo &
+IGC::DbgDecoder::VarInfoTable::get(size_t Idx) const {
+  IGC_ASSERT(Idx < Records.size());
+  if (Decoded.empty())
+    Decoded.resize(Records.size());
+
+  auto &Var = Decoded[Idx];
+  if (!Var) {
+    const Record &R = Records[Idx];
+    Var = std::make_unique<VarInfo>();
+    Var->name = R.Name.str();
+    Var->lrs.reserve(R.NumLRs);
+    const void *dbg = R.LRs;
+    for (unsigned i = 0; i != R.NumLRs; ++i)
+      Var->lrs.push_back(readLiveIntervalsVISA(dbg));
+  }
+  return *Var;
+}
+
+const IGC::DbgDecoder::VarInfo *
+IGC::DbgDecoder::VarInfoTable::findVReg(unsigned RegNum) const {
+  auto It = std::lower_bound(
+      VRegIndex.begin(), VRegIndex.end(), RegNum,
+      [](const auto &Entry, unsigned Num) { return Entry.first < Num; });
+  if (It == VRegIndex.end() || It->first != RegNum)
+    return nullptr;
+  return &get(It->second);
+}
+
+void IGC::DbgDecoder::VarInfoTable::buildVRegIndex() {
+  for (unsigned i = 0, e = Records.size(); i != e; ++i) {
+    llvm::StringRef Name = Records[i].Name;
+    // TODO: what to do with variables starting with "T"?
+    if (!Name.startswith("V"))
+      continue;
+    unsigned RegNum = 0;
+    if (!Name.drop_front().getAsInteger(10, RegNum))
+      VRegIndex.push_back(std::make_pair(RegNum, i));
+  }
+  // Keep the first record of a register if there are duplicates.
+  std::stable_sort(
+      VRegIndex.begin(), VRegIndex.end(),
+      [](const auto &L, const auto &R) { return L.first < R.first; });
+}
+
+void IGC::DbgDecoder::VarInfoTable::print(llvm::raw_ostream &OS,
+                                          const char *Separator) const {
+  for (size_t i = 0, e = size(); i != e; ++i) {
+    if (i != 0)
+      OS << Separator;
+    OS << "(";
+    get(i).print(OS);
+    OS << ")";
+  }
+}
+
 void IGC::DbgDecoder::LiveIntervalGenISA::print(llvm::raw_ostream &OS) const {
   OS << "LInt-G[" << start << ";" << end << "] ";
   var.print(OS);
@@ -171,7 +227,7 @@ void IGC::DbgDecoder::DbgInfoFormat::print(llvm::raw_ostream &OS) const {
   OS << "  }\n";
 
   OS << "  Vars: {\n    ";
-  PrintItems(OS, Vars, "\n    ");
+  Vars.print(OS, "\n    ");
   OS << "\n  }\n";
   OS << "  CisaIndex: {\n";
   std::for_each(CISAIndexMap.begin(), CISAIndexMap.end(), [&OS](const auto &V) {
@@ -10,6 +10,7 @@ SPDX-License-Identifier: MIT
 
 // clang-format off
 #include "common/LLVMWarningsPush.hpp"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/raw_ostream.h"
@@ -20,7 +21,10 @@ SPDX-License-Identifier: MIT
 
 #include <algorithm>
 #include <cstdint>
+#include <memory>
+#include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace IGC {
@@ -144,6 +148,45 @@ public:
     void print(llvm::raw_ostream &OS) const;
     void dump() const;
   };
+  // Variables of a compiled object. The decoder only indexes the variable
+  // records of the debug info blob, a record is decoded into VarInfo the
+  // first time it is queried. Names and not yet decoded records refer to
+  // the blob, so the blob must outlive the decoder.
+  class VarInfoTable {
+  public:
+    size_t size() const { return Records.size(); }
+    bool empty() const { return Records.empty(); }
+
+    // Name of the Idx-th variable, does not decode the record.
+    llvm::StringRef getName(size_t Idx) const { return Records[Idx].Name; }
+
+    // Decode (once) and return the Idx-th variable.
+    const VarInfo &get(size_t Idx) const;
+
+    // Find the variable of vISA virtual register "V<RegNum>", return
+    // nullptr if there is no such variable.
+    const VarInfo *findVReg(unsigned RegNum) const;
+
+    void print(llvm::raw_ostream &OS, const char *Separator) const;
+
+  private:
+    friend class DbgDecoder;
+
+    struct Record {
+      llvm::StringRef Name;
+      // Live intervals of the variable, still encoded.
+      const void *LRs = nullptr;
+      uint16_t NumLRs = 0;
+    };
+
+    void buildVRegIndex();
+
+    std::vector<Record> Records;
+    // Register numbers of "V<n>" variables and their record indices, sorted
+    // by register number.
+    std::vector<std::pair<unsigned, unsigned>> VRegIndex;
+    mutable std::vector<std::unique_ptr<VarInfo>> Decoded;
+  };
   class SubroutineInfo {
   public:
     std::string name;
@@ -211,7 +254,7 @@ public:
     uint32_t relocOffset = 0;
     std::vector<std::pair<unsigned int, unsigned int>> CISAOffsetMap;
     std::vector<std::pair<unsigned int, unsigned int>> CISAIndexMap;
-    std::vector<VarInfo> Vars;
+    VarInfoTable Vars;
 
     std::vector<SubroutineInfo> subs;
     CallFrameInfo cfi;
@@ -223,30 +266,38 @@ public:
   std::vector<DbgInfoFormat> compiledObjs;
 
 private:
-  void readMappingReg(DbgDecoder::Mapping &mapping) {
+  static void readMappingReg(const void *&dbg, DbgDecoder::Mapping &mapping) {
     mapping.r.regNum = read<uint16_t>(dbg);
     mapping.r.subRegNum = read<uint16_t>(dbg);
   }
 
-  void readMappingMem(DbgDecoder::Mapping &mapping) {
+  static void readMappingMem(const void *&dbg, DbgDecoder::Mapping &mapping) {
     uint32_t temp = read<uint32_t>(dbg);
     mapping.m.memoryOffset = (temp & 0x7fffffff);
     mapping.m.isBaseOffBEFP = (temp & 0x80000000);
   }
 
-  LiveIntervalsVISA readLiveIntervalsVISA() {
+  static LiveIntervalsVISA readLiveIntervalsVISA(const void *&dbg) {
     DbgDecoder::LiveIntervalsVISA lv;
     lv.start = read<uint16_t>(dbg);
     lv.end = read<uint16_t>(dbg);
-    lv.var = readVarAlloc();
+    lv.var = readVarAlloc(dbg);
     return lv;
   }
 
+  static void skipLiveIntervalsVISA(const void *&dbg) {
+    // start, end, virtual type
+    dbg = (const char *)dbg + 2 * sizeof(uint16_t) + sizeof(uint8_t);
+    auto physicalType = read<uint8_t>(dbg);
+    if (physicalType <= VarAlloc::PhyTypeMemory)
+      dbg = (const char *)dbg + sizeof(uint32_t);
+  }
+
   LiveIntervalGenISA readLiveIntervalGenISA() {
     DbgDecoder::LiveIntervalGenISA lr;
     lr.start = read<uint32_t>(dbg);
     lr.end = read<uint32_t>(dbg);
-    lr.var = readVarAlloc();
+    lr.var = readVarAlloc(dbg);
     return lr;
   }
 
@@ -256,14 +307,14 @@ private:
     info.numBytes = read<uint16_t>(dbg);
     info.dstInReg = (bool)read<uint8_t>(dbg);
     if (info.dstInReg) {
-      readMappingReg(info.dst);
+      readMappingReg(dbg, info.dst);
     } else {
-      readMappingMem(info.dst);
+      readMappingMem(dbg, info.dst);
     }
     return info;
   }
 
-  VarAlloc readVarAlloc() {
+  static VarAlloc readVarAlloc(const void *&dbg) {
     DbgDecoder::VarAlloc data;
 
     data.virtualType = (DbgDecoder::VarAlloc::VirtualVarType)read<uint8_t>(dbg);
@@ -274,9 +325,9 @@ private:
     if (data.physicalType == (unsigned)PhyType::Address ||
         data.physicalType == (unsigned)PhyType::Flag ||
         data.physicalType == (unsigned)PhyType::GRF) {
-      readMappingReg(data.mapping);
+      readMappingReg(dbg, data.mapping);
     } else if (data.physicalType == (unsigned)PhyType::Mem) {
-      readMappingMem(data.mapping);
+      readMappingMem(dbg, data.mapping);
     }
     return data;
   }
@@ -314,23 +365,24 @@ private:
             std::make_pair(cisaIndex, f.relocOffset + genOffset));
       }
 
-      // var info
+      // var info, only indexed here (see VarInfoTable)
       count = read<uint32_t>(dbg);
+      f.Vars.Records.reserve(count);
       for (unsigned int j = 0; j != count; j++) {
-        VarInfo v;
+        VarInfoTable::Record r;
 
         nameLen = read<uint16_t>(dbg);
-        for (unsigned int k = 0; k != nameLen; k++)
-          v.name += read<char>(dbg);
+        r.Name = llvm::StringRef((const char *)dbg, nameLen);
+        dbg = (const char *)dbg + nameLen;
 
-        auto countLRs = read<uint16_t>(dbg);
-        for (unsigned int k = 0; k != countLRs; k++) {
-          LiveIntervalsVISA lv = readLiveIntervalsVISA();
-          v.lrs.push_back(lv);
-        }
+        r.NumLRs = read<uint16_t>(dbg);
+        r.LRs = dbg;
+        for (unsigned int k = 0; k != r.NumLRs; k++)
+          skipLiveIntervalsVISA(dbg);
 
-        f.Vars.push_back(v);
+        f.Vars.Records.push_back(r);
       }
+      f.Vars.buildVRegIndex();
 
       // subroutines
       count = read<uint16_t>(dbg);
@@ -344,7 +396,7 @@ private:
         sub.endVISAIndex = read<uint32_t>(dbg);
         auto countLRs = read<uint16_t>(dbg);
         for (unsigned int k = 0; k != countLRs; k++) {
-          LiveIntervalsVISA lv = readLiveIntervalsVISA();
+          LiveIntervalsVISA lv = readLiveIntervalsVISA(dbg);
           sub.retval.push_back(lv);
         }
         f.subs.push_back(sub);
@@ -397,7 +449,7 @@ private:
         f.cfi.callerSaveEntry.push_back(phyRegSave);
       }
 
-      compiledObjs.push_back(f);
+      compiledObjs.push_back(std::move(f));
     }
   }
 
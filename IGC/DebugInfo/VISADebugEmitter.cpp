@@ -252,6 +252,11 @@ void DebugEmitter::SetDISPCache(DwarfDISubprogramCache *DISPCache) {
   m_pDwarfDebug->setDISPCache(DISPCache);
 }
 
+void DebugEmitter::SetDITypeCache(DwarfDITypeCache *DITypeCache) {
+  IGC_ASSERT(m_pDwarfDebug);
+  m_pDwarfDebug->setDITypeCache(DITypeCache);
+}
+
 std::vector<char> DebugEmitter::Finalize(bool Finalize,
                                          const IGC::VISADebugInfo &VD) {
   if (!m_debugEnabled) {
@@ -35,6 +35,7 @@ struct DebugEmitterOpts;
 class CShader;
 class VISAModule;
 class DwarfDISubprogramCache;
+class DwarfDITypeCache;
 class VISADebugInfo;
 
 /// @brief IDebugEmitter is an interface for debug info emitter class.
@@ -63,6 +64,10 @@ public:
   //  nodes. Calling this method is optional (this is an optimization).
   /// @param DISPCache [IN] pointer to an external DwarfDISubprogramCache
   virtual void SetDISPCache(DwarfDISubprogramCache *DISPCache) = 0;
+  /// @brief DITypeCache is used to share type DIEs between the kernels of
+  //  a module. Calling this method is optional (this is an optimization).
+  /// @param DITypeCache [IN] pointer to an external DwarfDITypeCache
+  virtual void SetDITypeCache(DwarfDITypeCache *DITypeCache) = 0;
   /// @brief Emit debug info to given buffer and reset debug emitter.
   /// @param Finalize [IN] indicates whether this is last function in group.
   /// @param VisaDbgIngo [IN] holds decoded VISA debug information.
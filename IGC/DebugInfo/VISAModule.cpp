@@ -486,26 +486,10 @@ VISAModule::getGenISARange(const VISAObjectDebugInfo &VDI,
 const DbgDecoder::VarInfo *
 VISAModule::getVarInfo(const VISAObjectDebugInfo &VDI,
                        unsigned int vreg) const {
-  auto &Cache = *VICache.get();
-  if (Cache.empty()) {
-    for (const auto &VarInfo : VDI.getVISAVariables()) {
-      StringRef Name = VarInfo.name;
-      // TODO: what to do with variables starting with "T"?
-      if (Name.startswith("V")) {
-        Name = Name.drop_front();
-        unsigned RegNum = 0;
-        if (!Name.getAsInteger(10, RegNum))
-          Cache.insert(std::make_pair(RegNum, &VarInfo));
-      }
-    }
-  }
-
-  auto FoundIt = Cache.find(vreg);
-  if (FoundIt == Cache.end())
-    return nullptr;
-  if (FoundIt->second->lrs.empty())
+  const auto *VarInfo = VDI.getVISAVariables().findVReg(vreg);
+  if (!VarInfo || VarInfo->lrs.empty())
     return nullptr;
-  return FoundIt->second;
+  return VarInfo;
 }
 
 bool VISAModule::hasOrIsStackCall(const VISAObjectDebugInfo &VDI) const {
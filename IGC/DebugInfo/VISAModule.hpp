@@ -380,10 +380,6 @@ private:
       llvm::DenseMap<unsigned, const llvm::Instruction *>;
   VisaIndexToInstMap VisaIndexToInst;
 
-  // mapping between virtual registers and VarInfo (see VISADebugDecoder.hpp)
-  using VarInfoCache =
-      std::unordered_map<unsigned, const DbgDecoder::VarInfo *>;
-
   std::string m_triple = "vISA_64";
   bool IsPrimaryFunc = false;
   // m_Func points to llvm::Function that resulted in this VISAModule instance.
@@ -399,8 +395,6 @@ private:
 
   ObjectType m_objectType = ObjectType::UNKNOWN;
 
-  std::unique_ptr<VarInfoCache> VICache = std::make_unique<VarInfoCache>();
-
 public:
   /// @brief Constructor.
   /// @param AssociatedFunc holds llvm IR function associated with
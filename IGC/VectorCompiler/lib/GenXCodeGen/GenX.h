@@ -38,6 +38,7 @@ class formatted_raw_ostream;
 class Function;
 class FunctionGroup;
 class FunctionPass;
+class GenXBackendConfig;
 class GenXSubtarget;
 class Instruction;
 class MDNode;
@@ -174,6 +175,13 @@ enum ImmIntVec : int8_t {
   MinSInt = -(1 << (ElemSize - 1))
 };
 
+// Whether the vISA builder must build, and verify, the vISA bytecode and not
+// only G4 IR: something consumes it, i.e. the vISA text writer mode, asm
+// dumps, zebin vISA sections, vISA-only output, or a finalizer argument
+// (e.g. -dumpcommonisa from -finalizer-opts) asking for a vISA text dump.
+bool needVISAPath(const GenXBackendConfig &BC, bool AsmWriterMode,
+                  ArrayRef<const char *> FinalizerArgs);
+
 } // End genx namespace
 } // End llvm namespace
 
@@ -109,6 +109,11 @@ static cl::opt<bool>
     OptDisableVisaLOC("vc-cg-disable-visa-loc", cl::init(false), cl::Hidden,
                       cl::desc("do not emit LOC and FILE instructions"));
 
+static cl::opt<bool> ForceVISAPath(
+    "vc-force-visa-path", cl::init(false), cl::Hidden,
+    cl::desc("build and verify vISA bytecode even if no vISA output is "
+             "requested"));
+
 static cl::opt<bool> OptStrictI64Check(
         "genx-cisa-builder-noi64-check", cl::init(false), cl::Hidden,
         cl::desc("strict check to ensure we produce no 64-bit operations"));
@@ -6619,6 +6624,19 @@ LLVMContext &GenXModule::getContext() {
   return *Ctx;
 }
 
+bool genx::needVISAPath(const GenXBackendConfig &BC, bool AsmWriterMode,
+                        ArrayRef<const char *> FinalizerArgs) {
+  if (AsmWriterMode || BC.asmDumpsEnabled() || BC.emitZebinVisaSections() ||
+      BC.emitVisaOnly())
+    return true;
+  // vISA writes these dumps from the vISA bytecode. -output and -binary are
+  // not listed, the G4 IR path writes the .asm and .dat files too.
+  return llvm::any_of(FinalizerArgs, [](StringRef Arg) {
+    return Arg == "-dumpcommonisa" || Arg == "-genIsaasmList" ||
+           Arg == "-isaasmNamesOutputFile";
+  });
+}
+
 static VISABuilder *createVISABuilder(const GenXSubtarget &ST,
                                       const GenXBackendConfig &BC,
                                       GenXModule::InfoForFinalizer Info,
@@ -6636,18 +6654,28 @@ static VISABuilder *createVISABuilder(const GenXSubtarget &ST,
   if (PrintFinalizerOptions)
     dumpFinalizerArgs(Argv, ST.getCPU());
 
+  // The vISA bytecode is only built when something consumes it. Otherwise
+  // the builder goes straight to G4 IR, as IGC does.
+  bool NeedVISAPath =
+      ForceVISAPath || genx::needVISAPath(BC, Mode != vISA_DEFAULT, Argv);
+#if defined(_DEBUG)
+  NeedVISAPath = true;
+#endif
+  const auto BuilderOpt = NeedVISAPath ? VISA_BUILDER_BOTH : VISA_BUILDER_GEN;
+
   // Special error processing here related to strange case where on Windows
   // machines only we had failures, reproducible only when shader dumps are
   // off. This code is to diagnose such cases simpler.
   VISABuilder *VB = nullptr;
   int Result = vISA::CreateVISABuilder(
-      VB, Mode, VISA_BUILDER_BOTH, Platform,
+      VB, Mode, BuilderOpt, Platform,
       Argv.size(), Argv.data(), BC.getWATable());
   if (Result != 0 || VB == nullptr) {
     std::string Str;
     llvm::raw_string_ostream Os(Str);
     Os << "VISA builder creation failed\n";
     Os << "Mode: " << Mode << "\n";
+    Os << "Builder option: " << BuilderOpt << "\n";
     Os << "Args:\n";
     for (const char *Arg : Argv)
       Os << Arg << " ";
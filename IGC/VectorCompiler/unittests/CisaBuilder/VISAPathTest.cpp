@@ -0,0 +1,68 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2023 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "GenX.h"
+
+#include "vc/Support/BackendConfig.h"
+
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+// Arguments that collectFinalizerArgs always passes.
+const char *const DefaultArgs[] = {"-dumpvisa", "-abiver", "2"};
+
+bool needVISAPath(const GenXBackendOptions &Options, bool AsmWriterMode,
+                  ArrayRef<const char *> Args = DefaultArgs) {
+  GenXBackendConfig BC(Options, GenXBackendData());
+  return genx::needVISAPath(BC, AsmWriterMode, Args);
+}
+
+TEST(GenXCisaBuilder, GenPathByDefault) {
+  EXPECT_FALSE(needVISAPath(GenXBackendOptions(), false));
+}
+
+TEST(GenXCisaBuilder, VISAPathForAsmWriter) {
+  EXPECT_TRUE(needVISAPath(GenXBackendOptions(), true));
+}
+
+TEST(GenXCisaBuilder, VISAPathForAsmDumps) {
+  GenXBackendOptions Options;
+  Options.EnableAsmDumps = true;
+  EXPECT_TRUE(needVISAPath(Options, false));
+}
+
+TEST(GenXCisaBuilder, VISAPathForZebinVisaSections) {
+  GenXBackendOptions Options;
+  Options.EmitZebinVisaSections = true;
+  EXPECT_TRUE(needVISAPath(Options, false));
+}
+
+TEST(GenXCisaBuilder, VISAPathForVisaOnly) {
+  GenXBackendOptions Options;
+  Options.EmitVisaOnly = true;
+  EXPECT_TRUE(needVISAPath(Options, false));
+}
+
+TEST(GenXCisaBuilder, VISAPathForFinalizerOpts) {
+  const char *const DumpCommonIsa[] = {"-dumpvisa", "-dumpcommonisa"};
+  EXPECT_TRUE(needVISAPath(GenXBackendOptions(), false, DumpCommonIsa));
+  const char *const IsaasmList[] = {"-dumpvisa", "-genIsaasmList"};
+  EXPECT_TRUE(needVISAPath(GenXBackendOptions(), false, IsaasmList));
+  const char *const IsaasmNames[] = {"-dumpvisa", "-isaasmNamesOutputFile",
+                                     "names.txt"};
+  EXPECT_TRUE(needVISAPath(GenXBackendOptions(), false, IsaasmNames));
+}
+
+TEST(GenXCisaBuilder, GenPathForGenOutputs) {
+  // The G4 IR path writes the .asm and .dat files itself.
+  const char *const Output[] = {"-dumpvisa", "-output", "-binary"};
+  EXPECT_FALSE(needVISAPath(GenXBackendOptions(), false, Output));
+}
+} // namespace
@@ -8,10 +8,17 @@ SPDX-License-Identifier: MIT
 
 #include "Tester.hpp"
 #include "ZEELFObjectBuilder.hpp"
-#include "ZEinfoYAML.hpp"
+#include "ZEInfoBinary.hpp"
+#include "ZEInfoYAML.hpp"
+
+#include "llvm/Object/ELF.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/EndianStream.h"
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <cstring>
 
 using llvm::yaml::Output;
 using llvm::yaml::Input;
@@ -22,7 +29,6 @@ static void getTestZEInfo(zeInfoContainer& ks)
     zeInfoKernel k1;
 
     k1.name = "kernel_name_1";
-    k1.execution_env.actual_kernel_start_offset = 0;
     k1.execution_env.grf_count = 128;
     k1.execution_env.simd_size = 8;
     k1.execution_env.required_work_group_size.push_back(256);
@@ -86,7 +92,6 @@ static void getTestZEInfo(zeInfoContainer& ks)
 
     zeInfoKernel k2;
     k2.name = "kernel_name_2";
-    k2.execution_env.actual_kernel_start_offset = 0;
     k2.execution_env.grf_count = 100;
     k2.execution_env.simd_size = 16;
 
@@ -108,7 +113,7 @@ static void getTestZEInfo(zeInfoContainer& ks)
     ks.kernels.push_back(k2);
 }
 
-void Tester::testZEInfoOutput()
+bool Tester::testZEInfoOutput()
 {
     zeInfoContainer in_ks;
     getTestZEInfo(in_ks);
@@ -125,13 +130,379 @@ void Tester::testZEInfoOutput()
     llvm::raw_string_ostream out_OS(out_string);
     Output out_yout(out_OS);
     out_yout << out_ks;
+
+    if (Yin.error() || OS.str() != out_OS.str()) {
+        std::cout << "ze_info YAML round trip mismatch\n";
+        return false;
+    }
+    std::cout << "ze_info YAML round trip passed\n";
+    return true;
+}
+
+static bool decodeZEInfoBinary(const std::string& bin, zeInfoContainer& out,
+    std::string& error)
+{
+    ZEInfoBinaryReader reader((const uint8_t*)bin.data(), bin.size());
+    bool ok = reader.init() && reader.read(out);
+    error = reader.getError();
+    return ok;
+}
+
+bool Tester::testZEInfoBinary()
+{
+    zeInfoContainer in_ks;
+    getTestZEInfo(in_ks);
+    in_ks.version = PreDefinedAttrGetter::getVersionNumber();
+
+    std::string bin;
+    llvm::raw_string_ostream bin_OS(bin);
+    ZEInfoBinaryWriter::write(in_ks, bin_OS);
+    bin_OS.flush();
+
+    ZEInfoBinaryReader reader((const uint8_t*)bin.data(), bin.size());
+    zeInfoContainer out_ks;
+    if (!reader.init() || !reader.read(out_ks)) {
+        std::cout << "binary ze_info decoding failed: " << reader.getError() << "\n";
+        return false;
+    }
+    if (reader.getKernelName(1) != in_ks.kernels[1].name || !(out_ks == in_ks)) {
+        std::cout << "binary ze_info round trip mismatch\n";
+        return false;
+    }
+
+    // binary -> YAML must match the direct YAML output
+    std::string in_string;
+    llvm::raw_string_ostream OS(in_string);
+    Output yout(OS);
+    yout << in_ks;
+
+    std::string out_string;
+    llvm::raw_string_ostream out_OS(out_string);
+    convertZEInfoBinaryToYAML((const uint8_t*)bin.data(), bin.size(), out_OS);
+    if (OS.str() != out_OS.str()) {
+        std::cout << "binary ze_info YAML conversion mismatch\n";
+        return false;
+    }
+
+    // every truncation of the encoding must be rejected without reading
+    // past the end of the buffer
+    for (size_t size = 0; size < bin.size(); ++size) {
+        zeInfoContainer trunc_ks;
+        std::string error;
+        if (decodeZEInfoBinary(bin.substr(0, size), trunc_ks, error)) {
+            std::cout << "truncated binary ze_info of " << size << " bytes accepted\n";
+            return false;
+        }
+    }
+
+    std::cout << "binary ze_info round trip passed\n";
+    return true;
+}
+
+bool Tester::testZEInfoBinaryCompat()
+{
+    using namespace llvm::support;
+
+    // a kernel record written by a newer minor version: the reader must skip
+    // the fields appended to the record
+    zeInfoContainer in_ks;
+    zeInfoKernel k;
+    k.name = "k";
+    k.execution_env.simd_size = 16;
+    in_ks.kernels.push_back(k);
+
+    std::string bin;
+    llvm::raw_string_ostream bin_OS(bin);
+    ZEInfoBinaryWriter::write(in_ks, bin_OS);
+    bin_OS.flush();
+
+    uint32_t kernelOff = endian::read32le(bin.data() + ZEInfoBinaryFormat::HeaderSize);
+    uint8_t recordSize = (uint8_t)bin[kernelOff];
+    // keep the record size a single byte ULEB128 when growing it
+    if (recordSize + 2 >= 0x80) {
+        std::cout << "binary ze_info compat test kernel record too large\n";
+        return false;
+    }
+    bin.insert(kernelOff + 1 + recordSize, "\x01\x02", 2);
+    bin[kernelOff] = (char)(recordSize + 2);
+    endian::write32le(&bin[8], endian::read32le(bin.data() + 8) + 2);
+    endian::write32le(&bin[16], endian::read32le(bin.data() + 16) + 2);
+
+    zeInfoContainer out_ks;
+    std::string error;
+    if (!decodeZEInfoBinary(bin, out_ks, error) || !(out_ks == in_ks)) {
+        std::cout << "binary ze_info newer minor version decoding failed " << error << "\n";
+        return false;
+    }
+
+    // a kernel record written by an older minor version having only the
+    // name: the missing fields must keep their default values
+    std::string old_bin;
+    llvm::raw_string_ostream old_OS(old_bin);
+    endian::Writer W(old_OS, little);
+    W.write<uint32_t>(ZEInfoBinaryFormat::Magic);
+    W.write<uint16_t>(ZEInfoBinaryFormat::MajorVersion);
+    W.write<uint16_t>(0);
+    W.write<uint32_t>(ZEInfoBinaryFormat::HeaderSize + 4 + 1 + 3 + 3);
+    W.write<uint32_t>(1);
+    W.write<uint32_t>(ZEInfoBinaryFormat::HeaderSize + 4 + 1 + 3);
+    W.write<uint32_t>(ZEInfoBinaryFormat::HeaderSize + 4 + 1);
+    // empty version string
+    old_OS << '\0';
+    // kernel record: size, name length, name
+    old_OS << '\x02' << '\x01' << 'k';
+    // no functions, host access table and misc info
+    old_OS << '\0' << '\0' << '\0';
+    old_OS.flush();
+
+    zeInfoContainer old_ks, expected_ks;
+    zeInfoKernel old_k;
+    old_k.name = "k";
+    expected_ks.kernels.push_back(old_k);
+    if (!decodeZEInfoBinary(old_bin, old_ks, error) || !(old_ks == expected_ks)) {
+        std::cout << "binary ze_info older minor version decoding failed " << error << "\n";
+        return false;
+    }
+
+    std::cout << "binary ze_info compatibility passed\n";
+    return true;
+}
+
+namespace {
+// yaml::Output that writes every key, also the ones holding their default
+// value or an empty sequence
+class AllKeysOutput : public Output {
+public:
+    AllKeysOutput(llvm::raw_ostream& os) : Output(os) { setWriteDefaultValues(true); }
+    bool canElideEmptySequence() override { return false; }
+};
+} // anonymous namespace
+
+// Give every scalar of the YAML text a distinct value that is not the
+// default of any ze_info field, and one such element to empty sequences.
+static std::string fillZEInfoYAML(const std::string& text)
+{
+    std::string out;
+    unsigned n = 0;
+    std::istringstream in(text);
+    for (std::string line; std::getline(in, line);) {
+        size_t colon = line.find(": ");
+        size_t start = colon == std::string::npos ? colon : line.find_first_not_of(' ', colon + 1);
+        if (start != std::string::npos) {
+            std::string value = line.substr(start);
+            std::string filled;
+            if (value == "false")
+                filled = "true";
+            else if (value == "''")
+                filled = "s" + std::to_string(++n);
+            else if (value == "[  ]")
+                filled = "[ " + std::to_string(1000 + ++n) + " ]";
+            else if (value.find_first_not_of("-0123456789") == std::string::npos)
+                filled = std::to_string(1000 + ++n);
+            if (!filled.empty())
+                line = line.substr(0, colon + 2) + filled;
+        }
+        out += line + "\n";
+    }
+    return out;
+}
+
+bool Tester::testZEInfoBinaryFields()
+{
+    // One element in each sequence of records, so that all the record types
+    // get written. The remaining empty sequences hold scalars.
+    zeInfoContainer skel;
+    skel.kernels.resize(1);
+    zeInfoKernel& k = skel.kernels[0];
+    k.payload_arguments.resize(1);
+    k.per_thread_payload_arguments.resize(1);
+    k.binding_table_indices.resize(1);
+    k.per_thread_memory_buffers.resize(1);
+    k.inline_samplers.resize(1);
+    skel.functions.resize(1);
+    skel.global_host_access_table.resize(1);
+    skel.kernels_misc_info.resize(1);
+    skel.kernels_misc_info[0].args_info.resize(1);
+
+    std::string skel_string;
+    llvm::raw_string_ostream skel_OS(skel_string);
+    AllKeysOutput skel_yout(skel_OS);
+    skel_yout << skel;
+
+    // The YAML mapping and operator== are generated from the same list of
+    // fields as ZEInfo.hpp, so a field that mapFields in ZEInfoBinary.cpp
+    // misses gets its default value back and breaks the comparison.
+    zeInfoContainer in_ks;
+    std::string filled = fillZEInfoYAML(skel_OS.str());
+    Input yin(filled);
+    yin >> in_ks;
+    if (yin.error()) {
+        std::cout << "binary ze_info field test could not fill every field\n";
+        return false;
+    }
+
+    std::string bin;
+    llvm::raw_string_ostream bin_OS(bin);
+    ZEInfoBinaryWriter::write(in_ks, bin_OS);
+    bin_OS.flush();
+
+    zeInfoContainer out_ks;
+    std::string error;
+    if (!decodeZEInfoBinary(bin, out_ks, error) || !(out_ks == in_ks)) {
+        std::string in_string, out_string;
+        llvm::raw_string_ostream in_OS(in_string), out_OS(out_string);
+        Output in_yout(in_OS), out_yout(out_OS);
+        in_yout << in_ks;
+        out_yout << out_ks;
+        std::cout << "binary ze_info does not encode every field " << error
+                  << "\nexpected:\n" << in_OS.str()
+                  << "decoded:\n" << out_OS.str();
+        return false;
+    }
+
+    std::cout << "binary ze_info field coverage passed\n";
+    return true;
+}
+
+bool Tester::testKernelStatsNotes()
+{
+    ZEELFObjectBuilder builder(true);
+    uint8_t text_buff[16] = { 0x1, 0x2, 0x3, 0x4 };
+    builder.addSectionText("kernel", text_buff, 16, 0, 0);
+    // descriptions of each length modulo 4, so that every padding is used
+    const std::vector<std::string> stats = {
+        "{}", "{\"simdSize\":8}", "{\"simdSize\":16,\"numGRFTotal\":128}",
+        "{\"simdSize\":32,\"isSpill\":true}" };
+    builder.addSectionKernelStats("kernel", stats);
+
+    llvm::SmallVector<char, 0> elf;
+    llvm::raw_svector_ostream os(elf);
+    builder.finalize(os);
+
+    auto elfOrErr = llvm::object::ELF64LEFile::create(
+        llvm::StringRef(elf.data(), elf.size()));
+    auto sectionsOrErr = elfOrErr ? elfOrErr->sections()
+        : llvm::Expected<llvm::object::ELF64LEFile::Elf_Shdr_Range>(elfOrErr.takeError());
+    if (!sectionsOrErr) {
+        std::cout << "kernel stats notes: ELF output unreadable: "
+                  << llvm::toString(sectionsOrErr.takeError()) << "\n";
+        return false;
+    }
+
+    size_t numStats = 0, numCompat = 0;
+    for (const auto& shdr : *sectionsOrErr) {
+        llvm::Expected<llvm::StringRef> name = elfOrErr->getSectionName(shdr);
+        if (!name) {
+            llvm::consumeError(name.takeError());
+            continue;
+        }
+        bool isStats = *name == ".note.intelgt.metrics.kernel";
+        if (!isStats && *name != ".note.intelgt.compat")
+            continue;
+        if (shdr.sh_type != llvm::ELF::SHT_NOTE || shdr.sh_offset % 4 ||
+            shdr.sh_size % 4) {
+            std::cout << "kernel stats notes: " << name->str()
+                      << " is not a 4 byte aligned SHT_NOTE section\n";
+            return false;
+        }
+        llvm::Error err = llvm::Error::success();
+        for (const auto& note : elfOrErr->notes(shdr, err)) {
+            if (!isStats) {
+                numCompat++;
+                continue;
+            }
+            llvm::ArrayRef<uint8_t> desc = note.getDesc();
+            if (numStats >= stats.size() || note.getName() != "IntelGT" ||
+                note.getType() != NT_INTELGT_KERNEL_STATS ||
+                desc.size() != stats[numStats].size() + 1 || desc.back() != 0 ||
+                llvm::StringRef((const char*)desc.data(), desc.size() - 1) !=
+                    stats[numStats]) {
+                std::cout << "kernel stats notes: note " << numStats
+                          << " does not match\n";
+                return false;
+            }
+            numStats++;
+        }
+        if (err) {
+            std::cout << "kernel stats notes: " << name->str() << ": "
+                      << llvm::toString(std::move(err)) << "\n";
+            return false;
+        }
+    }
+    // the compat notes must be unaffected
+    if (numStats != stats.size() || numCompat != 4) {
+        std::cout << "kernel stats notes: found " << numStats
+                  << " stats and " << numCompat << " compat notes\n";
+        return false;
+    }
+    std::cout << "kernel stats notes layout passed\n";
+    return true;
+}
+
+bool Tester::testBufferOutput()
+{
+    for (bool binaryZEInfo : { false, true }) {
+        ZEELFObjectBuilder builder(true);
+        builder.setZEInfoBinaryFormat(binaryZEInfo);
+        uint8_t text_buff[10] = { 0x1, 0x2, 0x3, 0x4 };
+        uint32_t text =
+            builder.addSectionText(".text.kernel", text_buff, 10, 0, 0);
+        uint8_t data_buff[3] = { 0x5, 0x6, 0x7 };
+        builder.addSectionData(".data.buff", data_buff, 3);
+        builder.addSymbol("text_sym", 0, 10, llvm::ELF::STB_GLOBAL,
+                          llvm::ELF::STT_FUNC, text);
+        zeInfoContainer ks;
+        getTestZEInfo(ks);
+        builder.addSectionZEInfo(ks);
+
+        auto streamed = [&builder]() {
+            llvm::SmallVector<char, 0> elf;
+            llvm::raw_svector_ostream os(elf);
+            builder.finalize(os);
+            return std::string(elf.data(), elf.size());
+        };
+        const std::string expected = streamed();
+        const char* format = binaryZEInfo ? "binary" : "YAML";
+
+        // the layout must match the streamed output, and the two-phase
+        // write must produce the very same bytes
+        uint64_t size = builder.getBinarySize();
+        std::vector<uint8_t> buf(size + 1, 0xcd);
+        uint64_t written = builder.finalize(buf.data(), size);
+        if (size != expected.size() || written != size ||
+            memcmp(buf.data(), expected.data(), size) || buf[size] != 0xcd) {
+            std::cout << "buffer output (" << format << " ze_info): "
+                      << "layout size " << size << ", written " << written
+                      << ", streamed " << expected.size() << "\n";
+            return false;
+        }
+
+        // a too small buffer is rejected without writing past its end
+        size = builder.getBinarySize();
+        std::fill(buf.begin(), buf.end(), 0xcd);
+        written = builder.finalize(buf.data(), size - 1);
+        if (written != 0 || buf[size - 1] != 0xcd) {
+            std::cout << "buffer output (" << format << " ze_info): "
+                      << "too small buffer not rejected\n";
+            return false;
+        }
+
+        // the ze_info encoded for a layout is dropped by the following
+        // finalize, so later changes are written
+        ks.kernels.front().name = "renamed";
+        if (streamed() == expected) {
+            std::cout << "buffer output (" << format << " ze_info): "
+                      << "stale ze_info written\n";
+            return false;
+        }
+    }
+    std::cout << "buffer output passed\n";
+    return true;
 }
 
-void Tester::testELFOutput()
+bool Tester::testELFOutput()
 {
-    TargetFlags flag;
-    flag.packed = 10;
-    ZEELFObjectBuilder builder(false, ET_ZEBIN_EXE, 0, flag);
+    ZEELFObjectBuilder builder(false);
 
     // add fake text
     uint8_t text_buff[100] = { 0x1, 0x2, 0x3, 0x4 };
@@ -156,8 +527,8 @@ void Tester::testELFOutput()
     builder.addSymbol("undef_sym", 0, 0, llvm::ELF::STB_GLOBAL, llvm::ELF::STT_OBJECT, -1);
 
     // add fake relocations
-    builder.addRelocation(4, "data1_sym_at_3", R_TYPE_ZEBIN::R_ZE_SYM_ADDR, text);
-    builder.addRelocation(8, "text_sym_at_1", R_TYPE_ZEBIN::R_ZE_SYM_ADDR_32, text);
+    builder.addRelRelocation(4, "data1_sym_at_3", R_TYPE_ZEBIN::R_ZE_SYM_ADDR, text);
+    builder.addRelRelocation(8, "text_sym_at_1", R_TYPE_ZEBIN::R_ZE_SYM_ADDR_32, text);
 
     // add fake ze_info
     zeInfoContainer ks;
@@ -168,4 +539,5 @@ void Tester::testELFOutput()
     llvm::raw_fd_ostream os("testELFOutput", EC);
     builder.finalize(os);
     os.close();
+    return !os.has_error();
 }
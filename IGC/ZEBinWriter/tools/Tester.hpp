@@ -19,8 +19,14 @@ namespace zebin {
 
 class Tester {
 public:
-    static void testZEInfoOutput();
-    static void testELFOutput();
+    // each test prints its result and returns false on failure
+    static bool testZEInfoOutput();
+    static bool testZEInfoBinary();
+    static bool testZEInfoBinaryCompat();
+    static bool testZEInfoBinaryFields();
+    static bool testKernelStatsNotes();
+    static bool testBufferOutput();
+    static bool testELFOutput();
 };
 
 } // namespace zebin
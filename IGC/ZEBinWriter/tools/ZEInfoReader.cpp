@@ -10,7 +10,8 @@ SPDX-License-Identifier: MIT
 
 #include "Tester.hpp"
 #include <ZEInfo.hpp>
-#include <ZEinfoYAML.hpp>
+#include <ZEInfoBinary.hpp>
+#include <ZEInfoYAML.hpp>
 
 #include <llvm/Object/ObjectFile.h>
 #include <llvm/Object/ELFObjectFile.h>
@@ -31,18 +32,38 @@ using namespace zebin;
 static void dumpZEInfo(std::unique_ptr<llvm::object::ObjectFile> object) {
     bool dump = false;
     for (auto sect : object->sections()) {
-        llvm::StringRef name;
-        sect.getName(name);
+        llvm::Expected<llvm::StringRef> nameOrErr = sect.getName();
+        if (!nameOrErr) {
+            llvm::consumeError(nameOrErr.takeError());
+            continue;
+        }
+        llvm::StringRef name = *nameOrErr;
 
-        if (name.compare(llvm::StringRef(".ze_info")))
+        bool isBinary = !name.compare(llvm::StringRef(".ze_info.bin"));
+        if (name.compare(llvm::StringRef(".ze_info")) && !isBinary)
             continue;
 
-        llvm::StringRef content;
-        sect.getContents(content);
+        llvm::Expected<llvm::StringRef> contentOrErr = sect.getContents();
+        if (!contentOrErr) {
+            llvm::consumeError(contentOrErr.takeError());
+            continue;
+        }
+        llvm::StringRef content = *contentOrErr;
 
         std::ofstream outfile;
         outfile.open("ze_info.dump", std::ios::out | std::ios::binary);
-        outfile.write(content.data(), content.size());
+        if (isBinary) {
+            // convert the binary encoding back to YAML
+            std::string yaml, error;
+            llvm::raw_string_ostream os(yaml);
+            if (!convertZEInfoBinaryToYAML((const uint8_t*)content.data(),
+                    content.size(), os, &error))
+                std::cerr << "Invalid .ze_info.bin section: " << error;
+            os.flush();
+            outfile.write(yaml.data(), yaml.size());
+        } else {
+            outfile.write(content.data(), content.size());
+        }
         outfile.close();
         if (dump)
             std::cerr << "Given ELF object has more than one .ze_info section";
@@ -61,17 +82,21 @@ static llvm::cl::opt<bool> DumpZEInfo ("info",
     llvm::cl::desc("Dump .ze_info section into ze_info.dump file"));
 
 static llvm::cl::opt<bool> RunTestZEInfo ("test-ze-info",
-    llvm::cl::desc("Run static zeinfo generating tests, print the result to std output"));
+    llvm::cl::desc("Run static zeinfo generating tests, print the result to std output and return non-zero on failure"));
 /// ----------------------------------------------------------------------- ///
 
 int zeinfo_reader_main(int argc, const char** argv) {
     llvm::cl::ParseCommandLineOptions(argc, argv);
 
     // run zeinfo generating tests
-    // FIXME: This is just a static test, need to be enhanced
     if (RunTestZEInfo) {
-        Tester::testZEInfoOutput();
-        return 0;
+        bool passed = Tester::testZEInfoOutput();
+        passed &= Tester::testZEInfoBinary();
+        passed &= Tester::testZEInfoBinaryCompat();
+        passed &= Tester::testZEInfoBinaryFields();
+        passed &= Tester::testKernelStatsNotes();
+        passed &= Tester::testBufferOutput();
+        return passed ? 0 : 1;
     }
 
     // read input elf file
@@ -35,7 +35,8 @@ enum SHT_ZEBIN : uint32_t
     SHT_ZEBIN_ZEINFO     = 0xff000011, // .ze.info section
     SHT_ZEBIN_GTPIN_INFO = 0xff000012, // .gtpin_info section
     SHT_ZEBIN_VISAASM    = 0xff000013, // .visaasm section
-    SHT_ZEBIN_MISC       = 0xff000014  // .misc section
+    SHT_ZEBIN_MISC       = 0xff000014, // .misc section
+    SHT_ZEBIN_ZEINFO_BIN = 0xff000015  // .ze_info.bin section
 };
 
 // ELF relocation type for ELF32_Rel::ELF32_R_TYPE
@@ -59,6 +60,10 @@ enum {
     // attribute and section changes. The content is stored in a nul-terminated
     // string and the format is "<Major number>.<Minor number>".
     NT_INTELGT_ZEBIN_VERSION = 4,
+    // The description is the codegen statistics of one SIMD variant of a
+    // kernel, stored in a nul-terminated JSON object. These notes are placed
+    // in the .note.intelgt.metrics.<kernel_name> sections.
+    NT_INTELGT_KERNEL_STATS = 5,
 };
 
 struct TargetMetadata {
@@ -8,6 +8,7 @@ SPDX-License-Identifier: MIT
 
 #include <ZEELFObjectBuilder.hpp>
 #include <ZEInfo.hpp>
+#include <ZEInfoBinary.hpp>
 #include <ZEInfoYAML.hpp>
 
 #ifndef ZEBinStandAloneBuild
@@ -23,6 +24,7 @@ SPDX-License-Identifier: MIT
 #include "common/LLVMWarningsPop.hpp"
 #endif
 
+#include <cstring>
 #include <iostream>
 #include <tuple>
 #include "Probe/Assertion.h"
@@ -148,9 +150,69 @@ private:
 
 };
 
+/// CountingPWriteStream - A stream that discards everything written into it
+///                        and only tracks the position. Used to lay out the
+///                        ELF file without writing the section contents.
+class CountingPWriteStream : public llvm::raw_pwrite_stream {
+public:
+    CountingPWriteStream() : llvm::raw_pwrite_stream(true) {}
+
+private:
+    void write_impl(const char* ptr, size_t size) override { m_pos += size; }
+    void pwrite_impl(const char* ptr, size_t size, uint64_t offset) override {}
+    uint64_t current_pos() const override { return m_pos; }
+
+    uint64_t m_pos = 0;
+};
+
+/// MemoryPWriteStream - A stream that writes directly into a caller-provided
+///                      fixed-size memory, without buffering
+class MemoryPWriteStream : public llvm::raw_pwrite_stream {
+public:
+    MemoryPWriteStream(uint8_t* buffer, uint64_t size)
+        : llvm::raw_pwrite_stream(true), m_buffer(buffer), m_size(size)
+    {}
+
+    bool overflowed() const { return m_overflowed; }
+
+private:
+    void write_impl(const char* ptr, size_t size) override {
+        if (m_pos + size <= m_size)
+            memcpy(m_buffer + m_pos, ptr, size);
+        else
+            m_overflowed = true;
+        m_pos += size;
+    }
+    void pwrite_impl(const char* ptr, size_t size, uint64_t offset) override {
+        if (offset + size <= m_size)
+            memcpy(m_buffer + offset, ptr, size);
+        else
+            m_overflowed = true;
+    }
+    uint64_t current_pos() const override { return m_pos; }
+
+    uint8_t* m_buffer;
+    uint64_t m_size;
+    uint64_t m_pos = 0;
+    bool m_overflowed = false;
+};
+
 } // namespace zebin
 
 using namespace zebin;
+
+// serialize ze_info contents in the binary or the YAML format
+static void writeZEInfoContents(zeInfoContainer& zeInfo, bool binaryFormat,
+                                llvm::raw_ostream& os)
+{
+    if (binaryFormat) {
+        ZEInfoBinaryWriter::write(zeInfo, os);
+    } else {
+        llvm::yaml::Output yout(os);
+        yout << zeInfo;
+    }
+}
+
 using namespace llvm;
 
 ZEELFObjectBuilder::Section&
@@ -192,6 +254,34 @@ ZEELFObjectBuilder::addSectionText(
     return sect.id();
 }
 
+ZEELFObjectBuilder::SectionID
+ZEELFObjectBuilder::addSectionTextAlias(std::string name, SectionID aliasee)
+{
+    StandardSection* target = nullptr;
+    for (StandardSection& sect : m_textSections) {
+        if (sect.id() == aliasee) {
+            target = &sect;
+            break;
+        }
+    }
+    IGC_ASSERT_MESSAGE(target, "addSectionTextAlias: aliasee is not a text section");
+    IGC_ASSERT_MESSAGE(target->m_aliasee < 0, "addSectionTextAlias: aliasee is an alias");
+
+    std::string sectName;
+    if (name != "")
+        sectName = m_TextName + "." + name;
+    else
+        sectName = m_TextName;
+
+    // the padding is already counted into the aliasee
+    StandardSection sect(sectName, target->m_data, target->m_size, target->m_type,
+        target->m_flags, target->m_padding, m_sectionIdCount);
+    sect.m_aliasee = aliasee;
+    m_textSections.push_back(sect);
+    ++m_sectionIdCount;
+    return sect.id();
+}
+
 ZEELFObjectBuilder::SectionID
 ZEELFObjectBuilder::addSectionData(
     std::string name, const uint8_t* data, uint64_t size, uint32_t padding, uint32_t align, bool rodata, bool alloc)
@@ -287,6 +377,36 @@ ZEELFObjectBuilder::addSectionMetrics(std::string name, const uint8_t* data, uin
         data, size, ELF::SHT_NOTE, 0, 0, 0, m_otherStdSections);
 }
 
+void
+ZEELFObjectBuilder::addSectionKernelStats(const std::string& kernel,
+                                          const std::vector<std::string>& stats)
+{
+    if (stats.empty())
+        return;
+
+    // The ELF note layout: namesz, descsz and type words, then the owner
+    // name and the description, each nul-terminated and padded to 4 bytes
+    // (c.f. writeCompatibilityNote)
+    std::string& notes = m_kernelStatsNotes.emplace_back();
+    llvm::raw_string_ostream os(notes);
+    llvm::support::endian::Writer w(os, llvm::support::little);
+    auto writeStr = [&](llvm::StringRef str) {
+        os << str << '\0';
+        os.write_zeros(llvm::alignTo(str.size() + 1, 4) - (str.size() + 1));
+    };
+    const llvm::StringRef owner = "IntelGT";
+    for (const std::string& desc : stats) {
+        w.write<uint32_t>(owner.size() + 1);
+        w.write<uint32_t>(desc.size() + 1);
+        w.write<uint32_t>(NT_INTELGT_KERNEL_STATS);
+        writeStr(owner);
+        writeStr(desc);
+    }
+    os.flush();
+    addSectionMetrics(kernel, reinterpret_cast<const uint8_t*>(notes.data()),
+                      notes.size());
+}
+
 void
 ZEELFObjectBuilder::addSectionSpirv(std::string name, const uint8_t* data, uint64_t size)
 {
@@ -372,10 +492,36 @@ void ZEELFObjectBuilder::addRelaRelocation(
 
 uint64_t ZEELFObjectBuilder::finalize(llvm::raw_pwrite_stream& os)
 {
+    ELFWriter w(os, *this);
+    uint64_t size = w.write();
+    // the ze_info encoded by getBinarySize is only valid for this write
+    if (m_zeInfoSection)
+        std::string().swap(m_zeInfoSection->getEncoded());
+    return size;
+}
+
+uint64_t ZEELFObjectBuilder::getBinarySize()
+{
+    // encode ze_info once, for the layout and the following finalize
+    if (m_zeInfoSection) {
+        std::string& encoded = m_zeInfoSection->getEncoded();
+        encoded.clear();
+        llvm::raw_string_ostream os(encoded);
+        writeZEInfoContents(m_zeInfoSection->getZeInfo(), m_zeInfoBinaryFormat, os);
+        os.flush();
+    }
+    CountingPWriteStream os;
     ELFWriter w(os, *this);
     return w.write();
 }
 
+uint64_t ZEELFObjectBuilder::finalize(uint8_t* buffer, uint64_t bufferSize)
+{
+    MemoryPWriteStream os(buffer, bufferSize);
+    uint64_t size = finalize(os);
+    return os.overflowed() ? 0 : size;
+}
+
 ZEELFObjectBuilder::SectionID
 ZEELFObjectBuilder::getSectionIDBySectionName(const char* name)
 {
@@ -572,9 +718,13 @@ uint64_t ELFWriter::writeZEInfo()
 {
     uint64_t start_off = m_W.OS.tell();
     // serialize ze_info contents
-    llvm::yaml::Output yout(m_W.OS);
     IGC_ASSERT(m_ObjBuilder.m_zeInfoSection);
-    yout << m_ObjBuilder.m_zeInfoSection->getZeInfo();
+    ZEInfoSection& zeInfoSect = *m_ObjBuilder.m_zeInfoSection;
+    const std::string& encoded = zeInfoSect.getEncoded();
+    if (encoded.empty())
+        writeZEInfoContents(zeInfoSect.getZeInfo(), m_ObjBuilder.m_zeInfoBinaryFormat, m_W.OS);
+    else
+        m_W.OS << encoded;
 
     return m_W.OS.tell() - start_off;
 }
@@ -721,6 +871,18 @@ void ELFWriter::writeSections()
                 static_cast<const StandardSection*>(entry.section);
             IGC_ASSERT(nullptr != stdsect);
             IGC_ASSERT(stdsect->m_size + stdsect->m_padding);
+            if (stdsect->m_aliasee >= 0) {
+                // refer to the contents written for the aliasee, which must
+                // have been written as text sections keep the order of being
+                // added
+                IGC_ASSERT(m_SectionIndex.find(stdsect->m_aliasee) != m_SectionIndex.end());
+                const SectionHdrEntry& aliasee =
+                    m_SectionHdrEntries[m_SectionIndex.at(stdsect->m_aliasee)];
+                IGC_ASSERT(&aliasee < &entry);
+                entry.offset = aliasee.offset;
+                entry.size = aliasee.size;
+                break;
+            }
             entry.size = writeSectionData(
                 stdsect->m_data, stdsect->m_size, stdsect->m_padding);
             break;
@@ -753,6 +915,7 @@ void ELFWriter::writeSections()
             break;
         }
         case SHT_ZEBIN_ZEINFO:
+        case SHT_ZEBIN_ZEINFO_BIN:
             entry.size = writeZEInfo();
             break;
 
@@ -788,6 +951,16 @@ void ELFWriter::writeSections()
                 if (stdsect->m_size + stdsect->m_padding > 0)
                     entry.size = writeSectionData(stdsect->m_data, stdsect->m_size, stdsect->m_padding);
             }
+            else if (llvm::StringRef(entry.sectName).startswith(
+                         m_ObjBuilder.m_MetricsNoteName + ".")) {
+                // the named metrics notes (e.g. .note.intelgt.metrics.<kernel>
+                // from addSectionKernelStats) are given already encoded
+                IGC_ASSERT(nullptr != entry.section);
+                IGC_ASSERT(entry.section->getKind() == Section::STANDARD);
+                const StandardSection* const stdsect =
+                    static_cast<const StandardSection*>(entry.section);
+                entry.size = writeSectionData(stdsect->m_data, stdsect->m_size, stdsect->m_padding);
+            }
             break;
         }
 
@@ -997,10 +1170,14 @@ void ELFWriter::createSectionHdrEntries()
         }
     }
 
-    // .ze_info
+    // .ze_info or .ze_info.bin
     if (m_ObjBuilder.m_zeInfoSection) {
-        createSectionHdrEntry(m_ObjBuilder.m_ZEInfoName, SHT_ZEBIN_ZEINFO, 0,
-            m_ObjBuilder.m_zeInfoSection.get());
+        if (m_ObjBuilder.m_zeInfoBinaryFormat)
+            createSectionHdrEntry(m_ObjBuilder.m_ZEInfoBinName, SHT_ZEBIN_ZEINFO_BIN, 0,
+                m_ObjBuilder.m_zeInfoSection.get());
+        else
+            createSectionHdrEntry(m_ObjBuilder.m_ZEInfoName, SHT_ZEBIN_ZEINFO, 0,
+                m_ObjBuilder.m_zeInfoSection.get());
         ++index;
     }
 
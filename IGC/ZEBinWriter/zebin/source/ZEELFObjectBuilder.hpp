@@ -30,6 +30,7 @@ SPDX-License-Identifier: MIT
 #include "common/LLVMWarningsPop.hpp"
 #endif
 
+#include <list>
 #include <map>
 #include <memory>
 #include <string>
@@ -80,6 +81,15 @@ public:
     SectionID addSectionText(
         std::string name, const uint8_t* data, uint64_t size, uint32_t padding, uint32_t align);
 
+    // add a text section which shares the contents of a text section that has
+    // been added by addSectionText. Only one copy of the contents is written
+    // into the ELF file, and the section header of the alias refers to the
+    // same file offset and size as the aliasee's.
+    // - name: section name, the same as addSectionText
+    // - aliasee: the id returned by addSectionText of the section to be shared
+    // - return a unique id for referencing in addSymbol and relocations
+    SectionID addSectionTextAlias(std::string name, SectionID aliasee);
+
     // add a data section contains raw data, such as constant or global buffer.
     // - name: section name. Do not includes leading .data in given
     //         name. For example, giving "const", the section name will be
@@ -158,8 +168,17 @@ public:
     // - Note that the alignment requirement of the section should be satisfied
     //   by the given data and size
     // - Note that the given data buffer have to be alive through ZEELFObjectBuilder
+    // - Note that the data of a named section is written as is, so it must be
+    //   encoded as ELF notes already
     void addSectionMetrics(std::string name, const uint8_t* data, uint64_t size);
 
+    // add .note.intelgt.metrics.<kernel> section holding one
+    // NT_INTELGT_KERNEL_STATS note per given JSON object
+    // - kernel: the kernel name
+    // - stats: the statistics of each compiled SIMD variant of the kernel
+    void addSectionKernelStats(const std::string& kernel,
+                               const std::vector<std::string>& stats);
+
     // .debug_info section in DWARF format
     // - name: section name. The default name is .debug_info
     // - size in byte
@@ -173,6 +192,12 @@ public:
     // add ze_info section
     void addSectionZEInfo(zeInfoContainer& zeInfo);
 
+    // emit the ze_info section in the compact binary encoding (see
+    // ZEInfoBinary.hpp) instead of YAML. The section is then named
+    // .ze_info.bin and has SHT_ZEBIN_ZEINFO_BIN type.
+    void setZEInfoBinaryFormat(bool binary) { m_zeInfoBinaryFormat = binary; }
+    bool isZEInfoBinaryFormat() const       { return m_zeInfoBinaryFormat; }
+
     // add a symbol
     // - name    : symbol's name
     // - addr    : symbol's address. The binary offset of where this symbol is
@@ -210,8 +235,24 @@ public:
 
     // finalize - Finalize the ELF Object, write ELF file into given os
     // return number of written bytes
+    // The section contents are streamed from the buffers given when adding
+    // the sections, so with an unbuffered or file stream (e.g.
+    // llvm::raw_fd_ostream) no copy of the whole image is made.
     uint64_t finalize(llvm::raw_pwrite_stream& os);
 
+    // getBinarySize - Lay out the ELF Object and return the number of bytes
+    // the next finalize will write, without writing any section contents.
+    // All sections must have been added. The ze_info contents are encoded
+    // here and kept for the next finalize, which writes them and drops them,
+    // so they must not change in between.
+    uint64_t getBinarySize();
+
+    // finalize - Finalize the ELF Object, write ELF file directly into the
+    // given memory (for example a region allocated by the caller once the
+    // size is known). The buffer size must be at least getBinarySize().
+    // return number of written bytes, or 0 if the buffer is too small
+    uint64_t finalize(uint8_t* buffer, uint64_t bufferSize);
+
     // get an ID of a section
     // - name  : section name
     SectionID getSectionIDBySectionName(const char* name);
@@ -253,6 +294,8 @@ private:
         unsigned m_type;
         unsigned m_flags = 0;
         uint32_t m_padding;
+        // the section whose contents this section shares, -1 if none
+        SectionID m_aliasee = -1;
     };
 
     class ZEInfoSection : public Section {
@@ -266,8 +309,14 @@ private:
         zeInfoContainer& getZeInfo()
         { return m_zeinfo; }
 
+        // the serialized contents, kept from getBinarySize to the next
+        // finalize; empty otherwise
+        std::string& getEncoded()
+        { return m_encoded; }
+
     private:
         zeInfoContainer& m_zeinfo;
+        std::string m_encoded;
     };
 
     class Symbol {
@@ -361,6 +410,7 @@ private:
     const std::string m_VISAAsmName     = ".visaasm";
     const std::string m_DebugName       = ".debug_info";
     const std::string m_ZEInfoName      = ".ze_info";
+    const std::string m_ZEInfoBinName   = ".ze_info.bin";
     const std::string m_GTPinInfoName   = ".gtpin_info";
     const std::string m_MiscName        = ".misc";
     const std::string m_CompatNoteName  = ".note.intelgt.compat";
@@ -386,9 +436,13 @@ private:
 
     // every ze object contains at most one ze_info section
     std::unique_ptr<ZEInfoSection> m_zeInfoSection;
+    // emit ze_info in binary encoding instead of YAML
+    bool m_zeInfoBinaryFormat = false;
     SymbolListTy m_localSymbols;
     SymbolListTy m_globalSymbols;
 
+    // encoded notes of the .note.intelgt.metrics.<kernel> sections
+    std::list<std::string> m_kernelStatsNotes;
 };
 
 /// ZEInfoBuilder - Build a zeInfoContainer for .ze_info section
@@ -0,0 +1,570 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include <ZEInfoBinary.hpp>
+#include <ZEInfoYAML.hpp>
+
+#ifndef ZEBinStandAloneBuild
+#include "common/LLVMWarningsPush.hpp"
+#endif
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/LEB128.h"
+
+#ifndef ZEBinStandAloneBuild
+#include "common/LLVMWarningsPop.hpp"
+#endif
+
+#include "Probe/Assertion.h"
+
+using namespace zebin;
+using namespace llvm;
+
+namespace {
+
+/// EncodeIO - the output side of the field mapping below
+class EncodeIO {
+public:
+    static const bool Decoding = false;
+
+    EncodeIO(raw_ostream& os) : m_OS(os) {}
+
+    void scalar(zeinfo_int32_t& v)  { encodeSLEB128(v, m_OS); }
+    void scalar(zeinfo_int64_t& v)  { encodeSLEB128(v, m_OS); }
+    void scalar(zeinfo_bool_t& v)   { m_OS << char(v ? 1 : 0); }
+    void scalar(zeinfo_str_t& v) {
+        encodeULEB128(v.size(), m_OS);
+        m_OS << v;
+    }
+    void length(uint64_t& n)        { encodeULEB128(n, m_OS); }
+    void bytes(StringRef data)      { m_OS << data; }
+    bool failed() const             { return false; }
+
+private:
+    raw_ostream& m_OS;
+};
+
+/// DecodeIO - the input side of the field mapping below. On malformed input
+/// it sets the failed flag and yields default values from then on.
+///
+/// A DecodeIO created by subRecord() is bounded by the length prefix of the
+/// record. Reaching the end of the record before its last field is not an
+/// error: the record was written by an older minor version and the missing
+/// fields keep their default values. Trailing bytes a newer minor version
+/// appended to the record are skipped by the parent.
+class DecodeIO {
+public:
+    static const bool Decoding = true;
+
+    DecodeIO(const uint8_t* begin, const uint8_t* end, bool isRecord = false)
+        : m_cur(begin), m_end(end), m_isRecord(isRecord)
+    {}
+
+    void scalar(zeinfo_int32_t& v) {
+        if (!atRecordEnd())
+            v = (zeinfo_int32_t)readSLEB();
+    }
+    void scalar(zeinfo_int64_t& v) {
+        if (!atRecordEnd())
+            v = readSLEB();
+    }
+    void scalar(zeinfo_bool_t& v) {
+        if (atRecordEnd())
+            return;
+        if (m_cur >= m_end) {
+            m_failed = true;
+            v = false;
+            return;
+        }
+        v = *m_cur++ != 0;
+    }
+    void scalar(zeinfo_str_t& v) {
+        if (!atRecordEnd())
+            v = readString().str();
+    }
+
+    void length(uint64_t& n) {
+        if (atRecordEnd()) {
+            n = 0;
+            return;
+        }
+        n = readULEB();
+        // every element takes at least one byte
+        if (n > (uint64_t)(m_end - m_cur)) {
+            m_failed = true;
+            n = 0;
+        }
+    }
+
+    StringRef readString() {
+        uint64_t len = readULEB();
+        if (m_failed || len > (uint64_t)(m_end - m_cur)) {
+            m_failed = true;
+            return StringRef();
+        }
+        StringRef str((const char*)m_cur, len);
+        m_cur += len;
+        return str;
+    }
+
+    // subRecord - read the length prefix of a record and return a decoder
+    // bounded by it. The parent continues after the whole record.
+    DecodeIO subRecord() {
+        // a record missing from an older minor version is empty
+        if (atRecordEnd())
+            return DecodeIO(m_cur, m_cur, true);
+        uint64_t len = readULEB();
+        if (m_failed || len > (uint64_t)(m_end - m_cur)) {
+            m_failed = true;
+            return DecodeIO(m_end, m_end, true);
+        }
+        const uint8_t* begin = m_cur;
+        m_cur += len;
+        return DecodeIO(begin, m_cur, true);
+    }
+
+    bool failed() const { return m_failed; }
+    void setFailed()    { m_failed = true; }
+
+private:
+    bool atRecordEnd() const { return m_isRecord && !m_failed && m_cur == m_end; }
+
+    uint64_t readULEB() {
+        if (m_failed)
+            return 0;
+        unsigned n = 0;
+        const char* err = nullptr;
+        uint64_t v = decodeULEB128(m_cur, &n, m_end, &err);
+        if (err) {
+            m_failed = true;
+            return 0;
+        }
+        m_cur += n;
+        return v;
+    }
+
+    int64_t readSLEB() {
+        if (m_failed)
+            return 0;
+        unsigned n = 0;
+        const char* err = nullptr;
+        int64_t v = decodeSLEB128(m_cur, &n, m_end, &err);
+        if (err) {
+            m_failed = true;
+            return 0;
+        }
+        m_cur += n;
+        return v;
+    }
+
+private:
+    const uint8_t* m_cur;
+    const uint8_t* m_end;
+    bool m_isRecord;
+    bool m_failed = false;
+};
+
+/// ---------------- Field mapping ---------------------------------------- ///
+// The fields are mapped in their declaration order in ZEInfo.hpp. Any change
+// to that order or removing a field requires a ZEInfoBinaryFormat major
+// version bump, adding a field at the end of a struct a minor version bump.
+// Every struct is written as a record prefixed by its ULEB128 encoded byte
+// size (see mapRecord), which is what lets readers of a different minor
+// version skip or default the fields they do not know.
+// ZEInfo.hpp is generated and these lists are not: Tester::
+// testZEInfoBinaryFields (ZEInfoReader -test-ze-info) round trips a
+// ze_info with every field set and fails on a field missing here.
+
+template <typename IO> void mapValue(IO& io, zeinfo_int32_t& v) { io.scalar(v); }
+template <typename IO> void mapValue(IO& io, zeinfo_int64_t& v) { io.scalar(v); }
+template <typename IO> void mapValue(IO& io, zeinfo_bool_t& v)  { io.scalar(v); }
+template <typename IO> void mapValue(IO& io, zeinfo_str_t& v)   { io.scalar(v); }
+
+// mapValue of the zeInfo structs, defined after their mapFields below
+template <typename IO, typename T> void mapValue(IO& io, T& rec);
+
+template <typename IO, typename T>
+void mapValue(IO& io, std::vector<T>& vec)
+{
+    uint64_t n = vec.size();
+    io.length(n);
+    if (IO::Decoding)
+        vec.resize(n);
+    for (T& elem : vec) {
+        mapValue(io, elem);
+        if (io.failed())
+            return;
+    }
+}
+
+template <typename IO>
+void mapFields(IO& io, zeInfoUserAttribute& info)
+{
+    mapValue(io, info.intel_reqd_sub_group_size);
+    mapValue(io, info.intel_reqd_workgroup_walk_order);
+    mapValue(io, info.invalid_kernel);
+    mapValue(io, info.reqd_work_group_size);
+    mapValue(io, info.vec_type_hint);
+    mapValue(io, info.work_group_size_hint);
+}
+
+template <typename IO>
+void mapFields(IO& io, zeInfoExecutionEnv& info)
+{
+    mapValue(io, info.barrier_count);
+    mapValue(io, info.disable_mid_thread_preemption);
+    mapValue(io, info.grf_count);
+    mapValue(io, info.has_4gb_buffers);
+    mapValue(io, info.has_device_enqueue);
+    mapValue(io, info.has_dpas);
+    mapValue(io, info.has_fence_for_image_access);
+    mapValue(io, info.has_global_atomics);
+    mapValue(io, info.has_multi_scratch_spaces);
+    mapValue(io, info.has_no_stateless_write);
+    mapValue(io, info.has_stack_calls);
+    mapValue(io, info.require_disable_eufusion);
+    mapValue(io, info.indirect_stateless_count);
+    mapValue(io, info.inline_data_payload_size);
+    mapValue(io, info.offset_to_skip_per_thread_data_load);
+    mapValue(io, info.offset_to_skip_set_ffid_gp);
+    mapValue(io, info.required_sub_group_size);
+    mapValue(io, info.required_work_group_size);
+    mapValue(io, info.simd_size);
+    mapValue(io, info.slm_size);
+    mapValue(io, info.subgroup_independent_forward_progress);
+    mapValue(io, info.thread_scheduling_mode);
+    mapValue(io, info.work_group_walk_order_dimensions);
+    mapValue(io, info.eu_thread_count);
+    mapValue(io, info.has_sample);
+}
+
+template <typename IO>
+void mapFields(IO& io, zeInfoPayloadArgument& info)
+{
+    mapValue(io, info.arg_type);
+    mapValue(io, info.offset);
+    mapValue(io, info.size);
+    mapValue(io, info.arg_index);
+    mapValue(io, info.addrmode);
+    mapValue(io, info.addrspace);
+    mapValue(io, info.access_type);
+    mapValue(io, info.sampler_index);
+    mapValue(io, info.source_offset);
+    mapValue(io, info.slm_alignment);
+    mapValue(io, info.image_type);
+    mapValue(io, info.image_transformable);
+    mapValue(io, info.sampler_type);
+    mapValue(io, info.is_pipe);
+    mapValue(io, info.is_ptr);
+    mapValue(io, info.bti_value);
+}
+
+template <typename IO>
+void mapFields(IO& io, zeInfoPerThreadPayloadArgument& info)
+{
+    mapValue(io, info.arg_type);
+    mapValue(io, info.offset);
+    mapValue(io, info.size);
+}
+
+template <typename IO>
+void mapFields(IO& io, zeInfoBindingTableIndex& info)
+{
+    mapValue(io, info.bti_value);
+    mapValue(io, info.arg_index);
+}
+
+template <typename IO>
+void mapFields(IO& io, zeInfoPerThreadMemoryBuffer& info)
+{
+    mapValue(io, info.type);
+    mapValue(io, info.usage);
+    mapValue(io, info.size);
+    mapValue(io, info.slot);
+    mapValue(io, info.is_simt_thread);
+}
+
+template <typename IO>
+void mapFields(IO& io, zeInfoInlineSampler& info)
+{
+    mapValue(io, info.sampler_index);
+    mapValue(io, info.addrmode);
+    mapValue(io, info.filtermode);
+    mapValue(io, info.normalized);
+}
+
+template <typename IO>
+void mapFields(IO& io, zeInfoExperimentalProperties& info)
+{
+    mapValue(io, info.has_non_kernel_arg_load);
+    mapValue(io, info.has_non_kernel_arg_store);
+    mapValue(io, info.has_non_kernel_arg_atomic);
+}
+
+template <typename IO>
+void mapFields(IO& io, zeInfoDebugEnv& info)
+{
+    mapValue(io, info.sip_surface_bti);
+    mapValue(io, info.sip_surface_offset);
+}
+
+template <typename IO>
+void mapFields(IO& io, zeInfoHostAccess& info)
+{
+    mapValue(io, info.device_name);
+    mapValue(io, info.host_name);
+}
+
+template <typename IO>
+void mapFields(IO& io, zeInfoArgInfo& info)
+{
+    mapValue(io, info.index);
+    mapValue(io, info.name);
+    mapValue(io, info.address_qualifier);
+    mapValue(io, info.access_qualifier);
+    mapValue(io, info.type_name);
+    mapValue(io, info.type_qualifiers);
+}
+
+template <typename IO>
+void mapFields(IO& io, zeInfoKernel& info)
+{
+    // name must be the first field so that ZEInfoBinaryReader::getKernelName
+    // can read it without decoding the kernel
+    mapValue(io, info.name);
+    mapValue(io, info.user_attributes);
+    mapValue(io, info.execution_env);
+    mapValue(io, info.payload_arguments);
+    mapValue(io, info.per_thread_payload_arguments);
+    mapValue(io, info.binding_table_indices);
+    mapValue(io, info.per_thread_memory_buffers);
+    mapValue(io, info.inline_samplers);
+    mapValue(io, info.experimental_properties);
+    mapValue(io, info.debug_env);
+}
+
+template <typename IO>
+void mapFields(IO& io, zeInfoFunction& info)
+{
+    mapValue(io, info.name);
+    mapValue(io, info.execution_env);
+}
+
+template <typename IO>
+void mapFields(IO& io, zeInfoKernelMiscInfo& info)
+{
+    mapValue(io, info.name);
+    mapValue(io, info.args_info);
+}
+
+template <typename T>
+void mapRecord(EncodeIO& io, T& rec)
+{
+    SmallVector<char, 64> buf;
+    raw_svector_ostream bufOS(buf);
+    EncodeIO sub(bufOS);
+    mapFields(sub, rec);
+    uint64_t n = buf.size();
+    io.length(n);
+    io.bytes(StringRef(buf.data(), buf.size()));
+}
+
+template <typename T>
+void mapRecord(DecodeIO& io, T& rec)
+{
+    DecodeIO sub = io.subRecord();
+    if (io.failed())
+        return;
+    mapFields(sub, rec);
+    if (sub.failed())
+        io.setFailed();
+}
+
+template <typename IO, typename T>
+void mapValue(IO& io, T& rec)
+{
+    mapRecord(io, rec);
+}
+
+// the records following the kernels
+template <typename IO>
+void mapTail(IO& io, zeInfoContainer& info)
+{
+    mapValue(io, info.functions);
+    mapValue(io, info.global_host_access_table);
+    mapValue(io, info.kernels_misc_info);
+}
+
+} // anonymous namespace
+
+uint64_t ZEInfoBinaryWriter::write(const zeInfoContainer& zeInfo, raw_ostream& os)
+{
+    // The mapping functions are shared with the decoder and take non-const
+    // references. The encoder never modifies the given values.
+    zeInfoContainer& info = const_cast<zeInfoContainer&>(zeInfo);
+
+    SmallVector<char, 0> buf;
+    raw_svector_ostream bufOS(buf);
+    support::endian::Writer W(bufOS, support::little);
+    EncodeIO io(bufOS);
+
+    uint32_t numKernels = (uint32_t)info.kernels.size();
+    W.write<uint32_t>(ZEInfoBinaryFormat::Magic);
+    W.write<uint16_t>(ZEInfoBinaryFormat::MajorVersion);
+    W.write<uint16_t>(ZEInfoBinaryFormat::MinorVersion);
+    // total size and tail offset are patched after the records are written
+    W.write<uint32_t>(0);
+    W.write<uint32_t>(numKernels);
+    W.write<uint32_t>(0);
+    bufOS.write_zeros(numKernels * sizeof(uint32_t));
+
+    mapValue(io, info.version);
+
+    char* header = nullptr;
+    for (uint32_t i = 0; i < numKernels; ++i) {
+        uint32_t off = (uint32_t)buf.size();
+        mapValue(io, info.kernels[i]);
+        header = buf.data();
+        support::endian::write32le(
+            header + ZEInfoBinaryFormat::HeaderSize + i * sizeof(uint32_t), off);
+    }
+
+    uint32_t tailOff = (uint32_t)buf.size();
+    mapTail(io, info);
+
+    header = buf.data();
+    support::endian::write32le(header + 8, (uint32_t)buf.size());
+    support::endian::write32le(header + 16, tailOff);
+
+    os.write(buf.data(), buf.size());
+    return buf.size();
+}
+
+bool ZEInfoBinaryReader::isBinaryZEInfo(const uint8_t* data, uint64_t size)
+{
+    return data != nullptr && size >= ZEInfoBinaryFormat::HeaderSize &&
+        support::endian::read32le(data) == ZEInfoBinaryFormat::Magic;
+}
+
+bool ZEInfoBinaryReader::init()
+{
+    if (!isBinaryZEInfo(m_data, m_size)) {
+        m_error = "not a binary ze_info";
+        return false;
+    }
+    uint16_t major = support::endian::read16le(m_data + 4);
+    if (major != ZEInfoBinaryFormat::MajorVersion) {
+        m_error = "unsupported binary ze_info format version " + std::to_string(major);
+        return false;
+    }
+    uint32_t totalSize = support::endian::read32le(m_data + 8);
+    if (totalSize > m_size) {
+        m_error = "truncated binary ze_info";
+        return false;
+    }
+    m_size = totalSize;
+    m_numKernels = support::endian::read32le(m_data + 12);
+    m_tailOffset = support::endian::read32le(m_data + 16);
+
+    uint64_t tableEnd = ZEInfoBinaryFormat::HeaderSize +
+        (uint64_t)m_numKernels * sizeof(uint32_t);
+    if (tableEnd > m_size || m_tailOffset < tableEnd || m_tailOffset > m_size) {
+        m_error = "malformed binary ze_info header";
+        return false;
+    }
+    for (uint32_t i = 0; i < m_numKernels; ++i) {
+        uint32_t off = getKernelOffset(i);
+        if (off < tableEnd || off >= m_tailOffset) {
+            m_error = "malformed binary ze_info kernel offset table";
+            return false;
+        }
+    }
+
+    DecodeIO io(m_data + tableEnd, m_data + m_size);
+    m_version = io.readString();
+    if (io.failed()) {
+        m_error = "malformed binary ze_info version";
+        return false;
+    }
+    return true;
+}
+
+uint32_t ZEInfoBinaryReader::getKernelOffset(uint32_t idx) const
+{
+    IGC_ASSERT(idx < m_numKernels);
+    return support::endian::read32le(
+        m_data + ZEInfoBinaryFormat::HeaderSize + idx * sizeof(uint32_t));
+}
+
+StringRef ZEInfoBinaryReader::getKernelName(uint32_t idx) const
+{
+    DecodeIO io(m_data + getKernelOffset(idx), m_data + m_tailOffset);
+    DecodeIO rec = io.subRecord();
+    if (io.failed())
+        return StringRef();
+    return rec.readString();
+}
+
+bool ZEInfoBinaryReader::readKernel(uint32_t idx, zeInfoKernel& kernel) const
+{
+    DecodeIO io(m_data + getKernelOffset(idx), m_data + m_tailOffset);
+    mapValue(io, kernel);
+    if (io.failed()) {
+        m_error = "malformed binary ze_info kernel record " + std::to_string(idx);
+        return false;
+    }
+    return true;
+}
+
+bool ZEInfoBinaryReader::read(zeInfoContainer& zeInfo) const
+{
+    zeInfo.version = m_version.str();
+    zeInfo.kernels.resize(m_numKernels);
+    for (uint32_t i = 0; i < m_numKernels; ++i) {
+        if (!readKernel(i, zeInfo.kernels[i]))
+            return false;
+    }
+
+    // the tail is bounded by the total size like a record, so that tail
+    // fields added by a newer minor version are ignored
+    DecodeIO io(m_data + m_tailOffset, m_data + m_size, /*isRecord=*/true);
+    mapTail(io, zeInfo);
+    if (io.failed()) {
+        m_error = "malformed binary ze_info";
+        return false;
+    }
+    return true;
+}
+
+bool zebin::convertZEInfoBinaryToYAML(const uint8_t* data, uint64_t size,
+    raw_ostream& os, std::string* error)
+{
+    ZEInfoBinaryReader reader(data, size);
+    zeInfoContainer zeInfo;
+    if (!reader.init() || !reader.read(zeInfo)) {
+        if (error)
+            *error = reader.getError();
+        return false;
+    }
+    yaml::Output yout(os);
+    yout << zeInfo;
+    return true;
+}
+
+bool zebin::convertZEInfoYAMLToBinary(StringRef yamlText, raw_ostream& os)
+{
+    zeInfoContainer zeInfo;
+    yaml::Input yin(yamlText);
+    yin >> zeInfo;
+    if (yin.error())
+        return false;
+    ZEInfoBinaryWriter::write(zeInfo, os);
+    return true;
+}
@@ -0,0 +1,133 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+//===- ZEInfoBinary.hpp -----------------------------------------*- C++ -*-===//
+// ZE Binary Utilities
+//
+// \file
+// This file declares the compact binary encoding of .ze_info contents
+//===----------------------------------------------------------------------===//
+
+#ifndef ZE_INFO_BINARY_HPP
+#define ZE_INFO_BINARY_HPP
+
+#include <ZEInfo.hpp>
+
+#ifndef ZEBinStandAloneBuild
+#include "common/LLVMWarningsPush.hpp"
+#endif
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+#ifndef ZEBinStandAloneBuild
+#include "common/LLVMWarningsPop.hpp"
+#endif
+
+#include <cstdint>
+#include <string>
+
+namespace zebin {
+
+/// Binary ze_info layout (all fixed-size fields are little endian):
+///
+///   uint32_t magic              'ZEIB'
+///   uint16_t format major       bumped when the field order of any zeInfo
+///                               struct changes
+///   uint16_t format minor       bumped for backward-compatible additions
+///   uint32_t total size         size of the whole encoding in byte
+///   uint32_t number of kernels
+///   uint32_t tail offset        offset of the functions/host-access/misc-info
+///                               records
+///   uint32_t kernel offsets[number of kernels]
+///   str      zeinfo version
+///   kernel records ...
+///   tail records ...
+///
+/// Every zeInfo struct is encoded as a record prefixed by its ULEB128 encoded
+/// byte size, holding its fields in declaration order. Integers inside the
+/// records are SLEB128 encoded, bools take one byte, strings and vectors are
+/// prefixed by their ULEB128 encoded length. The kernel offset table allows a
+/// reader to access a single kernel without decoding the ones before it.
+///
+/// Within a major version, a reader skips the trailing fields a newer minor
+/// version appended to a record, and fields missing from a record written by
+/// an older minor version keep their default values.
+struct ZEInfoBinaryFormat {
+    static const uint32_t Magic = 0x4249455a; // "ZEIB"
+    static const uint16_t MajorVersion = 1;
+    static const uint16_t MinorVersion = 0;
+    // magic, version, total size, number of kernels and tail offset
+    static const uint32_t HeaderSize = 20;
+};
+
+/// ZEInfoBinaryWriter - Encode a zeInfoContainer into the binary format
+class ZEInfoBinaryWriter {
+public:
+    // write the binary encoding of zeInfo into os, return number of written
+    // bytes
+    static uint64_t write(const zeInfoContainer& zeInfo, llvm::raw_ostream& os);
+};
+
+/// ZEInfoBinaryReader - Zero-copy reader of the binary ze_info encoding.
+/// The reader only references the given buffer, which must be live through
+/// the reader. Kernel names are returned as references into the buffer and
+/// a single kernel can be decoded without decoding the others.
+class ZEInfoBinaryReader {
+public:
+    ZEInfoBinaryReader(const uint8_t* data, uint64_t size)
+        : m_data(data), m_size(size)
+    {}
+
+    // validate the header and the kernel offset table, must be called
+    // before any other query. Return false if the given buffer is not a
+    // valid encoding and set the error message.
+    bool init();
+
+    // isBinaryZEInfo - return true if the given buffer starts with the binary
+    // ze_info magic
+    static bool isBinaryZEInfo(const uint8_t* data, uint64_t size);
+
+    llvm::StringRef getVersion() const { return m_version; }
+    uint32_t getNumKernels() const     { return m_numKernels; }
+
+    // get the name of the idx-th kernel without decoding the kernel
+    llvm::StringRef getKernelName(uint32_t idx) const;
+
+    // decode the idx-th kernel
+    bool readKernel(uint32_t idx, zeInfoKernel& kernel) const;
+
+    // decode the whole container
+    bool read(zeInfoContainer& zeInfo) const;
+
+    const std::string& getError() const { return m_error; }
+
+private:
+    uint32_t getKernelOffset(uint32_t idx) const;
+
+private:
+    const uint8_t* m_data;
+    uint64_t m_size;
+    uint32_t m_numKernels = 0;
+    uint32_t m_tailOffset = 0;
+    llvm::StringRef m_version;
+    mutable std::string m_error;
+};
+
+// convertZEInfoBinaryToYAML - decode the binary ze_info in the given buffer
+// and emit it as YAML text into os. Return false if the decoding failed.
+bool convertZEInfoBinaryToYAML(const uint8_t* data, uint64_t size,
+    llvm::raw_ostream& os, std::string* error = nullptr);
+
+// convertZEInfoYAMLToBinary - parse the given YAML text and emit its binary
+// encoding into os. Return false if the YAML parsing failed.
+bool convertZEInfoYAMLToBinary(llvm::StringRef yaml, llvm::raw_ostream& os);
+
+} // namespace zebin
+
+#endif // ZE_INFO_BINARY_HPP
@@ -0,0 +1,354 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "common/CleanupPassCache.h"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Metadata.h>
+#include <llvm/IR/Module.h>
+#include <llvm/PassInfo.h>
+#include "common/LLVMWarningsPop.hpp"
+
+using namespace llvm;
+
+namespace {
+// Metadata attached to V: for instructions the !dbg location and all other
+// kinds, for functions and globals their attachments.
+template <typename T>
+hash_code hashMetadata(hash_code H, const T& V)
+{
+    SmallVector<std::pair<unsigned, MDNode*>, 4> MDs;
+    V.getAllMetadata(MDs);
+    for (auto& MD : MDs)
+    {
+        H = hash_combine(H, MD.first, MD.second);
+    }
+    return H;
+}
+
+// Position of the arguments, blocks and instructions of a function.
+using LocalIds = DenseMap<const Value*, unsigned>;
+
+// The parts of an operand that can change without the operand itself
+// changing: the attributes of a callee and the constness and initializer of
+// a global variable, also when used through a constant expression. Values
+// local to the function are hashed by position.
+hash_code hashOperand(hash_code H, const Value* Op, const LocalIds& Ids)
+{
+    if (isa<Instruction>(Op) || isa<Argument>(Op) || isa<BasicBlock>(Op))
+    {
+        return hash_combine(H, Op->getValueID(), Ids.lookup(Op));
+    }
+    if (auto* MAV = dyn_cast<MetadataAsValue>(Op))
+    {
+        if (auto* LAM = dyn_cast<LocalAsMetadata>(MAV->getMetadata()))
+        {
+            return hashOperand(hash_combine(H, Op->getValueID()), LAM->getValue(), Ids);
+        }
+    }
+    H = hash_combine(H, Op);
+    if (isa<ConstantExpr>(Op) || isa<ConstantAggregate>(Op))
+    {
+        // Not kept alive by the context: hash the contents as well
+        H = hash_combine(H, Op->getValueID(), Op->getType());
+        for (const Value* CEOp : cast<User>(Op)->operand_values())
+        {
+            H = hashOperand(H, CEOp, Ids);
+        }
+    }
+    else if (auto* GV = dyn_cast<GlobalVariable>(Op))
+    {
+        H = hash_combine(H, GV->getName(), GV->isConstant(),
+            GV->hasInitializer() ? GV->getInitializer() : nullptr);
+    }
+    else if (auto* Callee = dyn_cast<Function>(Op))
+    {
+        H = hash_combine(H, Callee->getName(), Callee->getAttributes().getRawPointer(),
+            Callee->isDeclaration());
+    }
+    return H;
+}
+
+// The data an instruction keeps outside of its operands and optional flags.
+hash_code hashInstructionData(hash_code H, const Instruction& I, const LocalIds& Ids)
+{
+    if (auto* Cmp = dyn_cast<CmpInst>(&I))
+    {
+        H = hash_combine(H, Cmp->getPredicate());
+    }
+    else if (auto* Phi = dyn_cast<PHINode>(&I))
+    {
+        for (const BasicBlock* Pred : Phi->blocks())
+        {
+            H = hash_combine(H, Ids.lookup(Pred));
+        }
+    }
+    else if (auto* LI = dyn_cast<LoadInst>(&I))
+    {
+        H = hash_combine(H, LI->getAlignment(), LI->isVolatile(),
+            LI->getOrdering(), LI->getSyncScopeID());
+    }
+    else if (auto* SI = dyn_cast<StoreInst>(&I))
+    {
+        H = hash_combine(H, SI->getAlignment(), SI->isVolatile(),
+            SI->getOrdering(), SI->getSyncScopeID());
+    }
+    else if (auto* AI = dyn_cast<AllocaInst>(&I))
+    {
+        H = hash_combine(H, AI->getAllocatedType(), AI->getAlignment());
+    }
+    else if (auto* GEP = dyn_cast<GetElementPtrInst>(&I))
+    {
+        H = hash_combine(H, GEP->getSourceElementType());
+    }
+    else if (auto* RMW = dyn_cast<AtomicRMWInst>(&I))
+    {
+        H = hash_combine(H, RMW->getOperation(), RMW->isVolatile(),
+            RMW->getOrdering(), RMW->getSyncScopeID());
+    }
+    else if (auto* CmpXchg = dyn_cast<AtomicCmpXchgInst>(&I))
+    {
+        H = hash_combine(H, CmpXchg->isVolatile(), CmpXchg->isWeak(),
+            CmpXchg->getSuccessOrdering(), CmpXchg->getFailureOrdering(),
+            CmpXchg->getSyncScopeID());
+    }
+    else if (auto* Fence = dyn_cast<FenceInst>(&I))
+    {
+        H = hash_combine(H, Fence->getOrdering(), Fence->getSyncScopeID());
+    }
+    else if (auto* Call = dyn_cast<CallBase>(&I))
+    {
+        H = hash_combine(H, Call->getFunctionType(), Call->getCallingConv(),
+            Call->getAttributes().getRawPointer());
+        if (auto* CI = dyn_cast<CallInst>(Call))
+        {
+            H = hash_combine(H, CI->getTailCallKind());
+        }
+    }
+    else if (auto* EV = dyn_cast<ExtractValueInst>(&I))
+    {
+        H = hash_combine(H, hash_combine_range(EV->idx_begin(), EV->idx_end()));
+    }
+    else if (auto* IV = dyn_cast<InsertValueInst>(&I))
+    {
+        H = hash_combine(H, hash_combine_range(IV->idx_begin(), IV->idx_end()));
+    }
+    else if (auto* SV = dyn_cast<ShuffleVectorInst>(&I))
+    {
+        SmallVector<int, 16> Mask;
+        SV->getShuffleMask(Mask);
+        H = hash_combine(H, hash_combine_range(Mask.begin(), Mask.end()));
+    }
+    return H;
+}
+
+// Runs right before or right after a cleanup pass and tells the cache.
+class SkipUnchangedPass : public FunctionPass
+{
+public:
+    static char ID;
+
+    SkipUnchangedPass(const Pass* pass, IGC::CleanupPassCache& cache, bool isBegin)
+        : FunctionPass(ID), m_pass(pass), m_cache(cache), m_isBegin(isBegin) {}
+
+    void getAnalysisUsage(AnalysisUsage& AU) const override
+    {
+        AU.setPreservesAll();
+    }
+
+    StringRef getPassName() const override
+    {
+        return m_isBegin ? "Skip Unchanged Begin" : "Skip Unchanged End";
+    }
+
+    bool doInitialization(Module& M) override
+    {
+        m_cache.installGate(M.getContext());
+        return false;
+    }
+
+    bool doFinalization(Module&) override
+    {
+        m_cache.removeGate();
+        return false;
+    }
+
+    bool runOnFunction(Function& F) override
+    {
+        if (m_isBegin)
+            m_cache.beginPass(m_pass, F);
+        else
+            m_cache.endPass(m_pass, F);
+        return false;
+    }
+
+private:
+    const Pass* m_pass;
+    IGC::CleanupPassCache& m_cache;
+    bool m_isBegin;
+};
+
+char SkipUnchangedPass::ID = 0;
+} // namespace
+
+namespace IGC
+{
+hash_code getFunctionFingerprint(const Function& F)
+{
+    LocalIds Ids;
+    for (const Argument& Arg : F.args())
+    {
+        Ids.try_emplace(&Arg, Ids.size());
+    }
+    for (const BasicBlock& BB : F)
+    {
+        Ids.try_emplace(&BB, Ids.size());
+        for (const Instruction& I : BB)
+        {
+            Ids.try_emplace(&I, Ids.size());
+        }
+    }
+
+    hash_code H = hash_combine(F.getName(), F.size(), F.getFunctionType(),
+        F.getCallingConv(), F.getAttributes().getRawPointer());
+    H = hashMetadata(H, F);
+    for (const BasicBlock& BB : F)
+    {
+        H = hash_combine(H, BB.size());
+        for (const Instruction& I : BB)
+        {
+            H = hash_combine(H, I.getOpcode(), I.getType(),
+                I.getRawSubclassOptionalData());
+            for (const Value* Op : I.operand_values())
+            {
+                H = hashOperand(H, Op, Ids);
+            }
+            H = hashInstructionData(H, I, Ids);
+            H = hashMetadata(H, I);
+        }
+    }
+    return H;
+}
+
+CleanupPassCache::~CleanupPassCache()
+{
+    removeGate();
+}
+
+unsigned CleanupPassCache::getEpoch(Function& F)
+{
+    hash_code H = getFunctionFingerprint(F);
+    auto Res = m_functions.try_emplace(&F);
+    FunctionState& State = Res.first->second;
+    if (Res.second || State.fingerprint != H)
+    {
+        State.fingerprint = H;
+        State.epoch++;
+    }
+    return State.epoch;
+}
+
+void CleanupPassCache::beginPass(const Pass* P, Function& F)
+{
+    m_skipped = false;
+    m_skipPending = nullptr;
+    auto It = m_lastRun.find(std::make_pair(P->getPassID(), (const Function*)&F));
+    if (It != m_lastRun.end() && It->second == getEpoch(F))
+    {
+        m_skipPending = P;
+    }
+}
+
+void CleanupPassCache::endPass(const Pass* P, Function& F)
+{
+    auto& Stats = stats[P->getPassName().str()];
+    if (m_skipped)
+    {
+        Stats.second++;
+    }
+    else
+    {
+        // Also when P did not ask the gate
+        Stats.first++;
+        m_lastRun[std::make_pair(P->getPassID(), (const Function*)&F)] = getEpoch(F);
+    }
+    m_skipped = false;
+    m_skipPending = nullptr;
+}
+
+#if LLVM_VERSION_MAJOR >= 16
+bool CleanupPassCache::shouldRunPass(const StringRef PassName, StringRef IRDescription)
+{
+    if (m_skipPending && m_skipPending->getPassName() == PassName)
+    {
+        m_skipPending = nullptr;
+        m_skipped = true;
+        return false;
+    }
+    return !m_prevGate || !m_prevGate->isEnabled() ||
+        m_prevGate->shouldRunPass(PassName, IRDescription);
+}
+#else
+bool CleanupPassCache::shouldRunPass(const Pass* P, StringRef IRDescription)
+{
+    if (m_skipPending && m_skipPending == P)
+    {
+        m_skipPending = nullptr;
+        m_skipped = true;
+        return false;
+    }
+    return !m_prevGate || !m_prevGate->isEnabled() ||
+        m_prevGate->shouldRunPass(P, IRDescription);
+}
+#endif
+
+void CleanupPassCache::installGate(LLVMContext& Ctx)
+{
+    if (m_gateContext)
+        return;
+    m_gateContext = &Ctx;
+    m_prevGate = &Ctx.getOptPassGate();
+    Ctx.setOptPassGate(*this);
+}
+
+void CleanupPassCache::removeGate()
+{
+    if (!m_gateContext)
+        return;
+    m_gateContext->setOptPassGate(*m_prevGate);
+    m_gateContext = nullptr;
+    m_prevGate = nullptr;
+}
+
+bool isCleanupPass(Pass* P)
+{
+    if (P->getPassKind() != PT_Function)
+        return false;
+    const PassInfo* PI = Pass::lookupPassInfo(P->getPassID());
+    if (!PI)
+        return false;
+    StringRef Arg = PI->getPassArgument();
+    return Arg == "dce" || Arg == "sroa" || Arg == "simplifycfg" ||
+        Arg == "early-cse" || Arg == "early-cse-memssa" ||
+        Arg == "instcombine" || Arg == "gvn";
+}
+
+FunctionPass* createSkipUnchangedBeginPass(const Pass* P, CleanupPassCache& cache)
+{
+    return new SkipUnchangedPass(P, cache, true);
+}
+
+FunctionPass* createSkipUnchangedEndPass(const Pass* P, CleanupPassCache& cache)
+{
+    return new SkipUnchangedPass(P, cache, false);
+}
+} // namespace IGC
@@ -0,0 +1,95 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/Hashing.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/OptBisect.h>
+#include <llvm/Pass.h>
+#include "common/LLVMWarningsPop.hpp"
+#include <map>
+#include <string>
+#include <utility>
+
+namespace IGC
+{
+    // State shared by the cleanup passes of one IGCPassManager under
+    // SkipUnchangedCleanupPasses.
+    //
+    // Every function has a modification epoch that goes up whenever the
+    // function is found changed, and every (cleanup pass, function) pair the
+    // epoch of the function right after that kind of pass last ran on it. A
+    // cleanup pass is skipped on a function whose epoch did not move since.
+    // The skip goes through the OptPassGate of the LLVMContext, which the
+    // cleanup passes consult in skipFunction(), so they run in the pass
+    // manager with their own analyses as usual.
+    class CleanupPassCache : public llvm::OptPassGate
+    {
+    public:
+        ~CleanupPassCache();
+
+        // pass name -> (functions run on, functions skipped)
+        std::map<std::string, std::pair<unsigned, unsigned>> stats;
+
+        // Called right before and right after P runs on F.
+        void beginPass(const llvm::Pass* P, llvm::Function& F);
+        void endPass(const llvm::Pass* P, llvm::Function& F);
+
+        // Installs the cache as the gate of Ctx until removeGate.
+        void installGate(llvm::LLVMContext& Ctx);
+        void removeGate();
+
+#if LLVM_VERSION_MAJOR >= 16
+        bool shouldRunPass(const llvm::StringRef PassName, llvm::StringRef IRDescription) override;
+#else
+        bool shouldRunPass(const llvm::Pass* P, llvm::StringRef IRDescription) override;
+#endif
+        bool isEnabled() const override { return true; }
+
+    private:
+        struct FunctionState
+        {
+            llvm::hash_code fingerprint = 0;
+            unsigned epoch = 0;
+        };
+
+        // Updates and returns the epoch of F.
+        unsigned getEpoch(llvm::Function& F);
+
+        llvm::DenseMap<const llvm::Function*, FunctionState> m_functions;
+        llvm::DenseMap<std::pair<const void*, const llvm::Function*>, unsigned> m_lastRun;
+        // The pass to skip on the function it is about to run on, and
+        // whether the pass asked the gate
+        const llvm::Pass* m_skipPending = nullptr;
+        bool m_skipped = false;
+        llvm::LLVMContext* m_gateContext = nullptr;
+        llvm::OptPassGate* m_prevGate = nullptr;
+    };
+
+    // Hash of everything a cleanup pass can look at in F: the instructions
+    // with their operands, flags, alignment, atomic ordering, metadata and
+    // attributes, and the attributes of F, of its callees and the constness
+    // and initializers of the globals it uses. Blocks, arguments and
+    // instructions are identified by their position in F and not by their
+    // address, which can be reused after they are freed. Equal fingerprints
+    // mean that F was not changed in between.
+    llvm::hash_code getFunctionFingerprint(const llvm::Function& F);
+
+    // True for the cleanup passes that are scheduled over and over in the
+    // pipelines: DCE, SROA, SimplifyCFG, EarlyCSE, InstCombine and GVN.
+    bool isCleanupPass(llvm::Pass* P);
+
+    // The passes to add right before and right after the cleanup pass P.
+    llvm::FunctionPass* createSkipUnchangedBeginPass(const llvm::Pass* P, CleanupPassCache& cache);
+    llvm::FunctionPass* createSkipUnchangedEndPass(const llvm::Pass* P, CleanupPassCache& cache);
+}
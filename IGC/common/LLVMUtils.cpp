@@ -14,13 +14,18 @@ SPDX-License-Identifier: MIT
 #include "common/shaderOverride.hpp"
 #include "common/IntrinsicAnnotator.hpp"
 #include "common/LLVMUtils.h"
+#include "common/CleanupPassCache.h"
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <unordered_map>
 #include <string>
 
 #include "common/LLVMWarningsPush.hpp"
+#include <llvm/IR/Instructions.h>
 #include <llvm/IR/Module.h>
+#include <llvm/IR/OptBisect.h>
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvmWrapper/ADT/StringRef.h>
@@ -78,6 +83,162 @@ llvm::Pass* createFlushPass(llvm::Pass* pass, Dump& dump)
     return nullptr;
 }
 
+namespace {
+// Run a callback between two passes. The callback is run by a pass of the
+// same kind as the pass next to it, so that the pass pipelining done by the
+// pass manager is not changed.
+class ModuleCallbackPass : public llvm::ModulePass
+{
+public:
+    static char ID;
+
+    ModuleCallbackPass(const char* name, std::function<void()> callback)
+        : ModulePass(ID), m_name(name), m_callback(std::move(callback)) {}
+
+    void getAnalysisUsage(llvm::AnalysisUsage& AU) const override
+    {
+        AU.setPreservesAll();
+    }
+
+    llvm::StringRef getPassName() const override
+    {
+        return m_name;
+    }
+
+    bool runOnModule(llvm::Module&) override
+    {
+        m_callback();
+        return false;
+    }
+
+private:
+    const char* m_name;
+    std::function<void()> m_callback;
+};
+
+class FunctionCallbackPass : public llvm::FunctionPass
+{
+public:
+    static char ID;
+
+    FunctionCallbackPass(const char* name, std::function<void()> callback)
+        : FunctionPass(ID), m_name(name), m_callback(std::move(callback)) {}
+
+    void getAnalysisUsage(llvm::AnalysisUsage& AU) const override
+    {
+        AU.setPreservesAll();
+    }
+
+    llvm::StringRef getPassName() const override
+    {
+        return m_name;
+    }
+
+    bool runOnFunction(llvm::Function&) override
+    {
+        m_callback();
+        return false;
+    }
+
+private:
+    const char* m_name;
+    std::function<void()> m_callback;
+};
+
+char ModuleCallbackPass::ID = 0;
+char FunctionCallbackPass::ID = 0;
+
+llvm::Pass* createCallbackPass(llvm::Pass* pass, const char* name, std::function<void()> callback)
+{
+    switch (pass->getPassKind())
+    {
+    case PT_Function:
+        return new FunctionCallbackPass(name, std::move(callback));
+    case PT_Module:
+        return new ModuleCallbackPass(name, std::move(callback));
+    default:
+        // loop/region/scc passes are covered by the function or module pass
+        // that runs them
+        break;
+    }
+    return nullptr;
+}
+
+// Once the compile budget is exceeded, the remaining optional passes are
+// skipped. The optional passes are the ones asking the OptPassGate of the
+// context in skipFunction()/skipModule(), that is the LLVM optimizations
+// -opt-bisect-limit can drop and optnone functions go without; the IGC passes
+// lowering the IR do not ask and always run. The budget is checked each time
+// such a pass is about to run. The gate is the first pass of the pass manager
+// and is installed from its initialization to its finalization, so around all
+// the other passes.
+class CompileBudgetGate : public llvm::ModulePass, public llvm::OptPassGate
+{
+public:
+    static char ID;
+
+    CompileBudgetGate(CodeGenContext* ctx) : ModulePass(ID), m_ctx(ctx) {}
+
+    void getAnalysisUsage(llvm::AnalysisUsage& AU) const override
+    {
+        AU.setPreservesAll();
+    }
+
+    llvm::StringRef getPassName() const override
+    {
+        return "Compile Budget Gate";
+    }
+
+    bool runOnModule(llvm::Module&) override
+    {
+        return false;
+    }
+
+    bool doInitialization(llvm::Module& M) override
+    {
+        m_gateContext = &M.getContext();
+        m_prevGate = &m_gateContext->getOptPassGate();
+        m_gateContext->setOptPassGate(*this);
+        return false;
+    }
+
+    bool doFinalization(llvm::Module&) override
+    {
+        if (m_gateContext)
+        {
+            m_gateContext->setOptPassGate(*m_prevGate);
+            m_gateContext = nullptr;
+        }
+        return false;
+    }
+
+#if LLVM_VERSION_MAJOR >= 16
+    bool shouldRunPass(const llvm::StringRef PassName, llvm::StringRef IRDescription) override
+    {
+        if (m_ctx->isCompileBudgetExceeded())
+            return false;
+        return !m_prevGate->isEnabled() || m_prevGate->shouldRunPass(PassName, IRDescription);
+    }
+#else
+    bool shouldRunPass(const llvm::Pass* P, llvm::StringRef IRDescription) override
+    {
+        if (m_ctx->isCompileBudgetExceeded())
+            return false;
+        return !m_prevGate->isEnabled() || m_prevGate->shouldRunPass(P, IRDescription);
+    }
+#endif
+    bool isEnabled() const override { return true; }
+
+private:
+    CodeGenContext* m_ctx;
+    llvm::LLVMContext* m_gateContext = nullptr;
+    llvm::OptPassGate* m_prevGate = nullptr;
+};
+
+char CompileBudgetGate::ID = 0;
+} // namespace
+
+
 /*
 ShaderPassDisable
 The syntax is as follows:
@@ -581,6 +742,32 @@ void displayAllPasses(const Pass* P)
     countPass++;
 }
 
+IGCPassManager::IGCPassManager(CodeGenContext* ctx, const char* name)
+    : m_pContext(ctx), m_name(name)
+{
+    if (IGC_IS_FLAG_ENABLED(SkipUnchangedCleanupPasses))
+    {
+        m_cleanupCache = std::make_unique<CleanupPassCache>();
+    }
+    if (m_pContext->getCompileBudgetMs() != 0)
+    {
+        PassManager::add(new CompileBudgetGate(m_pContext));
+    }
+}
+
+IGCPassManager::~IGCPassManager()
+{
+    if (m_cleanupCache && IGC_IS_FLAG_ENABLED(PrintCleanupPassSkips))
+    {
+        for (auto& S : m_cleanupCache->stats)
+        {
+            errs() << m_name << ": " << S.first << ": skipped on "
+                   << S.second.second << " of " << S.second.first + S.second.second
+                   << " functions\n";
+        }
+    }
+}
+
 void IGCPassManager::add(Pass *P)
 {
     //check only once
@@ -650,8 +837,41 @@ void IGCPassManager::add(Pass *P)
         PassManager::add(createTimeStatsIGCPass(m_pContext, m_name + '_' + std::string(P->getPassName()), STATS_COUNTER_START));
     }
 
+    // Record a span named after the pass, the begin and end passes share
+    // the name.
+    std::shared_ptr<const std::string> traceName;
+    if (vISA::CompileTrace::isEnabled() && !isAnalysisPass)
+    {
+        traceName = std::make_shared<const std::string>(P->getPassName().str());
+        if (llvm::Pass* tracePass = createCallbackPass(P, "Compile Trace Begin",
+                [traceName]() { vISA::CompileTrace::begin("IGC pass", *traceName); }))
+        {
+            PassManager::add(tracePass);
+        }
+    }
+
+    const bool skipUnchanged = m_cleanupCache && isCleanupPass(P);
+    if (skipUnchanged)
+    {
+        PassManager::add(createSkipUnchangedBeginPass(P, *m_cleanupCache));
+    }
+
     PassManager::add(P);
 
+    if (skipUnchanged)
+    {
+        PassManager::add(createSkipUnchangedEndPass(P, *m_cleanupCache));
+    }
+
+    if (traceName)
+    {
+        if (llvm::Pass* tracePass = createCallbackPass(P, "Compile Trace End",
+                [traceName]() { vISA::CompileTrace::end(*traceName); }))
+        {
+            PassManager::add(tracePass);
+        }
+    }
+
     if (IGC_REGKEY_OR_FLAG_ENABLED(DumpTimeStatsPerPass, TIME_STATS_PER_PASS))
     {
         PassManager::add(createTimeStatsIGCPass(m_pContext, m_name + '_' + std::string(P->getPassName()), STATS_COUNTER_END));
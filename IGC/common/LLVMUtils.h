@@ -12,6 +12,7 @@ SPDX-License-Identifier: MIT
 #include <llvm/IR/LegacyPassManager.h>
 #include "common/LLVMWarningsPop.hpp"
 #include <list>
+#include <memory>
 #include "Stats.hpp"
 #include <string.h>
 
@@ -22,18 +23,20 @@ namespace IGC
         class Dump;
     }
     class CodeGenContext;
+    class CleanupPassCache;
 
     class IGCPassManager : public llvm::legacy::PassManager
     {
     public:
-        IGCPassManager(CodeGenContext* ctx, const char* name = "") : m_pContext(ctx), m_name(name)
-        {
-        }
+        IGCPassManager(CodeGenContext* ctx, const char* name = "");
+        ~IGCPassManager();
         void add(llvm::Pass *P);
     private:
         CodeGenContext* const m_pContext;
         const std::string m_name;
         std::list<Debug::Dump> m_irDumps;
+        // Modification epochs for SkipUnchangedCleanupPasses
+        std::unique_ptr<CleanupPassCache> m_cleanupCache;
 
         void addPrintPass(llvm::Pass* P, bool isBefore);
         bool isPrintBefore(llvm::Pass* P);
@@ -404,6 +404,7 @@ namespace IGC
         bool MatchSinCosPi                              = false;
         bool ExcludeIRFromZEBinary                      = false;
         bool EmitZeBinVISASections                      = false;
+        bool EmitZeBinKernelStats                       = false;
         bool FP64GenEmulationEnabled                    = false;
 
         //when true, compiler disables the Remat optimization for compute shaders
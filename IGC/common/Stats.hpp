@@ -22,6 +22,7 @@ SPDX-License-Identifier: MIT
 #include "common/MemStats.h"
 
 #include "AdaptorCommon/customApi.hpp"
+#include "CompileTrace.h"
 
 #include <3d/common/iStdLib/utility.h>
 
@@ -279,6 +280,10 @@ private:
         { \
                 (pointer)->m_compilerTimeStats->recordTimerStart( compileTimeInterval );  \
         } \
+        if( vISA::CompileTrace::isEnabled() ) \
+        { \
+                vISA::CompileTrace::begin( "IGC", g_cCompTimeIntervals[compileTimeInterval] ); \
+        } \
     } while (0)
 #define COMPILER_TIME_END( pointer, compileTimeInterval ) \
     do \
@@ -287,6 +292,10 @@ private:
         { \
                 (pointer)->m_compilerTimeStats->recordTimerEnd( compileTimeInterval ); \
         } \
+        if( vISA::CompileTrace::isEnabled() ) \
+        { \
+                vISA::CompileTrace::end( g_cCompTimeIntervals[compileTimeInterval] ); \
+        } \
     } while (0)
 
 #define COMPILER_TIME_PASS_START( pointer, name ) \
@@ -425,8 +434,23 @@ private:
 
 #else // GET_TIME_STATS
 
-#   define COMPILER_TIME_START( pointer, value ) do { } while (0)
-#   define COMPILER_TIME_END( pointer, value ) do { } while (0)
+// The intervals still feed the compile trace.
+#   define COMPILER_TIME_START( pointer, value ) \
+    do \
+    { \
+        if( vISA::CompileTrace::isEnabled() ) \
+        { \
+                vISA::CompileTrace::begin( "IGC", g_cCompTimeIntervals[value] ); \
+        } \
+    } while (0)
+#   define COMPILER_TIME_END( pointer, value ) \
+    do \
+    { \
+        if( vISA::CompileTrace::isEnabled() ) \
+        { \
+                vISA::CompileTrace::end( g_cCompTimeIntervals[value] ); \
+        } \
+    } while (0)
 #   define COMPILER_TIME_PRINT( pointer, shaderType, shaderhash ) do { } while (0)
 #   define COMPILER_TIME_SUM( pointerDst, pointerSrc ) do { } while (0)
 #   define COMPILER_TIME_SUM2( pointerDst, pointerSrc ) do { } while (0)
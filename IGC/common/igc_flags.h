@@ -41,6 +41,7 @@ DECLARE_IGC_REGKEY(bool, EnableVISADumpCommonISA,       false, "Enable VISA Dump
 DECLARE_IGC_REGKEY(bool, EnableVISABinary,              false, "Enable VISA Binary", true)
 DECLARE_IGC_REGKEY(bool, EnableVISAOutput,              false, "Enable VISA GenISA output", true)
 DECLARE_IGC_REGKEY(bool, EnableVISASlowpath,            false, "Enable VISA Slowpath. Needed to dump .visaasm", true)
+DECLARE_IGC_REGKEY(bool, ReparseKernelForInlineAsm,     false, "Compile kernels with inline assembly by printing the whole kernel as vISA text and parsing it back, instead of parsing only the inline assembly", false)
 DECLARE_IGC_REGKEY(bool, EnableVISADotAll,              false, "Enable VISA DotAll. Dumps dot files for intermediate stages", false)
 DECLARE_IGC_REGKEY(bool, EnableVISADebug,               false, "Runs VISA in debug mode, all optimizations disabled", false)
 DECLARE_IGC_REGKEY(DWORD, EnableVISAStructurizer,       1,     "Enable/Disable VISA structurizer. See value defs in igc_flags.hpp.", false)
@@ -113,6 +114,8 @@ DECLARE_IGC_REGKEY(bool, UseLinearScanRA,               false,  "use Linear Scan
 DECLARE_IGC_REGKEY(bool, DisableWriteCombine, false, "Disable write combine. PVC+ only", false)
 DECLARE_IGC_REGKEY(bool, Force32bitConstantGEPLowering, false, "Go back to old version of GEP lowering for constant address space. PVC only", false)
 DECLARE_IGC_REGKEY(bool, NewSpillCostFunction,          false, "Use new spill cost function in VISA RA", false)
+DECLARE_IGC_REGKEY(bool, SpillCostTrials,               false, "When VISA RA spills, also color with the other spill cost function and keep the cheaper spills", false)
+DECLARE_IGC_REGKEY(bool, FreqSpillCost,                 false, "Price spills, fills and remat in VISA RA in cycles weighted by the estimated execution frequency of each BB", false)
 DECLARE_IGC_REGKEY(bool, EnableCoalesceScalarMoves, true, "Enable scalar moves to be coalesced into fewer moves", true)
 DECLARE_IGC_GROUP("IGC Optimization")
 DECLARE_IGC_REGKEY(bool, AllowMem2Reg,                  false, "Setting this to true makes IGC run mem2reg even when optimizations are disabled", true)
@@ -257,6 +260,7 @@ DECLARE_IGC_REGKEY(bool, ForceHoistDp3,              false,   "force dp3 Hoistin
 DECLARE_IGC_REGKEY(bool, EnableBitcastedLoadNarrowing, false, "Enable narrowing of vector loads in bitcasts patterns.", false)
 DECLARE_IGC_REGKEY(bool, EnableBitcastedLoadNarrowingToScalar, false, "Enable narrowing of vector loads to scalar ones in bitcasts patterns.", false)
 DECLARE_IGC_REGKEY(bool, EnableOptReportLoadNarrowing, false, "Generate opt report for narrowing of vector loads.", false)
+DECLARE_IGC_REGKEY(bool, SkipUnchangedCleanupPasses, false, "Skip DCE, SROA, SimplifyCFG, EarlyCSE, InstCombine and GVN on a function that has not changed since the same pass last ran on it", false)
 
 DECLARE_IGC_GROUP("Shader debugging")
 DECLARE_IGC_REGKEY(bool, ForceDisableShaderDebugHashCodeInKernel,   false,  "Disable hash code addition to the binary after EOT", false)
@@ -297,6 +301,7 @@ DECLARE_IGC_REGKEY(DWORD, RetryManagerFirstStateId,     0,     "For debugging pu
 DECLARE_IGC_REGKEY(bool, DisableSendSrcDstOverlapWA,    false, "Disable Send Source/destination overlap WA which is enabled for GEN10/GEN11 and whenever Wddm2Svm is set in WATable", false)
 DECLARE_IGC_REGKEY(debugString, DisablePassToggles,     0,     "Disable each IGC pass by setting the bit. HEXADECIMAL ONLY!. Ex: C0 is to disable pass 6 and pass 7.", false)
 DECLARE_IGC_REGKEY(bool, ShaderDisplayAllPassesNames,   false, "Display to console all passes name with their ID and occurrence number.", false)
+DECLARE_IGC_REGKEY(bool, PrintCleanupPassSkips,         false, "Display to console how often each cleanup pass was skipped by SkipUnchangedCleanupPasses.", false)
 DECLARE_IGC_REGKEY(debugString, ShaderPassDisable,      0,     "Disable specific passes eg. '9;17-19;239-;Error Check;ResolveOCLAtomics:2;Dead Code Elimination:3-5;BreakConstantExprPass:7-' \
                                                                 disable pass 9, disable passes from 17 to 19, disable all passes after 238, disable all occurrences of pass Error Check, \
                                                                 disable second occurrence of ResolveOCLAtomics, disable pass Dead Code Elimination occurrences from 3 to 5, \
@@ -372,6 +377,7 @@ DECLARE_IGC_REGKEY(bool, EnableWriteOldFPToStack,       true,  "Setting this to
 DECLARE_IGC_REGKEY(bool, ZeBinCompatibleDebugging,      true,  "Setting this to 1 (true) enables embed debug info in zeBinary", true)
 DECLARE_IGC_REGKEY(bool, DebugInfoEnforceAmd64EM,       false, "Enforces elf file with the debug infomation to have eMachine set to AMD64", false)
 DECLARE_IGC_REGKEY(bool, DebugInfoValidation,           false, "Enable optional (strict) checks to detect debug information inconsistencies", false)
+DECLARE_IGC_REGKEY(bool, EnableDwarfTypeDIECache,       false, "Share type DIEs between the kernels and SIMD variants of a module instead of constructing them per kernel", true)
 DECLARE_IGC_REGKEY(bool, deadLoopForFloatException,           false, "enable a dead loop if float exception happened", false)
 DECLARE_IGC_REGKEY(debugString, ExtraOCLOptions,        0,     "Extra options for OpenCL", true)
 DECLARE_IGC_REGKEY(debugString, ExtraOCLInternalOptions, 0,    "Extra internal options for OpenCL", true)
@@ -621,6 +627,10 @@ DECLARE_IGC_REGKEY(DWORD, FastestS1Experiments,         0,      "Select configs
 DECLARE_IGC_REGKEY(bool, ForceAddingStackcallKernelPrerequisites, false,  "Force adding static overhead for stackcall to the kernel entry such as HWTID instructions for experiments", false)
 DECLARE_IGC_REGKEY(bool, DisableFastestLinearScan,      false,   "Disable LinearScanRA in FastestSIMD.", false)
 DECLARE_IGC_REGKEY(bool, DisableFastestGopt,            false,   "Disable global optimizations for stage 1 shaders.", false)
+DECLARE_IGC_REGKEY(bool, EnableOCLTieredCompilation,    false,   "Return a stage 1 (fastest) binary for OpenCL programs and compile the optimized one in the background", false)
+DECLARE_IGC_REGKEY(DWORD, OCLTieredCompilationCacheSize, 64,      "Max number of optimized OpenCL binaries kept by tiered compilation", false)
+DECLARE_IGC_REGKEY(DWORD, CompileBudgetMs,               0,       "Compile-time budget in ms, 0 means no budget. Once exceeded, the remaining optional LLVM passes are skipped, RA, scheduling and SWSB use their fast variants and no retry is done", false)
+DECLARE_IGC_REGKEY(debugString, CompileTraceFile,        0,       "Write the timeline of the compilation (IGC passes, vISA passes, RA iterations) to the given file in the Chrome trace event format", false)
 DECLARE_IGC_REGKEY(bool, ForceFastestSIMD, false,  "Force pixel shader to return SIMD8 as fast as possible.", false)
 DECLARE_IGC_REGKEY(bool, EnableFastestSingleCSSIMD,     false,  "Enable selecting single CS SIMD in staged compilation.", false)
 DECLARE_IGC_REGKEY(bool, ForceBestSIMD, false,  "Force pixel shader to return the best SIMD, either SIMD16 or SIMD8.", false)
@@ -678,6 +688,10 @@ DECLARE_IGC_REGKEY(bool, EnableLocalIdCalculationInShader, false,
 DECLARE_IGC_REGKEY(bool, EnableVector8LoadStore, false, "Enable Vectorizer to generate 8x32i and 4x64i loads and stores", true)
 DECLARE_IGC_REGKEY(bool, EnableZEBinary, true,  "Force-enable output in ZE binary format. Leave unset for compiler to choose based on current platform's support for ZE binary", true)
 DECLARE_IGC_REGKEY(bool, ExcludeIRFromZEBinary, false, "Exclude IR sections from ZE binary", true)
+DECLARE_IGC_REGKEY(bool, EmitZeBinKernelStats, false, "Emit the codegen statistics (spills, GRF usage, instruction counts) of each kernel SIMD variant into .note.intelgt.metrics.<kernel> sections of ZE binary", true)
+DECLARE_IGC_REGKEY(bool, EmitZeBinKernelStatsTiming, false, "With EmitZeBinKernelStats, also emit the kernel statistics that change from one compile to the next (compile time, compaction cache hits)", true)
+DECLARE_IGC_REGKEY(bool, EnableZEInfoBinaryFormat, false, "Emit .ze_info in the compact binary encoding (.ze_info.bin section) instead of YAML", true)
+DECLARE_IGC_REGKEY(bool, EnableZEBinaryKernelDedup, false, "Store identical kernel binaries with identical relocations only once in ZE binary, and let the other kernels' text sections refer to it", true)
 DECLARE_IGC_REGKEY(bool, AllocateZeroInitializedVarsInBss, false,  "Allocate zero initialized global variables in .bss section in ZEBinary", true)
 DECLARE_IGC_REGKEY(DWORD, OverrideOCLMaxParamSize, 0,  "Override the value imposed on the kernel by CL_DEVICE_MAX_PARAMETER_SIZE. Value in bytes, if value==0 no override happens.", true)
 
@@ -18,6 +18,7 @@ SPDX-License-Identifier: MIT
 #include "secure_mem.h"
 #include "secure_string.h"
 #include "AdaptorCommon/customApi.hpp"
+#include "CompileTrace.h"
 
 #if defined(_WIN64) || defined(_WIN32)
 #include <devguid.h>  // for GUID_DEVCLASS_DISPLAY
@@ -1096,6 +1097,11 @@ void LoadRegistryKeys(const std::string& options, bool *RegFlagNameError)
             llvm::cl::ParseCommandLineOptions(args.size(), &args[0]);
         }
 
+        if (IGC_IS_FLAG_ENABLED(CompileTraceFile))
+        {
+            vISA::CompileTrace::enable(IGC_GET_REGKEYSTRING(CompileTraceFile));
+        }
+
         setImpliedIGCKeys();
     }
 }
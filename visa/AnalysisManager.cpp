@@ -0,0 +1,51 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "AnalysisManager.h"
+#include "G4_Kernel.hpp"
+#include "PointsToAnalysis.h"
+
+using namespace vISA;
+
+AnalysisManager::AnalysisManager(G4_Kernel &k) : kernel(k) {}
+
+AnalysisManager::~AnalysisManager() {}
+
+void AnalysisManager::invalidate(unsigned changes) {
+  if (changes & (IRC_CFG | IRC_Declares | IRC_Operands))
+    pointsToStale = true;
+}
+
+PointsToAnalysis &AnalysisManager::getPointsToAnalysis() {
+  if (pointsTo && !pointsToStale) {
+    numPointsToReuses++;
+    return *pointsTo;
+  }
+
+  // The constructor also assigns the ids of the address variables that the
+  // points-to sets are indexed by. They are only renumbered by RA, which
+  // takes the analysis over.
+  pointsTo = std::make_unique<PointsToAnalysis>(kernel.Declares,
+                                                kernel.fg.getNumBB());
+  pointsTo->doPointsToAnalysis(kernel.fg);
+  pointsToStale = false;
+  numPointsToRuns++;
+  return *pointsTo;
+}
+
+std::unique_ptr<PointsToAnalysis> AnalysisManager::takePointsToAnalysis() {
+  getPointsToAnalysis();
+  pointsToStale = true;
+  return std::move(pointsTo);
+}
+
+void AnalysisManager::dump(std::ostream &os) const {
+  os << "PointsToAnalysis: " << numPointsToRuns << " runs, "
+     << numPointsToReuses << " reuses"
+     << (pointsTo && !pointsToStale ? "" : " (stale)") << "\n";
+}
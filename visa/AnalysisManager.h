@@ -0,0 +1,71 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#ifndef __ANALYSISMANAGER_H__
+#define __ANALYSISMANAGER_H__
+
+#include <iostream>
+#include <memory>
+
+namespace vISA {
+class G4_Kernel;
+class PointsToAnalysis;
+
+// IR changes a pass reports to the AnalysisManager, see
+// G4_Kernel::invalidateAnalyses().
+enum IRChange : unsigned {
+  IRC_None = 0,
+  // BBs or edges were added or removed, or BBs were renumbered
+  IRC_CFG = 0x1,
+  // declares were added, removed or re-aliased
+  IRC_Declares = 0x2,
+  // instructions or their operands were added, removed or rewritten
+  IRC_Operands = 0x4,
+  IRC_All = IRC_CFG | IRC_Declares | IRC_Operands
+};
+
+// Caches the whole-kernel analyses that several passes query, so that they
+// are computed once and reused until a pass reports a change they depend on.
+// Optimizer::runPass reports the changes of each pass it runs (see
+// PassInfo::Changes), and FlowGraph reports its CFG updates. The dominator
+// and loop analyses are not kept here: FlowGraph caches them and marks them
+// stale on CFG updates.
+//
+// A reference returned by a getter stays valid until the analysis is queried
+// again after being invalidated.
+class AnalysisManager {
+public:
+  AnalysisManager(G4_Kernel &k);
+  ~AnalysisManager();
+
+  void invalidate(unsigned changes);
+
+  // Depends on the CFG, as the indirect uses are kept per BB id, on the
+  // address declares and on the instructions defining them.
+  PointsToAnalysis &getPointsToAnalysis();
+
+  // For passes that keep the points-to sets up to date as they rewrite the
+  // IR, like RA does for spill code; the analysis is recomputed on the next
+  // query.
+  std::unique_ptr<PointsToAnalysis> takePointsToAnalysis();
+
+  void dump(std::ostream &os = std::cerr) const;
+
+private:
+  G4_Kernel &kernel;
+
+  std::unique_ptr<PointsToAnalysis> pointsTo;
+  bool pointsToStale = true;
+
+  // for dump()
+  unsigned numPointsToRuns = 0;
+  unsigned numPointsToReuses = 0;
+};
+} // namespace vISA
+
+#endif // __ANALYSISMANAGER_H__
@@ -9,6 +9,7 @@ SPDX-License-Identifier: MIT
 #include "BinaryEncodingIGA.h"
 #include "BuildIR.h"
 #include "Common_ISA_framework.h"
+#include "BuildCISAIR.h"
 #include "Timer.h"
 #include "iga/IGALibrary/Frontend/FormatterJSON.hpp"
 #include "iga/IGALibrary/api/igaEncoderWrapper.hpp"
@@ -1160,8 +1161,25 @@ void BinaryEncodingIGA::Encode() {
       encoder.enableIGAAutoDeps();
     }
 
+    iga::CompactionCache *compactionCache = nullptr;
+    if (autoCompact && kernel.fg.builder->getParent()) {
+      compactionCache = kernel.fg.builder->getParent()->getCompactionCache(
+          platformModel->platform);
+      encoder.setCompactionCache(compactionCache);
+    }
+    uint64_t cacheHits = compactionCache ? compactionCache->getHits() : 0;
+    uint64_t cacheMisses = compactionCache ? compactionCache->getMisses() : 0;
+
     encoder.encode(kernel.fg.builder->criticalMsgStream());
 
+    if (compactionCache) {
+      auto &stats = kernel.fg.builder->getJitInfo()->stats;
+      stats.compactionCacheHits =
+          (uint32_t)(compactionCache->getHits() - cacheHits);
+      stats.compactionCacheMisses =
+          (uint32_t)(compactionCache->getMisses() - cacheMisses);
+    }
+
     m_kernelBufferSize = encoder.getBinarySize();
     m_kernelBuffer = allocCodeBlock(m_kernelBufferSize);
     memcpy_s(m_kernelBuffer, m_kernelBufferSize, encoder.getBinary(),
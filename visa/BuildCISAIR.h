@@ -9,6 +9,7 @@ SPDX-License-Identifier: MIT
 #ifndef _BUILDCISAIR_H_
 #define _BUILDCISAIR_H_
 
+#include <chrono>
 #include <cstdint>
 #include <sstream>
 
@@ -16,6 +17,10 @@ namespace vISA {
 class Mem_Manager;
 class PlatformInfo;
 } // namespace vISA
+namespace iga {
+class CompactionCache;
+enum class Platform;
+} // namespace iga
 class CisaKernel;
 class CisaBinary;
 class VISAKernelImpl;
@@ -86,6 +91,8 @@ public:
   VISA_BUILDER_API int ParseVISAText(const std::string &visaText,
                                      const std::string &visaTextFile) override;
   VISA_BUILDER_API int ParseVISAText(const std::string &visaFile) override;
+  VISA_BUILDER_API int ParseVISAAsmSnippet(VISAKernel *kernel,
+                                           const std::string &asmText) override;
   VISA_BUILDER_API std::stringstream &GetAsmTextStream() override {
     return m_ssIsaAsm;
   }
@@ -114,6 +121,14 @@ public:
 
   bool debugParse() const { return m_options.getOption(vISA_DebugParse); }
 
+  // Returns true once at the start of a snippet, for the lexer to tell the
+  // parser that there is no .version header.
+  bool takeSnippetStart() {
+    bool start = m_snippetStart;
+    m_snippetStart = false;
+    return start;
+  }
+
   int verifyVISAIR();
 
   static void cat(std::stringstream &ss) {}
@@ -567,6 +582,15 @@ public:
   VISA_BUILDER_OPTION getBuilderOption() const { return mBuildOption; }
   vISABuilderMode getBuilderMode() const { return m_builderMode; }
 
+  // isCompileBudgetExceeded - return true if vISA_CompileBudget is set and
+  // more time than that has passed since the creation of the builder.
+  bool isCompileBudgetExceeded() const;
+
+  // getCompactionCache - the IGA compaction results shared by all kernels
+  // encoded by this builder. Created on first use, from the
+  // vISA_CompactionCacheFile if one is given.
+  iga::CompactionCache *getCompactionCache(iga::Platform platform) const;
+
   bool CISA_create_dpas_instruction(ISA_Opcode opcode, VISA_EMask_Ctrl emask,
                                     unsigned exec_size, VISA_opnd *dst_cisa,
                                     VISA_opnd *src0_cisa, VISA_opnd *src1_cisa,
@@ -628,6 +652,10 @@ private:
   const VISA_BUILDER_OPTION mBuildOption;
   // FIXME: we need to make 3D/media per kernel instead of per builder
   const vISABuilderMode m_builderMode;
+  const std::chrono::steady_clock::time_point m_createTime =
+      std::chrono::steady_clock::now();
+  // see getCompactionCache()
+  mutable iga::CompactionCache *m_compactionCache = nullptr;
 
   unsigned int m_kernel_count = 0;
   unsigned int m_function_count = 0;
@@ -700,6 +728,8 @@ private:
 
   void *gtpin_init = nullptr;
 
+  bool m_snippetStart = false;
+
   // important messages that we should relay to the user
   // (things like if RA is spilling, etc.)
   std::stringstream criticalMsg;
@@ -17,6 +17,7 @@ SPDX-License-Identifier: MIT
 #endif
 #include "BinaryCISAEmission.h"
 #include "BinaryEncoding.h"
+#include "CompileTrace.h"
 #include "IsaDisassembly.h"
 #include "Timer.h"
 #include "VISAKernel.h"
@@ -26,7 +27,10 @@ SPDX-License-Identifier: MIT
 #include "G4_IR.hpp"
 #include "IsaVerification.h"
 #include "IGC/common/StringMacros.hpp"
+#include "iga/IGALibrary/Backend/CompactionCache.hpp"
 
+#include <atomic>
+#include <cstdio>
 #include <fstream>
 #include <functional>
 #include <iostream>
@@ -35,6 +39,11 @@ SPDX-License-Identifier: MIT
 #include <sstream>
 #include <string>
 #include <string_view>
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
 
 using namespace vISA;
 
@@ -45,6 +54,42 @@ using namespace vISA;
 #define IS_VISA_BOTH_PATH                                                      \
   (mBuildOption == VISA_BUILDER_VISA || mBuildOption == VISA_BUILDER_BOTH)
 
+static int getProcessId() {
+#if defined(_WIN32)
+  return _getpid();
+#else
+  return getpid();
+#endif
+}
+
+// Compiles running at the same time may share a cache file, so the cache is
+// written to a file of its own and then renamed over cacheFile. Readers see
+// either the old or the new cache, never a partial one.
+static void saveCompactionCache(const iga::CompactionCache &cache,
+                                const char *cacheFile) {
+  static std::atomic<unsigned> tmpCounter{0};
+  std::string tmpFile = std::string(cacheFile) + ".tmp" +
+                        std::to_string(getProcessId()) + "." +
+                        std::to_string(tmpCounter++);
+  {
+    std::ofstream ofs(tmpFile, std::ios::binary);
+    if (!ofs)
+      return;
+    cache.save(ofs);
+    if (!ofs.flush()) {
+      ofs.close();
+      std::remove(tmpFile.c_str());
+      return;
+    }
+  }
+  if (std::rename(tmpFile.c_str(), cacheFile) != 0) {
+    // rename does not replace an existing file on Windows
+    std::remove(cacheFile);
+    if (std::rename(tmpFile.c_str(), cacheFile) != 0)
+      std::remove(tmpFile.c_str());
+  }
+}
+
 CISA_IR_Builder::~CISA_IR_Builder() {
   m_cisaBinary->~CisaBinary();
 
@@ -62,6 +107,39 @@ CISA_IR_Builder::~CISA_IR_Builder() {
   if (needsToFreeWATable) {
     delete m_pWaTable;
   }
+
+  if (m_compactionCache) {
+    if (const char *cacheFile =
+            m_options.getOptionCstr(vISA_CompactionCacheFile)) {
+      saveCompactionCache(*m_compactionCache, cacheFile);
+    }
+    delete m_compactionCache;
+  }
+}
+
+bool CISA_IR_Builder::isCompileBudgetExceeded() const {
+  uint32_t budget = m_options.getuInt32Option(vISA_CompileBudget);
+  if (budget == 0)
+    return false;
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - m_createTime);
+  return elapsed.count() >= budget;
+}
+
+iga::CompactionCache *
+CISA_IR_Builder::getCompactionCache(iga::Platform platform) const {
+  if (!m_compactionCache) {
+    m_compactionCache = new iga::CompactionCache(platform);
+    if (const char *cacheFile =
+            m_options.getOptionCstr(vISA_CompactionCacheFile)) {
+      // a missing, stale or foreign cache file just starts an empty cache
+      std::ifstream ifs(cacheFile, std::ios::binary);
+      if (ifs)
+        m_compactionCache->load(ifs);
+    }
+  }
+  return m_compactionCache->getPlatform() == platform ? m_compactionCache
+                                                      : nullptr;
 }
 
 static const WA_TABLE *CreateVisaWaTable(TARGET_PLATFORM platform,
@@ -268,6 +346,11 @@ int CISA_IR_Builder::CreateBuilder(CISA_IR_Builder *&builder,
   builder->m_options.getOptionsFromEV();
 #endif
 
+  if (const char *traceFile =
+          builder->m_options.getOptionCstr(vISA_CompileTrace)) {
+    CompileTrace::enable(traceFile);
+  }
+
 #if !defined(NDEBUG) && !defined(DLL_MODE)
   auto debugPassesCstr = builder->m_options.getOptionCstr(vISA_DebugOnly);
   if (debugPassesCstr) {
@@ -1399,6 +1482,7 @@ typedef struct yy_buffer_state *YY_BUFFER_STATE;
 extern int CISAparse(CISA_IR_Builder *builder);
 extern YY_BUFFER_STATE CISA_scan_string(const char *yy_str);
 extern void CISA_delete_buffer(YY_BUFFER_STATE buf);
+extern int CISAlineno;
 static std::mutex mtx;
 
 int CISA_IR_Builder::ParseVISAText(const std::string &visaText,
@@ -1449,6 +1533,53 @@ int CISA_IR_Builder::ParseVISAText(const std::string &visaText,
   return status;
 }
 
+int CISA_IR_Builder::ParseVISAAsmSnippet(VISAKernel *kernel,
+                                         const std::string &asmText) {
+  const std::lock_guard<std::mutex> lock(mtx);
+  auto *snippetKernel = static_cast<VISAKernelImpl *>(kernel);
+  VISAKernelImpl *prevKernel = m_kernel;
+  m_kernel = snippetKernel;
+
+  // Look variables up by name, as when a whole kernel is parsed.
+  bool parseMode = m_options.getOption(vISA_isParseMode);
+  m_options.setOptionInternally(vISA_isParseMode, true);
+
+  int status = VISA_SUCCESS;
+  if (!snippetKernel->beginAsmSnippet()) {
+    criticalMsg << "inline assembly operand bound twice\n";
+    status = VISA_FAILURE;
+  } else {
+#if defined(_WIN32)
+    CISAout = fopen("nul", "w");
+#else
+    CISAout = fopen("/dev/null", "w");
+#endif
+    CISAlineno = 1;
+    // Each snippet is parsed on its own and reports its own first error.
+    m_errorMessage.clear();
+    m_snippetStart = true;
+    YY_BUFFER_STATE visaBuf = CISA_scan_string(asmText.c_str());
+    if (CISAparse(this) != 0) {
+#ifndef DLL_MODE
+      std::cerr << "Parsing inline vISA assembly failed:\n" << asmText << "\n"
+                << criticalMsg.str();
+#endif // DLL_MODE
+      status = VISA_FAILURE;
+    }
+    CISA_delete_buffer(visaBuf);
+    m_snippetStart = false;
+
+    if (CISAout) {
+      fclose(CISAout);
+    }
+  }
+  snippetKernel->endAsmSnippet();
+
+  m_options.setOptionInternally(vISA_isParseMode, parseMode);
+  m_kernel = prevKernel;
+  return status;
+}
+
 // Parses inline asm file from ShaderOverride
 int CISA_IR_Builder::ParseVISAText(const std::string &visaFile) {
   // Direct output of parser to null
@@ -1916,6 +2047,7 @@ int CISA_IR_Builder::Compile(const char *nameInput, std::ostream *os,
     m_options.getOption(VISA_AsmFileName, asmName);
     dumpAllTimers(asmName, true);
   }
+  CompileTrace::flush();
 
 #ifndef DLL_MODE
   if (criticalMsg.str().length() > 0) {
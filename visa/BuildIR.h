@@ -476,6 +476,10 @@ public:
 
   const CISA_IR_Builder *getParent() const { return parentBuilder; }
 
+  // isCompileBudgetExceeded - the compile budget is shared by all kernels and
+  // functions of the parent builder.
+  bool isCompileBudgetExceeded() const;
+
   void dump(std::ostream &os); // not const because G4_INST::emit isn't :(
 
   std::stringstream &criticalMsgStream();
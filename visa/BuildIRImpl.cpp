@@ -18,6 +18,7 @@ SPDX-License-Identifier: MIT
 #include "Common_ISA_util.h"
 #include "JitterDataStruct.h"
 #include "Timer.h"
+#include "VISAKernel.h"
 #include "common.h"
 #include "visa_igc_common_header.h"
 
@@ -769,6 +770,10 @@ IR_Builder::~IR_Builder() {
   delete fcPatchInfo;
 }
 
+bool IR_Builder::isCompileBudgetExceeded() const {
+  return parentBuilder && parentBuilder->isCompileBudgetExceeded();
+}
+
 G4_Declare *
 IR_Builder::cloneDeclare(std::map<G4_Declare *, G4_Declare *> &dclMap,
                          G4_Declare *dcl) {
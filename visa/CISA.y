@@ -261,6 +261,7 @@ std::vector<attr_gen_struct*> AttrOptVar;
 %token <atomic_op> ATOMIC_SUB_OP
 
 // directives
+%token          SNIPPET_START         // start of ParseVISAAsmSnippet input
 %token          DIRECTIVE_DECL        // .decl
 %token          DIRECTIVE_FUNC        // .function
 %token          DIRECTIVE_FUNCDECL    // .funcdecl
@@ -619,6 +620,14 @@ Listing: NewlinesOpt ListingHeader NewlinesOpt Statements NewlinesOpt {
         TRACE("** Listing Complete\n");
         pBuilder->CISA_post_file_parse();
     }
+    |
+    // inline assembly appended to a kernel being built, c.f.
+    // CISA_IR_Builder::ParseVISAAsmSnippet
+    SNIPPET_START NewlinesOpt
+    |
+    SNIPPET_START NewlinesOpt Statements NewlinesOpt {
+        TRACE("** Snippet Complete\n");
+    }
 
 ListingHeader: DirectiveVersion
 
@@ -0,0 +1,245 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "CompileTrace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace vISA;
+
+std::atomic<bool> CompileTrace::Enabled(false);
+
+namespace {
+using Clock = std::chrono::steady_clock;
+using Tag = std::shared_ptr<const std::string>;
+
+struct Span {
+  std::string name;
+  const char *category;
+  Tag tag;
+  Clock::time_point start;
+  Clock::time_point end;
+};
+
+struct ThreadTrace {
+  const unsigned tid;
+  // Taken by the owning thread and by flush().
+  std::mutex lock;
+  Tag tag;
+  // Spans begun but not ended yet, in begin order.
+  std::vector<Span> open;
+  // Spans ended since the last flush.
+  std::vector<Span> done;
+
+  explicit ThreadTrace(unsigned id) : tid(id) {}
+};
+
+struct Trace {
+  std::mutex lock;
+  std::string fileName;
+  Clock::time_point epoch;
+  // Owned here so that the spans of finished threads are still flushed.
+  std::vector<std::unique_ptr<ThreadTrace>> threads;
+  // Whether the file has been created and whether it has any span yet.
+  bool fileStarted = false;
+  bool fileHasSpans = false;
+};
+
+// Never destroyed, threads may still record while statics are torn down.
+Trace &getTrace() {
+  static Trace *trace = new Trace;
+  return *trace;
+}
+
+ThreadTrace &getThreadTrace() {
+  thread_local ThreadTrace *current = nullptr;
+  if (!current) {
+    Trace &trace = getTrace();
+    std::lock_guard<std::mutex> guard(trace.lock);
+    trace.threads.emplace_back(
+        new ThreadTrace(static_cast<unsigned>(trace.threads.size() + 1)));
+    current = trace.threads.back().get();
+  }
+  return *current;
+}
+
+void writeEscaped(std::ostream &os, const std::string &str) {
+  for (char c : str) {
+    switch (c) {
+    case '"':
+      os << "\\\"";
+      break;
+    case '\\':
+      os << "\\\\";
+      break;
+    case '\t':
+      os << "\\t";
+      break;
+    case '\n':
+      os << "\\n";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        char buf[8];
+        std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+        os << buf;
+      } else {
+        os << c;
+      }
+    }
+  }
+}
+
+// Take the completed spans of all threads, paired with their thread id.
+std::vector<std::pair<unsigned, Span>> takeSpans(Trace &trace) {
+  std::vector<std::pair<unsigned, Span>> spans;
+  std::lock_guard<std::mutex> guard(trace.lock);
+  for (auto &thread : trace.threads) {
+    std::vector<Span> done;
+    {
+      std::lock_guard<std::mutex> threadGuard(thread->lock);
+      done.swap(thread->done);
+    }
+    for (auto &span : done)
+      spans.emplace_back(thread->tid, std::move(span));
+  }
+  return spans;
+}
+
+// Write the spans as complete events, each preceded by a separator unless it
+// is the first one of the array.
+void writeSpans(std::ostream &os, Clock::time_point epoch,
+                const std::vector<std::pair<unsigned, Span>> &spans,
+                bool &hasSpans) {
+  auto toUS = [](Clock::duration d) {
+    return std::chrono::duration<double, std::micro>(d).count();
+  };
+  char buf[64];
+  for (const auto &entry : spans) {
+    const Span &span = entry.second;
+    os << (hasSpans ? ",\n" : "\n");
+    hasSpans = true;
+    os << "{\"name\":\"";
+    writeEscaped(os, span.name);
+    os << "\",\"cat\":\"" << span.category << "\",\"ph\":\"X\"";
+    std::snprintf(buf, sizeof(buf), ",\"ts\":%.3f,\"dur\":%.3f",
+                  toUS(span.start - epoch), toUS(span.end - span.start));
+    os << buf << ",\"pid\":1,\"tid\":" << entry.first;
+    if (span.tag && !span.tag->empty()) {
+      os << ",\"args\":{\"tag\":\"";
+      writeEscaped(os, *span.tag);
+      os << "\"}";
+    }
+    os << "}";
+  }
+}
+
+// Flushes the remaining spans and closes the JSON array at exit.
+struct TraceFinalizer {
+  ~TraceFinalizer() {
+    CompileTrace::flush();
+    Trace &trace = getTrace();
+    std::lock_guard<std::mutex> guard(trace.lock);
+    if (trace.fileStarted) {
+      std::ofstream os(trace.fileName, std::ios::app);
+      os << "\n]\n";
+    }
+  }
+};
+} // namespace
+
+void CompileTrace::enable(const char *fileName) {
+  Trace &trace = getTrace();
+  {
+    std::lock_guard<std::mutex> guard(trace.lock);
+    if (isEnabled())
+      return;
+    trace.fileName = fileName ? fileName : "";
+    trace.epoch = Clock::now();
+    Enabled.store(true, std::memory_order_relaxed);
+  }
+  static TraceFinalizer finalizer;
+}
+
+void CompileTrace::begin(const char *category, const char *name) {
+  if (!isEnabled())
+    return;
+  begin(category, std::string(name));
+}
+
+void CompileTrace::begin(const char *category, const std::string &name) {
+  if (!isEnabled())
+    return;
+  ThreadTrace &thread = getThreadTrace();
+  Clock::time_point now = Clock::now();
+  std::lock_guard<std::mutex> guard(thread.lock);
+  thread.open.push_back(Span{name, category, thread.tag, now, now});
+}
+
+void CompileTrace::end(const char *name) {
+  if (!isEnabled())
+    return;
+  end(std::string(name));
+}
+
+void CompileTrace::end(const std::string &name) {
+  if (!isEnabled())
+    return;
+  Clock::time_point now = Clock::now();
+  ThreadTrace &thread = getThreadTrace();
+  std::lock_guard<std::mutex> guard(thread.lock);
+  for (auto it = thread.open.rbegin(); it != thread.open.rend(); ++it) {
+    if (it->name == name) {
+      it->end = now;
+      thread.done.push_back(std::move(*it));
+      thread.open.erase(std::next(it).base());
+      return;
+    }
+  }
+}
+
+std::string CompileTrace::swapThreadTag(std::string tag) {
+  ThreadTrace &thread = getThreadTrace();
+  std::lock_guard<std::mutex> guard(thread.lock);
+  std::string prevTag = thread.tag ? *thread.tag : std::string();
+  thread.tag = std::make_shared<const std::string>(std::move(tag));
+  return prevTag;
+}
+
+void CompileTrace::write(std::ostream &os) {
+  Trace &trace = getTrace();
+  auto spans = takeSpans(trace);
+  bool hasSpans = false;
+  os << "[";
+  writeSpans(os, trace.epoch, spans, hasSpans);
+  os << "\n]\n";
+}
+
+void CompileTrace::flush() {
+  if (!isEnabled())
+    return;
+  Trace &trace = getTrace();
+  auto spans = takeSpans(trace);
+  std::lock_guard<std::mutex> guard(trace.lock);
+  if (trace.fileName.empty())
+    return;
+  // The array is only closed at exit; trace viewers accept an unterminated
+  // array, so the file can be inspected while the process is running.
+  std::ofstream os(trace.fileName,
+                   trace.fileStarted ? std::ios::app : std::ios::trunc);
+  if (!trace.fileStarted) {
+    os << "[";
+    trace.fileStarted = true;
+  }
+  writeSpans(os, trace.epoch, spans, trace.fileHasSpans);
+}
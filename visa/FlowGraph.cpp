@@ -8,6 +8,7 @@ SPDX-License-Identifier: MIT
 
 
 #include "FlowGraph.h"
+#include "AnalysisManager.h"
 #include "BitSet.h"
 #include "BuildIR.h"
 #include "CFGStructurizer.h"
@@ -2217,13 +2218,18 @@ void FlowGraph::reassignBlockIDs() {
   // that depends on BB id. Or the code will be incorrect once we reassign id.
   //
   unsigned i = 0;
+  bool renumbered = false;
   for (G4_BB *bb : BBs) {
+    renumbered |= bb->getId() != i;
     bb->setId(i);
     i++;
     vISA_ASSERT(i <= getNumBB(), ERROR_FLOWGRAPH);
   }
 
+  renumbered |= numBBId != i;
   numBBId = i;
+  if (renumbered)
+    pKernel->invalidateAnalyses(IRC_CFG);
 }
 
 G4_BB *FlowGraph::findLabelBB(BB_LIST_ITER StartIter, BB_LIST_ITER EndIter,
@@ -3831,6 +3837,7 @@ void vISA::FlowGraph::markStale() {
 
   // any other analysis that becomes stale when FlowGraph changes
   // should be marked as stale here.
+  pKernel->invalidateAnalyses(IRC_CFG);
 }
 
 void FlowGraph::markRPOTraversal() {
@@ -7,6 +7,7 @@ SPDX-License-Identifier: MIT
 ============================= end_copyright_notice ===========================*/
 
 #include "G4_Kernel.hpp"
+#include "AnalysisManager.h"
 #include "BuildIR.h"
 #include "DebugInfo.h"
 #include "G4_BB.hpp"
@@ -530,6 +531,11 @@ G4_Kernel::~G4_Kernel() {
     varSplitPass = nullptr;
   }
 
+  if (analyses) {
+    delete analyses;
+    analyses = nullptr;
+  }
+
   Declares.clear();
 }
 
@@ -861,6 +867,18 @@ VarSplitPass *G4_Kernel::getVarSplitPass() {
   return varSplitPass;
 }
 
+AnalysisManager &G4_Kernel::getAnalyses() {
+  if (!analyses)
+    analyses = new AnalysisManager(*this);
+
+  return *analyses;
+}
+
+void G4_Kernel::invalidateAnalyses(unsigned changes) {
+  if (analyses)
+    analyses->invalidate(changes);
+}
+
 unsigned G4_Kernel::getRegisterNumWithThreads(unsigned overrideNumThreads) {
   unsigned numRegTotal = 128;
 
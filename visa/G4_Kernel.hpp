@@ -132,6 +132,7 @@ private:
 class G4_BB;
 class KernelDebugInfo;
 class VarSplitPass;
+class AnalysisManager;
 
 
 // NoMask WA Information
@@ -210,6 +211,13 @@ private:
   bool hasAddrTaken;
   bool regSharingHeuristics = false;
   bool needDPASWA = false;
+  // Set by the optimizer once the compile budget is exceeded. The remaining
+  // passes of this kernel then take their fast variants; the builder options
+  // are left untouched.
+  bool compileBudgetExceeded = false;
+  // FastCompileRA forced by the compile budget. Only decided before GRF RA
+  // starts, so that RA does not change its mode half way.
+  bool budgetFastCompileRA = false;
   Options *m_options;
   const Attributes *m_kernelAttrs;
   const uint32_t m_function_id;
@@ -227,6 +235,8 @@ private:
 
   VarSplitPass *varSplitPass = nullptr;
 
+  AnalysisManager *analyses = nullptr;
+
   // map key is filename string with complete path.
   // if first elem of pair is false, the file wasn't found.
   // the second elem of pair stores the actual source line stream
@@ -380,6 +390,14 @@ public:
   void setNeedDPASWA(bool val) { needDPASWA = val; }
   bool getNeedDPASWA() const { return needDPASWA; }
 
+  void setCompileBudgetExceeded(bool val) { compileBudgetExceeded = val; }
+  bool isCompileBudgetExceeded() const { return compileBudgetExceeded; }
+  void setBudgetFastCompileRA(bool val) { budgetFastCompileRA = val; }
+  // useFastCompileRA - vISA_FastCompileRA, or forced by the compile budget.
+  bool useFastCompileRA() const {
+    return getOption(vISA_FastCompileRA) || budgetFastCompileRA;
+  }
+
   void setNumRegTotal(unsigned num) { numRegTotal = num; }
   unsigned getNumRegTotal() const { return numRegTotal; }
 
@@ -492,6 +510,10 @@ public:
 
   VarSplitPass *getVarSplitPass();
 
+  AnalysisManager &getAnalyses();
+  // Drop the cached analyses that depend on the given IRChange kinds.
+  void invalidateAnalyses(unsigned changes);
+
   VISATarget getKernelType() const { return kernelType; }
   void setKernelType(VISATarget t) { kernelType = t; }
 
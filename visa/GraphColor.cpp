@@ -8,6 +8,7 @@ SPDX-License-Identifier: MIT
 
 #include "GraphColor.h"
 #include "BuildIR.h"
+#include "CompileTrace.h"
 #include "DebugInfo.h"
 #include "FlowGraph.h"
 #include "LinearScanRA.h"
@@ -5200,7 +5201,7 @@ GraphColor::GraphColor(LivenessAnalysis &live, unsigned totalGRF, bool hybrid,
            live.getNumSplitVar(), gra),
       regPool(gra.regPool), builder(gra.builder), isHybrid(hybrid),
       forceSpill(forceSpill_), GCMem(GRAPH_COLOR_MEM_SIZE), kernel(gra.kernel),
-      liveAnalysis(live) {
+      liveAnalysis(live), directRefs(gra.kernel, true, false) {
   spAddrRegSig.resize(getNumAddrRegisters(), 0);
   m_options = builder.getOptions();
 }
@@ -5334,17 +5335,19 @@ void GraphColor::computeDegreeForARF() {
 void GraphColor::computeSpillCosts(bool useSplitLLRHeuristic, const RPE *rpe) {
   std::vector<LiveRange *> addressSensitiveVars;
   float maxNormalCost = 0.0f;
-  VarReferences directRefs(kernel, true, false);
   std::unordered_map<G4_Declare *, std::list<std::pair<G4_INST *, G4_BB *>>>
       indirectRefs;
   // when reg pressure is not very high in iter0, use spill cost function
   // that favors allocating large variables
   bool useNewSpillCost =
       (builder.getOption(vISA_NewSpillCostFunctionISPC) ||
-       builder.getOption(vISA_NewSpillCostFunction)) &&
+       builder.getOption(vISA_NewSpillCostFunction) ||
+       builder.getOption(vISA_FreqSpillCost)) &&
       rpe &&
       !(gra.getIterNo() == 0 &&
         (float)rpe->getMaxRP() < (float)kernel.getNumRegTotal() * 0.80f);
+  if (flipSpillCostFunction)
+    useNewSpillCost = !useNewSpillCost;
 
   if (builder.getOption(vISA_RATrace)) {
     if (useNewSpillCost)
@@ -5448,6 +5451,27 @@ void GraphColor::computeSpillCosts(bool useSplitLLRHeuristic, const RPE *rpe) {
     return refCount == 0 ? 1 : refCount;
   };
 
+  // With -freqSpillCost, the new spill cost of GRF variables is the number of
+  // cycles their spill code would take, weighted by BB frequency. The cycles
+  // are kept with either function, estimateSpillTraffic() uses them.
+  spillCycles.clear();
+  if (builder.getOption(vISA_FreqSpillCost) &&
+      liveAnalysis.livenessClass(G4_GRF)) {
+    if (!spillCostModel)
+      spillCostModel = std::make_unique<SpillCostModel>(kernel, directRefs);
+    spillCycles.resize(numVar, 0.0f);
+  }
+  SpillCostModel *costModel = spillCostModel.get();
+
+  auto getNewGRFSpillCost = [&](LiveRange *lr) -> float {
+    float degree = (float)(lr->getDegree() + 1);
+    if (costModel)
+      return std::max(spillCycles[lr->getVar()->getId()], 1.0f) / degree;
+
+    auto refCount = getWeightedRefCount(lr->getDcl());
+    return 1.0f * refCount * refCount * refCount / (degree * degree);
+  };
+
   std::unordered_map<G4_Declare *, std::vector<G4_Declare *>> addrTakenMap,
       revAddrTakenMap;
   bool addrMapsComputed = false;
@@ -5480,6 +5504,9 @@ void GraphColor::computeSpillCosts(bool useSplitLLRHeuristic, const RPE *rpe) {
     if (dcl->getIsPartialDcl()) {
       continue;
     }
+    if (costModel) {
+      spillCycles[i] = costModel->getSpillCycles(dcl);
+    }
     //
     // The spill cost of pseudo nodes inserted to aid generation of save/restore
     // code must be the minimum so that such nodes go to the bootom of the color
@@ -5542,11 +5569,7 @@ void GraphColor::computeSpillCosts(bool useSplitLLRHeuristic, const RPE *rpe) {
                          (float)(sqrt(sqrt(numRows))));
           } else {
             // GRF variables
-
-            auto refCount = getWeightedRefCount(lrs[i]->getDcl());
-            spillCost = 1.0f * refCount * refCount * refCount /
-                        ((float)(lrs[i]->getDegree() + 1) *
-                         (float)(lrs[i]->getDegree() + 1));
+            spillCost = getNewGRFSpillCost(lrs[i]);
           }
         }
       } else {
@@ -5557,10 +5580,7 @@ void GraphColor::computeSpillCosts(bool useSplitLLRHeuristic, const RPE *rpe) {
                                 lrs[i]->getRefCount() /
                                 (lrs[i]->getDegree() + 1);
         } else {
-          auto refCount = getWeightedRefCount(lrs[i]->getDcl());
-          spillCost = 1.0f * refCount * refCount * refCount /
-                      ((float)(lrs[i]->getDegree() + 1) *
-                       (float)(lrs[i]->getDegree() + 1));
+          spillCost = getNewGRFSpillCost(lrs[i]);
         }
       }
 
@@ -6476,7 +6496,7 @@ void GlobalRA::determineSpillRegSize(unsigned &spillRegSize,
                 for (auto pt : *pointsToSet) {
                   if (pt.var->isRegAllocPartaker() ||
                       ((builder.getOption(vISA_HybridRAWithSpill) ||
-                        builder.getOption(vISA_FastCompileRA)) &&
+                        kernel.useFastCompileRA()) &&
                        livenessCandidate(pt.var->getDeclare()))) {
                     indrVars.push_back(pt.var);
                     indrDstSpillRegSize += pt.var->getDeclare()->getNumRows();
@@ -6512,7 +6532,7 @@ void GlobalRA::determineSpillRegSize(unsigned &spillRegSize,
                 for (auto pt : *pointsToSet) {
                   if (pt.var->isRegAllocPartaker() ||
                       ((builder.getOption(vISA_HybridRAWithSpill) ||
-                        builder.getOption(vISA_FastCompileRA)) &&
+                        kernel.useFastCompileRA()) &&
                        livenessCandidate(pt.var->getDeclare()))) {
                     if (std::find(indrVars.begin(), indrVars.end(), pt.var) ==
                         indrVars.end()) {
@@ -6747,50 +6767,115 @@ bool GraphColor::regAlloc(bool doBankConflictReduction,
         kernel.fg.getHasStackCalls() || kernel.fg.getIsStackCallFunc();
 
     bool willSpill =
-        ((builder.getOption(vISA_FastCompileRA) ||
+        ((kernel.useFastCompileRA() ||
           builder.getOption(vISA_HybridRAWithSpill)) &&
          (!hasStackCall ||
           builder.getOption(vISA_PartitionWithFastHybridRA))) ||
         (kernel.getInt32KernelAttr(Attributes::ATTR_Target) == VISA_3D &&
          rpe->getMaxRP() >= kernel.getNumRegTotal() + 24);
-    if (willSpill) {
-      // go straight to first_fit to save compile time since we are definitely
-      // spilling we do this for 3D only since with indirect/subroutine the RP
-      // pressure can be very unreliable
-      // FIXME: due to factors like local split and scalar variables that are
-      // not accurately modeled in RP estimate, RA may succeed even when RP is >
-      // total #GRF. We should investigate these cases and fix RPE
-      assignColors(FIRST_FIT, false, false);
-      // assert(requireSpillCode() && "inaccurate GRF pressure estimate");
-      return !requireSpillCode();
-    }
 
-    if (kernel.getOption(vISA_RoundRobin) && !hasStackCall &&
-        !gra.isReRAPass()) {
-      if (assignColors(ROUND_ROBIN, doBankConflictReduction,
-                       highInternalConflict) == false) {
-        resetTemporaryRegisterAssignments();
-        bool success = assignColors(FIRST_FIT, doBankConflictReduction,
-                                    highInternalConflict);
+    // Return false if hybrid RA should give up.
+    auto assignGRFs = [&]() {
+      if (willSpill) {
+        // go straight to first_fit to save compile time since we are
+        // definitely spilling we do this for 3D only since with
+        // indirect/subroutine the RP pressure can be very unreliable
+        // FIXME: due to factors like local split and scalar variables that are
+        // not accurately modeled in RP estimate, RA may succeed even when RP
+        // is > total #GRF. We should investigate these cases and fix RPE
+        assignColors(FIRST_FIT, false, false);
+        // assert(requireSpillCode() && "inaccurate GRF pressure estimate");
+        return true;
+      }
 
-        if (!success && doBankConflictReduction && isHybrid) {
-          return false;
-        }
+      if (kernel.getOption(vISA_RoundRobin) && !hasStackCall &&
+          !gra.isReRAPass()) {
+        if (assignColors(ROUND_ROBIN, doBankConflictReduction,
+                         highInternalConflict) == false) {
+          resetTemporaryRegisterAssignments();
+          bool success = assignColors(FIRST_FIT, doBankConflictReduction,
+                                      highInternalConflict);
+
+          if (!success && doBankConflictReduction && isHybrid) {
+            return false;
+          }
 
-        if (!kernel.getOption(vISA_forceBCR)) {
-          if (!success && doBankConflictReduction) {
-            resetTemporaryRegisterAssignments();
-            kernel.getOptions()->setOption(vISA_enableBundleCR, false);
-            assignColors(FIRST_FIT, false, false);
-            kernel.getOptions()->setOption(vISA_enableBundleCR, true);
+          if (!kernel.getOption(vISA_forceBCR)) {
+            if (!success && doBankConflictReduction) {
+              resetTemporaryRegisterAssignments();
+              kernel.getOptions()->setOption(vISA_enableBundleCR, false);
+              assignColors(FIRST_FIT, false, false);
+              kernel.getOptions()->setOption(vISA_enableBundleCR, true);
+            }
           }
         }
+      } else {
+        bool success = assignColors(FIRST_FIT, true, highInternalConflict);
+        if (!success) {
+          resetTemporaryRegisterAssignments();
+          assignColors(FIRST_FIT, false, false);
+        }
       }
-    } else {
-      bool success = assignColors(FIRST_FIT, true, highInternalConflict);
-      if (!success) {
+      return true;
+    };
+
+    if (!assignGRFs()) {
+      return false;
+    }
+
+    // Both spill cost functions win on some kernels, so when coloring spills
+    // try the other one too and keep the assignment whose spill code is
+    // cheaper. The interference graph is shared, only coloring is redone.
+    // Under the 3D split heuristic both functions give the same costs.
+    bool sameSpillCosts =
+        useSplitLLRHeuristic &&
+        kernel.getInt32KernelAttr(Attributes::ATTR_Target) == VISA_3D;
+    if (requireSpillCode() && kernel.getOption(vISA_SpillCostTrials) &&
+        !isHybrid && !failSafeIter && !sameSpillCosts) {
+      uint64_t firstTraffic = estimateSpillTraffic();
+      // Save the first assignment so that it can be kept without coloring
+      // again. Spill costs are saved too, spilling uses them.
+      struct LRAssignment {
+        G4_VarBase *phyReg;
+        unsigned phyRegOff;
+        unsigned allocHint;
+        bool spilled;
+        float spillCost;
+      };
+      std::vector<LRAssignment> firstAssignment(numVar);
+      for (unsigned i = 0; i < numVar; i++) {
+        firstAssignment[i] = {lrs[i]->getPhyReg(), lrs[i]->getPhyRegOff(),
+                              lrs[i]->getAllocHint(), lrs[i]->isSpilled(),
+                              lrs[i]->getSpillCost()};
+      }
+      LIVERANGE_LIST firstSpilledLRs = spilledLRs;
+      std::vector<LiveRange *> firstColorOrder = colorOrder;
+
+      flipSpillCostFunction = true;
+      recomputeColorOrdering(useSplitLLRHeuristic, rpe);
+      assignGRFs();
+      flipSpillCostFunction = false;
+      uint64_t otherTraffic = estimateSpillTraffic();
+      if (builder.getOption(vISA_RATrace)) {
+        std::cout << "\t--spill cost trials: spill traffic " << firstTraffic
+                  << " vs " << otherTraffic << " with the other function, "
+                  << (otherTraffic < firstTraffic ? "keeping the other"
+                                                  : "keeping the first")
+                  << "\n";
+      }
+      if (otherTraffic >= firstTraffic) {
         resetTemporaryRegisterAssignments();
-        assignColors(FIRST_FIT, false, false);
+        for (unsigned i = 0; i < numVar; i++) {
+          const LRAssignment &a = firstAssignment[i];
+          if (lrs[i]->getVar()->getPhyReg() == nullptr && a.phyReg)
+            lrs[i]->setPhyReg(a.phyReg, a.phyRegOff);
+          if (a.allocHint != lrs[i]->getAllocHint())
+            lrs[i]->setAllocHint(a.allocHint);
+          lrs[i]->setSpilled(a.spilled);
+          lrs[i]->setSpillCost(a.spillCost);
+        }
+        spilledLRs = std::move(firstSpilledLRs);
+        colorOrder = std::move(firstColorOrder);
       }
     }
   } else if (liveAnalysis.livenessClass(G4_FLAG)) {
@@ -6810,6 +6895,40 @@ bool GraphColor::regAlloc(bool doBankConflictReduction,
   return (requireSpillCode() == false);
 }
 
+// Undo the current assignment and compute the color order again from scratch,
+// e.g. after changing the spill cost function.
+void GraphColor::recomputeColorOrdering(bool useSplitLLRHeuristic,
+                                        const RPE *rpe) {
+  resetTemporaryRegisterAssignments();
+  colorOrder.clear();
+  // determineColorOrdering consumed the degrees, recompute them.
+  evenTotalDegree = oddTotalDegree = 1;
+  evenTotalRegNum = oddTotalRegNum = 1;
+  evenMaxRegNum = oddMaxRegNum = 1;
+  computeDegreeForGRF();
+  computeSpillCosts(useSplitLLRHeuristic, rpe);
+  determineColorOrdering();
+}
+
+// Estimate the spill/fill traffic the current assignment needs. Under
+// -freqSpillCost it is the spill cycles of SpillCostModel. Otherwise it is the
+// references of the spilled live ranges, loop weighted when
+// vISA_ConsiderLoopInfoInRA is set, times their size in GRFs. Unlike spill
+// costs neither depends on the spill cost function, so assignments using
+// different functions compare.
+uint64_t GraphColor::estimateSpillTraffic() const {
+  uint64_t traffic = 0;
+  for (const LiveRange *lr : spilledLRs) {
+    if (!spillCycles.empty()) {
+      traffic += (uint64_t)spillCycles[lr->getVar()->getId()];
+      continue;
+    }
+    traffic += (uint64_t)lr->getRefCount() *
+               std::max<unsigned>(1, lr->getDcl()->getNumRows());
+  }
+  return traffic;
+}
+
 void GraphColor::confirmRegisterAssignments() {
   for (unsigned i = 0; i < numVar; i++) {
     if (lrs[i]->getPhyReg()) {
@@ -9589,7 +9708,7 @@ int GlobalRA::coloringRegAlloc() {
   uint32_t sendAssociatedGRFSpillFillCount = 0;
   unsigned fastCompileIter = 1;
   bool fastCompile =
-      (builder.getOption(vISA_FastCompileRA) ||
+      (kernel.useFastCompileRA() ||
        builder.getOption(vISA_HybridRAWithSpill)) &&
       (!hasStackCall || builder.getOption(vISA_PartitionWithFastHybridRA));
 
@@ -9636,6 +9755,8 @@ int GlobalRA::coloringRegAlloc() {
   DynPerfModel perfModel(kernel);
 
   while (iterationNo < maxRAIterations) {
+    CompileTraceScope traceScope(
+        "vISA", "GRF RA iteration " + std::to_string(iterationNo));
     if (builder.getOption(vISA_DynPerfModel)) {
       perfModel.NumRAIters++;
     }
@@ -9693,6 +9814,13 @@ int GlobalRA::coloringRegAlloc() {
       doBankConflictReduction = reduceBCInRR && reduceBCInTAandFF;
     }
 
+    // Out of compile budget: don't wait for vISA_FailSafeRALimit, make this
+    // the fail safe iteration.
+    if (iterationNo > 0 && iterationNo < failSafeRAIteration &&
+        builder.isCompileBudgetExceeded()) {
+      failSafeRAIteration = iterationNo;
+    }
+
     bool allowAddrTaken = builder.getOption(vISA_FastSpill) || fastCompile ||
                           !kernel.getHasAddrTaken();
     if (builder.getOption(vISA_FailSafeRA) &&
@@ -13,6 +13,7 @@ SPDX-License-Identifier: MIT
 #include "BitSet.h"
 #include "G4_IR.hpp"
 #include "RPE.h"
+#include "SpillCostModel.h"
 #include "SpillManagerGMRF.h"
 #include "VarSplit.h"
 
@@ -593,6 +594,19 @@ class GraphColor {
 
   bool failSafeIter = false;
 
+  // Use the other spill cost function than the one selected by the options,
+  // see -spillCostTrials.
+  bool flipSpillCostFunction = false;
+  // Spill cycles of each live range from SpillCostModel, indexed by live range
+  // id. Only computed for GRF under -freqSpillCost, empty otherwise.
+  std::vector<float> spillCycles;
+  // GRF references used by computeSpillCosts. The IR does not change while
+  // coloring, so they are shared by every computeSpillCosts call and by the
+  // spill cost model.
+  VarReferences directRefs;
+  // Built by the first computeSpillCosts call for GRF under -freqSpillCost.
+  std::unique_ptr<SpillCostModel> spillCostModel;
+
   unsigned edgeWeightGRF(const LiveRange *lr1, const LiveRange *lr2);
   unsigned edgeWeightARF(const LiveRange *lr1, const LiveRange *lr2);
 
@@ -600,6 +614,8 @@ class GraphColor {
   void computeDegreeForARF();
   void computeSpillCosts(bool useSplitLLRHeuristic, const RPE *rpe);
   void determineColorOrdering();
+  void recomputeColorOrdering(bool useSplitLLRHeuristic, const RPE *rpe);
+  uint64_t estimateSpillTraffic() const;
   void removeConstrained();
   void relaxNeighborDegreeGRF(LiveRange *lr);
   void relaxNeighborDegreeARF(LiveRange *lr);
@@ -633,6 +649,7 @@ public:
   void createLiveRanges(unsigned reserveSpillSize = 0);
   LiveRange **getLiveRanges() const { return lrs; }
   const LIVERANGE_LIST &getSpilledLiveRanges() const { return spilledLRs; }
+  SpillCostModel *getSpillCostModel() const { return spillCostModel.get(); }
   void confirmRegisterAssignments();
   void resetTemporaryRegisterAssignments();
   void cleanupRedundantARFFillCode();
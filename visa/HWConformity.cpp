@@ -6406,11 +6406,12 @@ void HWConformity::chkHWConformity() {
 #endif
   }
 
+  // Everything above may have changed the IR. avoidDstSrcOverlap only
+  // inserts GRF copies, which the points-to sets do not depend on, so LVN
+  // can reuse them.
+  kernel.invalidateAnalyses(IRC_All);
   if (builder.avoidDstSrcOverlap()) {
-    PointsToAnalysis p(kernel.Declares, kernel.fg.getNumBB());
-    p.doPointsToAnalysis(kernel.fg);
-
-    avoidDstSrcOverlap(p);
+    avoidDstSrcOverlap(kernel.getAnalyses().getPointsToAnalysis());
   }
 }
 
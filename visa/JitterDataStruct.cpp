@@ -22,7 +22,15 @@ llvm::json::Value PERF_STATS::toJSON() {
                             {"numGRFSpillFill", numGRFSpillFillWeighted},
                             {"GRFSpillSize", spillMemUsed},
                             {"numCycles", numCycles},
-                            {"maxGRFPressure", maxGRFPressure}};
+                            {"maxGRFPressure", maxGRFPressure},
+                            {"simdSize", simdSize},
+                            {"sendStallCycle", sendStallCycle},
+                            {"staticCycle", staticCycle},
+                            {"loopNestedStallCycle", loopNestedStallCycle},
+                            {"loopNestedCycle", loopNestedCycle},
+                            {"compileBudgetExceeded", compileBudgetExceeded},
+                            {"compactionCacheHits", compactionCacheHits},
+                            {"compactionCacheMisses", compactionCacheMisses}};
 }
 
 llvm::json::Value PERF_STATS_VERBOSE::toJSON() {
@@ -152,7 +152,7 @@ void LocalRA::preLocalRAAnalysis() {
   gra.removeUnreferencedDcls();
 
   if (builder.getOption(vISA_HybridRAWithSpill) ||
-      builder.getOption(vISA_FastCompileRA)) {
+      kernel.useFastCompileRA()) {
     unsigned reserveSpillSize = 0;
     unsigned int spillRegSize = 0;
     unsigned int indrSpillRegSize = 0;
@@ -164,6 +164,7 @@ void LocalRA::preLocalRAAnalysis() {
           ->setOption(vISA_HybridRAWithSpill, false);
       const_cast<Options *>(builder.getOptions())
           ->setOption(vISA_FastCompileRA, false);
+      kernel.setBudgetFastCompileRA(false);
       numRegLRA = numGRF - numRowsReserved;
     } else {
       numRegLRA = numGRF - numRowsReserved - reserveSpillSize -
@@ -254,6 +254,10 @@ public:
     // This indicates which operand this node is tracking.
     Gen4_Operand_Number OpNum;
 
+    // GRF rows of the declare touched by this operand, see LiveDcl.
+    unsigned FirstRow = 0;
+    unsigned LastRow = 0;
+
     // Check if this is a read/write operand.
     bool isWrite() const {
       return OpNum == Gen4_Operand_Number::Opnd_dst ||
@@ -265,13 +269,40 @@ public:
     friend void swap(LiveNode &a, LiveNode &b) {
       std::swap(a.N, b.N);
       std::swap(a.OpNum, b.OpNum);
+      std::swap(a.FirstRow, b.FirstRow);
+      std::swap(a.LastRow, b.LastRow);
+    }
+  };
+
+  // Live nodes of one declare.
+  //
+  // Nodes is the list of live nodes, in the order they are visited: new
+  // nodes are appended and a killed node is replaced by the last one.
+  // WriteRows and ReadRows index the positions in Nodes by the GRF rows of
+  // the declare their operand touches, so that an operand only visits the
+  // live nodes it may overlap, and a read only visits the live writes. This
+  // keeps DAG construction near-linear in large blocks where a declare has
+  // many live nodes. Operands whose footprint is not known (indirect, acc,
+  // flag, pseudo kill, etc.) are indexed in every row.
+  struct LiveDcl {
+    std::vector<LiveNode> Nodes;
+    std::vector<std::vector<unsigned>> WriteRows;
+    std::vector<std::vector<unsigned>> ReadRows;
+
+    unsigned getNumRows() const { return (unsigned)WriteRows.size(); }
+    std::vector<std::vector<unsigned>> &rows(const LiveNode &LN) {
+      return LN.isWrite() ? WriteRows : ReadRows;
     }
   };
 
 private:
   // Keep live nodes while scanning the block.
   // Each declare is associated with a list of live nodes.
-  std::unordered_map<const G4_Declare *, std::vector<LiveNode>> LiveNodes;
+  std::unordered_map<const G4_Declare *, LiveDcl> LiveNodes;
+
+  // Scratch buffer for the positions of the live nodes to be checked against
+  // the current operand.
+  std::vector<unsigned> Candidates;
 
   // Use an extra list to track physically assigned nodes, I.e. a0.2 etc.
   std::vector<LiveNode> LivePhysicalNodes;
@@ -289,9 +320,12 @@ private:
 
   // Create a new edge from pred->succ of type D.
   void addEdge(preNode *pred, preNode *succ, DepType D) {
-    auto fn = [=](const preEdge &E) { return E.getNode() == succ; };
-    if (pred->succ_end() ==
-        std::find_if(pred->succ_begin(), pred->succ_end(), fn)) {
+    // All edges out of pred are added while pred is being added to the
+    // graph, so an existing pred->succ edge is the last pred of succ.
+    vASSERT(succ->pred_empty() || succ->Preds.back().getNode() == pred ||
+            std::none_of(pred->succ_begin(), pred->succ_end(),
+                         [=](const preEdge &E) { return E.getNode() == succ; }));
+    if (succ->pred_empty() || succ->Preds.back().getNode() != pred) {
       pred->Succs.emplace_back(succ, D);
       succ->Preds.emplace_back(pred, D);
     }
@@ -301,6 +335,15 @@ private:
   void processSend(preNode *curNode);
   void processReadWrite(preNode *curNode);
   void prune();
+
+  // Helpers to maintain LiveNodes.
+  void addLiveNode(G4_Declare *Dcl, preNode *N, Gen4_Operand_Number OpNum);
+  void killLiveNode(LiveDcl &LD, unsigned Pos);
+  // Collect into Candidates the positions, in visiting order, of the live
+  // writes (and reads if WithReads) of LD that may overlap Opnd.
+  void getCandidates(LiveDcl &LD, G4_Operand *Opnd, bool WithReads);
+  std::pair<unsigned, unsigned> getRows(const LiveDcl &LD,
+                                        G4_Operand *Opnd) const;
 };
 
 // Track and recompute register pressure for a block.
@@ -2067,7 +2110,7 @@ void preDDD::addNodeToGraph(preNode *N) {
     G4_Operand *Opnd = N->getInst()->getOperand(OpNum);
     vASSERT(Opnd != nullptr);
     G4_Declare *Dcl = Opnd->getTopDcl();
-    LiveNodes[Dcl].emplace_back(N, OpNum);
+    addLiveNode(Dcl, N, OpNum);
 
     if (isPhyicallyAllocatedRegVar(Opnd))
       LivePhysicalNodes.emplace_back(N, OpNum);
@@ -2091,12 +2134,17 @@ void preDDD::processBarrier(preNode *curNode, DepType Dep) {
   // A barrier kills all live nodes, so add dependency edge to all live
   // nodes and clear.
   for (auto &Nodes : LiveNodes) {
-    for (LiveNode &X : Nodes.second) {
+    LiveDcl &LD = Nodes.second;
+    for (LiveNode &X : LD.Nodes) {
       if (X.N->pred_empty()) {
         addEdge(curNode, X.N, Dep);
       }
     }
-    Nodes.second.clear();
+    LD.Nodes.clear();
+    for (auto &Row : LD.WriteRows)
+      Row.clear();
+    for (auto &Row : LD.ReadRows)
+      Row.clear();
   }
 
   for (auto &X : LivePhysicalNodes) {
@@ -2219,6 +2267,108 @@ getDepAndRel(G4_Operand *Opnd, const preDDD::LiveNode &LN, DepType Dep) {
   return std::make_pair(Dep, Rel);
 }
 
+// Return the first and last GRF rows of the declare that the given operand
+// may touch. Operands without a precise footprint touch all rows.
+std::pair<unsigned, unsigned> preDDD::getRows(const LiveDcl &LD,
+                                              G4_Operand *Opnd) const {
+  unsigned NumRows = LD.getNumRows();
+  vASSERT(NumRows > 0);
+  auto AllRows = std::make_pair(0u, NumRows - 1);
+  if (NumRows == 1)
+    return AllRows;
+
+  // Only direct GRF regions are compared by their bounds, see
+  // compareRegRegionToOperand.
+  if (!Opnd->isDstRegRegion() && !Opnd->isSrcRegRegion())
+    return AllRows;
+  if (Opnd->isIndirect() || isPhyicallyAllocatedRegVar(Opnd))
+    return AllRows;
+  G4_INST *Inst = Opnd->getInst();
+  if (!Inst || Inst->isPseudoKill() || Inst->isLifeTimeEnd())
+    return AllRows;
+
+  unsigned GRFSize = kernel.getGRFSize();
+  unsigned FirstRow = Opnd->getLeftBound() / GRFSize;
+  unsigned LastRow = Opnd->getRightBound() / GRFSize;
+  if (FirstRow >= NumRows || LastRow < FirstRow)
+    return AllRows;
+  return std::make_pair(FirstRow, std::min(LastRow, NumRows - 1));
+}
+
+void preDDD::addLiveNode(G4_Declare *Dcl, preNode *N,
+                         Gen4_Operand_Number OpNum) {
+  LiveDcl &LD = LiveNodes[Dcl];
+  if (LD.getNumRows() == 0) {
+    unsigned NumRows = 1;
+    if (Dcl && Dcl->getRegFile() == G4_GRF) {
+      unsigned GRFSize = kernel.getGRFSize();
+      NumRows = std::max(1u, (Dcl->getByteSize() + GRFSize - 1) / GRFSize);
+    }
+    LD.WriteRows.resize(NumRows);
+    LD.ReadRows.resize(NumRows);
+  }
+
+  unsigned Pos = (unsigned)LD.Nodes.size();
+  LD.Nodes.emplace_back(N, OpNum);
+  LiveNode &LN = LD.Nodes.back();
+  auto Rows = getRows(LD, N->getInst()->getOperand(OpNum));
+  LN.FirstRow = Rows.first;
+  LN.LastRow = Rows.second;
+
+  auto &Positions = LD.rows(LN);
+  for (unsigned Row = LN.FirstRow; Row <= LN.LastRow; ++Row)
+    Positions[Row].push_back(Pos);
+}
+
+// Remove the live node at Pos, the last live node takes its position.
+void preDDD::killLiveNode(LiveDcl &LD, unsigned Pos) {
+  auto replacePos = [](std::vector<unsigned> &Row, unsigned From,
+                       unsigned To) {
+    auto Iter = std::find(Row.begin(), Row.end(), From);
+    vASSERT(Iter != Row.end());
+    *Iter = To;
+  };
+
+  LiveNode &Killed = LD.Nodes[Pos];
+  auto &KilledRows = LD.rows(Killed);
+  for (unsigned Row = Killed.FirstRow; Row <= Killed.LastRow; ++Row) {
+    auto &Positions = KilledRows[Row];
+    replacePos(Positions, Pos, Positions.back());
+    Positions.pop_back();
+  }
+
+  unsigned LastPos = (unsigned)LD.Nodes.size() - 1;
+  if (Pos != LastPos) {
+    LiveNode &Last = LD.Nodes[LastPos];
+    auto &LastRows = LD.rows(Last);
+    for (unsigned Row = Last.FirstRow; Row <= Last.LastRow; ++Row)
+      replacePos(LastRows[Row], LastPos, Pos);
+  }
+
+  auto Iter = LD.Nodes.begin() + Pos;
+  kill_if(true, LD.Nodes, Iter);
+}
+
+void preDDD::getCandidates(LiveDcl &LD, G4_Operand *Opnd, bool WithReads) {
+  Candidates.clear();
+  auto Rows = getRows(LD, Opnd);
+  unsigned FirstRow = Rows.first, LastRow = Rows.second;
+  for (unsigned Row = FirstRow; Row <= LastRow; ++Row) {
+    auto &Writes = LD.WriteRows[Row];
+    Candidates.insert(Candidates.end(), Writes.begin(), Writes.end());
+    if (WithReads) {
+      auto &Reads = LD.ReadRows[Row];
+      Candidates.insert(Candidates.end(), Reads.begin(), Reads.end());
+    }
+  }
+  // Visit in the order of the live node list. A node spanning several rows
+  // is collected once per row.
+  std::sort(Candidates.begin(), Candidates.end());
+  if (FirstRow != LastRow)
+    Candidates.erase(std::unique(Candidates.begin(), Candidates.end()),
+                     Candidates.end());
+}
+
 // This is not a label nor a barrier and check the dependency
 // introduced by this node.
 void preDDD::processReadWrite(preNode *curNode) {
@@ -2230,23 +2380,43 @@ void preDDD::processReadWrite(preNode *curNode) {
     if (opnd == nullptr || opnd->getBase() == nullptr || opnd->isNullReg())
       continue;
     G4_Declare *Dcl = opnd->getTopDcl();
-    auto &Nodes = LiveNodes[Dcl];
-    // Iterate all live nodes associated to the same declaration.
-    for (auto Iter = Nodes.begin(); Iter != Nodes.end(); /*empty*/) {
-      LiveNode &liveNode = *Iter;
-      DepType Dep = getDep(opnd, liveNode);
-      if (Dep == DepType::NODEP) {
-        ++Iter;
-      } else {
+    auto LDIter = LiveNodes.find(Dcl);
+    if (LDIter != LiveNodes.end()) {
+      LiveDcl &LD = LDIter->second;
+      // Iterate all live nodes associated to the same declaration that may
+      // overlap this operand.
+      getCandidates(LD, opnd, /*WithReads*/ true);
+      for (size_t i = 0; i < Candidates.size(); /*empty*/) {
+        unsigned Pos = Candidates[i];
+        LiveNode &liveNode = LD.Nodes[Pos];
+        DepType Dep = getDep(opnd, liveNode);
+        if (Dep == DepType::NODEP) {
+          ++i;
+          continue;
+        }
         auto DepRel = getDepAndRel(opnd, liveNode, Dep);
-        if (DepRel.first != DepType::NODEP) {
-          addEdge(curNode, liveNode.N, Dep);
-          // Check if this kills current live node. If yes, remove it.
-          bool pred = DepRel.second == G4_CmpRelation::Rel_eq ||
-                      DepRel.second == G4_CmpRelation::Rel_gt;
-          Iter = kill_if(pred, Nodes, Iter);
-        } else
-          ++Iter;
+        if (DepRel.first == DepType::NODEP) {
+          ++i;
+          continue;
+        }
+        addEdge(curNode, liveNode.N, Dep);
+        // Check if this kills current live node. If yes, remove it.
+        bool pred = DepRel.second == G4_CmpRelation::Rel_eq ||
+                    DepRel.second == G4_CmpRelation::Rel_gt;
+        if (!pred) {
+          ++i;
+          continue;
+        }
+        unsigned LastPos = (unsigned)LD.Nodes.size() - 1;
+        killLiveNode(LD, Pos);
+        // The last live node now takes the killed one's position and is
+        // visited next, if it may overlap this operand.
+        if (LastPos != Pos && Candidates.back() == LastPos) {
+          Candidates.pop_back();
+          Candidates[i] = Pos;
+        } else {
+          ++i;
+        }
       }
     }
 
@@ -2286,20 +2456,23 @@ void preDDD::processReadWrite(preNode *curNode) {
       continue;
 
     G4_Declare *Dcl = opnd->getTopDcl();
-    auto &Nodes = LiveNodes[Dcl];
-    // Iterate all live nodes associated to the same declaration.
-    for (auto &liveNode : Nodes) {
-      // Skip read live nodes.
-      if (liveNode.isRead())
-        continue;
-
-      DepType Dep = getDep(opnd, liveNode);
-      if (Dep == DepType::NODEP)
-        continue;
-      std::pair<DepType, G4_CmpRelation> DepRel =
-          getDepAndRel(opnd, liveNode, Dep);
-      if (DepRel.first != DepType::NODEP)
-        addEdge(curNode, liveNode.N, DepRel.first);
+    auto LDIter = LiveNodes.find(Dcl);
+    if (LDIter != LiveNodes.end()) {
+      LiveDcl &LD = LDIter->second;
+      // Iterate live writes associated to the same declaration that may
+      // overlap this operand.
+      getCandidates(LD, opnd, /*WithReads*/ false);
+      for (unsigned Pos : Candidates) {
+        LiveNode &liveNode = LD.Nodes[Pos];
+        vASSERT(liveNode.isWrite());
+        DepType Dep = getDep(opnd, liveNode);
+        if (Dep == DepType::NODEP)
+          continue;
+        std::pair<DepType, G4_CmpRelation> DepRel =
+            getDepAndRel(opnd, liveNode, Dep);
+        if (DepRel.first != DepType::NODEP)
+          addEdge(curNode, liveNode.N, DepRel.first);
+      }
     }
 
     // If this is a physically allocated regvar, then check dependency on the
@@ -7,6 +7,7 @@ SPDX-License-Identifier: MIT
 ============================= end_copyright_notice ===========================*/
 
 #include "LocalScheduler_G4IR.h"
+#include "../AnalysisManager.h"
 #include "../G4_Opcode.h"
 #include "../PointsToAnalysis.h"
 #include "../Timer.h"
@@ -37,8 +38,7 @@ void LocalScheduler::localScheduling() {
   const Options *m_options = fg.builder->getOptions();
   LatencyTable LT(fg.builder);
 
-  PointsToAnalysis p(fg.getKernel()->Declares, fg.size());
-  p.doPointsToAnalysis(fg);
+  PointsToAnalysis &p = fg.getKernel()->getAnalyses().getPointsToAnalysis();
 
   uint32_t totalCycles = 0;
   uint32_t scheduleStartBBId =
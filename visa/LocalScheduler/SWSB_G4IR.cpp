@@ -7,6 +7,7 @@ SPDX-License-Identifier: MIT
 ============================= end_copyright_notice ===========================*/
 
 #include "SWSB_G4IR.h"
+#include "../AnalysisManager.h"
 #include "../G4_Opcode.h"
 #include "../PointsToAnalysis.h"
 #include "../Timer.h"
@@ -1620,7 +1621,8 @@ void SWSB::SWSBGlobalTokenGenerator(PointsToAnalysis &p, LiveGRFBuckets &LB,
     tokenAllocationGlobal();
   } else if (enableDistPropTokenAllocation) {
     tokenAllocationGlobalWithPropogation();
-  } else if (fg.builder->getOptions()->getOption(vISA_QuickTokenAllocation)) {
+  } else if (fg.builder->getOptions()->getOption(vISA_QuickTokenAllocation) ||
+             fg.getKernel()->isCompileBudgetExceeded()) {
     quickTokenAllocation();
   } else {
     tokenAllocation();
@@ -1885,10 +1887,9 @@ void SWSB::getDominators(ImmDominator *dom) {
 //
 void SWSB::SWSBGenerator() {
   DEBUG_VERBOSE("[SWSB]: Starting...");
-  PointsToAnalysis p(kernel.Declares, kernel.fg.getNumBB());
-  p.doPointsToAnalysis(kernel.fg);
-
   kernel.fg.reassignBlockIDs();
+  PointsToAnalysis &p = kernel.getAnalyses().getPointsToAnalysis();
+
   kernel.fg.findBackEdges();
   kernel.fg.findNaturalLoops();
 
@@ -2616,94 +2617,215 @@ void SWSB::addToLiveList(SBNode *node) {
   return;
 }
 
+// Sparse forward dataflow driver shared by the global SWSB analyses.
 //
-//  Global reaching define analysis for tokens
-//
-bool SWSB::globalTokenReachAnalysis(G4_BB *bb) {
-  bool changed = false;
-  unsigned bbID = bb->getId();
-
-  // Do nothing for the entry BB
-  // Because it has no live in
-  if (bb->Preds.empty()) {
-    return false;
-  }
-
-  vASSERT(BBVector[bbID]->liveInTokenNodes.getSize() != 0);
-
-  BitSet temp_live_in(unsigned(SBSendNodes.size()), false);
-  temp_live_in = BBVector[bbID]->liveInTokenNodes;
-
-  // Union all of out of SIMDCF predecessor BB to the live in of current BB.
-  for (const G4_BB_SB *predBB : BBVector[bbID]->Preds) {
-    unsigned predID = predBB->getBB()->getId();
-    temp_live_in |= BBVector[predID]->liveOutTokenNodes;
+// A fact is one bit of the live-in/live-out sets of a BB. Each BB is seeded
+// once with its live-in merged with the live-out of its predecessors, a dense
+// union done once per BB. After that, only the facts that newly become
+// live-out of a BB are passed to its successors, so the work of a visit is
+// proportional to the number of facts that reach the BB for the first time
+// through one of its predecessors, not to the number of global sends. The
+// transfer function appends to newOut the facts it adds to the live-out of
+// the BB; facts given again are just skipped, as the transfer functions only
+// ever set bits. BBs are popped in layout order so loops still converge in few
+// passes. The result is the least fixed point above the initial sets.
+template <typename SeedFn, typename TransferFn, typename SuccFn>
+static void runSparseForward(FlowGraph &fg, size_t numBBIds, SeedFn seed,
+                             TransferFn transfer, SuccFn forEachSucc) {
+  std::vector<G4_BB *> layout(fg.begin(), fg.end());
+  std::vector<unsigned> layoutPos(numBBIds, 0);
+  for (unsigned i = 0; i < layout.size(); i++) {
+    layoutPos[layout[i]->getId()] = i;
+  }
+
+  std::vector<std::vector<unsigned>> pending(numBBIds);
+  for (G4_BB *bb : layout) {
+    seed(bb, pending[bb->getId()]);
+  }
+
+  std::priority_queue<unsigned, std::vector<unsigned>, std::greater<unsigned>>
+      worklist;
+  std::vector<bool> inWorklist(layout.size(), true);
+  for (unsigned i = 0; i < layout.size(); i++) {
+    worklist.push(i);
+  }
+
+  std::vector<unsigned> facts;
+  std::vector<unsigned> newOut;
+  while (!worklist.empty()) {
+    unsigned pos = worklist.top();
+    worklist.pop();
+    inWorklist[pos] = false;
+
+    G4_BB *bb = layout[pos];
+    facts.clear();
+    facts.swap(pending[bb->getId()]);
+    newOut.clear();
+    transfer(bb, facts, newOut);
+    if (newOut.empty()) {
+      continue;
+    }
+    forEachSucc(bb, [&](const G4_BB *succ) {
+      std::vector<unsigned> &succFacts = pending[succ->getId()];
+      succFacts.insert(succFacts.end(), newOut.begin(), newOut.end());
+      unsigned succPos = layoutPos[succ->getId()];
+      if (!inWorklist[succPos]) {
+        inWorklist[succPos] = true;
+        worklist.push(succPos);
+      }
+    });
   }
+}
 
-  // Union all of out of scalar predecessor BB to the live in of current BB.
-  for (const G4_BB *predBB : bb->Preds) {
-    unsigned predID = predBB->getId();
-    temp_live_in |= BBVector[predID]->liveOutTokenNodes;
+// Appends the indices of the bits set in bs to facts, as 2 * index + offset.
+static void appendFacts(const BitSet &bs, unsigned offset,
+                        std::vector<unsigned> &facts) {
+  unsigned size = bs.getSize();
+  for (int i = bs.findFirstIn(0, size); i != -1;
+       i = bs.findFirstIn(unsigned(i) + 1, size)) {
+    facts.push_back(2 * unsigned(i) + offset);
   }
+}
 
-  // Changed? Yes, get the new live in, other wise do nothing
-  if (temp_live_in != BBVector[bbID]->liveInTokenNodes) {
-    changed = true;
-    BBVector[bbID]->liveInTokenNodes = temp_live_in;
+//
+// Global reaching define analysis for tokens
+// live_in(BBi) = Union(live_out(BBj)) // BBj is a scalar or SIMD predecessor
+// live_out(BBi) += live_in(BBi) - killed(BBi)
+// A fact is the sendID of a node.
+//
+void SWSB::globalTokenReachAnalysis(G4_BB *bb, const BitSet &killedNodes,
+                                    const std::vector<unsigned> &newLiveIn,
+                                    std::vector<unsigned> &newLiveOut) {
+  // Do nothing for the entry BB
+  // Because it has no live in
+  if (bb->Preds.empty()) {
+    return;
   }
 
-  // Calculate the live out according to the live in and killed tokens in
-  // current BB
-  for (uint32_t token = 0; token < totalTokenNum; token++) {
-    if (BBVector[bbID]->killedTokens.isSet(token)) {
-      temp_live_in -= allTokenNodesMap[token].bitset;
+  G4_BB_SB *sb_bb = BBVector[bb->getId()];
+  for (unsigned node : newLiveIn) {
+    sb_bb->liveInTokenNodes.set(node, true);
+    if (!killedNodes.isSet(node) && !sb_bb->liveOutTokenNodes.isSet(node)) {
+      sb_bb->liveOutTokenNodes.set(node, true);
+      newLiveOut.push_back(node);
     }
   }
-
-  // Get the new live out,
-  // FIXME: is it right? the live out is always assigned in increasing.
-  // Original, we only have local live out.
-  // should we separate the local live out vs total live out?
-  // Not necessary, can live out, will always be live out.
-  BBVector[bbID]->liveOutTokenNodes |= temp_live_in;
-
-  return changed;
 }
 
 void SWSB::SWSBGlobalTokenAnalysis() {
-  bool change = true;
-  while (change) {
-    change = false;
-    for (G4_BB *bb : fg) {
-      if (globalTokenReachAnalysis(bb)) {
-        change = true;
+  // The killed tokens of a BB don't change during the analysis, merge their
+  // nodes once instead of once per visit.
+  std::vector<BitSet> killedTokenNodes(BBVector.size());
+  for (G4_BB_SB *sb_bb : BBVector) {
+    BitSet &killedNodes = killedTokenNodes[sb_bb->getBB()->getId()];
+    killedNodes = BitSet(unsigned(SBSendNodes.size()), false);
+    for (uint32_t token = 0; token < sb_bb->killedTokens.getSize(); token++) {
+      if (sb_bb->killedTokens.isSet(token)) {
+        killedNodes |= allTokenNodesMap[token].bitset;
       }
     }
   }
+
+  runSparseForward(
+      fg, BBVector.size(),
+      [&](G4_BB *bb, std::vector<unsigned> &facts) {
+        if (bb->Preds.empty()) {
+          return;
+        }
+        G4_BB_SB *sb_bb = BBVector[bb->getId()];
+        BitSet liveIn = sb_bb->liveInTokenNodes;
+        for (const G4_BB_SB *predBB : sb_bb->Preds) {
+          liveIn |= predBB->liveOutTokenNodes;
+        }
+        for (const G4_BB *predBB : bb->Preds) {
+          liveIn |= BBVector[predBB->getId()]->liveOutTokenNodes;
+        }
+        unsigned size = liveIn.getSize();
+        for (int i = liveIn.findFirstIn(0, size); i != -1;
+             i = liveIn.findFirstIn(unsigned(i) + 1, size)) {
+          facts.push_back(unsigned(i));
+        }
+      },
+      [&](G4_BB *bb, const std::vector<unsigned> &facts,
+          std::vector<unsigned> &newOut) {
+        globalTokenReachAnalysis(bb, killedTokenNodes[bb->getId()], facts,
+                                 newOut);
+      },
+      [&](G4_BB *bb, auto &&visit) {
+        for (const G4_BB_SB *succBB : BBVector[bb->getId()]->Succs) {
+          visit(succBB->getBB());
+        }
+        for (const G4_BB *succBB : bb->Succs) {
+          visit(succBB);
+        }
+      });
+}
+
+// Seeds the send facts of bb for the global dependence analyses: its live-in
+// merged with the live-out of its scalar or SIMD predecessors. A fact is
+// 2 * globalID for the dst of a send and 2 * globalID + 1 for its sources.
+template <typename PredFn>
+static void seedSendFacts(const G4_BB_SB *sb_bb, PredFn forEachPred,
+                          std::vector<unsigned> &facts) {
+  SBBitSets liveIn(sb_bb->send_live_in.getSize());
+  liveIn = sb_bb->send_live_in;
+  forEachPred([&](const G4_BB_SB *predBB) { liveIn |= predBB->send_live_out; });
+  appendFacts(liveIn.dst, 0, facts);
+  appendFacts(liveIn.src, 1, facts);
 }
 
 void SWSB::SWSBGlobalScalarCFGReachAnalysis() {
-  bool change = true;
-  while (change) {
-    change = false;
-    for (G4_BB *bb : fg) {
-      if (globalDependenceDefReachAnalysis(bb)) {
-        change = true;
-      }
-    }
-  }
+  runSparseForward(
+      fg, BBVector.size(),
+      [&](G4_BB *bb, std::vector<unsigned> &facts) {
+        if (bb->Preds.empty()) {
+          return;
+        }
+        seedSendFacts(
+            BBVector[bb->getId()],
+            [&](auto &&visit) {
+              for (const G4_BB *predBB : bb->Preds) {
+                visit(BBVector[predBB->getId()]);
+              }
+            },
+            facts);
+      },
+      [&](G4_BB *bb, const std::vector<unsigned> &facts,
+          std::vector<unsigned> &newOut) {
+        globalDependenceDefReachAnalysis(bb, facts, newOut);
+      },
+      [&](G4_BB *bb, auto &&visit) {
+        for (const G4_BB *succBB : bb->Succs) {
+          visit(succBB);
+        }
+      });
 }
 
 void SWSB::SWSBGlobalSIMDCFGReachAnalysis() {
-  bool change = true;
-  while (change) {
-    change = false;
-    for (G4_BB *bb : fg) {
-      if (globalDependenceUseReachAnalysis(bb)) {
-        change = true;
-      }
-    }
-  }
+  runSparseForward(
+      fg, BBVector.size(),
+      [&](G4_BB *bb, std::vector<unsigned> &facts) {
+        if (bb->Preds.empty()) {
+          return;
+        }
+        seedSendFacts(
+            BBVector[bb->getId()],
+            [&](auto &&visit) {
+              for (const G4_BB_SB *predBB : BBVector[bb->getId()]->Preds) {
+                visit(predBB);
+              }
+            },
+            facts);
+      },
+      [&](G4_BB *bb, const std::vector<unsigned> &facts,
+          std::vector<unsigned> &newOut) {
+        globalDependenceUseReachAnalysis(bb, facts, newOut);
+      },
+      [&](G4_BB *bb, auto &&visit) {
+        for (const G4_BB_SB *succBB : BBVector[bb->getId()]->Succs) {
+          visit(succBB->getBB());
+        }
+      });
 }
 
 void SWSB::setTopTokenIndex() {
@@ -4675,83 +4797,81 @@ void SWSB::buildLiveIntervals() {
 //
 // live_in(BBi) = Union(def_out(BBj)) // BBj is predecessor of BBi
 // live_out(BBi) += live_in(BBi) - may_kill(BBi)
+// Adds the given facts to the live in of bb, see seedSendFacts, and appends
+// the ones added to its live out to newLiveOut.
 //
-bool SWSB::globalDependenceDefReachAnalysis(G4_BB *bb) {
-  bool changed = false;
-  unsigned bbID = bb->getId();
-
+void SWSB::globalDependenceDefReachAnalysis(
+    G4_BB *bb, const std::vector<unsigned> &newLiveIn,
+    std::vector<unsigned> &newLiveOut) {
   if (bb->Preds.empty()) {
-    return false;
-  }
-
-  SBBitSets temp_live_in(globalSendNum);
-  temp_live_in = BBVector[bbID]->send_live_in;
-
-  for (const G4_BB *predBB : bb->Preds) {
-    unsigned predID = predBB->getId();
-    temp_live_in |= BBVector[predID]->send_live_out;
+    return;
   }
 
-  if (temp_live_in != BBVector[bbID]->send_live_in) {
-    changed = true;
-    BBVector[bbID]->send_live_in = temp_live_in;
+  G4_BB_SB *sb_bb = BBVector[bb->getId()];
+  for (unsigned fact : newLiveIn) {
+    unsigned globalID = fact / 2;
+    bool killed = false;
+    if (fact % 2 == 0) {
+      sb_bb->send_live_in.setDst(globalID, true);
+      // Record the killed dst in scalar CF iterating
+      killed = sb_bb->send_may_kill.isDstSet(globalID);
+      if (killed) {
+        sb_bb->send_kill_scalar.setDst(globalID, true);
+      } else if (!sb_bb->send_live_out.isDstSet(globalID)) {
+        sb_bb->send_live_out.setDst(globalID, true);
+        newLiveOut.push_back(fact);
+      }
+    } else {
+      sb_bb->send_live_in.setSrc(globalID, true);
+      // Record the killed src in scalar CF iterating
+      // once dst is killed, src definitely is killed
+      killed = sb_bb->send_may_kill.isSrcSet(globalID) ||
+               sb_bb->send_may_kill.isDstSet(globalID);
+      if (killed) {
+        sb_bb->send_kill_scalar.setSrc(globalID, true);
+      } else if (!sb_bb->send_live_out.isSrcSet(globalID)) {
+        sb_bb->send_live_out.setSrc(globalID, true);
+        newLiveOut.push_back(fact);
+      }
+    }
   }
-
-  // Record the killed dst and src in scalar CF iterating
-  SBBitSets temp_kill(globalSendNum);
-  temp_kill = temp_live_in;
-  temp_kill &= BBVector[bbID]->send_may_kill;
-  BBVector[bbID]->send_kill_scalar |= temp_kill;
-
-  temp_kill = temp_live_in;
-  temp_kill.src &= BBVector[bbID]->send_may_kill.dst;
-  BBVector[bbID]->send_kill_scalar.src |= temp_kill.src;
-
-  // Kill nodes
-  // once dst is killed, src definitely is killed
-  temp_live_in -= BBVector[bbID]->send_may_kill;
-  temp_live_in.src -= BBVector[bbID]->send_may_kill.dst;
-
-  BBVector[bbID]->send_live_out |= temp_live_in;
-
-  return changed;
 }
 
 //
 // live_in(BBi) = Union(def_out(BBj)) // BBj is predecessor of BBi
 // live_out(BBi) += live_in(BBi) - may_kill(BBi)
+// Adds the given facts to the live in of bb, see seedSendFacts, and appends
+// the ones added to its live out to newLiveOut.
 //
-bool SWSB::globalDependenceUseReachAnalysis(G4_BB *bb) {
-  bool changed = false;
-  unsigned bbID = bb->getId();
-
+void SWSB::globalDependenceUseReachAnalysis(
+    G4_BB *bb, const std::vector<unsigned> &newLiveIn,
+    std::vector<unsigned> &newLiveOut) {
   if (bb->Preds.empty()) {
-    return false;
-  }
-
-  SBBitSets temp_live_in(globalSendNum);
-  temp_live_in = BBVector[bbID]->send_live_in;
-
-  for (BB_SWSB_LIST_ITER it = BBVector[bbID]->Preds.begin();
-       it != BBVector[bbID]->Preds.end(); it++) {
-    G4_BB *predBB = (*it)->getBB();
-    unsigned predID = predBB->getId();
-    temp_live_in |= BBVector[predID]->send_live_out;
+    return;
   }
 
-  if (temp_live_in != BBVector[bbID]->send_live_in) {
-    changed = true;
-    BBVector[bbID]->send_live_in = temp_live_in;
+  G4_BB_SB *sb_bb = BBVector[bb->getId()];
+  for (unsigned fact : newLiveIn) {
+    unsigned globalID = fact / 2;
+    if (fact % 2 == 0) {
+      sb_bb->send_live_in.setDst(globalID, true);
+      // Kill scalar kills
+      if (!sb_bb->send_kill_scalar.isDstSet(globalID) &&
+          !sb_bb->send_WAW_may_kill.isSet(globalID) &&
+          !sb_bb->send_live_out.isDstSet(globalID)) {
+        sb_bb->send_live_out.setDst(globalID, true);
+        newLiveOut.push_back(fact);
+      }
+    } else {
+      sb_bb->send_live_in.setSrc(globalID, true);
+      if (!sb_bb->send_kill_scalar.isSrcSet(globalID) &&
+          !sb_bb->send_may_kill.isSrcSet(globalID) &&
+          !sb_bb->send_live_out.isSrcSet(globalID)) {
+        sb_bb->send_live_out.setSrc(globalID, true);
+        newLiveOut.push_back(fact);
+      }
+    }
   }
-
-  // Kill scalar kills
-  temp_live_in -= BBVector[bbID]->send_kill_scalar;
-  temp_live_in.src -= BBVector[bbID]->send_may_kill.src;
-  temp_live_in.dst -= BBVector[bbID]->send_WAW_may_kill;
-
-  BBVector[bbID]->send_live_out |= temp_live_in;
-
-  return changed;
 }
 
 void SWSB::tokenEdgePrune(unsigned &prunedEdgeNum,
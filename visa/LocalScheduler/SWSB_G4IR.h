@@ -962,8 +962,12 @@ class SWSB {
   SWSB_TOKEN_PROFILE tokenProfile;
 
   // Global dependence analysis
-  bool globalDependenceDefReachAnalysis(G4_BB *bb);
-  bool globalDependenceUseReachAnalysis(G4_BB *bb);
+  void globalDependenceDefReachAnalysis(G4_BB *bb,
+                                        const std::vector<unsigned> &newLiveIn,
+                                        std::vector<unsigned> &newLiveOut);
+  void globalDependenceUseReachAnalysis(G4_BB *bb,
+                                        const std::vector<unsigned> &newLiveIn,
+                                        std::vector<unsigned> &newLiveOut);
   void addGlobalDependence(unsigned globalSendNum,
                            SBBUCKET_VECTOR *globalSendOpndList,
                            SBNODE_VECT &SBNodes, PointsToAnalysis &p,
@@ -1070,7 +1074,9 @@ class SWSB {
   void shareToken(const SBNode *node, const SBNode *succ, unsigned short token);
 
   void SWSBGlobalTokenAnalysis();
-  bool globalTokenReachAnalysis(G4_BB *bb);
+  void globalTokenReachAnalysis(G4_BB *bb, const BitSet &killedNodes,
+                                const std::vector<unsigned> &newLiveIn,
+                                std::vector<unsigned> &newLiveOut);
 
   // Dump
   void dumpDepInfo() const;
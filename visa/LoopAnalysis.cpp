@@ -12,6 +12,9 @@ SPDX-License-Identifier: MIT
 #include "G4_BB.hpp"
 #include "G4_Kernel.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 using namespace vISA;
 
 G4_BB *ImmDominator::InterSect(G4_BB *bb, int i, int k) {
@@ -946,6 +949,73 @@ bool Loop::contains(const G4_BB *bb) {
   return BBsLookup.find(bb) != BBsLookup.end();
 }
 
+float ExecFrequency::getFrequency(const G4_BB *bb) {
+  recomputeIfStale();
+
+  // BBs created after the analysis ran are assumed to run once.
+  if (bb->getId() >= freqs.size())
+    return 1.0f;
+  return freqs[bb->getId()];
+}
+
+G4_BB *ExecFrequency::getScopeExit(G4_BB *bb) {
+  auto *loop = kernel.fg.getLoops().getInnerMostLoop(bb);
+  if (loop)
+    return loop->backEdgeSrc();
+
+  for (auto *func : kernel.fg.funcInfoTable) {
+    if (func->contains(bb))
+      return func->getExitBB();
+  }
+  return kernel.fg.kernelInfo ? kernel.fg.kernelInfo->getExitBB() : nullptr;
+}
+
+void ExecFrequency::reset() {
+  freqs.clear();
+
+  setStale();
+}
+
+void ExecFrequency::run() {
+  auto &loops = kernel.fg.getLoops();
+  auto &dom = kernel.fg.getImmDominator();
+
+  unsigned int maxId = 0;
+  for (auto bb : kernel.fg)
+    maxId = std::max(maxId, bb->getId());
+  freqs.assign(maxId + 1, 1.0f);
+
+  const Options *opts = kernel.getOptions();
+  loopIterations = (float)opts->getuInt32Option(vISA_FreqLoopIterations);
+  branchProbability =
+      std::min(opts->getuInt32Option(vISA_FreqBranchPercent), 100u) / 100.0f;
+
+  for (auto bb : kernel.fg) {
+    float freq = 1.0f;
+    auto *loop = loops.getInnerMostLoop(bb);
+    if (loop)
+      freq = (float)std::pow(loopIterations, loop->getNestingLevel());
+
+    auto *scopeExit = getScopeExit(bb);
+    if (scopeExit && !dom.dominates(bb, scopeExit))
+      freq *= branchProbability;
+
+    freqs[bb->getId()] = freq;
+  }
+
+  setValid();
+}
+
+void ExecFrequency::dump(std::ostream &os) {
+  if (isStale())
+    os << "Execution frequency data is stale.\n";
+
+  for (auto bb : kernel.fg) {
+    if (bb->getId() < freqs.size())
+      os << "BB" << bb->getId() << " - " << freqs[bb->getId()] << "\n";
+  }
+}
+
 bool VarReferences::isUniqueDef(G4_Operand *dst) {
   recomputeIfStale();
 
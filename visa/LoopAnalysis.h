@@ -206,4 +206,37 @@ private:
   G4_BB *getPreheader(Loop *loop);
   void computeInnermostLoops();
 };
+
+// Estimates how many times each BB runs per run of the kernel entry, from the
+// loop nest and the branch structure. Every enclosing loop is assumed to run
+// -freqLoopIterations times, and a BB that does not dominate the latch of its
+// innermost loop (or the exit of its function when it is not in a loop) is
+// assumed to run on -freqBranchPercent of the paths.
+//
+// vISA has neither trip counts nor branch probabilities: loop bounds are
+// mostly kernel arguments, and there is no profile. The default of 10
+// iterations is the assumeLoopIter that the reference-based spill cost
+// function weights loop references with, so that both spill cost functions
+// agree on how much a loop matters and only differ in the cycles of a
+// reference. The default of 50% treats both sides of a branch as equally
+// likely.
+class ExecFrequency : public Analysis {
+public:
+  ExecFrequency(G4_Kernel &k) : kernel(k) {}
+
+  float getFrequency(const G4_BB *bb);
+
+private:
+  G4_Kernel &kernel;
+  float loopIterations = 10.0f;
+  float branchProbability = 0.5f;
+  // indexed by BB id
+  std::vector<float> freqs;
+
+  G4_BB *getScopeExit(G4_BB *bb);
+
+  void reset() override;
+  void run() override;
+  void dump(std::ostream &os = std::cerr) override;
+};
 } // namespace vISA
@@ -8,6 +8,7 @@ SPDX-License-Identifier: MIT
 
 #include "Optimizer.h"
 #include "Assertions.h"
+#include "CompileTrace.h"
 #include "G4_Opcode.h"
 #include "G4_Verifier.hpp"
 #include "Timer.h"
@@ -47,8 +48,7 @@ void Optimizer::LVN() {
   // redundancies that got introduced mainly by HW
   // conformity or due to VISA lowering.
   int numInstsRemoved = 0;
-  PointsToAnalysis p(kernel.Declares, kernel.fg.getNumBB());
-  p.doPointsToAnalysis(kernel.fg);
+  PointsToAnalysis &p = kernel.getAnalyses().getPointsToAnalysis();
   for (auto bb : kernel.fg) {
     ::LVN lvn(fg, bb, *fg.builder, p);
     lvn.doLVN();
@@ -1325,7 +1325,25 @@ void Optimizer::removeLifetimeOps() {
   }
 }
 
+void Optimizer::checkCompileBudget(PassIndex Index) {
+  if (!kernel.isCompileBudgetExceeded() &&
+      (builder.isCompileBudgetExceeded() ||
+       BudgetExpireAtPass == Passes[Index].Name)) {
+    // Only this kernel degrades here. The kernels compiled after it check the
+    // shared budget on their own.
+    kernel.setCompileBudgetExceeded(true);
+    if (!RAStarted) {
+      kernel.setBudgetFastCompileRA(true);
+    }
+  }
+  if (Index == PI_regAlloc) {
+    RAStarted = true;
+  }
+}
+
 void Optimizer::runPass(PassIndex Index) {
+  checkCompileBudget(Index);
+
   const PassInfo &PI = Passes[Index];
 
   // Do not execute.
@@ -1333,6 +1351,10 @@ void Optimizer::runPass(PassIndex Index) {
       EarlyExited)
     return;
 
+  // Out of compile budget: pre-RA scheduling is skipped.
+  if (Index == PI_preRA_Schedule && kernel.isCompileBudgetExceeded())
+    return;
+
   std::string Name = PI.Name;
   setCurrentDebugPass(PI.Name);
 
@@ -1342,11 +1364,16 @@ void Optimizer::runPass(PassIndex Index) {
   kernel.dumpToFile("before." + Name);
 
   // Execute pass.
-  (this->*(PI.Pass))();
+  {
+    CompileTraceScope traceScope("vISA pass", PI.Name);
+    (this->*(PI.Pass))();
+  }
 
   if (PI.Timer != TimerID::NUM_TIMERS)
     stopTimer(PI.Timer);
 
+  kernel.invalidateAnalyses(PI.Changes);
+
   kernel.dumpToFile("after." + Name);
 #ifndef DLL_MODE
   // Only check for stop-after in offline build as it's intended for vISA
@@ -1456,6 +1483,14 @@ void Optimizer::initOptimizations() {
   INITIALIZE_PASS(ACCSchedule, vISA_PreSchedForAcc, TimerID::PRERA_SCHEDULING);
   INITIALIZE_PASS(staticProfiling, vISA_staticProfiling, TimerID::MISC_OPTS);
 
+  // By default a pass invalidates all cached analyses. These ones only read
+  // the IR, or report their own changes so that the analyses they compute
+  // last can be reused by the following passes.
+  Passes[PI_HWConformityChk].Changes = IRC_None;
+  Passes[PI_collectStats].Changes = IRC_None;
+  Passes[PI_countGRFUsage].Changes = IRC_None;
+  Passes[PI_staticProfiling].Changes = IRC_None;
+
   // Verify all passes are initialized.
 #ifdef _DEBUG
   for (unsigned i = 0; i < PI_NUM_PASSES; ++i) {
@@ -2043,6 +2078,8 @@ int Optimizer::optimization() {
 
   runPass(PI_staticProfiling);
 
+  VISA_DEBUG_VERBOSE(kernel.getAnalyses().dump(std::cout));
+
   if (EarlyExited) {
     return VISA_EARLY_EXIT;
   }
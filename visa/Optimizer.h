@@ -9,6 +9,7 @@ SPDX-License-Identifier: MIT
 #ifndef __OPTIMIZER_H__
 #define __OPTIMIZER_H__
 
+#include "AnalysisManager.h"
 #include "BuildIR.h"
 #include "HWConformity.h"
 #include "LocalScheduler/LocalScheduler_G4IR.h"
@@ -317,13 +318,18 @@ private:
     /// timer i.e. TIMER_NUM_TIMERS, then no time will be recorded.
     TimerID Timer;
 
+    /// The IRChange kinds this pass may make; the cached analyses depending
+    /// on them are invalidated after it runs. Passes that report their own
+    /// changes to the kernel's AnalysisManager use IRC_None.
+    unsigned Changes;
+
     PassInfo(PassType P, const char *N, vISAOptions O,
-             TimerID T = TimerID::NUM_TIMERS)
-        : Pass(P), Name(N), Option(O), Timer(T) {}
+             TimerID T = TimerID::NUM_TIMERS, unsigned C = IRC_All)
+        : Pass(P), Name(N), Option(O), Timer(T), Changes(C) {}
 
     PassInfo()
         : Pass(0), Name(0), Option(vISA_EnableAlways),
-          Timer(TimerID::NUM_TIMERS) {}
+          Timer(TimerID::NUM_TIMERS), Changes(IRC_All) {}
   };
 
   bool foldPseudoAndOr(G4_BB *bb, INST_LIST_ITER &iter);
@@ -406,6 +412,11 @@ private:
   std::string StopAfterPass;
   // Whether we have hit the stop-after pass.
   bool EarlyExited = false;
+  // Name of the pass at which the compile budget runs out, from the
+  // -compileBudgetExpireAt flag.
+  std::string BudgetExpireAtPass;
+  // Whether GRF RA has started, after which its options must not change.
+  bool RAStarted = false;
 
   /// Initialize all passes during the construction.
   void initOptimizations();
@@ -413,6 +424,10 @@ private:
   /// Common interface to execute a pass.
   void runPass(PassIndex Index);
 
+  /// Switch the remaining expensive passes to their fast variants once the
+  /// compile budget is exceeded. Called before running each pass.
+  void checkCompileBudget(PassIndex Index);
+
   bool isCopyPropProfitable(G4_INST *movInst) const;
 
   std::optional<INST_LIST_ITER> findFenceCommitPos(INST_LIST_ITER fence,
@@ -429,6 +444,10 @@ public:
     if (PassName) {
       StopAfterPass = std::string(PassName);
     }
+    auto ExpireAtPass = k.getOptions()->getOptionCstr(vISA_CompileBudgetExpireAt);
+    if (ExpireAtPass) {
+      BudgetExpireAtPass = std::string(ExpireAtPass);
+    }
 #endif // DLL_MODE
     initOptimizations();
   }
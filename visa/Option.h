@@ -48,60 +48,6 @@ union EntryValue {
   const char *cstr;
 };
 
-struct VISAOptionsEntry {
-  EntryType type = ET_UNINIT;
-  EntryValue val;
-  EntryType getType(void) const { return type; }
-  virtual void dump(void) const { std::cerr << "BASE"; }
-  virtual ~VISAOptionsEntry() {}
-};
-
-struct VISAOptionsEntryBool : VISAOptionsEntry {
-  VISAOptionsEntryBool(bool Val) {
-    val.boolean = Val;
-    type = ET_BOOL;
-  }
-  virtual void dump(void) const override {
-    std::cerr << std::left << std::setw(10)
-              << ((val.boolean) ? "true" : "false");
-  }
-  bool getVal(void) const { return val.boolean; }
-};
-struct VISAOptionsEntryUint32 : VISAOptionsEntry {
-  VISAOptionsEntryUint32(uint32_t Val) {
-    val.int32 = Val;
-    type = ET_INT32;
-  }
-  virtual void dump(void) const override {
-    std::cerr << std::left << std::setw(10) << val.int32;
-  }
-  uint32_t getVal(void) const { return val.int32; }
-};
-struct VISAOptionsEntryUint64 : VISAOptionsEntry {
-  VISAOptionsEntryUint64(uint64_t Val) {
-    val.int64 = Val;
-    type = ET_INT64;
-  }
-  virtual void dump(void) const override {
-    std::cerr << std::left << std::setw(10) << val.int64;
-  }
-  uint64_t getVal(void) const { return val.int64; }
-};
-struct VISAOptionsEntryCstr : VISAOptionsEntry {
-  VISAOptionsEntryCstr(const char *Val) {
-    val.cstr = Val;
-    type = ET_CSTR;
-  }
-  virtual void dump(void) const override {
-    if (val.cstr) {
-      std::cerr << std::left << std::setw(10) << val.cstr;
-    } else {
-      std::cerr << std::left << std::setw(10) << "NULL";
-    }
-  }
-  const char *getVal(void) const { return val.cstr; }
-};
-
 class Options {
   std::unordered_map<std::string, vISAOptions> argToOption;
   const char *vISAOptionsToStr[vISA_NUM_OPTIONS];
@@ -159,251 +105,190 @@ private:
   // This holds the data of a single vISAOptions entry
   struct VISAOptionsLine {
     // This is the "-fooBarOption"
-    const char *argStr;
+    const char *argStr = nullptr;
     // The TYPE
-    EntryType type;
+    EntryType type = ET_UNINIT;
+    // The type of the value currently held, normally the same as TYPE
+    // (or ET_INT64 for ET_2xINT32)
+    EntryType valueType = ET_UNINIT;
     // This holds the actual value
-    VISAOptionsEntry *value;
+    EntryValue value = {};
     // This holds the default value
-    VISAOptionsEntry *defaultValue;
+    EntryValue defaultValue = {};
     // The error message to show when argument is badly formed
-    const char *errorMsg;
+    const char *errorMsg = nullptr;
     // This is set to TRUE if this option is passed as an argument
-    bool argIsSet;
-
-    VISAOptionsLine(void) {
-      argStr = (const char *)nullptr;
-      type = ET_UNINIT;
-      value = nullptr;
-      defaultValue = nullptr;
-      errorMsg = nullptr;
-      argIsSet = false;
+    bool argIsSet = false;
+
+    static void dumpValue(EntryType type, const EntryValue &val) {
+      std::cerr << std::left << std::setw(10);
+      switch (type) {
+      case ET_BOOL:
+        std::cerr << (val.boolean ? "true" : "false");
+        break;
+      case ET_INT32:
+        std::cerr << val.int32;
+        break;
+      case ET_INT64:
+      case ET_2xINT32:
+        std::cerr << val.int64;
+        break;
+      case ET_CSTR:
+        std::cerr << (val.cstr ? val.cstr : "NULL");
+        break;
+      default:
+        std::cerr << "NULL";
+        break;
+      }
     }
     // Debug print
     void dump(void) const {
       std::cerr << std::setw(30) << argStr << " [" << argIsSet << "] ";
-      if (value) {
-        value->dump();
-      } else {
-        std::cerr << std::left << std::setw(10) << "NULL";
-      }
+      dumpValue(valueType, value);
       std::cerr << ", (default:";
-      if (defaultValue) {
-        defaultValue->dump();
-      } else {
-        std::cerr << std::left << std::setw(10) << "NULL";
-      }
+      dumpValue(type == ET_2xINT32 ? ET_INT64 : type, defaultValue);
       std::cerr << ")";
     }
   };
 
-  // gcc 4.9.3 does not support enum as unordered_map key without an explicit
-  // hash function
-  struct vISAOptionsHash {
-    size_t operator()(vISAOptions opt) const { return (size_t)opt; }
-  };
-
   // The main structure where we hold the options, their "-argument string",
   // their assigned values, their default values etc.
-  // It is a map from vISAOptions->VISAOptionsLine
+  // It is an array indexed by vISAOptions, so that querying an option (which
+  // many passes do per instruction or per live range) is a single load
+  // instead of a hash lookup.
   class VISAOptionsDB {
   private:
     Options *options = nullptr;
-    std::unordered_map<vISAOptions, VISAOptionsLine, vISAOptionsHash>
-        optionsMap;
-    // Check if KEY has already a value assigned to it
-    void freeIfAlreadySet(vISAOptions key, bool dontCheckNull = true) {
-      // If already set, free tha last one
-      auto it = optionsMap.find(key);
-      if (it != optionsMap.end()) {
-        if (dontCheckNull || it->second.value != nullptr) {
-          delete it->second.value;
-        }
-      }
+    VISAOptionsLine optionsMap[vISA_NUM_OPTIONS];
+
+    const VISAOptionsLine &line(vISAOptions key) const {
+      vISA_ASSERT(key > vISA_OPTIONS_UNINIT && key < vISA_NUM_OPTIONS,
+                  "Option value is outside of range.");
+      return optionsMap[key];
+    }
+    VISAOptionsLine &line(vISAOptions key) {
+      vISA_ASSERT(key > vISA_OPTIONS_UNINIT && key < vISA_NUM_OPTIONS,
+                  "Option value is outside of range.");
+      return optionsMap[key];
     }
 
   public:
     // Debug print all the options
     void dump(void) const {
-      for (auto pair : optionsMap) {
-        const VISAOptionsLine &line = pair.second;
+      for (int i = vISA_OPTIONS_UNINIT + 1; i < vISA_NUM_OPTIONS; ++i) {
         std::cerr << std::left << std::setw(34)
-                  << options->get_vISAOptionsToStr(pair.first) << ": ";
-        line.dump();
+                  << options->get_vISAOptionsToStr((vISAOptions)i) << ": ";
+        optionsMap[i].dump();
         std::cerr << "\n";
       }
     }
     // Debug print a single entry
-    void dump(vISAOptions key) const { optionsMap.at(key).dump(); }
+    void dump(vISAOptions key) const { line(key).dump(); }
     // If the option is passed as a command line argument
-    void setArgSetByUser(vISAOptions key) { optionsMap[key].argIsSet = true; }
+    void setArgSetByUser(vISAOptions key) { line(key).argIsSet = true; }
     // Set the value of the option
     void setBool(vISAOptions key, bool val) {
-      freeIfAlreadySet(key);
-      optionsMap[key].value = new VISAOptionsEntryBool(val);
+      line(key).valueType = ET_BOOL;
+      line(key).value.boolean = val;
     }
     void setUint32(vISAOptions key, uint32_t val) {
-      freeIfAlreadySet(key);
-      optionsMap[key].value = new VISAOptionsEntryUint32(val);
+      line(key).valueType = ET_INT32;
+      line(key).value.int32 = val;
     }
     void setUint64(vISAOptions key, uint64_t val) {
-      freeIfAlreadySet(key);
-      optionsMap[key].value = new VISAOptionsEntryUint64(val);
+      line(key).valueType = ET_INT64;
+      line(key).value.int64 = val;
     }
     void setCstr(vISAOptions key, const char *val) {
-      freeIfAlreadySet(key, false);
-      if (!val) {
-        optionsMap[key].value = nullptr;
-      } else {
-        optionsMap[key].value = new VISAOptionsEntryCstr(val);
-      }
+      line(key).valueType = ET_CSTR;
+      line(key).value.cstr = val;
     }
 
     // Set the value of the option
     void setDefaultBool(vISAOptions key, bool val) {
-      optionsMap[key].defaultValue = new VISAOptionsEntryBool(val);
+      line(key).defaultValue.boolean = val;
     }
     void setDefaultUint32(vISAOptions key, uint32_t val) {
-      optionsMap[key].defaultValue = new VISAOptionsEntryUint32(val);
+      line(key).defaultValue.int32 = val;
     }
     void setDefaultUint64(vISAOptions key, uint64_t val) {
-      optionsMap[key].defaultValue = new VISAOptionsEntryUint64(val);
+      line(key).defaultValue.int64 = val;
     }
     void setDefaultCstr(vISAOptions key, const char *val) {
-      optionsMap[key].defaultValue = new VISAOptionsEntryCstr(val);
+      line(key).defaultValue.cstr = val;
     }
 
     // Set the "-fooBarOption"
     void setArgStr(vISAOptions key, const char *argStr) {
-      optionsMap[key].argStr = argStr;
+      line(key).argStr = argStr;
     }
 
     // Set the TYPE
-    void setType(vISAOptions key, EntryType type) {
-      optionsMap[key].type = type;
-    }
+    void setType(vISAOptions key, EntryType type) { line(key).type = type; }
 
     // Set the error message
     void setErrorMsg(vISAOptions key, const char *errorMsg) {
-      optionsMap[key].errorMsg = errorMsg;
+      line(key).errorMsg = errorMsg;
     }
 
     // Get the argument string "-fooArg"
     const char *getArgStr(vISAOptions key) const {
-      auto it = optionsMap.find(key);
-      if (it != optionsMap.end()) {
-        const char *argStr = it->second.argStr;
-        return argStr;
-      } else {
-        return "UNDEFINED";
-      }
+      const char *argStr = line(key).argStr;
+      return argStr ? argStr : "UNDEFINED";
     }
 
     // Get the type of KEY
-    EntryType getType(vISAOptions key) const {
-      vASSERT(optionsMap.count(key));
-      return optionsMap.at(key).type;
-    }
+    EntryType getType(vISAOptions key) const { return line(key).type; }
 
     // Get the type of KEY
     const char *getErrorMsg(vISAOptions key) const {
-      vASSERT(optionsMap.count(key));
-      return optionsMap.at(key).errorMsg;
+      return line(key).errorMsg;
     }
 
     // Get the values
     bool getBool(vISAOptions key) const {
-      vASSERT(optionsMap.count(key));
-      const VISAOptionsEntry *value = optionsMap.at(key).value;
-      vISA_ASSERT(value->getType() == ET_BOOL, "Bad Type");
-      const VISAOptionsEntryBool *Bool =
-          static_cast<const VISAOptionsEntryBool *>(value);
-      vISA_ASSERT(Bool, "Uninitialized?");
-      return Bool->getVal();
+      const VISAOptionsLine &l = line(key);
+      vISA_ASSERT(l.valueType == ET_BOOL, "Bad Type");
+      return l.value.boolean;
     }
     uint32_t getUint32(vISAOptions key) const {
-      vASSERT(optionsMap.count(key));
-      const VISAOptionsEntry *value = optionsMap.at(key).value;
-      vISA_ASSERT(value->getType() == ET_INT32, "Bad Type");
-      const VISAOptionsEntryUint32 *Int32 =
-          static_cast<const VISAOptionsEntryUint32 *>(value);
-      vISA_ASSERT(Int32, "Uninitialized?");
-      return Int32->getVal();
+      const VISAOptionsLine &l = line(key);
+      vISA_ASSERT(l.valueType == ET_INT32, "Bad Type");
+      return l.value.int32;
     }
     uint64_t getUint64(vISAOptions key) const {
-      vASSERT(optionsMap.count(key));
-      const VISAOptionsEntry *value = optionsMap.at(key).value;
-      vISA_ASSERT(value->getType() == ET_INT64, "Bad Type");
-      const VISAOptionsEntryUint64 *Int64 =
-          static_cast<const VISAOptionsEntryUint64 *>(value);
-      vISA_ASSERT(Int64, "Uninitialized?");
-      return Int64->getVal();
+      const VISAOptionsLine &l = line(key);
+      vISA_ASSERT(l.valueType == ET_INT64, "Bad Type");
+      return l.value.int64;
     }
     const char *getCstr(vISAOptions key) const {
-      vASSERT(optionsMap.count(key));
-      const VISAOptionsEntry *value = optionsMap.at(key).value;
-      if (!value) {
-        return nullptr;
-      }
-      vISA_ASSERT(value->getType() == ET_CSTR, "Bad Type");
-      const VISAOptionsEntryCstr *Cstr =
-          static_cast<const VISAOptionsEntryCstr *>(value);
-      // vISA_ASSERT(Cstr, "Bad option type OR uninit");
-      return Cstr->getVal();
+      const VISAOptionsLine &l = line(key);
+      vISA_ASSERT(l.valueType == ET_CSTR, "Bad Type");
+      return l.value.cstr;
     }
 
     // TRUE if the options is passed as a cmd line argument
-    bool isArgSetByUser(vISAOptions key) const {
-      return optionsMap.at(key).argIsSet;
-    }
+    bool isArgSetByUser(vISAOptions key) const { return line(key).argIsSet; }
     // Get defaults
     bool getDefaultBool(vISAOptions key) const {
-      vASSERT(optionsMap.count(key));
-      const VISAOptionsEntry *defValue = optionsMap.at(key).defaultValue;
-      vISA_ASSERT(defValue->getType() == ET_BOOL, "Bad Type");
-      const VISAOptionsEntryBool *Bool =
-          static_cast<const VISAOptionsEntryBool *>(defValue);
-      vISA_ASSERT(Bool, "Uninitialized?");
-      return Bool->getVal();
+      vISA_ASSERT(line(key).type == ET_BOOL, "Bad Type");
+      return line(key).defaultValue.boolean;
     }
     uint32_t getDefaultUint32(vISAOptions key) const {
-      vASSERT(optionsMap.count(key));
-      const VISAOptionsEntry *defValue = optionsMap.at(key).defaultValue;
-      vISA_ASSERT(defValue->getType() == ET_INT32, "Bad Type");
-      const VISAOptionsEntryUint32 *Int32 =
-          static_cast<const VISAOptionsEntryUint32 *>(defValue);
-      vISA_ASSERT(Int32, "Uninitialized?");
-      return Int32->getVal();
+      vISA_ASSERT(line(key).type == ET_INT32, "Bad Type");
+      return line(key).defaultValue.int32;
     }
     uint64_t getDefaultUint64(vISAOptions key) const {
-      vASSERT(optionsMap.count(key));
-      const VISAOptionsEntry *defValue = optionsMap.at(key).defaultValue;
-      vISA_ASSERT(defValue->getType() == ET_INT64, "Bad Type");
-      const VISAOptionsEntryUint64 *Int64 =
-          static_cast<const VISAOptionsEntryUint64 *>(defValue);
-      vISA_ASSERT(Int64, "Uninitialized?");
-      return Int64->getVal();
+      vISA_ASSERT(line(key).type == ET_INT64 || line(key).type == ET_2xINT32,
+                  "Bad Type");
+      return line(key).defaultValue.int64;
     }
     const char *getDefaultCstr(vISAOptions key) const {
-      vASSERT(optionsMap.count(key));
-      const VISAOptionsEntry *defValue = optionsMap.at(key).defaultValue;
-      vISA_ASSERT(defValue->getType() == ET_CSTR, "Bad Type");
-      const VISAOptionsEntryCstr *Cstr =
-          static_cast<const VISAOptionsEntryCstr *>(defValue);
-      vISA_ASSERT(Cstr, "Uninitialized?");
-      return Cstr->getVal();
+      vISA_ASSERT(line(key).type == ET_CSTR, "Bad Type");
+      return line(key).defaultValue.cstr;
     }
     VISAOptionsDB() {}
     VISAOptionsDB(Options *opt) { options = opt; }
-
-    ~VISAOptionsDB(void) {
-      for (auto pair : optionsMap) {
-        auto *val = pair.second.value;
-        delete val;
-        auto *defVal = pair.second.defaultValue;
-        delete defVal;
-      }
-    }
   };
 
   VISAOptionsDB m_vISAOptions;
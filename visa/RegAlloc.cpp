@@ -7,6 +7,7 @@ SPDX-License-Identifier: MIT
 ============================= end_copyright_notice ===========================*/
 
 #include "RegAlloc.h"
+#include "AnalysisManager.h"
 #include "Assertions.h"
 #include "DebugInfo.h"
 #include "FlowGraph.h"
@@ -3017,11 +3018,11 @@ int regAlloc(IR_Builder &builder, PhyRegPool &regPool, G4_Kernel &kernel) {
   }
 
   //
-  // Perform flow-insensitive points-to-analysis.
+  // Perform flow-insensitive points-to-analysis. RA updates it with the
+  // spill code it inserts, so it takes the analysis over.
   //
-  PointsToAnalysis pointsToAnalysis(kernel.Declares, kernel.fg.getNumBB());
-  pointsToAnalysis.doPointsToAnalysis(kernel.fg);
-  GlobalRA gra(kernel, regPool, pointsToAnalysis);
+  auto pointsToAnalysis = kernel.getAnalyses().takePointsToAnalysis();
+  GlobalRA gra(kernel, regPool, *pointsToAnalysis);
 
   //
   // insert pseudo save/restore return address so that reg alloc
@@ -3080,7 +3081,7 @@ int regAlloc(IR_Builder &builder, PhyRegPool &regPool, G4_Kernel &kernel) {
   if (!gra.isReRAPass()) {
     // propagate address takens to gtpin info
     std::unordered_map<G4_Declare *, std::vector<G4_Declare *>> addrTakenMap;
-    pointsToAnalysis.getPointsToMap(addrTakenMap);
+    pointsToAnalysis->getPointsToMap(addrTakenMap);
     auto gtpinData = kernel.getGTPinData();
     for (auto &indirRef : addrTakenMap) {
       for (auto target : indirRef.second)
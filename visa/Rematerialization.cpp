@@ -536,7 +536,13 @@ bool Rematerialization::canRematerialize(G4_SrcRegRegion *src, G4_BB *bb,
         rpe.getRegisterPressure(srcInst) < rematLoopRegPressure)
       return false;
 
-    if (getNumRematsInLoop() > 0) {
+    if (costModel) {
+      // Remat only if recomputing the value at its uses in the loop takes
+      // fewer cycles than the spill code it is meant to avoid.
+      if (costModel->getRematCycles(uniqueDefInst, topdcl) >
+          costModel->getSpillCycles(topdcl))
+        return false;
+    } else if (getNumRematsInLoop() > 0) {
       // Restrict non-SIMD1 remats to a low percent of loop instructions.
       float loopInstToTotalInstRatio =
           (float)getNumRematsInLoop() / (float)loopInstsBeforeRemat * 100.0f;
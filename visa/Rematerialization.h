@@ -12,8 +12,10 @@ SPDX-License-Identifier: MIT
 #include "FlowGraph.h"
 #include "GraphColor.h"
 #include "RPE.h"
+#include "SpillCostModel.h"
 #include <list>
 #include <map>
+#include <memory>
 
 namespace vISA {
 // Remat will trigger only for vars that have less than following uses
@@ -58,6 +60,9 @@ private:
   GlobalRA &gra;
   G4_Declare *samplerHeader = nullptr;
   unsigned int numRematsInLoop = 0;
+  // Set with -freqSpillCost to price remat in loops in cycles, shared with
+  // GRF coloring.
+  SpillCostModel *costModel = nullptr;
   bool IRChanged = false;
   bool samplerHeaderMapPopulated = false;
   unsigned int loopInstsBeforeRemat = 0;
@@ -191,6 +196,9 @@ public:
 
     rematCandidates.resize(l.getNumSelectedVar(), false);
 
+    if (k.getOption(vISA_FreqSpillCost))
+      costModel = c.getSpillCostModel();
+
     for (auto &&lr : coloring.getSpilledLiveRanges()) {
       auto dcl = lr->getDcl()->getRootDeclare();
       if (!dcl->isSpilled()) {
@@ -9,9 +9,11 @@ SPDX-License-Identifier: MIT
 #include "SpillCleanup.h"
 #include "Assertions.h"
 #include "FlowGraph.h"
+#include "BitSet.h"
 #include "GraphColor.h"
 
 #include <list>
+#include <unordered_map>
 
 uint32_t computeFillMsgDesc(unsigned int payloadSize, unsigned int offset);
 uint32_t computeSpillMsgDesc(unsigned int payloadSize, unsigned int offset);
@@ -1881,6 +1883,128 @@ void CoalesceSpillFills::removeRedundantWrites() {
   }
 }
 
+void CoalesceSpillFills::removeDeadSpills() {
+  // Remove spills whose rows are not read on any path leaving them, using
+  // the liveness of the scratch rows over the whole CFG. This catches the
+  // writes removeRedundantWrites() can't see from within a single BB:
+  //
+  // BB1: spill TV1 at offset = 1
+  //      (P1) goto BB3
+  // BB2: spill TV2 at offset = 1 (NoMask)
+  //      goto BB4
+  // BB3: spill TV3 at offset = 1 (NoMask)
+  // BB4: fill FP1 from offset = 1
+  // ===>
+  // Remove spill of TV1
+  //
+  // Only unpredicated NoMask spills overwrite all channels of a row, so only
+  // they end the liveness of the rows they write.
+
+  // With stack calls the scratch offsets of different frames alias, and the
+  // CFG edges into callees would make a callee spill look like it kills a
+  // row of its caller.
+  if (kernel.fg.getHasStackCalls() || kernel.fg.getIsStackCallFunc())
+    return;
+
+  unsigned int numRows = 0;
+  for (auto bb : kernel.fg) {
+    for (auto inst : *bb) {
+      if (inst->isSpillIntrinsic() || inst->isFillIntrinsic()) {
+        unsigned int offset = 0, size = 0;
+        getScratchMsgInfo(inst, offset, size);
+        numRows = std::max(numRows, offset + size);
+      }
+    }
+  }
+  if (numRows == 0)
+    return;
+
+  auto killsRows = [](G4_INST *inst) {
+    return inst->isSpillIntrinsic() && inst->isWriteEnableInst() &&
+           !inst->getPredicate();
+  };
+
+  // gen: rows filled in the BB before being overwritten
+  // kill: rows overwritten in the BB
+  struct RowLiveness {
+    BitSet gen, kill, liveIn, liveOut;
+  };
+  std::unordered_map<G4_BB *, RowLiveness> rowLiveness;
+  for (auto bb : kernel.fg) {
+    RowLiveness &rl = rowLiveness[bb];
+    rl.gen = BitSet(numRows, false);
+    rl.kill = BitSet(numRows, false);
+    rl.liveIn = BitSet(numRows, false);
+    rl.liveOut = BitSet(numRows, false);
+    for (auto instIt = bb->rbegin(); instIt != bb->rend(); ++instIt) {
+      auto inst = (*instIt);
+      if (!inst->isSpillIntrinsic() && !inst->isFillIntrinsic())
+        continue;
+      unsigned int offset = 0, size = 0;
+      getScratchMsgInfo(inst, offset, size);
+      if (inst->isFillIntrinsic()) {
+        for (unsigned int k = offset; k != (offset + size); k++) {
+          rl.gen.set(k, true);
+          rl.kill.set(k, false);
+        }
+      } else if (killsRows(inst)) {
+        for (unsigned int k = offset; k != (offset + size); k++) {
+          rl.gen.set(k, false);
+          rl.kill.set(k, true);
+        }
+      }
+    }
+  }
+
+  // Iterate to the fixed point, visiting the BBs in reverse layout order
+  // so that most successors are already up to date.
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto bbIt = kernel.fg.rbegin(); bbIt != kernel.fg.rend(); ++bbIt) {
+      RowLiveness &rl = rowLiveness[*bbIt];
+      for (auto succ : (*bbIt)->Succs)
+        rl.liveOut |= rowLiveness[succ].liveIn;
+      BitSet liveIn = rl.liveOut;
+      liveIn -= rl.kill;
+      liveIn |= rl.gen;
+      if (liveIn != rl.liveIn) {
+        rl.liveIn = std::move(liveIn);
+        changed = true;
+      }
+    }
+  }
+
+  unsigned int numRemoved = 0;
+  for (auto bb : kernel.fg) {
+    if (!gra.hasSpillCodeInBB(bb))
+      continue;
+    BitSet live = rowLiveness[bb].liveOut;
+    for (auto instIt = bb->end(); instIt != bb->begin();) {
+      --instIt;
+      auto inst = (*instIt);
+      if (!inst->isSpillIntrinsic() && !inst->isFillIntrinsic())
+        continue;
+      unsigned int offset = 0, size = 0;
+      getScratchMsgInfo(inst, offset, size);
+      if (inst->isFillIntrinsic()) {
+        live.set(offset, offset + size - 1);
+      } else if (live.isEmpty(offset, offset + size - 1) &&
+                 !isGRFAssigned(inst->asSpillIntrinsic()->getPayload())) {
+        instIt = bb->erase(instIt);
+        numRemoved++;
+      } else if (killsRows(inst)) {
+        for (unsigned int k = offset; k != (offset + size); k++)
+          live.set(k, false);
+      }
+    }
+  }
+
+  if (kernel.getOption(vISA_RATrace)) {
+    std::cout << "\t--removed dead spills: " << numRemoved << "\n";
+  }
+}
+
 void CoalesceSpillFills::run() {
   removeRedundantSplitMovs();
 
@@ -1891,6 +2015,8 @@ void CoalesceSpillFills::run() {
   spillFillCleanup();
 
   removeRedundantWrites();
+  if (kernel.getOption(vISA_DeadSpillRemoval))
+    removeDeadSpills();
 
   fixSendsSrcOverlap();
 
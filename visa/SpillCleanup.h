@@ -93,6 +93,7 @@ private:
   void populateSendDstDcl();
   void spillFillCleanup();
   void removeRedundantWrites();
+  void removeDeadSpills();
 
 public:
   CoalesceSpillFills(G4_Kernel &k, LivenessAnalysis &l, GraphColor &g,
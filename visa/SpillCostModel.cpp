@@ -0,0 +1,103 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "SpillCostModel.h"
+#include "G4_BB.hpp"
+#include "G4_Kernel.hpp"
+
+#include "LocalScheduler/LatencyTable.h"
+
+#include <algorithm>
+
+using namespace vISA;
+
+namespace {
+struct PlatformCycles {
+  PlatformGen gen;
+  SpillCostModel::Cycles cycles;
+};
+
+// The entry of the newest generation not newer than the kernel's applies.
+// Fills take the dataport read latency of the local scheduler and ALU
+// instructions its general instruction latency. Spill stores are not waited
+// for, only their issue and payload cost is counted.
+const PlatformCycles CycleTable[] = {
+    {PlatformGen::GEN_UNKNOWN,
+     {20.0f, (float)LegacyFFLatency[4], 4.0f, (float)COMPR_LATENCY}},
+    {PlatformGen::XE,
+     {20.0f, (float)LatenciesXe::DP_L3, 4.0f, (float)LatenciesXe::FPU}},
+};
+
+const SpillCostModel::Cycles &getCycles(PlatformGen gen) {
+  const PlatformCycles *entry = &CycleTable[0];
+  for (const PlatformCycles &pc : CycleTable) {
+    if (pc.gen <= gen)
+      entry = &pc;
+  }
+  return entry->cycles;
+}
+} // namespace
+
+SpillCostModel::SpillCostModel(G4_Kernel &k, VarReferences &r)
+    : kernel(k), freq(k), refs(r),
+      cycles(getCycles(k.getPlatformGeneration())) {}
+
+// Spill code only moves the rows an instruction touches, which is at most 2
+// GRFs for general instructions and 8 GRFs for sends.
+float SpillCostModel::getRowsMoved(const G4_Declare *dcl,
+                                   const G4_INST *inst) const {
+  unsigned int rows = std::max<unsigned int>(dcl->getNumRows(), 1);
+  return (float)std::min(rows, inst->isSend() ? 8u : 2u);
+}
+
+float SpillCostModel::getSpillCycles(G4_Declare *dcl) {
+  auto it = spillCycles.find(dcl);
+  if (it != spillCycles.end())
+    return it->second;
+
+  float total = 0.0f;
+  if (auto defs = refs.getDefs(dcl)) {
+    for (auto &def : *defs) {
+      auto *inst = std::get<0>(def);
+      total += freq.getFrequency(std::get<1>(def)) *
+               (cycles.spillStore + cycles.perGRF * getRowsMoved(dcl, inst));
+    }
+  }
+  if (auto uses = refs.getUses(dcl)) {
+    for (auto &use : *uses) {
+      auto *inst = std::get<0>(use);
+      total += freq.getFrequency(std::get<1>(use)) *
+               (cycles.fill + cycles.perGRF * getRowsMoved(dcl, inst));
+    }
+  }
+
+  spillCycles[dcl] = total;
+  return total;
+}
+
+float SpillCostModel::getRematCycles(const G4_INST *def, G4_Declare *dcl) {
+  // A rematerialized sampler message is as slow as a fill.
+  float instCycles = cycles.fill;
+  if (!def->isSend()) {
+    unsigned int rows = 1;
+    auto dst = def->getDst();
+    if (dst && !dst->isNullReg()) {
+      unsigned int bytes = dst->getRightBound() - dst->getLeftBound() + 1;
+      rows = std::max(1u, (bytes + kernel.getGRFSize() - 1) /
+                              kernel.getGRFSize());
+    }
+    instCycles = cycles.alu * rows;
+  }
+
+  float total = 0.0f;
+  if (auto uses = refs.getUses(dcl)) {
+    for (auto &use : *uses)
+      total += freq.getFrequency(std::get<1>(use)) * instCycles;
+  }
+  return total;
+}
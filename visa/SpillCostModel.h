@@ -0,0 +1,64 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#ifndef __SPILLCOSTMODEL_H__
+#define __SPILLCOSTMODEL_H__
+
+#include "LoopAnalysis.h"
+#include <unordered_map>
+
+namespace vISA {
+class G4_BB;
+class G4_Declare;
+class G4_INST;
+class G4_Kernel;
+
+// Prices spilling and rematerializing a variable in estimated cycles, with
+// every reference weighted by the ExecFrequency of its BB. GRF coloring uses
+// it for the spill cost of GRF variables and Rematerialization to decide
+// whether recomputing a value inside a loop beats keeping it live, so that
+// both decisions compare the same quantity.
+//
+// The costs below are only meaningful relative to each other.
+class SpillCostModel {
+public:
+  // refs must be a GRF-only VarReferences of k that outlives the model.
+  SpillCostModel(G4_Kernel &k, VarReferences &refs);
+
+  // Cycles spent if dcl is spilled: a store after every def and a fill
+  // before every use.
+  float getSpillCycles(G4_Declare *dcl);
+
+  // Cycles spent if def is recomputed before every use of dcl instead.
+  float getRematCycles(const G4_INST *def, G4_Declare *dcl);
+
+  float getFrequency(const G4_BB *bb) { return freq.getFrequency(bb); }
+
+  // Cycle estimates of one platform generation, see CycleTable in
+  // SpillCostModel.cpp.
+  struct Cycles {
+    // spill stores are fire and forget
+    float spillStore;
+    // the fill latency is usually exposed to the use
+    float fill;
+    float perGRF;
+    float alu;
+  };
+
+private:
+  G4_Kernel &kernel;
+  ExecFrequency freq;
+  VarReferences &refs;
+  const Cycles &cycles;
+  std::unordered_map<const G4_Declare *, float> spillCycles;
+
+  float getRowsMoved(const G4_Declare *dcl, const G4_INST *inst) const;
+};
+} // namespace vISA
+
+#endif // __SPILLCOSTMODEL_H__
@@ -8,6 +8,7 @@ SPDX-License-Identifier: MIT
 
 #include "Timer.h"
 #include "Assertions.h"
+#include "CompileTrace.h"
 #include "Option.h"
 
 #include <fstream>
@@ -153,8 +154,26 @@ int createNewTimer(const char *name) {
   return numTimers++;
 }
 
+// The VISA_BUILDER timers are hit per instruction and operand, too fine
+// grained for the compile trace.
+static bool isTracedTimer(TimerID timerId) {
+  return timerId < TimerID::NUM_TIMERS &&
+         timerId != TimerID::VISA_BUILDER_APPEND_INST &&
+         timerId != TimerID::VISA_BUILDER_CREATE_VAR &&
+         timerId != TimerID::VISA_BUILDER_CREATE_OPND;
+}
+
+static const char *getTracedTimerName(TimerID timerId) {
+  const char *name = timerNames[static_cast<int>(timerId)];
+  while (*name == '\t')
+    name++;
+  return name;
+}
+
 void startTimer(TimerID timerId) {
   int timer = static_cast<int>(timerId);
+  if (vISA::CompileTrace::isEnabled() && isTracedTimer(timerId))
+    vISA::CompileTrace::begin("vISA", getTracedTimerName(timerId));
 #ifdef MEASURE_COMPILATION_TIME
   if (timer < static_cast<int>(TimerID::NUM_TIMERS)) {
 #if defined(_DEBUG) && defined(CHECK_TIMER)
@@ -182,6 +201,8 @@ void startTimer(TimerID timerId) {
 
 void stopTimer(TimerID timerId) {
   int timer = static_cast<int>(timerId);
+  if (vISA::CompileTrace::isEnabled() && isTracedTimer(timerId))
+    vISA::CompileTrace::end(getTracedTimerName(timerId));
 #ifdef MEASURE_COMPILATION_TIME
   if (timer < static_cast<int>(TimerID::NUM_TIMERS)) {
     LARGE_INTEGER stop;
@@ -15,6 +15,7 @@ SPDX-License-Identifier: MIT
 #define MEASURE_COMPILATION_TIME
 #endif
 
+#include "CompileTrace.h"
 #include "Option.h"
 
 // Timer library for the compiler
@@ -54,10 +55,26 @@ struct TimerScope {
   ~TimerScope() { stopTimer(timerId); }
 };
 
+// Without MEASURE_COMPILATION_TIME the timers only feed the compile trace, so
+// the scope does nothing beyond a relaxed load unless the trace is on.
+struct TraceTimerScope {
+  const TimerID timerId;
+  const bool active;
+  TraceTimerScope(const TimerID _timerId)
+      : timerId(_timerId), active(vISA::CompileTrace::isEnabled()) {
+    if (active)
+      startTimer(timerId);
+  }
+  ~TraceTimerScope() {
+    if (active)
+      stopTimer(timerId);
+  }
+};
+
 #if defined(MEASURE_COMPILATION_TIME)
 #define TIME_SCOPE(TIMER_ID) TimerScope __timerScope(TimerID::TIMER_ID);
 #else
-#define TIME_SCOPE(TIMER_ID)
+#define TIME_SCOPE(TIMER_ID) TraceTimerScope __timerScope(TimerID::TIMER_ID);
 #endif
 
 #undef DEF_TIMER
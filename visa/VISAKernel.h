@@ -267,6 +267,12 @@ public:
   void pushIndexMapScopeLevel();
   void popIndexMapScopeLevel();
 
+  // Opens a name scope with the predefined variables and the operands bound
+  // with BindVISAAsmOperand, for an inline assembly snippet to be parsed
+  // into this kernel. endAsmSnippet closes it and drops the bindings.
+  bool beginAsmSnippet();
+  void endAsmSnippet();
+
   vISA::G4_Kernel *getKernel() const { return m_kernel; }
   vISA::IR_Builder *getIRBuilder() const { return m_builder; }
   CISA_IR_Builder *getCISABuilder() const { return m_CISABuilder; }
@@ -1060,6 +1066,17 @@ public:
   VISA_BUILDER_API std::string getVarName(VISA_SurfaceVar *decl) const override;
   VISA_BUILDER_API std::string getVarName(VISA_SamplerVar *decl) const override;
 
+  VISA_BUILDER_API int BindVISAAsmOperand(const char *name,
+                                          VISA_GenVar *decl) override;
+  VISA_BUILDER_API int BindVISAAsmOperand(const char *name,
+                                          VISA_PredVar *decl) override;
+  VISA_BUILDER_API int BindVISAAsmOperand(const char *name,
+                                          VISA_AddrVar *decl) override;
+  VISA_BUILDER_API int BindVISAAsmOperand(const char *name,
+                                          VISA_SurfaceVar *decl) override;
+  VISA_BUILDER_API int BindVISAAsmOperand(const char *name,
+                                          VISA_SamplerVar *decl) override;
+
   // Gets the VISA string format for the operand
   VISA_BUILDER_API std::string
   getVectorOperandName(VISA_VectorOpnd *opnd, bool showRegion) const override;
@@ -1363,6 +1380,9 @@ private:
   // Note that name is only unique within the same scope
   std::map<CISA_GEN_VAR *, std::string> m_GenVarToNameMap;
 
+  // operands bound to the next inline assembly snippet
+  std::vector<std::pair<std::string, CISA_GEN_VAR *>> m_asmSnippetOperands;
+
   std::unordered_map<std::string, VISA_LabelOpnd *> m_label_name_to_index_map;
   std::unordered_map<std::string, VISA_LabelOpnd *> m_funcName_to_labelID_map;
 
@@ -660,6 +660,8 @@ void VISAKernelImpl::recordFinalizerInfo() {
     jitInfo->stats.numAsmCountUnweighted = m_kernel->getAsmCount();
     jitInfo->stats.numGRFTotal = m_kernel->getNumRegTotal();
     jitInfo->stats.numThreads = m_kernel->getNumThreads();
+    jitInfo->stats.simdSize = m_kernel->getSimdSize();
+    jitInfo->stats.compileBudgetExceeded = m_kernel->isCompileBudgetExceeded();
     jitInfo->BBNum = static_cast<uint32_t>(m_kernel->fg.size());
   }
 }
@@ -948,6 +950,33 @@ std::string VISAKernelImpl::getVarName(VISA_SamplerVar *decl) const {
   return getVarName((CISA_GEN_VAR *)decl);
 }
 
+int VISAKernelImpl::BindVISAAsmOperand(const char *name, VISA_GenVar *decl) {
+  m_asmSnippetOperands.emplace_back(name, decl);
+  return VISA_SUCCESS;
+}
+
+int VISAKernelImpl::BindVISAAsmOperand(const char *name, VISA_PredVar *decl) {
+  m_asmSnippetOperands.emplace_back(name, decl);
+  return VISA_SUCCESS;
+}
+
+int VISAKernelImpl::BindVISAAsmOperand(const char *name, VISA_AddrVar *decl) {
+  m_asmSnippetOperands.emplace_back(name, decl);
+  return VISA_SUCCESS;
+}
+
+int VISAKernelImpl::BindVISAAsmOperand(const char *name,
+                                       VISA_SurfaceVar *decl) {
+  m_asmSnippetOperands.emplace_back(name, decl);
+  return VISA_SUCCESS;
+}
+
+int VISAKernelImpl::BindVISAAsmOperand(const char *name,
+                                       VISA_SamplerVar *decl) {
+  m_asmSnippetOperands.emplace_back(name, decl);
+  return VISA_SUCCESS;
+}
+
 std::string VISAKernelImpl::getVectorOperandName(VISA_VectorOpnd *opnd,
                                                  bool showRegion) const {
   VISAKernel_format_provider fmt(this);
@@ -8429,6 +8458,38 @@ void VISAKernelImpl::popIndexMapScopeLevel() {
   m_GenNamedVarMap.pop_back();
 }
 
+bool VISAKernelImpl::beginAsmSnippet() {
+  pushIndexMapScopeLevel();
+
+  // The predefined variables are only named when the kernel is parsed from
+  // text or built with the vISA path.
+  auto bindPreDefined = [&](const std::string &name, CISA_GEN_VAR *decl) {
+    if (!getDeclFromName(name))
+      setNameIndexMap(name, decl);
+  };
+  for (unsigned int i = 0; i < m_num_pred_vars; i++) {
+    auto predefId = mapExternalToInternalPreDefVar(i);
+    if (predefId == PreDefinedVarsInternal::VAR_LAST)
+      continue;
+    bindPreDefined(getPredefinedVarString(predefId), m_var_info_list[i]);
+    bindPreDefined("V" + std::to_string(i), m_var_info_list[i]);
+  }
+  for (unsigned int i = 0; i < Get_CISA_PreDefined_Surf_Count(); i++)
+    bindPreDefined(vISAPreDefSurf[i].name, m_surface_info_list[i]);
+  bindPreDefined("S31", m_bindlessSampler);
+
+  for (auto &operand : m_asmSnippetOperands) {
+    if (!setNameIndexMap(operand.first, operand.second))
+      return false;
+  }
+  return true;
+}
+
+void VISAKernelImpl::endAsmSnippet() {
+  popIndexMapScopeLevel();
+  m_asmSnippetOperands.clear();
+}
+
 VISAKernelImpl::~VISAKernelImpl() {
   std::list<CisaFramework::CisaInst *>::iterator iter =
       m_instruction_list.begin();
@@ -0,0 +1,99 @@
+# ========================== begin_copyright_notice ============================
+#
+# Copyright (C) 2022 Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+#
+# =========================== end_copyright_notice =============================
+
+"""Check that GenX_IR falls back to the fast passes once its budget runs out.
+
+Compiles corpus/small.visaasm several times and reads the
+compileBudgetExceeded flag that -dumpVISAJsonStats writes to
+<kernel>.stats.json. The runs do not depend on the speed of the machine:
+
+  - without a budget, and with a budget far longer than any compile of the
+    kernel, the fallback is not taken;
+  - with -compileBudgetExpireAt, the budget runs out at the given pass: before
+    RA, when FastCompileRA can still be forced, and after RA, when only the
+    SWSB fallback is left.
+
+Exit status: 0 if the fallback is taken exactly when expected, 1 if not, 2 if
+GenX_IR failed.
+"""
+
+import argparse
+import glob
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+
+class ToolError(Exception):
+    pass
+
+
+def budget_exceeded(genx_ir, src, platform, cwd, extra):
+    """Return {kernel: compileBudgetExceeded} for one GenX_IR run."""
+    os.makedirs(cwd)
+    cmd = [genx_ir, src, "-platform", platform, "-dumpVISAJsonStats"] + extra
+    proc = subprocess.run(cmd, cwd=cwd, stdout=subprocess.PIPE,
+                          stderr=subprocess.STDOUT)
+    if proc.returncode != 0:
+        raise ToolError("'%s' exited with %d\n%s" % (
+            " ".join(cmd), proc.returncode,
+            proc.stdout.decode(errors="replace")))
+    result = {}
+    for path in glob.glob(os.path.join(cwd, "*.stats.json")):
+        with open(path) as f:
+            for kernel, values in json.load(f).items():
+                result[kernel] = values.get("compileBudgetExceeded")
+    if not result:
+        raise ToolError("'%s' did not write any .stats.json" % " ".join(cmd))
+    return result
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(
+        description="Check the compile budget fallback of GenX_IR.")
+    parser.add_argument("--genx-ir", metavar="PATH", required=True,
+                        help="GenX_IR executable")
+    parser.add_argument("--platform", default="DG2",
+                        help="GenX_IR platform (default DG2)")
+    args = parser.parse_args(argv)
+    genx_ir = os.path.abspath(args.genx_ir)
+
+    src = os.path.join(os.path.dirname(os.path.abspath(__file__)), "corpus",
+                       "small.visaasm")
+
+    work_dir = tempfile.mkdtemp(prefix="visa_budget_")
+    try:
+        runs = [("no budget", [], False),
+                ("10min budget", ["-compileBudget", "600000"], False),
+                ("budget out before RA",
+                 ["-compileBudgetExpireAt", "HWConformityChk"], True),
+                ("budget out after RA",
+                 ["-compileBudgetExpireAt", "removeLifetimeOps"], True)]
+        failed = False
+        for i, (name, extra, expected) in enumerate(runs):
+            for kernel, exceeded in budget_exceeded(
+                    genx_ir, src, args.platform,
+                    os.path.join(work_dir, str(i)), extra).items():
+                ok = exceeded == expected
+                failed |= not ok
+                print("%-4s %s: %s compileBudgetExceeded=%s, expected %s"
+                      % ("ok" if ok else "FAIL", name, kernel, exceeded,
+                         expected))
+        return 1 if failed else 0
+    except ToolError as e:
+        print(e, file=sys.stderr)
+        return 2
+    finally:
+        shutil.rmtree(work_dir, ignore_errors=True)
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
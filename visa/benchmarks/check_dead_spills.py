@@ -0,0 +1,104 @@
+# ========================== begin_copyright_notice ============================
+#
+# Copyright (C) 2022 Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+#
+# =========================== end_copyright_notice =============================
+
+"""Check that the spill cleanup removes spills no fill reads.
+
+Compiles the dead_spills kernel of gen_corpus.py, whose first spill of every
+spilled value is overwritten on both sides of a branch before it is filled,
+with and without -noDeadSpillRemoval. It reads the "removed dead spills" lines
+that -RATrace prints and the instruction count that -dumpVISAJsonStats writes
+to <kernel>.stats.json:
+
+  - with the removal, some spills are removed and the kernel has fewer
+    instructions;
+  - without it, none are.
+
+Exit status: 0 if the removal cuts the spill code, 1 if not, 2 if GenX_IR
+failed.
+"""
+
+import argparse
+import glob
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+import gen_corpus
+
+REMOVED_RE = re.compile(r"--removed dead spills: (\d+)")
+
+
+class ToolError(Exception):
+    pass
+
+
+def compile_kernel(genx_ir, src, platform, cwd, extra):
+    """Return the dead spills removed and {kernel: stats} of one run."""
+    os.makedirs(cwd)
+    cmd = [genx_ir, src, "-platform", platform, "-dumpVISAJsonStats",
+           "-RATrace"] + extra
+    proc = subprocess.run(cmd, cwd=cwd, stdout=subprocess.PIPE,
+                          stderr=subprocess.STDOUT)
+    output = proc.stdout.decode(errors="replace")
+    if proc.returncode != 0:
+        raise ToolError("'%s' exited with %d\n%s" % (
+            " ".join(cmd), proc.returncode, output))
+    removed = sum(int(m.group(1)) for m in REMOVED_RE.finditer(output))
+    stats = {}
+    for path in glob.glob(os.path.join(cwd, "*.stats.json")):
+        with open(path) as f:
+            stats.update(json.load(f))
+    if not stats:
+        raise ToolError("'%s' did not write any .stats.json" % " ".join(cmd))
+    return removed, stats
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(
+        description="Check the dead spill removal of GenX_IR.")
+    parser.add_argument("--genx-ir", metavar="PATH", required=True,
+                        help="GenX_IR executable")
+    parser.add_argument("--platform", default="DG2",
+                        help="GenX_IR platform (default DG2)")
+    args = parser.parse_args(argv)
+    genx_ir = os.path.abspath(args.genx_ir)
+
+    work_dir = tempfile.mkdtemp(prefix="visa_dead_spills_")
+    try:
+        src = os.path.join(work_dir, "dead_spills.visaasm")
+        gen_corpus.write(src, gen_corpus.gen_dead_spills(),
+                         gen_corpus.COPYRIGHT)
+
+        removed, stats = compile_kernel(genx_ir, src, args.platform,
+                                        os.path.join(work_dir, "on"), [])
+        kept, base = compile_kernel(genx_ir, src, args.platform,
+                                    os.path.join(work_dir, "off"),
+                                    ["-noDeadSpillRemoval"])
+        failed = False
+        for kernel in sorted(stats):
+            before = base.get(kernel, {}).get("numAsmCount")
+            after = stats[kernel].get("numAsmCount")
+            ok = (removed > 0 and kept == 0 and before is not None and
+                  after is not None and after < before)
+            failed |= not ok
+            print("%-4s %s: %d dead spills removed, %s -> %s instructions"
+                  % ("ok" if ok else "FAIL", kernel, removed, before, after))
+        return 1 if failed else 0
+    except ToolError as e:
+        print(e, file=sys.stderr)
+        return 2
+    finally:
+        shutil.rmtree(work_dir, ignore_errors=True)
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
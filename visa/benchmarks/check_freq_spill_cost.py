@@ -0,0 +1,117 @@
+# ========================== begin_copyright_notice ============================
+#
+# Copyright (C) 2022 Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+#
+# =========================== end_copyright_notice =============================
+
+"""Check that -freqSpillCost moves spills out of loops.
+
+Compiles the freq_spill kernel of gen_corpus.py, whose "loop" values L<n> are
+read in a loop and whose "outer" values O<n> are written and read outside of
+it, and reads the variables spilled by the first GRF coloring from the
+"spilled variables" line that -RATrace prints:
+
+  - with -newspillcost, which counts references, some loop values spill;
+  - with -freqSpillCost, which prices references in frequency-weighted
+    cycles, only outer values spill.
+
+The loop-weighted spill/fill count that -dumpVISAJsonStats writes to
+<kernel>.stats.json is printed for both runs.
+
+Exit status: 0 if the spills are where expected, 1 if not, 2 if GenX_IR
+failed.
+"""
+
+import argparse
+import glob
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+import gen_corpus
+
+SPILLED = "--spilled variables:"
+
+
+class ToolError(Exception):
+    pass
+
+
+def compile_kernel(genx_ir, src, platform, cwd, extra):
+    """Return the first spilled variables and {kernel: stats} of one run."""
+    os.makedirs(cwd)
+    cmd = [genx_ir, src, "-platform", platform, "-dumpVISAJsonStats",
+           "-RATrace"] + extra
+    proc = subprocess.run(cmd, cwd=cwd, stdout=subprocess.PIPE,
+                          stderr=subprocess.STDOUT)
+    output = proc.stdout.decode(errors="replace")
+    if proc.returncode != 0:
+        raise ToolError("'%s' exited with %d\n%s" % (
+            " ".join(cmd), proc.returncode, output))
+    spilled = None
+    for line in output.splitlines():
+        line = line.strip()
+        if line.startswith(SPILLED):
+            spilled = line[len(SPILLED):].split()
+            break
+    stats = {}
+    for path in glob.glob(os.path.join(cwd, "*.stats.json")):
+        with open(path) as f:
+            stats.update(json.load(f))
+    if not stats:
+        raise ToolError("'%s' did not write any .stats.json" % " ".join(cmd))
+    return spilled, stats
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(
+        description="Check the spills of GenX_IR under -freqSpillCost.")
+    parser.add_argument("--genx-ir", metavar="PATH", required=True,
+                        help="GenX_IR executable")
+    parser.add_argument("--platform", default="DG2",
+                        help="GenX_IR platform (default DG2)")
+    args = parser.parse_args(argv)
+    genx_ir = os.path.abspath(args.genx_ir)
+
+    work_dir = tempfile.mkdtemp(prefix="visa_freq_spill_")
+    try:
+        src = os.path.join(work_dir, "freq_spill.visaasm")
+        gen_corpus.write(src, gen_corpus.gen_freq_spill(),
+                         gen_corpus.COPYRIGHT)
+
+        # (name, options, loop values expected to spill)
+        runs = [("reference counts", ["-newspillcost"], True),
+                ("frequency-weighted cycles", ["-freqSpillCost"], False)]
+        failed = False
+        for i, (name, extra, loop_spills) in enumerate(runs):
+            spilled, stats = compile_kernel(genx_ir, src, args.platform,
+                                            os.path.join(work_dir, str(i)),
+                                            extra)
+            if not spilled:
+                print("FAIL %s: nothing spilled" % name)
+                failed = True
+                continue
+            in_loop = [v for v in spilled if v.startswith("L")]
+            outer = [v for v in spilled if v.startswith("O")]
+            ok = bool(in_loop) == loop_spills and (loop_spills or bool(outer))
+            failed |= not ok
+            for kernel in sorted(stats):
+                print("%-4s %s: %s %d loop and %d outer values spilled, "
+                      "spill/fill %s"
+                      % ("ok" if ok else "FAIL", name, kernel, len(in_loop),
+                         len(outer), stats[kernel].get("numGRFSpillFill")))
+        return 1 if failed else 0
+    except ToolError as e:
+        print(e, file=sys.stderr)
+        return 2
+    finally:
+        shutil.rmtree(work_dir, ignore_errors=True)
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,264 @@
+# ========================== begin_copyright_notice ============================
+#
+# Copyright (C) 2022 Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+#
+# =========================== end_copyright_notice =============================
+
+"""Static code-quality checks for the vISA finalizer.
+
+Compiles every kernel of corpus/, and the kernels generated by gen_corpus.py,
+with GenX_IR for each platform listed in its "// platforms:" line, reads the stats written by -dumpVISAJsonStats (the
+PERF_STATS part of FINALIZER_INFO) and compares them against a stored
+baseline with per-metric tolerances. No GPU is needed.
+
+Exit status: 0 if nothing regressed, 1 if some metric regressed, 2 if
+GenX_IR failed or the baseline is missing.
+"""
+
+import argparse
+import glob
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+import gen_corpus
+
+RESULTS_VERSION = 1
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+
+LOWER, HIGHER, EXACT = "lower", "higher", "exact"
+
+# Metric -> (better direction, relative tolerance, absolute tolerance).
+# A change is reported when it goes the wrong way by more than both
+# tolerances; EXACT metrics are reported on any change.
+METRICS = {
+    "numAsmCount": (LOWER, 0.02, 2),
+    "numGRFSpillFill": (LOWER, 0.0, 0),
+    "GRFSpillSize": (LOWER, 0.0, 0),
+    "numFlagSpillStore": (LOWER, 0.0, 0),
+    "numFlagSpillLoad": (LOWER, 0.0, 0),
+    "numGRFUsed": (LOWER, 0.05, 2),
+    "maxGRFPressure": (LOWER, 0.05, 2),
+    "numCycles": (LOWER, 0.02, 10),
+    "staticCycle": (LOWER, 0.02, 10),
+    "loopNestedCycle": (LOWER, 0.02, 10),
+    "sendStallCycle": (LOWER, 0.05, 10),
+    "simdSize": (HIGHER, 0.0, 0),
+    "numGRFTotal": (EXACT, 0.0, 0),
+    "numThreads": (HIGHER, 0.0, 0),
+}
+
+
+class ToolError(Exception):
+    pass
+
+
+def kernel_platforms(path):
+    """Return the platforms listed in the "// platforms:" line of a kernel."""
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith("// platforms:"):
+                return line[len("// platforms:"):].split()
+    return []
+
+
+def compile_kernel(genx_ir, src, platform, cwd, extra):
+    cmd = [genx_ir, os.path.abspath(src), "-platform", platform,
+           "-dumpVISAJsonStats"] + extra
+    proc = subprocess.run(cmd, cwd=cwd, stdout=subprocess.PIPE,
+                          stderr=subprocess.STDOUT)
+    if proc.returncode != 0:
+        raise ToolError("'%s' exited with %d\n%s" % (
+            " ".join(cmd), proc.returncode,
+            proc.stdout.decode(errors="replace")))
+    stats = {}
+    for path in glob.glob(os.path.join(cwd, "*.stats.json")):
+        with open(path) as f:
+            # {"<kernel name>": {<PERF_STATS>}}
+            for kernel, values in json.load(f).items():
+                stats[kernel] = {k: v for k, v in values.items()
+                                 if k in METRICS or k == "binaryHash"}
+    if not stats:
+        raise ToolError("'%s' did not write any .stats.json" % " ".join(cmd))
+    return stats
+
+
+def collect(args):
+    results = {}
+    work_dir = tempfile.mkdtemp(prefix="visa_quality_")
+    try:
+        generated_dir = os.path.join(work_dir, "corpus")
+        gen_corpus.write_generated(generated_dir)
+        for src in gen_corpus.corpus_files(args.corpus, generated_dir,
+                                           "*.visaasm"):
+            stem = os.path.splitext(os.path.basename(src))[0]
+            for platform in kernel_platforms(src):
+                if args.platform and platform not in args.platform:
+                    continue
+                name = "%s.%s" % (stem, platform)
+                if args.filter and not any(f in name for f in args.filter):
+                    continue
+                cwd = os.path.join(work_dir, name)
+                os.makedirs(cwd)
+                for kernel, stats in compile_kernel(
+                        args.genx_ir, src, platform, cwd,
+                        args.extra).items():
+                    results["%s.%s" % (name, kernel)] = stats
+                    print("%-48s %6s instructions %5s spill/fill %8s cycles"
+                          % ("%s.%s" % (name, kernel),
+                             stats.get("numAsmCount", "-"),
+                             stats.get("numGRFSpillFill", "-"),
+                             stats.get("staticCycle", "-")))
+        return results
+    finally:
+        shutil.rmtree(work_dir, ignore_errors=True)
+
+
+def compare(results, baseline, tolerances):
+    """Return the regressions, the improvements and the other notes."""
+    regressions, improvements, notes = [], [], []
+    for name, base in sorted(baseline.items()):
+        cur = results.get(name)
+        if cur is None:
+            notes.append("%s: in the baseline but not compiled" % name)
+            continue
+        for metric, (better, rel, abs_tol) in sorted(tolerances.items()):
+            if metric not in base or metric not in cur:
+                continue
+            old, new = base[metric], cur[metric]
+            if old == new:
+                continue
+            change = "%s: %s %s -> %s" % (name, metric, old, new)
+            if better == EXACT:
+                regressions.append(change)
+                continue
+            worse = new > old if better == LOWER else new < old
+            delta = abs(new - old)
+            if worse and delta > abs_tol and delta > abs(old) * rel:
+                regressions.append(change)
+            elif not worse:
+                improvements.append(change)
+        if base.get("binaryHash") != cur.get("binaryHash"):
+            notes.append("%s: binary changed" % name)
+    for name in sorted(set(results) - set(baseline)):
+        notes.append("%s: not in the baseline" % name)
+    return regressions, improvements, notes
+
+
+def parse_tolerances(overrides):
+    tolerances = dict(METRICS)
+    for override in overrides or []:
+        metric, sep, value = override.partition("=")
+        if not sep or metric not in tolerances:
+            raise ValueError("bad tolerance '%s', expected one of %s=REL[,ABS]"
+                             % (override, "|".join(sorted(METRICS))))
+        rel, _, abs_tol = value.partition(",")
+        better, old_rel, old_abs = tolerances[metric]
+        tolerances[metric] = (better, float(rel) if rel else old_rel,
+                              float(abs_tol) if abs_tol else old_abs)
+    return tolerances
+
+
+def parse_args(argv):
+    parser = argparse.ArgumentParser(
+        description="Static code-quality checks of GenX_IR on the corpus.")
+    parser.add_argument("--genx-ir", metavar="PATH", required=True,
+                        help="GenX_IR executable")
+    parser.add_argument("--platform", action="append", metavar="NAME",
+                        help="only compile for this GenX_IR platform; by "
+                             "default every platform a kernel lists is used")
+    parser.add_argument("--corpus", default=os.path.join(SCRIPT_DIR, "corpus"))
+    parser.add_argument("--baseline",
+                        default=os.path.join(SCRIPT_DIR, "quality.json"))
+    parser.add_argument("--update-baseline", action="store_true",
+                        help="write the results to the baseline instead of "
+                             "comparing against it")
+    parser.add_argument("-o", "--output", metavar="FILE",
+                        help="also write the results to FILE")
+    parser.add_argument("--filter", action="append", metavar="SUBSTR",
+                        help="only compile the kernel.platform pairs whose "
+                             "name contains SUBSTR")
+    parser.add_argument("--tolerance", action="append",
+                        metavar="METRIC=REL[,ABS]",
+                        help="override the tolerance of a metric")
+    parser.add_argument("--extra", action="append", default=[],
+                        metavar="OPTION",
+                        help="extra GenX_IR option, e.g. --extra=-noschedule")
+    args = parser.parse_args(argv)
+    try:
+        args.tolerances = parse_tolerances(args.tolerance)
+    except ValueError as e:
+        parser.error(str(e))
+    args.genx_ir = os.path.abspath(args.genx_ir)
+    return args
+
+
+def main(argv):
+    args = parse_args(argv)
+
+    baseline = None
+    if not args.update_baseline:
+        if not os.path.exists(args.baseline):
+            print("no baseline at %s, run with --update-baseline first"
+                  % args.baseline, file=sys.stderr)
+            return 2
+        with open(args.baseline) as f:
+            data = json.load(f)
+        if data.get("version") != RESULTS_VERSION:
+            print("%s: unsupported version" % args.baseline, file=sys.stderr)
+            return 2
+        baseline = data["kernels"]
+        # only compare what was compiled this time
+        if args.platform or args.filter:
+            baseline = {k: v for k, v in baseline.items()
+                        if (not args.platform or
+                            k.split(".")[1] in args.platform) and
+                        (not args.filter or
+                         any(f in k for f in args.filter))}
+
+    try:
+        results = collect(args)
+    except ToolError as e:
+        print(str(e), file=sys.stderr)
+        return 2
+
+    data = {"version": RESULTS_VERSION, "kernels": results}
+    outputs = [args.output] if args.output else []
+    if args.update_baseline:
+        if (args.platform or args.filter) and os.path.exists(args.baseline):
+            with open(args.baseline) as f:
+                old = json.load(f)
+            if old.get("version") == RESULTS_VERSION:
+                old["kernels"].update(results)
+                data["kernels"] = old["kernels"]
+        outputs.append(args.baseline)
+    for path in outputs:
+        with open(path, "w") as f:
+            json.dump(data, f, indent=2, sort_keys=True)
+            f.write("\n")
+
+    if baseline is None:
+        return 0
+    regressions, improvements, notes = compare(results, baseline,
+                                               args.tolerances)
+    for note in notes:
+        print("note: " + note)
+    for improvement in improvements:
+        print("improved: " + improvement)
+    for regression in regressions:
+        print("REGRESSION: " + regression)
+    if regressions:
+        return 1
+    print("no regression against %s" % args.baseline)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
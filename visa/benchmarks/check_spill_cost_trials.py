@@ -0,0 +1,123 @@
+# ========================== begin_copyright_notice ============================
+#
+# Copyright (C) 2022 Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+#
+# =========================== end_copyright_notice =============================
+
+"""Check that -spillCostTrials changes the spill choice when it should.
+
+Compiles the spill_choice kernel of gen_corpus.py, whose hot values are only
+kept by the reference-based spill cost function, and reads the
+"spill cost trials" lines that -RATrace prints and the stats that
+-dumpVISAJsonStats writes to <kernel>.stats.json:
+
+  - with the default, degree-based, function first, the trial keeps the other
+    function, and the binary and the spill/fill count differ from a compile
+    without trials;
+  - with -newspillcost, the reference-based function is the first one, the
+    trial keeps the first assignment, and the binary is the one of a compile
+    without trials.
+
+Exit status: 0 if the trials keep the expected assignment, 1 if not, 2 if
+GenX_IR failed.
+"""
+
+import argparse
+import glob
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+import gen_corpus
+
+TRIAL_RE = re.compile(r"--spill cost trials: spill traffic (\d+) vs (\d+) "
+                      r"with the other function, keeping the (first|other)")
+
+
+class ToolError(Exception):
+    pass
+
+
+def compile_kernel(genx_ir, src, platform, cwd, extra):
+    """Return the trials and {kernel: stats} of one GenX_IR run."""
+    os.makedirs(cwd)
+    cmd = [genx_ir, src, "-platform", platform, "-dumpVISAJsonStats",
+           "-RATrace"] + extra
+    proc = subprocess.run(cmd, cwd=cwd, stdout=subprocess.PIPE,
+                          stderr=subprocess.STDOUT)
+    output = proc.stdout.decode(errors="replace")
+    if proc.returncode != 0:
+        raise ToolError("'%s' exited with %d\n%s" % (
+            " ".join(cmd), proc.returncode, output))
+    trials = [(int(m.group(1)), int(m.group(2)), m.group(3))
+              for m in TRIAL_RE.finditer(output)]
+    stats = {}
+    for path in glob.glob(os.path.join(cwd, "*.stats.json")):
+        with open(path) as f:
+            stats.update(json.load(f))
+    if not stats:
+        raise ToolError("'%s' did not write any .stats.json" % " ".join(cmd))
+    return trials, stats
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(
+        description="Check the spill cost trials of GenX_IR.")
+    parser.add_argument("--genx-ir", metavar="PATH", required=True,
+                        help="GenX_IR executable")
+    parser.add_argument("--platform", default="DG2",
+                        help="GenX_IR platform (default DG2)")
+    args = parser.parse_args(argv)
+    genx_ir = os.path.abspath(args.genx_ir)
+
+    work_dir = tempfile.mkdtemp(prefix="visa_spill_trials_")
+    try:
+        src = os.path.join(work_dir, "spill_choice.visaasm")
+        gen_corpus.write(src, gen_corpus.gen_spill_choice(),
+                         gen_corpus.COPYRIGHT)
+
+        runs = [("degree-based first", [], "other"),
+                ("reference-based first", ["-newspillcost"], "first")]
+        failed = False
+        for i, (name, extra, expected) in enumerate(runs):
+            _, base = compile_kernel(genx_ir, src, args.platform,
+                                     os.path.join(work_dir, "%d.base" % i),
+                                     extra)
+            trials, stats = compile_kernel(
+                genx_ir, src, args.platform,
+                os.path.join(work_dir, "%d.trials" % i),
+                extra + ["-spillCostTrials"])
+            if not trials:
+                print("FAIL %s: no spill cost trial" % name)
+                failed = True
+                continue
+            # The first RA iteration decides which live ranges spill.
+            first, other, kept = trials[0]
+            ok = kept == expected and (kept == "other") == (other < first)
+            for kernel in sorted(stats):
+                same = (stats[kernel].get("binaryHash") ==
+                        base.get(kernel, {}).get("binaryHash"))
+                ok = ok and same == (expected == "first")
+                print("%-4s %s: %s spill traffic %d vs %d, kept the %s, "
+                      "spill/fill %s -> %s, %s binary"
+                      % ("ok" if ok else "FAIL", name, kernel, first, other,
+                         kept, base.get(kernel, {}).get("numGRFSpillFill"),
+                         stats[kernel].get("numGRFSpillFill"),
+                         "same" if same else "different"))
+            failed |= not ok
+        return 1 if failed else 0
+    except ToolError as e:
+        print(e, file=sys.stderr)
+        return 2
+    finally:
+        shutil.rmtree(work_dir, ignore_errors=True)
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,18 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+mov (16|M0) r10.0<1>:d r2.0<1;1,0>:d
+add (16|M0) r12.0<1>:f r10.0<1;1,0>:f r14.0<1;1,0>:f
+(W) cmp (16|M0) (lt)f0.0 null<1>:d r10.0<1;1,0>:d 0x10:d
+(W&f0.0) jmpi L0
+mad (16|M0) r16.0<1>:f r12.0<1;0>:f r14.0<1;0>:f r18.0<1>:f
+L0:
+sync.nop null {A@1}
+mul (16|M0) r20.0<1>:d r10.0<1;1,0>:d r12.0<1;1,0>:d
+dpas.8x8 (8|M0) r24:f r24:f r32:hf r40.0:hf
+(W) send.ugm (1|M0) null r112 null:0 0x0 0x02000010 {EOT}
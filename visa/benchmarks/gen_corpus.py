@@ -0,0 +1,384 @@
+# ========================== begin_copyright_notice ============================
+#
+# Copyright (C) 2022 Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+#
+# =========================== end_copyright_notice =============================
+
+"""Generate the large kernels of the compile-time benchmark corpus.
+
+The output is deterministic. Only the DPAS kernel is checked in; the larger
+ones are written by the scripts of this directory to their work directory on
+every run, with write_generated(). To regenerate the checked-in kernel, or to look at the
+others, run
+
+    python3 gen_corpus.py [corpus_dir]
+    python3 gen_corpus.py --generated <dir>
+"""
+
+import glob
+import os
+import sys
+
+COPYRIGHT = """\
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// Generated by visa/benchmarks/gen_corpus.py, do not edit.
+"""
+
+
+def visa_header(name, inputs, platforms):
+    # The platforms line is read by check_quality.py.
+    lines = ["// platforms: " + " ".join(platforms),
+             ".version 4.1", '.kernel "%s"' % name]
+    for var, _ in inputs:
+        lines.append(".decl %s v_type=G type=uq num_elts=1 align=qword" % var)
+    return lines
+
+
+def visa_inputs(inputs):
+    # Inputs start at r1, whatever the GRF size of the platform.
+    lines = [".input %s offset=(%%sizeof(GRF)+%d) size=8" % (var, offset)
+             for var, offset in inputs]
+    lines.append('.kernel_attr Target="cm"')
+    return lines
+
+
+# DPAS-heavy: a K loop over a 2x4 grid of 8x8 HF tiles, 8 accumulators live
+# across the loop.
+def gen_dpas(tile_m=2, tile_n=4, k_iters=16):
+    inputs = [("VA", 0), ("VB", 8), ("VC", 16)]
+    # SIMD8 DPAS is XeHPG only.
+    lines = visa_header("bench_dpas", inputs, ["DG2"])
+    for m in range(tile_m):
+        lines.append(".decl A%d v_type=G type=ud num_elts=64 align=GRF" % m)
+    for n in range(tile_n):
+        lines.append(".decl B%d v_type=G type=ud num_elts=64 align=GRF" % n)
+    for m in range(tile_m):
+        for n in range(tile_n):
+            lines.append(
+                ".decl C%d_%d v_type=G type=f num_elts=64 align=GRF" % (m, n))
+    lines.append(".decl VK v_type=G type=d num_elts=1 align=dword")
+    lines.append(".decl P1 v_type=P num_elts=1")
+    lines += visa_inputs(inputs)
+
+    for m in range(tile_m):
+        for n in range(tile_n):
+            lines.append("    mov (M1, 16) C%d_%d(0,0)<1> 0x0:f" % (m, n))
+            lines.append("    mov (M1, 16) C%d_%d(2,0)<1> 0x0:f" % (m, n))
+            lines.append("    mov (M1, 16) C%d_%d(4,0)<1> 0x0:f" % (m, n))
+            lines.append("    mov (M1, 16) C%d_%d(6,0)<1> 0x0:f" % (m, n))
+    lines.append("    mov (M1_NM, 1) VK(0,0)<1> 0x0:d")
+    lines.append("K_LOOP:")
+    for m in range(tile_m):
+        lines.append("    lsc_load.ugm (M1_NM, 1) A%d:d32x64t flat[VA+%d]:a64"
+                     % (m, 256 * m))
+    for n in range(tile_n):
+        lines.append("    lsc_load.ugm (M1_NM, 1) B%d:d32x64t flat[VB+%d]:a64"
+                     % (n, 256 * n))
+    for m in range(tile_m):
+        for n in range(tile_n):
+            lines.append(
+                "    dpas.hf.hf.8.8 (M1, 8) C%d_%d.0 C%d_%d.0 B%d.0 A%d(0,0)"
+                % (m, n, m, n, n, m))
+    lines.append("    add (M1_NM, 1) VA(0,0)<1> VA(0,0)<0;1,0> 0x%x:uq"
+                 % (256 * tile_m))
+    lines.append("    add (M1_NM, 1) VB(0,0)<1> VB(0,0)<0;1,0> 0x%x:uq"
+                 % (256 * tile_n))
+    lines.append("    add (M1_NM, 1) VK(0,0)<1> VK(0,0)<0;1,0> 0x1:d")
+    lines.append("    cmp.lt (M1_NM, 1) P1 VK(0,0)<0;1,0> 0x%x:d" % k_iters)
+    lines.append("    (P1) jmp (M1_NM, 1) K_LOOP")
+    for m in range(tile_m):
+        for n in range(tile_n):
+            lines.append(
+                "    lsc_store.ugm (M1_NM, 1) flat[VC+%d]:a64 C%d_%d:d32x64t"
+                % (256 * (m * tile_n + n), m, n))
+    lines.append("    ret (M1, 1)")
+    return lines
+
+
+# Huge CFG: a long chain of uniform diamonds with a short counted loop every
+# few blocks, so that the flow graph, liveness and RA interference walk many
+# small blocks.
+def gen_huge_cfg(num_blocks=2000, loop_every=32):
+    inputs = [("VA", 0)]
+    lines = visa_header("bench_huge_cfg", inputs, ["DG2", "MTL", "PVC"])
+    lines.append(".decl VX v_type=G type=d num_elts=16 align=GRF")
+    lines.append(".decl VY v_type=G type=d num_elts=16 align=GRF")
+    lines.append(".decl VS v_type=G type=d num_elts=1 align=dword")
+    lines.append(".decl VK v_type=G type=d num_elts=1 align=dword")
+    lines.append(".decl P1 v_type=P num_elts=1")
+    lines += visa_inputs(inputs)
+
+    lines.append("    lsc_load.ugm (M1_NM, 1) VX:d32x16t flat[VA]:a64")
+    lines.append("    mov (M1_NM, 1) VS(0,0)<1> VX(0,0)<0;1,0>")
+    lines.append("    mov (M1, 16) VY(0,0)<1> 0x0:d")
+    for i in range(num_blocks):
+        lines.append("    cmp.eq (M1_NM, 1) P1 VS(0,0)<0;1,0> 0x%x:d" % i)
+        lines.append("    (P1) jmp (M1_NM, 1) BB%d_ELSE" % i)
+        lines.append("    add (M1, 16) VX(0,0)<1> VX(0,0)<1;1,0> 0x%x:d" % i)
+        lines.append("    xor (M1, 16) VY(0,0)<1> VY(0,0)<1;1,0> "
+                     "VX(0,0)<1;1,0>")
+        lines.append("    jmp (M1_NM, 1) BB%d_END" % i)
+        lines.append("BB%d_ELSE:" % i)
+        lines.append("    mul (M1, 16) VY(0,0)<1> VY(0,0)<1;1,0> 0x%x:d"
+                     % (i + 3))
+        lines.append("BB%d_END:" % i)
+        if i % loop_every == loop_every - 1:
+            lines.append("    mov (M1_NM, 1) VK(0,0)<1> 0x0:d")
+            lines.append("BB%d_LOOP:" % i)
+            lines.append("    shl (M1, 16) VX(0,0)<1> VX(0,0)<1;1,0> 0x1:d")
+            lines.append("    add (M1_NM, 1) VK(0,0)<1> VK(0,0)<0;1,0> 0x1:d")
+            lines.append("    cmp.lt (M1_NM, 1) P1 VK(0,0)<0;1,0> 0x4:d")
+            lines.append("    (P1) jmp (M1_NM, 1) BB%d_LOOP" % i)
+    lines.append("    add (M1, 16) VY(0,0)<1> VY(0,0)<1;1,0> VX(0,0)<1;1,0>")
+    lines.append("    lsc_store.ugm (M1_NM, 1) flat[VA]:a64 VY:d32x16t")
+    lines.append("    ret (M1, 1)")
+    return lines
+
+
+# Spill-heavy: more 16-dword values live at once than fit in the GRF file,
+# each loaded up front and consumed from both ends of the list.
+def gen_spill_heavy(num_values=160):
+    inputs = [("VA", 0), ("VC", 8)]
+    lines = visa_header("bench_spill_heavy", inputs,
+                        ["DG2", "MTL", "PVC"])
+    for i in range(num_values):
+        lines.append(".decl V%d v_type=G type=d num_elts=16 align=GRF" % i)
+    lines.append(".decl ACC v_type=G type=d num_elts=16 align=GRF")
+    lines.append(".decl TMP v_type=G type=d num_elts=16 align=GRF")
+    lines += visa_inputs(inputs)
+
+    for i in range(num_values):
+        lines.append("    lsc_load.ugm (M1_NM, 1) V%d:d32x16t flat[VA+%d]:a64"
+                     % (i, 64 * i))
+    lines.append("    mov (M1, 16) ACC(0,0)<1> 0x0:d")
+    for i in range(num_values):
+        j = num_values - 1 - i
+        lines.append("    mul (M1, 16) TMP(0,0)<1> V%d(0,0)<1;1,0> "
+                     "V%d(0,0)<1;1,0>" % (i, j))
+        lines.append("    add (M1, 16) ACC(0,0)<1> ACC(0,0)<1;1,0> "
+                     "TMP(0,0)<1;1,0>")
+        if i % 16 == 15:
+            lines.append(
+                "    lsc_store.ugm (M1_NM, 1) flat[VC+%d]:a64 ACC:d32x16t"
+                % (64 * (i // 16)))
+    lines.append("    ret (M1, 1)")
+    return lines
+
+
+# Spill choice: "cold" values live across the whole kernel and read once at
+# the end, "hot" values read on every iteration of a loop. Short-lived values
+# loaded before the loop add to the degree of the cold values only, so the
+# degree-based spill cost of CM spills the hot values first, where the
+# reference-based one keeps them and spills the cold ones.
+def gen_spill_choice(num_cold=112, num_hot=24, num_early=24, iters=16):
+    inputs = [("VA", 0), ("VC", 8)]
+    lines = visa_header("bench_spill_choice", inputs, ["DG2", "MTL", "PVC"])
+    for i in range(num_cold):
+        lines.append(".decl C%d v_type=G type=d num_elts=16 align=GRF" % i)
+    for i in range(num_hot):
+        lines.append(".decl H%d v_type=G type=d num_elts=16 align=GRF" % i)
+    for i in range(num_early):
+        lines.append(".decl E%d v_type=G type=d num_elts=16 align=GRF" % i)
+    lines.append(".decl ACC v_type=G type=d num_elts=16 align=GRF")
+    lines.append(".decl VK v_type=G type=d num_elts=1 align=dword")
+    lines.append(".decl P1 v_type=P num_elts=1")
+    lines += visa_inputs(inputs)
+
+    offset = 0
+    for i in range(num_cold):
+        lines.append("    lsc_load.ugm (M1_NM, 1) C%d:d32x16t flat[VA+%d]:a64"
+                     % (i, offset))
+        offset += 64
+    lines.append("    mov (M1, 16) ACC(0,0)<1> 0x0:d")
+    for i in range(num_early):
+        lines.append("    lsc_load.ugm (M1_NM, 1) E%d:d32x16t flat[VA+%d]:a64"
+                     % (i, offset))
+        offset += 64
+    for i in range(num_early):
+        lines.append("    add (M1, 16) ACC(0,0)<1> ACC(0,0)<1;1,0> "
+                     "E%d(0,0)<1;1,0>" % i)
+    for i in range(num_hot):
+        lines.append("    lsc_load.ugm (M1_NM, 1) H%d:d32x16t flat[VA+%d]:a64"
+                     % (i, offset))
+        offset += 64
+    lines.append("    mov (M1_NM, 1) VK(0,0)<1> 0x0:d")
+    lines.append("HOT_LOOP:")
+    for i in range(num_hot):
+        lines.append("    mul (M1, 16) ACC(0,0)<1> ACC(0,0)<1;1,0> "
+                     "H%d(0,0)<1;1,0>" % i)
+        lines.append("    xor (M1, 16) ACC(0,0)<1> ACC(0,0)<1;1,0> "
+                     "H%d(0,0)<1;1,0>" % ((i + 1) % num_hot))
+    lines.append("    add (M1_NM, 1) VK(0,0)<1> VK(0,0)<0;1,0> 0x1:d")
+    lines.append("    cmp.lt (M1_NM, 1) P1 VK(0,0)<0;1,0> 0x%x:d" % iters)
+    lines.append("    (P1) jmp (M1_NM, 1) HOT_LOOP")
+    for i in range(num_cold):
+        lines.append("    add (M1, 16) ACC(0,0)<1> ACC(0,0)<1;1,0> "
+                     "C%d(0,0)<1;1,0>" % i)
+    lines.append("    lsc_store.ugm (M1_NM, 1) flat[VC]:a64 ACC:d32x16t")
+    lines.append("    ret (M1, 1)")
+    return lines
+
+
+# Frequency-weighted spills: "loop" values loaded before a loop and read once
+# per iteration, "outer" values written element by element before the loop
+# and read once after it. Both groups are live across the loop. Counting
+# references, loop-weighted or not, an outer value has more of them, so the
+# loop values spill. In cycles, a fill in the loop costs more than the stores
+# of an outer value, so -freqSpillCost spills the outer values instead.
+def gen_freq_spill(num_loop=40, num_outer=40, iters=16):
+    inputs = [("VA", 0), ("VC", 8)]
+    lines = visa_header("bench_freq_spill", inputs, ["DG2", "MTL", "PVC"])
+    for i in range(num_loop):
+        lines.append(".decl L%d v_type=G type=d num_elts=16 align=GRF" % i)
+    for i in range(num_outer):
+        lines.append(".decl O%d v_type=G type=d num_elts=16 align=GRF" % i)
+    lines.append(".decl ACC v_type=G type=d num_elts=16 align=GRF")
+    lines.append(".decl VK v_type=G type=d num_elts=1 align=dword")
+    lines.append(".decl P1 v_type=P num_elts=1")
+    lines += visa_inputs(inputs)
+
+    for i in range(num_loop):
+        lines.append("    lsc_load.ugm (M1_NM, 1) L%d:d32x16t flat[VA+%d]:a64"
+                     % (i, 64 * i))
+    for i in range(num_outer):
+        for e in range(16):
+            lines.append("    mov (M1_NM, 1) O%d(0,%d)<1> 0x%x:d"
+                         % (i, e, i * 16 + e))
+    lines.append("    mov (M1, 16) ACC(0,0)<1> 0x0:d")
+    lines.append("    mov (M1_NM, 1) VK(0,0)<1> 0x0:d")
+    lines.append("LOOP:")
+    for i in range(num_loop):
+        lines.append("    add (M1, 16) ACC(0,0)<1> ACC(0,0)<1;1,0> "
+                     "L%d(0,0)<1;1,0>" % i)
+    lines.append("    add (M1_NM, 1) VK(0,0)<1> VK(0,0)<0;1,0> 0x1:d")
+    lines.append("    cmp.lt (M1_NM, 1) P1 VK(0,0)<0;1,0> 0x%x:d" % iters)
+    lines.append("    (P1) jmp (M1_NM, 1) LOOP")
+    for i in range(num_outer):
+        lines.append("    xor (M1, 16) ACC(0,0)<1> ACC(0,0)<1;1,0> "
+                     "O%d(0,0)<1;1,0>" % i)
+    lines.append("    lsc_store.ugm (M1_NM, 1) flat[VC]:a64 ACC:d32x16t")
+    lines.append("    ret (M1, 1)")
+    return lines
+
+
+# Dead spills: every value is loaded and read once, then loaded again on
+# both sides of a branch and read after the join, where all of them are live
+# at once. The spills after the first loads are overwritten on every path
+# before any fill, in other BBs than the first loads.
+def gen_dead_spills(num_values=96):
+    inputs = [("VA", 0), ("VC", 8)]
+    lines = visa_header("bench_dead_spills", inputs, ["DG2", "MTL", "PVC"])
+    for i in range(num_values):
+        lines.append(".decl X%d v_type=G type=d num_elts=16 align=GRF" % i)
+    lines.append(".decl ACC v_type=G type=d num_elts=16 align=GRF")
+    lines.append(".decl P1 v_type=P num_elts=1")
+    lines += visa_inputs(inputs)
+
+    lines.append("    mov (M1, 16) ACC(0,0)<1> 0x0:d")
+    for i in range(num_values):
+        lines.append("    lsc_load.ugm (M1_NM, 1) X%d:d32x16t flat[VA+%d]:a64"
+                     % (i, 64 * i))
+        lines.append("    add (M1, 16) ACC(0,0)<1> ACC(0,0)<1;1,0> "
+                     "X%d(0,0)<1;1,0>" % i)
+    lines.append("    cmp.eq (M1_NM, 1) P1 ACC(0,0)<0;1,0> 0x0:d")
+    lines.append("    (P1) jmp (M1_NM, 1) BB_ELSE")
+    for i in range(num_values):
+        lines.append("    lsc_load.ugm (M1_NM, 1) X%d:d32x16t flat[VA+%d]:a64"
+                     % (i, 64 * (num_values + i)))
+    lines.append("    jmp (M1_NM, 1) BB_END")
+    lines.append("BB_ELSE:")
+    for i in range(num_values):
+        lines.append("    lsc_load.ugm (M1_NM, 1) X%d:d32x16t flat[VA+%d]:a64"
+                     % (i, 64 * (2 * num_values + i)))
+    lines.append("BB_END:")
+    for i in range(num_values):
+        lines.append("    xor (M1, 16) ACC(0,0)<1> ACC(0,0)<1;1,0> "
+                     "X%d(0,0)<1;1,0>" % i)
+    lines.append("    lsc_store.ugm (M1_NM, 1) flat[VC]:a64 ACC:d32x16t")
+    lines.append("    ret (M1, 1)")
+    return lines
+
+
+# IGA: a long straight-line XeHPG block of ALU, DPAS and branches, used to
+# time the assembler and disassembler on a large kernel. One assembly or
+# disassembly takes a few hundred milliseconds, well above the noise of
+# starting the process.
+def gen_iga_large(num_blocks=6000):
+    lines = []
+    for i in range(num_blocks):
+        r = 10 + (i % 8) * 8
+        lines.append("mov (16|M0) r%d.0<1>:d r2.0<1;1,0>:d" % r)
+        lines.append("add (16|M0) r%d.0<1>:f r%d.0<1;1,0>:f r%d.0<1;1,0>:f"
+                     % (r + 2, r, r + 4))
+        lines.append("(W) cmp (16|M0) (lt)f0.0 null<1>:d r%d.0<1;1,0>:d "
+                     "0x%x:d" % (r, i))
+        lines.append("(W&f0.0) jmpi L%d" % i)
+        lines.append("mad (16|M0) r%d.0<1>:f r%d.0<1;0>:f r%d.0<1;0>:f "
+                     "r%d.0<1>:f" % (r + 6, r + 2, r + 4, r + 6))
+        lines.append("L%d:" % i)
+        lines.append("sync.nop null {A@1}")
+        lines.append("mul (16|M0) r%d.0<1>:d r%d.0<1;1,0>:d r%d.0<1;1,0>:d"
+                     % (r + 4, r, r + 2))
+        if i % 4 == 0:
+            lines.append("dpas.8x8 (8|M0) r80:f r80:f r96:hf r112.0:hf")
+    lines.append("(W) send.ugm (1|M0) null r120 null:0 0x0 0x02000010 {EOT}")
+    return lines
+
+
+def write(path, lines, header):
+    with open(path, "w", newline="\n") as f:
+        if header:
+            f.write(header)
+        f.write("\n".join(lines))
+        f.write("\n")
+
+
+# Kernels written to the work directory of the benchmark scripts, by path
+# relative to the corpus directory.
+GENERATED = {
+    "huge_cfg.visaasm": gen_huge_cfg,
+    "spill_heavy.visaasm": gen_spill_heavy,
+    "spill_choice.visaasm": gen_spill_choice,
+    "freq_spill.visaasm": gen_freq_spill,
+    "dead_spills.visaasm": gen_dead_spills,
+    os.path.join("iga", "large.xehpg.asm"): gen_iga_large,
+}
+
+
+def write_generated(out_dir):
+    """Write the GENERATED kernels under out_dir, laid out like corpus/."""
+    for name, gen in sorted(GENERATED.items()):
+        path = os.path.join(out_dir, name)
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+        write(path, gen(), COPYRIGHT)
+
+
+def corpus_files(corpus, generated_dir, pattern):
+    """Return the checked-in and the generated files matching pattern, a glob
+    relative to the corpus directory, sorted by file name."""
+    files = glob.glob(os.path.join(corpus, pattern))
+    files += glob.glob(os.path.join(generated_dir, pattern))
+    return sorted(files, key=os.path.basename)
+
+
+def main():
+    if len(sys.argv) > 2 and sys.argv[1] == "--generated":
+        write_generated(sys.argv[2])
+        return 0
+    corpus = sys.argv[1] if len(sys.argv) > 1 else os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), "corpus")
+    write(os.path.join(corpus, "dpas.visaasm"), gen_dpas(), COPYRIGHT)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
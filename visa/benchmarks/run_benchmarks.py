@@ -0,0 +1,408 @@
+# ========================== begin_copyright_notice ============================
+#
+# Copyright (C) 2022 Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+#
+# =========================== end_copyright_notice =============================
+
+"""Compile-time and memory benchmarks for GenX_IR and iga64.
+
+Runs the standalone vISA compiler and the IGA assembler/disassembler on the
+kernels in corpus/ and on the ones generated by gen_corpus.py, repeats every
+run, and compares the medians against a
+stored baseline. See README.md for the list of benchmarks and the thresholds.
+
+Exit status: 0 if nothing regressed, 1 if some benchmark regressed, 2 if a
+tool failed or the baseline is missing.
+"""
+
+import argparse
+import glob
+import json
+import os
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+import gen_corpus
+from check_quality import kernel_platforms
+
+RESULTS_VERSION = 1
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+
+# Times only compare on the machine they were taken on, so the baseline is
+# kept with the user's files rather than next to the sources.
+DEFAULT_BASELINE = os.path.join(
+    os.environ.get("XDG_CACHE_HOME") or os.path.expanduser("~/.cache"),
+    "visa-benchmarks", "baseline.json")
+
+# Columns printed by GenX_IR when vISA is built with COLLECT_ALLOCATION_STATS.
+ARENA_FIELDS = ["allocations", "alloc_kb", "mallocs", "malloc_kb",
+                "mem_managers", "max_arena_length"]
+
+
+class ToolError(Exception):
+    pass
+
+
+class Benchmark:
+    def __init__(self, name, cmd, cwd, produces=()):
+        self.name = name
+        self.cmd = cmd
+        self.cwd = cwd
+        # files the first run has to leave in cwd, used by later benchmarks
+        self.produces = produces
+
+
+def run_once(bench):
+    """Run the benchmark command once and return its measurements."""
+    for f in glob.glob(os.path.join(bench.cwd, "timers.*")):
+        os.remove(f)
+    start = time.perf_counter()
+    proc = subprocess.Popen(bench.cmd, cwd=bench.cwd, stdout=subprocess.PIPE,
+                            stderr=subprocess.STDOUT)
+    out = proc.stdout.read()
+    proc.stdout.close()
+    # wait4 gives the peak RSS of this child alone; RUSAGE_CHILDREN would be
+    # the maximum over every child run so far.
+    _, status, rusage = os.wait4(proc.pid, 0)
+    wall = time.perf_counter() - start
+    if os.WIFSIGNALED(status):
+        proc.returncode = -os.WTERMSIG(status)
+    else:
+        proc.returncode = os.WEXITSTATUS(status)
+    text = out.decode(errors="replace")
+    if proc.returncode != 0:
+        raise ToolError("%s: '%s' exited with %d\n%s" % (
+            bench.name, " ".join(bench.cmd), proc.returncode, text))
+    for f in bench.produces:
+        if not os.path.exists(os.path.join(bench.cwd, f)):
+            raise ToolError("%s: '%s' did not produce %s" % (
+                bench.name, " ".join(bench.cmd), f))
+
+    return {
+        "wall": wall,
+        "rss_kb": rusage.ru_maxrss,
+        "timers": parse_timers(bench.cwd),
+        "arena": parse_arena(text),
+    }
+
+
+def parse_timers(cwd):
+    """Read the timers.<asm name> files written by -timestats."""
+    timers = {}
+    for path in glob.glob(os.path.join(cwd, "timers.*")):
+        with open(path) as f:
+            for line in f:
+                name, sep, value = line.rpartition(":")
+                if not sep:
+                    continue
+                name = name.strip()
+                try:
+                    timers[name] = timers.get(name, 0.0) + float(value)
+                except ValueError:
+                    pass
+    return timers
+
+
+def parse_arena(text):
+    """Return the arena statistics line of GenX_IR, if it printed one."""
+    for line in reversed(text.splitlines()):
+        fields = line.split("\t")
+        if len(fields) == len(ARENA_FIELDS) and all(
+                f.strip().isdigit() for f in fields):
+            return dict(zip(ARENA_FIELDS, (int(f) for f in fields)))
+    return None
+
+
+def summarize(runs):
+    """Median of the times over the runs; memory numbers are deterministic
+    up to allocator noise and use the maximum."""
+    result = {
+        "wall": statistics.median(r["wall"] for r in runs),
+        "rss_kb": max(r["rss_kb"] for r in runs),
+        "runs": len(runs),
+    }
+    names = sorted(set().union(*(r["timers"] for r in runs)))
+    if names:
+        result["timers"] = {
+            n: statistics.median(r["timers"].get(n, 0.0) for r in runs)
+            for n in names}
+    if runs[-1]["arena"] is not None:
+        result["arena"] = runs[-1]["arena"]
+    return result
+
+
+def collect_benchmarks(args, work_dir):
+    """Build the list of benchmarks, in the order they have to run."""
+    corpus = args.corpus
+    generated_dir = os.path.join(work_dir, "corpus")
+    gen_corpus.write_generated(generated_dir)
+    benches = []
+
+    if args.genx_ir:
+        genx = os.path.abspath(args.genx_ir)
+        common = ["-platform", args.platform, "-timestats"]
+        binaries = []
+        for src in gen_corpus.corpus_files(corpus, generated_dir,
+                                           "*.visaasm"):
+            stem = os.path.splitext(os.path.basename(src))[0]
+            platforms = kernel_platforms(src)
+            if args.platform not in platforms:
+                raise ToolError("%s: built for %s, not for -platform %s" % (
+                    src, " ".join(platforms) or "no platform",
+                    args.platform))
+            cwd = os.path.join(work_dir, "genx_ir", stem)
+            os.makedirs(cwd)
+            # Text input also writes the vISA binary (<stem>.isa) and, with
+            # -binary, the GEN binary (<stem>.dat). Both are benchmarked below.
+            benches.append(Benchmark(
+                "genx_ir.text." + stem,
+                [genx, os.path.abspath(src)] + common + ["-binary"],
+                cwd, produces=(stem + ".isa", stem + ".dat")))
+            binaries.append((stem, cwd))
+        for stem, text_cwd in binaries:
+            cwd = os.path.join(work_dir, "genx_ir_binary", stem)
+            os.makedirs(cwd)
+            benches.append(Benchmark(
+                "genx_ir.binary." + stem,
+                [genx, os.path.join(text_cwd, stem + ".isa")] + common,
+                cwd))
+        if args.iga:
+            iga = os.path.abspath(args.iga)
+            for stem, text_cwd in binaries:
+                cwd = os.path.join(work_dir, "iga_genx", stem)
+                os.makedirs(cwd)
+                benches.append(Benchmark(
+                    "iga.disasm.genx_ir." + stem,
+                    [iga, "-p=" + args.iga_platform, "-d", "-q",
+                     os.path.join(text_cwd, stem + ".dat"),
+                     "-o", stem + ".asm"],
+                    cwd))
+
+    if args.iga:
+        iga = os.path.abspath(args.iga)
+        for src in gen_corpus.corpus_files(
+                corpus, generated_dir, os.path.join("iga", "*.asm")):
+            # <name>.<platform>.asm
+            stem, platform = os.path.splitext(
+                os.path.splitext(os.path.basename(src))[0])
+            platform = platform[1:]
+            cwd = os.path.join(work_dir, "iga", stem)
+            os.makedirs(cwd)
+            # The assembled kernel is disassembled below, so that it always
+            # matches the iga64 under test.
+            benches.append(Benchmark(
+                "iga.asm." + stem,
+                [iga, "-p=" + platform, "-a", "-q", os.path.abspath(src),
+                 "-o", stem + ".krn"],
+                cwd, produces=(stem + ".krn",)))
+            benches.append(Benchmark(
+                "iga.disasm." + stem,
+                [iga, "-p=" + platform, "-d", "-q", stem + ".krn",
+                 "-o", stem + ".asm"],
+                cwd))
+
+    if args.filter:
+        benches = [b for b in benches
+                   if any(f in b.name for f in args.filter) or b.produces]
+    return benches
+
+
+def run_benchmarks(args, baseline):
+    work_dir = tempfile.mkdtemp(prefix="visa_bench_")
+    try:
+        results = {}
+        for bench in collect_benchmarks(args, work_dir):
+            runs = []
+            for _ in range(args.iterations):
+                runs.append(run_once(bench))
+            result = summarize(runs)
+            # A single slow median is often noise from the rest of the
+            # machine: take more runs before calling it a regression.
+            base = (baseline or {}).get(bench.name)
+            if base and args.confirm_runs and exceeds(
+                    result["wall"], base["wall"], args.time_threshold,
+                    args.time_slack):
+                print("%-40s %10.4fs, rerunning %d times" % (
+                    bench.name, result["wall"], args.confirm_runs))
+                for _ in range(args.confirm_runs):
+                    runs.append(run_once(bench))
+                result = summarize(runs)
+            results[bench.name] = result
+            print("%-40s %10.4fs %10d KB" % (
+                bench.name, result["wall"], result["rss_kb"]))
+        return results
+    finally:
+        if args.keep:
+            print("outputs kept in " + work_dir)
+        else:
+            shutil.rmtree(work_dir, ignore_errors=True)
+
+
+def exceeds(new, base, threshold, slack):
+    return new > base * (1.0 + threshold) and new - base > slack
+
+
+def compare(results, baseline, args):
+    """Compare the results against the baseline, return the regressions and
+    the notes to print."""
+    regressions = []
+    notes = []
+    for name, base in sorted(baseline.items()):
+        cur = results.get(name)
+        if cur is None:
+            if not args.filter or any(f in name for f in args.filter):
+                notes.append("%s: in the baseline but not run" % name)
+            continue
+        if exceeds(cur["wall"], base["wall"], args.time_threshold,
+                   args.time_slack):
+            regressions.append("%s: wall time %.4fs -> %.4fs (%+.1f%%)" % (
+                name, base["wall"], cur["wall"],
+                100.0 * (cur["wall"] / base["wall"] - 1.0)))
+            # point at the passes that account for the difference
+            base_timers = base.get("timers", {})
+            for timer, value in sorted(
+                    cur.get("timers", {}).items(),
+                    key=lambda t: base_timers.get(t[0], 0.0) - t[1]):
+                old = base_timers.get(timer, 0.0)
+                if exceeds(value, old, args.time_threshold, args.time_slack):
+                    notes.append("%s:   %s %.4fs -> %.4fs" % (
+                        name, timer, old, value))
+        if exceeds(cur["rss_kb"], base["rss_kb"], args.mem_threshold,
+                   args.mem_slack_kb):
+            regressions.append("%s: peak RSS %d KB -> %d KB (%+.1f%%)" % (
+                name, base["rss_kb"], cur["rss_kb"],
+                100.0 * (cur["rss_kb"] / base["rss_kb"] - 1.0)))
+        if "arena" in base and "arena" in cur:
+            for field in ("alloc_kb", "malloc_kb"):
+                old, new = base["arena"][field], cur["arena"][field]
+                if exceeds(new, old, args.mem_threshold, args.mem_slack_kb):
+                    regressions.append("%s: arena %s %d -> %d" % (
+                        name, field, old, new))
+    for name in sorted(set(results) - set(baseline)):
+        notes.append("%s: not in the baseline" % name)
+    return regressions, notes
+
+
+def parse_args(argv):
+    parser = argparse.ArgumentParser(
+        description="Compile-time benchmarks for GenX_IR and iga64.")
+    parser.add_argument("--genx-ir", metavar="PATH",
+                        help="GenX_IR executable; vISA benchmarks are "
+                             "skipped if not given")
+    parser.add_argument("--iga", metavar="PATH",
+                        help="iga64 executable; IGA benchmarks are skipped "
+                             "if not given")
+    parser.add_argument("--platform", default="DG2",
+                        help="GenX_IR -platform (default: %(default)s)")
+    parser.add_argument("--iga-platform", default="xehpg",
+                        help="iga64 platform of the GEN binaries produced "
+                             "for --platform (default: %(default)s)")
+    parser.add_argument("-n", "--iterations", type=int, default=5,
+                        help="runs per benchmark (default: %(default)s)")
+    parser.add_argument("--corpus", default=os.path.join(SCRIPT_DIR, "corpus"))
+    parser.add_argument("--baseline", default=DEFAULT_BASELINE,
+                        help="baseline file (default: %(default)s)")
+    parser.add_argument("--update-baseline", action="store_true",
+                        help="write the results to the baseline instead of "
+                             "comparing against it")
+    parser.add_argument("-o", "--output", metavar="FILE",
+                        help="also write the results to FILE")
+    parser.add_argument("--filter", action="append", metavar="SUBSTR",
+                        help="only run benchmarks whose name contains SUBSTR")
+    parser.add_argument("--time-threshold", type=float, default=0.10,
+                        help="relative wall time increase reported as a "
+                             "regression (default: %(default)s)")
+    parser.add_argument("--confirm-runs", type=int, default=10,
+                        help="extra runs of a benchmark whose median looks "
+                             "slower than the baseline, the median is then "
+                             "taken over all the runs (default: "
+                             "%(default)s)")
+    parser.add_argument("--time-slack", type=float, default=0.02,
+                        help="absolute wall time increase in seconds below "
+                             "which nothing is reported (default: "
+                             "%(default)s)")
+    parser.add_argument("--mem-threshold", type=float, default=0.05,
+                        help="relative peak RSS and arena increase reported "
+                             "as a regression (default: %(default)s)")
+    parser.add_argument("--mem-slack-kb", type=int, default=512,
+                        help="absolute memory increase in KB below which "
+                             "nothing is reported (default: %(default)s)")
+    parser.add_argument("--keep", action="store_true",
+                        help="keep the outputs of the tools")
+    args = parser.parse_args(argv)
+    if not args.genx_ir and not args.iga:
+        parser.error("nothing to run, give --genx-ir and/or --iga")
+    if args.iterations < 1:
+        parser.error("--iterations must be at least 1")
+    if args.confirm_runs < 0:
+        parser.error("--confirm-runs must not be negative")
+    return args
+
+
+def main(argv):
+    args = parse_args(argv)
+
+    baseline = None
+    if not args.update_baseline:
+        if not os.path.exists(args.baseline):
+            print("no baseline at %s, run with --update-baseline first"
+                  % args.baseline, file=sys.stderr)
+            return 2
+        with open(args.baseline) as f:
+            data = json.load(f)
+        if data.get("version") != RESULTS_VERSION:
+            print("%s: unsupported version" % args.baseline, file=sys.stderr)
+            return 2
+        baseline = data["benchmarks"]
+
+    try:
+        results = run_benchmarks(args, baseline)
+    except ToolError as e:
+        print(str(e), file=sys.stderr)
+        return 2
+
+    data = {
+        "version": RESULTS_VERSION,
+        "platform": args.platform,
+        "iga_platform": args.iga_platform,
+        "iterations": args.iterations,
+        "benchmarks": results,
+    }
+    outputs = [args.output] if args.output else []
+    if args.update_baseline:
+        if args.filter and os.path.exists(args.baseline):
+            # keep the entries that were not run
+            with open(args.baseline) as f:
+                old = json.load(f)
+            if old.get("version") == RESULTS_VERSION:
+                old["benchmarks"].update(results)
+                data["benchmarks"] = old["benchmarks"]
+        outputs.append(args.baseline)
+    for path in outputs:
+        os.makedirs(os.path.dirname(os.path.abspath(path)), exist_ok=True)
+        with open(path, "w") as f:
+            json.dump(data, f, indent=2, sort_keys=True)
+            f.write("\n")
+
+    if baseline is None:
+        return 0
+    regressions, notes = compare(results, baseline, args)
+    for note in notes:
+        print("note: " + note)
+    for regression in regressions:
+        print("REGRESSION: " + regression)
+    if regressions:
+        return 1
+    print("no regression against %s" % args.baseline)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -8,15 +8,46 @@ SPDX-License-Identifier: MIT
 
 #include "iga_main.hpp"
 
+#include "Frontend/JSON.hpp"
+
+#include <sstream>
+
+// -Xprint-cbor output assembles as the JSON it came from
+static bool convertCBORInput(const std::string &inpFile,
+                             const igax::Bits &cbor, std::string &inpText) {
+  std::stringstream ss;
+  std::string err;
+  if (!iga::CBORToJSON(cbor.data(), cbor.size(), ss, err)) {
+    std::cerr << inpFile << ": ";
+    emitRedText(std::cerr, "malformed CBOR input");
+    std::cerr << ": " << err << "\n";
+    return false;
+  }
+  inpText = ss.str();
+  return true;
+}
+
 bool assemble(const Opts &opts, igax::Context &ctx,
               const std::string &inpFile) {
   std::string inpText;
   if (inpFile == IGA_STDIN_FILENAME) {
     igax::Bits stdinBits = readBinaryStreamStdin();
-    stdinBits.push_back(0); // NUL
-    inpText = (const char *)stdinBits.data();
+    if (iga::LooksLikeCBORMap(stdinBits.data(), stdinBits.size())) {
+      if (!convertCBORInput(inpFile, stdinBits, inpText))
+        return false;
+    } else {
+      stdinBits.push_back(0); // NUL
+      inpText = (const char *)stdinBits.data();
+    }
   } else {
-    inpText = readTextFile(inpFile.c_str());
+    igax::Bits fileBits;
+    readBinaryFile(inpFile.c_str(), fileBits);
+    if (iga::LooksLikeCBORMap(fileBits.data(), fileBits.size())) {
+      if (!convertCBORInput(inpFile, fileBits, inpText))
+        return false;
+    } else {
+      inpText = readTextFile(inpFile.c_str());
+    }
   }
 
   igax::Bits bits;
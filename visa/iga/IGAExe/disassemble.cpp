@@ -8,6 +8,8 @@ SPDX-License-Identifier: MIT
 
 #include "iga_main.hpp"
 
+#include "Frontend/JSON.hpp"
+
 bool disassemble(const Opts &opts, igax::Context &ctx,
                  const std::string &inpFile) {
   std::vector<unsigned char> inp;
@@ -26,7 +28,18 @@ bool disassemble(const Opts &opts, igax::Context &ctx,
     for (auto &w : r.warnings) {
       emitWarningToStderr(w, inp);
     }
-    writeText(opts, r.value);
+    if (opts.printCbor) {
+      std::vector<uint8_t> cbor;
+      try {
+        iga::JSONToCBOR(r.value.c_str(), r.value.size(), cbor);
+      } catch (const iga::SyntaxError &e) {
+        fatalExitWithMessage("-Xprint-cbor: JSON output is malformed (",
+                             e.message, ")");
+      }
+      writeBinary(opts, cbor.data(), cbor.size());
+    } else {
+      writeText(opts, r.value);
+    }
     return true;
   } catch (const igax::DisassembleError &err) {
     // some error where we can report several potentially
@@ -8,6 +8,7 @@ SPDX-License-Identifier: MIT
 
 #include "iga_main.hpp"
 #include "opts.hpp"
+#include "parallel.hpp"
 
 #include <iomanip>
 #include <sstream>
@@ -382,6 +383,12 @@ extern "C" int iga_main(int argc, const char **argv) {
                   "prints bits decoded with each instruction",
                   "The instruction bits are emitted with each instruction",
                   opts::OptAttrs::ALLOW_UNSET, baseOpts.printBits);
+  xGrp.defineFlag("print-cbor", nullptr,
+                  "prints output as CBOR (binary JSON)",
+                  "Emits the -Xprint-json output in CBOR (RFC 8949) form; "
+                  "this is smaller and faster to load.  "
+                  "Assembling accepts either form.",
+                  opts::OptAttrs::ALLOW_UNSET, baseOpts.printCbor);
   xGrp.defineFlag("print-defs", nullptr,
                   "prints dependency definitions from each instruction",
                   "The analysis may be coarse.", opts::OptAttrs::ALLOW_UNSET,
@@ -392,7 +399,8 @@ extern "C" int iga_main(int argc, const char **argv) {
                   "instruction modifies.",
                   opts::OptAttrs::ALLOW_UNSET, baseOpts.printDeps);
   xGrp.defineFlag("print-json", nullptr, "prints output in JSON format",
-                  "Emits a JSON format with the assembly (c.f. JSONFormat.md)",
+                  "Emits a JSON format with the assembly (c.f. IGAJSON.md); "
+                  "assembling accepts this format as input",
                   opts::OptAttrs::ALLOW_UNSET, baseOpts.printJson);
   xGrp.defineFlag("print-ldst", nullptr,
                   "enables load/store pseudo instructions where possible",
@@ -406,6 +414,21 @@ extern "C" int iga_main(int argc, const char **argv) {
         std::string str = cinp;
         baseOpts.sbidCount = eh.parseInt(cinp);
       });
+  xGrp.defineOpt(
+      "threads", nullptr, "INT",
+      "the number of threads to disassemble large kernels with",
+      "Large kernels are decoded and formatted on up to 16 threads; "
+      "1 makes everything run on the calling thread and 0 (the default) "
+      "uses as many as the machine has.  This overrides the IGA_THREADS "
+      "environment variable.",
+      opts::OptAttrs::ALLOW_UNSET,
+      [](const char *cinp, const opts::ErrorHandler &eh, Opts &baseOpts) {
+        if (cinp == nullptr)
+          return;
+        baseOpts.threads = eh.parseInt(cinp);
+        if (baseOpts.threads < 0)
+          eh.fail("must not be negative");
+      });
   xGrp.defineFlag(
       "warn-on-compact-fail", nullptr,
       "makes compaction failure a warning instead of an error",
@@ -429,6 +452,8 @@ extern "C" int iga_main(int argc, const char **argv) {
       });
 
   cmdline.parse(argc, argv, baseOpts);
+  if (baseOpts.threads >= 0)
+    iga::SetParallelMaxThreads((unsigned)baseOpts.threads);
 
   // override various options not set
   auto optsForFile = [&](const std::string &inpFile) {
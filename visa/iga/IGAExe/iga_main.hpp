@@ -58,12 +58,14 @@ struct Opts {
   bool useNativeEncoder = false;                   // -Xnative
   bool forceNoCompact = false;                     // -Xforce-no-compact
   uint32_t pcOffset = 0; // pcOffset provided with -Xset-pc-base
+  int threads = -1;      // -Xthreads (-1 keeps IGA_THREADS)
 
   bool printBits = false;          // -Xprint-bits
   bool printDefs = false;          // -Xprint-defs
   bool printDeps = false;          // -Xprint-deps
   bool printHexFloats = false;     // -Xprint-hex-floats
   bool printJson = false;          // -Xprint-json
+  bool printCbor = false;          // -Xprint-cbor
   bool printBfnExprs = true;       // -Xprint-bfnexprs
   bool printLdSt = false;          // -Xprint-ldst
   bool printInstructionPc = false; // -Xprint-pc
@@ -254,7 +256,9 @@ static inline uint32_t makeFormattingOpts(const Opts &opts) {
                   (opts.color == Opts::Color::AUTO && opts.outputFile.empty() &&
                    iga::IsTty(std::cout));
   setOptBit(fmtOpts, IGA_FORMATTING_OPT_PRINT_ANSI, useColor);
-  setOptBit(fmtOpts, IGA_FORMATTING_OPT_PRINT_JSON, opts.printJson);
+  // CBOR is converted from the JSON output
+  setOptBit(fmtOpts, IGA_FORMATTING_OPT_PRINT_JSON,
+            opts.printJson || opts.printCbor);
 
   return fmtOpts;
 }
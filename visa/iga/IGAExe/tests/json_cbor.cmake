@@ -0,0 +1,126 @@
+#=========================== begin_copyright_notice ============================
+#
+# Copyright (C) 2022 Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+#
+#============================ end_copyright_notice =============================
+
+# Checks that -Xprint-json and -Xprint-cbor output assembles back to the
+# same bits, and that malformed JSON and CBOR input fails with a diagnostic
+# instead of crashing.
+#
+#   cmake -DIGA_EXE=<iga64> -DWORK_DIR=<dir> -P json_cbor.cmake
+
+if(NOT IGA_EXE OR NOT WORK_DIR)
+  message(FATAL_ERROR "IGA_EXE and WORK_DIR must be set")
+endif()
+file(MAKE_DIRECTORY "${WORK_DIR}")
+
+# runs iga and sets status and err in the caller
+macro(run_iga)
+  execute_process(COMMAND "${IGA_EXE}" -p=XeHP ${ARGN}
+                  RESULT_VARIABLE status ERROR_VARIABLE err
+                  OUTPUT_QUIET)
+endmacro()
+
+macro(expect_success)
+  run_iga(${ARGN})
+  if(NOT status EQUAL 0)
+    message(FATAL_ERROR "iga ${ARGN} failed (${status}):\n${err}")
+  endif()
+endmacro()
+
+# the input must be rejected with a message containing expected; a crash
+# shows up as a status other than 1
+function(expect_failure name expected)
+  run_iga(-a "${WORK_DIR}/${name}" -o "${WORK_DIR}/${name}.krn")
+  if(NOT status EQUAL 1)
+    message(FATAL_ERROR "${name}: expected exit status 1, got ${status}\n${err}")
+  endif()
+  string(FIND "${err}" "${expected}" at)
+  if(at EQUAL -1)
+    message(FATAL_ERROR "${name}: expected \"${expected}\" in:\n${err}")
+  endif()
+endfunction()
+
+function(expect_same_file a b)
+  execute_process(COMMAND "${CMAKE_COMMAND}" -E compare_files
+                          "${WORK_DIR}/${a}" "${WORK_DIR}/${b}"
+                  RESULT_VARIABLE diff)
+  if(NOT diff EQUAL 0)
+    message(FATAL_ERROR "${b} differs from ${a}")
+  endif()
+endfunction()
+
+###############################################################################
+# round trips
+file(WRITE "${WORK_DIR}/kernel.asm"
+"mov (8|M0)  r1.0<1>:d  r2.0<1;1,0>:d
+LOOP:
+add (16|M0)  r3.0<1>:f  -r4.0<1;1,0>:f  1.5:f
+mov (8|M0)  r5.0<1>:d  -7:d
+(W&f0.0) jmpi  LOOP
+(W) mov (1|M0)  r6.0<1>:ud  0x12345678:ud
+nop
+")
+expect_success(-a "${WORK_DIR}/kernel.asm" -o "${WORK_DIR}/kernel.krn")
+foreach(form json cbor)
+  expect_success(-d "${WORK_DIR}/kernel.krn" -Xprint-${form}
+                 -o "${WORK_DIR}/kernel.${form}")
+  expect_success(-a "${WORK_DIR}/kernel.${form}"
+                 -o "${WORK_DIR}/kernel.${form}.krn")
+  expect_same_file(kernel.krn kernel.${form}.krn)
+endforeach()
+
+###############################################################################
+# malformed JSON
+file(READ "${WORK_DIR}/kernel.json" json)
+string(LENGTH "${json}" jsonLen)
+math(EXPR half "${jsonLen} / 2")
+string(SUBSTRING "${json}" 0 ${half} truncated)
+file(WRITE "${WORK_DIR}/truncated.json" "${truncated}")
+expect_failure(truncated.json "error")
+
+file(WRITE "${WORK_DIR}/trailing.json" "${json} {}")
+expect_failure(trailing.json "unexpected text after JSON")
+
+string(REPEAT "[" 100000 brackets)
+file(WRITE "${WORK_DIR}/deep.json"
+     "{\"version\":\"1.1\",\"platform\":\"xehp\",\"insts\":${brackets}")
+expect_failure(deep.json "too deep")
+
+###############################################################################
+# malformed CBOR; all of these start {"k": (a one entry map)
+string(ASCII 161 97 107 mapK)
+
+# 4M tags on a missing item: tags must not recurse
+string(ASCII 198 tag)
+string(REPEAT "${tag}" 4194304 tags)
+file(WRITE "${WORK_DIR}/tags.cbor" "${mapK}${tags}")
+expect_failure(tags.cbor "truncated data item")
+
+# nested one element arrays ending in null
+string(ASCII 129 array1)
+string(ASCII 246 null)
+string(REPEAT "${array1}" 100000 arrays)
+file(WRITE "${WORK_DIR}/deep.cbor" "${mapK}${arrays}${null}")
+expect_failure(deep.cbor "nesting is too deep")
+
+# a 5 character text string with only 1 character
+string(ASCII 101 107 text5)
+file(WRITE "${WORK_DIR}/truncated.cbor" "${mapK}${text5}")
+expect_failure(truncated.cbor "truncated string")
+
+# a byte string
+string(ASCII 65 120 bytes1)
+file(WRITE "${WORK_DIR}/bytes.cbor" "${mapK}${bytes1}")
+expect_failure(bytes.cbor "byte strings have no JSON form")
+
+# tagged null is fine as CBOR (it then fails as a kernel)
+file(WRITE "${WORK_DIR}/tagged.cbor" "${mapK}${tag}${tag}${null}")
+run_iga(-a "${WORK_DIR}/tagged.cbor" -o "${WORK_DIR}/tagged.cbor.krn")
+string(FIND "${err}" "malformed CBOR input" at)
+if(NOT at EQUAL -1)
+  message(FATAL_ERROR "tagged.cbor: rejected as CBOR:\n${err}")
+endif()
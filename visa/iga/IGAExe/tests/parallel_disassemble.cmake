@@ -0,0 +1,72 @@
+#=========================== begin_copyright_notice ============================
+#
+# Copyright (C) 2022 Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+#
+#============================ end_copyright_notice =============================
+
+# Checks that a kernel large enough to be decoded and formatted on several
+# threads disassembles to the same text as with -Xthreads=1.
+#
+#   cmake -DIGA_EXE=<iga64> -DWORK_DIR=<dir> -P parallel_disassemble.cmake
+
+if(NOT IGA_EXE OR NOT WORK_DIR)
+  message(FATAL_ERROR "IGA_EXE and WORK_DIR must be set")
+endif()
+file(MAKE_DIRECTORY "${WORK_DIR}")
+
+# 100 blocks of 100 instructions, well over the 4096 instructions at which
+# the decoder and formatter go parallel; the jumps make the labels of one
+# thread's part refer to blocks in the others, and auto-compaction mixes
+# compacted and full instructions.
+set(asm "")
+foreach(b RANGE 0 99)
+  math(EXPR next "(${b} + 1) % 100")
+  string(APPEND asm "BLOCK_${b}:\n")
+  foreach(i RANGE 0 97)
+    math(EXPR dst "${i} % 64 + 1")
+    math(EXPR src "(${i} + ${b}) % 64 + 64")
+    if(i EQUAL 0)
+      string(APPEND asm
+        "mov (8|M0)  r${dst}.0<1>:d  r${src}.0<1;1,0>:d\n")
+    else()
+      string(APPEND asm
+        "add (16|M0)  r${dst}.0<1>:f  r${src}.0<1;1,0>:f  ${b}.${i}:f\n")
+    endif()
+  endforeach()
+  string(APPEND asm "(f0.0) jmpi  BLOCK_${next}\n")
+endforeach()
+string(APPEND asm "nop\n")
+file(WRITE "${WORK_DIR}/large.asm" "${asm}")
+
+function(run_iga)
+  execute_process(COMMAND "${IGA_EXE}" -p=XeHP ${ARGN}
+                  RESULT_VARIABLE status ERROR_VARIABLE err)
+  if(NOT status EQUAL 0)
+    message(FATAL_ERROR "iga ${ARGN} failed (${status}):\n${err}")
+  endif()
+endfunction()
+
+run_iga(-a "${WORK_DIR}/large.asm" -Xautocompact -o "${WORK_DIR}/large.krn")
+foreach(threads 1 4)
+  run_iga(-d "${WORK_DIR}/large.krn" -Xthreads=${threads}
+          -o "${WORK_DIR}/large.${threads}.asm")
+endforeach()
+# and the environment variable does the same as the option
+set(ENV{IGA_THREADS} 4)
+run_iga(-d "${WORK_DIR}/large.krn" -o "${WORK_DIR}/large.env.asm")
+unset(ENV{IGA_THREADS})
+
+foreach(other 4 env)
+  file(READ "${WORK_DIR}/large.1.asm" expected)
+  file(READ "${WORK_DIR}/large.${other}.asm" actual)
+  if(NOT expected STREQUAL actual)
+    message(FATAL_ERROR "large.${other}.asm differs from large.1.asm")
+  endif()
+endforeach()
+string(REGEX MATCHALL "\n" lines "${expected}")
+list(LENGTH lines numLines)
+if(numLines LESS 10000)
+  message(FATAL_ERROR "large.1.asm has only ${numLines} lines")
+endif()
@@ -0,0 +1,160 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "CompactionCache.hpp"
+#include "../version.hpp"
+
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace iga;
+
+// "IGACC" plus a format version
+static const char CACHE_MAGIC[8] = {'I', 'G', 'A', 'C', 'C', 0, 0, 3};
+
+// defined by the GED build (GEDLibrary version.cpp)
+extern const char *gedVersion;
+
+#ifndef GED_COMPACTION_TABLES_HASH
+// set by IGALibrary/CMakeLists.txt from ged_compaction_tables.cpp
+#define GED_COMPACTION_TABLES_HASH ""
+#endif
+
+// A compaction table fix in GED changes the compacted bits of a native
+// encoding, so a cache is only valid for the GED that wrote it: the build
+// id names the IGA version, the GED version and the hash of the GED
+// compaction tables.
+static std::string cacheBuildId() {
+  return std::string(IGA_VERSION_PREFIX_STRING IGA_VERSION_SUFFIX " GED ") +
+         gedVersion + " " GED_COMPACTION_TABLES_HASH;
+}
+
+// 64-bit FNV-1a
+static uint64_t checksum(const uint8_t *data, size_t size) {
+  uint64_t h = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < size; i++) {
+    h ^= data[i];
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
+
+CompactionCache::Key CompactionCache::makeKey(const uint8_t *native) {
+  Key k;
+  std::memcpy(&k.qw0, native, sizeof(k.qw0));
+  std::memcpy(&k.qw1, native + 8, sizeof(k.qw1));
+  return k;
+}
+
+const CompactionCache::Entry *
+CompactionCache::find(const uint8_t *native) const {
+  auto it = m_entries.find(makeKey(native));
+  if (it == m_entries.end()) {
+    m_misses++;
+    return nullptr;
+  }
+  m_hits++;
+  return &it->second;
+}
+
+void CompactionCache::insert(const uint8_t *native, bool compacted,
+                             const uint8_t *compact) {
+  Entry e{compacted, 0};
+  if (compacted)
+    std::memcpy(&e.bits, compact, sizeof(e.bits));
+  m_entries[makeKey(native)] = e;
+}
+
+// magic, build id (length and characters), platform, entry count,
+// then per entry: the two native qwords, the compacted flag and the
+// compacted qword, and last the checksum of all of the above (all in host
+// byte order)
+void CompactionCache::save(std::ostream &os) const {
+  std::vector<uint8_t> buf;
+  auto put = [&](const void *p, size_t n) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(p);
+    buf.insert(buf.end(), bytes, bytes + n);
+  };
+  put(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+  const std::string buildId = cacheBuildId();
+  uint32_t buildIdLen = static_cast<uint32_t>(buildId.size());
+  put(&buildIdLen, sizeof(buildIdLen));
+  put(buildId.data(), buildIdLen);
+  uint32_t platform = static_cast<uint32_t>(m_platform);
+  put(&platform, sizeof(platform));
+  uint64_t count = m_entries.size();
+  put(&count, sizeof(count));
+  for (const auto &e : m_entries) {
+    put(&e.first.qw0, sizeof(e.first.qw0));
+    put(&e.first.qw1, sizeof(e.first.qw1));
+    uint8_t compacted = e.second.compacted ? 1 : 0;
+    put(&compacted, sizeof(compacted));
+    put(&e.second.bits, sizeof(e.second.bits));
+  }
+  uint64_t sum = checksum(buf.data(), buf.size());
+  put(&sum, sizeof(sum));
+  os.write(reinterpret_cast<const char *>(buf.data()), buf.size());
+}
+
+bool CompactionCache::load(std::istream &is) {
+  std::vector<uint8_t> buf((std::istreambuf_iterator<char>(is)),
+                           std::istreambuf_iterator<char>());
+  uint64_t sum = 0;
+  if (buf.size() < sizeof(sum))
+    return false;
+  size_t end = buf.size() - sizeof(sum);
+  std::memcpy(&sum, buf.data() + end, sizeof(sum));
+  if (sum != checksum(buf.data(), end))
+    return false;
+
+  size_t pos = 0;
+  auto get = [&](void *p, size_t n) {
+    if (end - pos < n)
+      return false;
+    std::memcpy(p, buf.data() + pos, n);
+    pos += n;
+    return true;
+  };
+  char magic[sizeof(CACHE_MAGIC)];
+  const std::string buildId = cacheBuildId();
+  uint32_t buildIdLen = 0;
+  std::string fileBuildId(buildId.size(), '\0');
+  uint32_t platform = 0;
+  uint64_t count = 0;
+  if (!get(magic, sizeof(magic)) ||
+      std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0 ||
+      !get(&buildIdLen, sizeof(buildIdLen)) || buildIdLen != buildId.size() ||
+      !get(&fileBuildId[0], fileBuildId.size()) ||
+      fileBuildId != buildId ||
+      !get(&platform, sizeof(platform)) ||
+      platform != static_cast<uint32_t>(m_platform) ||
+      !get(&count, sizeof(count))) {
+    return false;
+  }
+
+  std::vector<std::pair<Key, Entry>> entries;
+  for (uint64_t i = 0; i < count; i++) {
+    Key k;
+    uint8_t compacted = 0;
+    Entry e{false, 0};
+    if (!get(&k.qw0, sizeof(k.qw0)) || !get(&k.qw1, sizeof(k.qw1)) ||
+        !get(&compacted, sizeof(compacted)) || compacted > 1 ||
+        !get(&e.bits, sizeof(e.bits))) {
+      return false;
+    }
+    e.compacted = compacted != 0;
+    entries.emplace_back(k, e);
+  }
+  if (pos != end)
+    return false;
+  for (const auto &e : entries)
+    m_entries[e.first] = e.second;
+  return true;
+}
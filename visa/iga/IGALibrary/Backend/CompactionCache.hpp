@@ -0,0 +1,76 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#ifndef IGA_BACKEND_COMPACTION_CACHE_HPP
+#define IGA_BACKEND_COMPACTION_CACHE_HPP
+
+#include "../IR/Types.hpp"
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <unordered_map>
+
+namespace iga {
+// Memoizes instruction compaction for one platform: maps a native
+// (uncompacted) encoding to its compacted form, or to the fact that it has
+// none. Kernels repeat the same encodings many times (movs, sync.nops,
+// sends), so all but the first of them skip the compaction table search.
+//
+// The key is the whole native encoding; the compacted form copies fields
+// verbatim from it (registers, immediates), so there is nothing that can be
+// masked out without knowing the platform's compaction layout.
+//
+// A cache may be shared by the encodes of one compile, but not by
+// concurrent ones.
+class CompactionCache {
+public:
+  struct Entry {
+    bool compacted;
+    uint64_t bits; // valid if compacted
+  };
+
+  CompactionCache(Platform p) : m_platform(p) {}
+
+  Platform getPlatform() const { return m_platform; }
+
+  // returns nullptr on a miss
+  const Entry *find(const uint8_t *native) const;
+  void insert(const uint8_t *native, bool compacted, const uint8_t *compact);
+
+  size_t size() const { return m_entries.size(); }
+  uint64_t getHits() const { return m_hits; }
+  uint64_t getMisses() const { return m_misses; }
+
+  // The persisted form is tagged with the platform, the IGA and GED
+  // versions and the hash of the GED compaction tables it was made with, and
+  // ends with a checksum. Loading a cache of another platform or build, or
+  // a truncated or corrupt one, fails and leaves this cache unchanged.
+  void save(std::ostream &os) const;
+  bool load(std::istream &is);
+
+private:
+  struct Key {
+    uint64_t qw0, qw1;
+    bool operator==(const Key &k) const { return qw0 == k.qw0 && qw1 == k.qw1; }
+  };
+  struct KeyHash {
+    size_t operator()(const Key &k) const {
+      return std::hash<uint64_t>()(k.qw0 * 0x9E3779B97F4A7C15ull ^ k.qw1);
+    }
+  };
+  static Key makeKey(const uint8_t *native);
+
+  const Platform m_platform;
+  std::unordered_map<Key, Entry, KeyHash> m_entries;
+  mutable uint64_t m_hits = 0;
+  mutable uint64_t m_misses = 0;
+};
+} // namespace iga
+
+#endif // IGA_BACKEND_COMPACTION_CACHE_HPP
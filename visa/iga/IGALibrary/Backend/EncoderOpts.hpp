@@ -12,6 +12,8 @@ SPDX-License-Identifier: MIT
 #include "../api/iga_types_swsb.hpp"
 
 namespace iga {
+class CompactionCache;
+
 struct EncoderOpts {
   bool autoCompact = false;
   bool explicitCompactMissIsWarning = false;
@@ -23,6 +25,9 @@ struct EncoderOpts {
   SWSB_ENCODE_MODE swsbEncodeMode = SWSB_ENCODE_MODE::SWSBInvalidMode;
   // Specify number of sbid that can be used
   uint32_t sbidCount = 16;
+  // If set, compaction results are looked up in and added to this cache;
+  // it must be for the platform being encoded. Not owned.
+  CompactionCache *compactionCache = nullptr;
 
   EncoderOpts(bool _autoCompact = false,
               bool _explicitCompactMissIsWarning = false,
@@ -14,6 +14,7 @@ SPDX-License-Identifier: MIT
 #include "../../IR/SWSBSetter.hpp"
 #include "../../MemManager/MemManager.hpp"
 #include "../../asserts.hpp"
+#include "../../parallel.hpp"
 #include "../../strings.hpp"
 #include "GEDToIGATranslation.hpp"
 #include "IGAToGEDTranslation.hpp"
@@ -272,14 +273,115 @@ const OpSpec *Decoder::decodeOpSpec(Op op) {
   return os;
 }
 
+// Kernels are split across threads only if each thread gets at least this
+// many instructions; below that the threads cost more than they save.
+static const size_t MIN_PARALLEL_DECODE_INSTS = 4096;
+
 // Pass 1. decode all instructions in Instruction*
 void Decoder::decodeInstructions(Kernel &kernel, const void *binaryStart,
                                  size_t binarySize, InstList &insts) {
-  restart();
-  uint32_t nextId = 1;
+  m_binary = binaryStart;
+
+  // The compaction control bit gives the length of each instruction, so
+  // the boundaries can be found without decoding anything.
   const unsigned char *binary = (const unsigned char *)binaryStart;
+  auto instLength = [&](size_t pc) {
+    uint32_t dw0;
+    std::memcpy(&dw0, binary + pc, sizeof(dw0));
+    return ((dw0 >> COMPACTION_CONTROL) & 1) ? COMPACTED_SIZE
+                                             : UNCOMPACTED_SIZE;
+  };
+  size_t numInsts = 0;
+  for (size_t pc = 0; pc + 4 <= binarySize;) {
+    size_t iLen = (size_t)instLength(pc);
+    if (pc + iLen > binarySize)
+      break;
+    pc += iLen;
+    numInsts++;
+  }
+
+  unsigned threads =
+      ParallelThreadCount(numInsts, MIN_PARALLEL_DECODE_INSTS);
+  if (threads <= 1) {
+    decodeInstructionRange(kernel, 0, (int32_t)binarySize, 1, insts);
+    return;
+  }
+
+  // chunks of roughly equal instruction counts, as (start PC, first
+  // instruction ID); the last one also gets any trailing padding so it is
+  // diagnosed as before
+  std::vector<std::pair<int32_t, uint32_t>> chunkStarts;
+  size_t instsPerChunk = (numInsts + threads - 1) / threads;
+  size_t pc = 0;
+  for (size_t instIx = 0; instIx < numInsts; instIx++) {
+    if (instIx % instsPerChunk == 0)
+      chunkStarts.emplace_back((int32_t)pc, (uint32_t)instIx + 1);
+    pc += (size_t)instLength(pc);
+  }
+  decodeInstructionsParallel(kernel, binarySize, chunkStarts, insts);
+}
+
+// Decodes each chunk with its own Decoder, Kernel (for the memory) and
+// ErrorHandler, then concatenates the results in order; branch targets
+// are still numeric and get resolved to blocks afterwards in pass 2.
+void Decoder::decodeInstructionsParallel(
+    Kernel &kernel, size_t binarySize,
+    const std::vector<std::pair<int32_t, uint32_t>> &chunkStarts,
+    InstList &insts) {
+  struct Chunk {
+    int32_t startPc = 0, endPc = 0;
+    uint32_t firstId = 1;
+    Kernel *kernel = nullptr;
+    ErrorHandler errors;
+    InstList insts;
+    bool fatal = false;
+  };
+  std::vector<Chunk> chunks(chunkStarts.size());
+  for (size_t i = 0; i < chunks.size(); i++) {
+    Chunk &c = chunks[i];
+    c.startPc = chunkStarts[i].first;
+    c.endPc = i + 1 < chunks.size() ? chunkStarts[i + 1].first
+                                    : (int32_t)binarySize;
+    c.firstId = chunkStarts[i].second;
+    c.kernel = new Kernel(m_model);
+    kernel.adoptMemory(c.kernel);
+  }
+
+  ParallelFor((unsigned)chunks.size(), [&](unsigned i) {
+    Chunk &c = chunks[i];
+    Decoder decoder(m_model, c.errors);
+    decoder.m_SWSBEncodeMode = m_SWSBEncodeMode;
+    decoder.m_binary = m_binary;
+    try {
+      decoder.decodeInstructionRange(*c.kernel, c.startPc, c.endPc, c.firstId,
+                                     c.insts);
+    } catch (const FatalError &) {
+      // error is already logged
+      c.fatal = true;
+    }
+  });
+
+  // a sequential decode would stop at the first fatal error
+  for (Chunk &c : chunks) {
+    errorHandler().append(c.errors);
+    if (c.fatal) {
+      throw FatalError();
+    }
+    for (Instruction *inst : c.insts) {
+      insts.push_back(inst);
+    }
+  }
+}
 
-  int32_t bytesLeft = (int32_t)binarySize;
+void Decoder::decodeInstructionRange(Kernel &kernel, int32_t startPc,
+                                     int32_t endPc, uint32_t firstId,
+                                     InstList &insts) {
+  restart();
+  setPc(startPc);
+  uint32_t nextId = firstId;
+  const unsigned char *binary = (const unsigned char *)m_binary + startPc;
+
+  int32_t bytesLeft = endPc - startPc;
   while (bytesLeft > 0) {
     // need at least 4 bytes to check compaction control
     if (bytesLeft < 4) {
@@ -293,52 +395,7 @@ void Decoder::decodeInstructions(Kernel &kernel, const void *binaryStart,
       warningT("unexpected padding at end of kernel");
       break;
     }
-    memset(&m_currGedInst, 0, sizeof(m_currGedInst));
-    GED_RETURN_VALUE status =
-        GED_DecodeIns(m_gedModel, binary, (uint32_t)binarySize, &m_currGedInst);
-    Instruction *inst = nullptr;
-    if (status == GED_RETURN_VALUE_NO_COMPACT_FORM) {
-      errorT("error decoding instruction (no compacted form)");
-      inst =
-          createErrorInstruction(kernel, "unable to decompact", binary, iLen);
-      // fall through: GED can sort of decode some things here
-    } else if (status != GED_RETURN_VALUE_SUCCESS) {
-      errorT("error decoding instruction");
-      inst = createErrorInstruction(kernel, "GED error decoding instruction",
-                                    binary, iLen);
-    } else {
-      const auto gedOp = GED_GetOpcode(&m_currGedInst);
-      const Op op = translate(gedOp);
-      m_opSpec = decodeOpSpec(op);
-      if (!m_opSpec->isValid()) {
-        // figure out if we failed to resolve the primary op
-        // or if it's an unmapped subfunction (e.g. math function)
-        auto os = m_model.lookupOpSpec(op);
-        std::stringstream ss;
-        ss << "GED_OPCODE 0x" << iga::hex((unsigned)op, 2)
-           << ": unsupported opcode on this platform";
-        std::string str = ss.str();
-        errorT(str);
-        inst = createErrorInstruction(kernel, str.c_str(), binary, iLen);
-      } else {
-        bool validSf = false;
-        m_subfunc = decodeSubfunction(validSf);
-        if (validSf) {
-          try {
-            inst = decodeNextInstruction(kernel);
-          } catch (const FatalError &) {
-            // error is already logged
-            inst = createErrorInstruction(
-                kernel, errorHandler().getErrors().back().message.c_str(),
-                binary, iLen);
-          }
-        } else {
-          // error is already logged
-          inst = createErrorInstruction(kernel, "invalid subfunction", binary,
-                                        iLen);
-        }
-      }
-    }
+    Instruction *inst = decodeInstruction(kernel, binary, bytesLeft, iLen);
     inst->setPC(currentPc());
     inst->setID(nextId++);
     inst->setLoc(currentPc());
@@ -355,6 +412,82 @@ void Decoder::decodeInstructions(Kernel &kernel, const void *binaryStart,
   }
 }
 
+// Decodes the instruction of iLen bytes at binary (and currentPc()) into
+// kernel; decode errors yield an illegal instruction carrying the message
+Instruction *Decoder::decodeInstruction(Kernel &kernel,
+                                        const unsigned char *binary,
+                                        int32_t bytesLeft, int32_t iLen) {
+  memset(&m_currGedInst, 0, sizeof(m_currGedInst));
+  GED_RETURN_VALUE status =
+      GED_DecodeIns(m_gedModel, binary, (uint32_t)bytesLeft, &m_currGedInst);
+  Instruction *inst = nullptr;
+  if (status == GED_RETURN_VALUE_NO_COMPACT_FORM) {
+    errorT("error decoding instruction (no compacted form)");
+    inst =
+        createErrorInstruction(kernel, "unable to decompact", binary, iLen);
+    // fall through: GED can sort of decode some things here
+  } else if (status != GED_RETURN_VALUE_SUCCESS) {
+    errorT("error decoding instruction");
+    inst = createErrorInstruction(kernel, "GED error decoding instruction",
+                                  binary, iLen);
+  } else {
+    const auto gedOp = GED_GetOpcode(&m_currGedInst);
+    const Op op = translate(gedOp);
+    m_opSpec = decodeOpSpec(op);
+    if (!m_opSpec->isValid()) {
+      // figure out if we failed to resolve the primary op
+      // or if it's an unmapped subfunction (e.g. math function)
+      auto os = m_model.lookupOpSpec(op);
+      std::stringstream ss;
+      ss << "GED_OPCODE 0x" << iga::hex((unsigned)op, 2)
+         << ": unsupported opcode on this platform";
+      std::string str = ss.str();
+      errorT(str);
+      inst = createErrorInstruction(kernel, str.c_str(), binary, iLen);
+    } else {
+      bool validSf = false;
+      m_subfunc = decodeSubfunction(validSf);
+      if (validSf) {
+        try {
+          inst = decodeNextInstruction(kernel);
+        } catch (const FatalError &) {
+          // error is already logged
+          inst = createErrorInstruction(
+              kernel, errorHandler().getErrors().back().message.c_str(),
+              binary, iLen);
+        }
+      } else {
+        // error is already logged
+        inst = createErrorInstruction(kernel, "invalid subfunction", binary,
+                                      iLen);
+      }
+    }
+  }
+  return inst;
+}
+
+Instruction *Decoder::decodeInstructionAt(Kernel &kernel, const void *binary,
+                                          size_t binarySize, int32_t pc) {
+  m_binary = binary;
+  restart();
+  setPc(pc);
+  int32_t bytesLeft = (int32_t)binarySize - pc;
+  if (pc < 0 || bytesLeft < 4) {
+    return nullptr;
+  }
+  int32_t iLen = getBitField(COMPACTION_CONTROL, 1) != 0 ? COMPACTED_SIZE
+                                                         : UNCOMPACTED_SIZE;
+  if (bytesLeft < iLen) {
+    return nullptr;
+  }
+  Instruction *inst = decodeInstruction(
+      kernel, (const unsigned char *)binary + pc, bytesLeft, iLen);
+  inst->setPC(pc);
+  inst->setID(1);
+  inst->setLoc(pc);
+  return inst;
+}
+
 void Decoder::decodeNextInstructionEpilog(Instruction *inst) {
   decodeSWSB(inst);
 }
@@ -13,6 +13,8 @@ SPDX-License-Identifier: MIT
 #include "GEDToIGATranslation.hpp"
 #include "ged.h"
 
+#include <vector>
+
 #define GED_DECODE_TO(FIELD, TRANS, DST)                                       \
   do {                                                                         \
     GED_RETURN_VALUE _status;                                                  \
@@ -115,6 +117,12 @@ public:
 
   bool isMacro() const;
 
+  // Decodes the instruction at pc into kernel without adding it to a block
+  // (branch targets are left numeric). Returns nullptr if there are too few
+  // bytes left at pc for an instruction.
+  Instruction *decodeInstructionAt(Kernel &kernel, const void *binary,
+                                   size_t binarySize, int32_t pc);
+
 private:
   Kernel *decodeKernel(const void *binary, size_t binarySize,
                        bool numericLabels);
@@ -122,7 +130,16 @@ private:
   // pass 1 decodes instructions with numeric labels
   void decodeInstructions(Kernel &kernel, const void *binary, size_t binarySize,
                           InstList &insts);
+  // decodes [startPc, endPc) of m_binary, numbering from firstId
+  void decodeInstructionRange(Kernel &kernel, int32_t startPc, int32_t endPc,
+                              uint32_t firstId, InstList &insts);
+  void decodeInstructionsParallel(
+      Kernel &kernel, size_t binarySize,
+      const std::vector<std::pair<int32_t, uint32_t>> &chunkStarts,
+      InstList &insts);
   const OpSpec *decodeOpSpec(Op op);
+  Instruction *decodeInstruction(Kernel &kernel, const unsigned char *binary,
+                                 int32_t bytesLeft, int32_t iLen);
 
   Instruction *decodeNextInstruction(Kernel &kernel);
 
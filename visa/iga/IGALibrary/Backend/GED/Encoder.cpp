@@ -8,6 +8,7 @@ SPDX-License-Identifier: MIT
 
 #include "Encoder.hpp"
 #include "../../Frontend/IRToString.hpp"
+#include "../CompactionCache.hpp"
 #include "../../IR/Kernel.hpp"
 #include "../../IR/SWSBSetter.hpp"
 #include "../../Models/Models.hpp"
@@ -206,10 +207,10 @@ void Encoder::encodeBlock(Kernel &k, Block *blk) {
     }
 
     int32_t iLen = 16;
+    bool encodedNative = false;
     if (mustCompact || (!mustNotCompact && m_opts.autoCompact)) {
       // try compact first
-      status = GED_EncodeIns(&m_gedInst, GED_INS_TYPE_COMPACT,
-                             m_instBuf + currentPc());
+      status = encodeCompacted(m_instBuf + currentPc(), encodedNative);
       if (status == GED_RETURN_VALUE_SUCCESS) {
         // If auto compation is turned on, in case we need to patch later.
         inst->addInstOpt(InstOpt::COMPACTED);
@@ -228,8 +229,12 @@ void Encoder::encodeBlock(Kernel &k, Block *blk) {
     // try native encoding if compaction failed
     if (status != GED_RETURN_VALUE_SUCCESS) {
       inst->removeInstOpt(InstOpt::COMPACTED);
-      status = GED_EncodeIns(&m_gedInst, GED_INS_TYPE_NATIVE,
-                             m_instBuf + currentPc());
+      if (!encodedNative) {
+        status = GED_EncodeIns(&m_gedInst, GED_INS_TYPE_NATIVE,
+                               m_instBuf + currentPc());
+      } else {
+        status = GED_RETURN_VALUE_SUCCESS;
+      }
       if (status != GED_RETURN_VALUE_SUCCESS) {
         errorAtT(inst->getLoc(), "GED unable to encode instruction: ",
                  gedReturnValueToString(status));
@@ -239,6 +244,54 @@ void Encoder::encodeBlock(Kernel &k, Block *blk) {
   }
 }
 
+// A cache hit saves the compaction table search, a miss costs the native
+// encode made only for the key plus the insert. After this many lookups of
+// one encode, the cache is bypassed for the rest of the kernel if fewer than
+// a quarter of them hit: a kernel of mostly unique encodings would otherwise
+// be encoded a third slower than without the cache.
+static const uint32_t CACHE_SAMPLE_LOOKUPS = 1024;
+
+// Compacts m_gedInst into dst. With a compaction cache, the instruction is
+// encoded natively first and the result of an earlier compaction of the same
+// bits is reused; if that found no compact form, the native bits are left
+// in dst and encodedNative is set.
+GED_RETURN_VALUE Encoder::encodeCompacted(uint8_t *dst, bool &encodedNative) {
+  CompactionCache *cache = m_opts.compactionCache;
+  if (!cache || cache->getPlatform() != platform() ||
+      (m_cacheLookups >= CACHE_SAMPLE_LOOKUPS &&
+       m_cacheHits < m_cacheLookups / 4)) {
+    return GED_EncodeIns(&m_gedInst, GED_INS_TYPE_COMPACT, dst);
+  }
+
+  uint8_t native[UNCOMPACTED_SIZE];
+  if (GED_EncodeIns(&m_gedInst, GED_INS_TYPE_NATIVE, native) !=
+      GED_RETURN_VALUE_SUCCESS) {
+    // let the uncached path report it
+    return GED_EncodeIns(&m_gedInst, GED_INS_TYPE_COMPACT, dst);
+  }
+
+  m_cacheLookups++;
+  if (const CompactionCache::Entry *e = cache->find(native)) {
+    m_cacheHits++;
+    if (e->compacted) {
+      std::memcpy(dst, &e->bits, COMPACTED_SIZE);
+      return GED_RETURN_VALUE_SUCCESS;
+    }
+    std::memcpy(dst, native, UNCOMPACTED_SIZE);
+    encodedNative = true;
+    return GED_RETURN_VALUE_NO_COMPACT_FORM;
+  }
+
+  GED_RETURN_VALUE status =
+      GED_EncodeIns(&m_gedInst, GED_INS_TYPE_COMPACT, dst);
+  if (status == GED_RETURN_VALUE_SUCCESS) {
+    cache->insert(native, true, dst);
+  } else if (status == GED_RETURN_VALUE_NO_COMPACT_FORM) {
+    cache->insert(native, false, nullptr);
+  }
+  return status;
+}
+
 bool Encoder::getBlockOffset(const Block *b, uint32_t &pc) {
   auto iter = m_blockToOffsetMap.find(b);
   if (iter != m_blockToOffsetMap.end()) {
@@ -151,6 +151,10 @@ private:
 
   void encodeBlock(Kernel &k, Block *blk);
   void encodeInstruction(Instruction &inst);
+  GED_RETURN_VALUE encodeCompacted(uint8_t *dst, bool &encodedNative);
+  // compaction cache lookups and hits of this encode (c.f. encodeCompacted)
+  uint32_t m_cacheLookups = 0;
+  uint32_t m_cacheHits = 0;
   void patchJumpOffsets();
 
   ///////////////////////////////////////////////////////////////////////
@@ -81,6 +81,15 @@ public:
     m_errors.emplace_back(loc, message);
   }
 
+  // appends the diagnostics of another handler (e.g. one that a worker
+  // thread used for its part of the same kernel)
+  void append(const ErrorHandler &eh) {
+    m_errors.insert(m_errors.end(), eh.m_errors.begin(), eh.m_errors.end());
+    m_warnings.insert(m_warnings.end(), eh.m_warnings.begin(),
+                      eh.m_warnings.end());
+    m_fatalError |= eh.m_fatalError;
+  }
+
   // hard stops with an exception a calling frame somewhere up the stack
   // must catch the iga::FatalError.   The ErrorHandler will contain this
   // error message.
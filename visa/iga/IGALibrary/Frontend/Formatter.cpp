@@ -19,12 +19,14 @@ SPDX-License-Identifier: MIT
 #include "SendDescriptorDecoding.hpp"
 #include "ged.h"
 #ifndef IGA_DISABLE_ENCODER_EXCEPTIONS
+#include "../Backend/GED/Decoder.hpp"
 #include "../Backend/GED/Interface.hpp"
 #include "../Backend/Native/Interface.hpp"
 #endif
 #include "../Backend/GED/IGAToGEDTranslation.hpp"
 #include "../Backend/Native/MInst.hpp"
 #include "../api/iga.h"
+#include "../parallel.hpp"
 
 #include <algorithm>
 #include <cstring>
@@ -130,6 +132,18 @@ public:
 
   void formatKernel(const Kernel &k, const void *vbits) {
     currInstBits = (const uint8_t *)vbits;
+    formatKernelPrologue();
+    for (const Block *b : k.getBlockList()) {
+      formatBlock(*b);
+    }
+  }
+
+  // the bits of the next instruction formatted (for printInstBits)
+  void setInstBits(const void *vbits) {
+    currInstBits = (const uint8_t *)vbits;
+  }
+
+  void formatKernelPrologue() {
     if (opts.printInstDefs && opts.liveAnalysis) {
       std::stringstream ss;
       ss << "// itrs: " << opts.liveAnalysis->iterations << "\n";
@@ -154,16 +168,16 @@ public:
       }
       emitAnsi(ANSI_FADED, ss.str());
     }
+  }
 
-    for (const Block *b : k.getBlockList()) {
-      if (!opts.numericLabels) {
-        formatLabel(b->getPC());
-        emit(':');
-        newline();
-      }
-
-      formatBlockContents(*b);
+  void formatBlock(const Block &b) {
+    if (!opts.numericLabels) {
+      formatLabel(b.getPC());
+      emit(':');
+      newline();
     }
+
+    formatBlockContents(b);
   }
 
   void formatBlockContents(const Block &b) {
@@ -1380,6 +1394,69 @@ void FormatOpts::addApiOpts(uint32_t fmtOpts, uint32_t pcOff) {
   basePCOffset = pcOff;
 }
 
+// Kernels are formatted on several threads only if each thread gets at
+// least this many instructions.
+static const size_t MIN_PARALLEL_FORMAT_INSTS = 4096;
+
+// Formats runs of whole blocks on separate threads, each into its own
+// buffer, and emits the buffers in block order; the text is the same as
+// a sequential format. Returns false (having emitted nothing) for small
+// kernels, if there is a user labeler, which needn't be thread safe, or
+// with -Xprint-defs, whose per-instruction scan of all the dependencies
+// only gets slower when several threads run it.
+static bool FormatKernelParallel(ErrorHandler &e, std::ostream &o,
+                                 const FormatOpts &opts, const Kernel &k,
+                                 const void *bits) {
+  if (opts.labeler || opts.printInstDefs)
+    return false;
+  size_t numInsts = 0;
+  for (const Block *b : k.getBlockList())
+    numInsts += b->getInstList().size();
+  unsigned threads = ParallelThreadCount(numInsts, MIN_PARALLEL_FORMAT_INSTS);
+  if (threads <= 1)
+    return false;
+
+  struct Part {
+    std::vector<const Block *> blocks;
+    size_t bitsOffset = 0;
+    std::stringstream text;
+    ErrorHandler errors;
+  };
+  std::vector<Part> parts(threads);
+  size_t instsPerPart = (numInsts + threads - 1) / threads;
+  size_t partIx = 0, partInsts = 0, bitsOffset = 0;
+  for (const Block *b : k.getBlockList()) {
+    if (partInsts >= instsPerPart && partIx + 1 < parts.size()) {
+      partIx++;
+      partInsts = 0;
+      parts[partIx].bitsOffset = bitsOffset;
+    }
+    parts[partIx].blocks.push_back(b);
+    partInsts += b->getInstList().size();
+    for (const Instruction *i : b->getInstList())
+      bitsOffset += i->hasInstOpt(InstOpt::COMPACTED) ? 8 : 16;
+  }
+
+  ParallelFor((unsigned)parts.size(), [&](unsigned ix) {
+    Part &p = parts[ix];
+    Formatter f(p.errors, p.text, opts);
+    if (bits)
+      f.setInstBits((const uint8_t *)bits + p.bitsOffset);
+    if (ix == 0)
+      f.formatKernelPrologue();
+    for (const Block *b : p.blocks)
+      f.formatBlock(*b);
+  });
+
+  for (Part &p : parts) {
+    // streaming an empty buffer would set failbit on o
+    if (p.text.tellp() > 0)
+      o << p.text.rdbuf();
+    e.append(p.errors);
+  }
+  return true;
+}
+
 void FormatKernel(ErrorHandler &e, std::ostream &o, const FormatOpts &opts,
                   const Kernel &k, const void *bits) {
   IGA_ASSERT(k.getModel().platform == opts.model.platform,
@@ -1392,8 +1469,10 @@ void FormatKernel(ErrorHandler &e, std::ostream &o, const FormatOpts &opts,
     return;
   }
   if (!opts.printJson) {
-    Formatter f(e, o, opts);
-    f.formatKernel(k, (const uint8_t *)bits);
+    if (!FormatKernelParallel(e, o, opts, k, bits)) {
+      Formatter f(e, o, opts);
+      f.formatKernel(k, (const uint8_t *)bits);
+    }
   } else {
     FormatJSON(o, opts, k, bits);
   }
@@ -1445,6 +1524,214 @@ void FormatInstruction(ErrorHandler &e, std::ostream &o, const FormatOpts &opts,
     delete k;
   }
 }
+
+// The scratch kernel is dropped and recreated after this many
+// instructions; this bounds the arena no matter the kernel size.
+static const size_t STREAM_SCRATCH_INSTS = 256;
+
+int StreamDisassembler::TextBuffer::overflow(int c) {
+  if (c != traits_type::eof())
+    chars.push_back((char)c);
+  return c;
+}
+std::streamsize StreamDisassembler::TextBuffer::xsputn(const char *s,
+                                                       std::streamsize n) {
+  chars.insert(chars.end(), s, s + n);
+  return n;
+}
+std::streambuf::pos_type
+StreamDisassembler::TextBuffer::seekoff(off_type off,
+                                       std::ios_base::seekdir dir,
+                                       std::ios_base::openmode which) {
+  if (off == 0 && dir == std::ios_base::cur && (which & std::ios_base::out))
+    return pos_type((off_type)chars.size());
+  return pos_type(off_type(-1));
+}
+const char *StreamDisassembler::TextBuffer::terminate(size_t &len) {
+  len = chars.size();
+  chars.push_back(0);
+  return chars.data();
+}
+
+StreamDisassembler::StreamDisassembler(ErrorHandler &e,
+                                       const FormatOpts &opts,
+                                       const void *bits, size_t bitsLen)
+    : m_errorHandler(e), m_opts(&opts), m_bits((const uint8_t *)bits),
+      m_bitsLen(bitsLen), m_scratch(new Kernel(opts.model)),
+      m_decoder(new Decoder(opts.model, e)), m_instStream(&m_instText),
+      m_labelStream(&m_labelText) {}
+
+StreamDisassembler::~StreamDisassembler() {}
+
+void StreamDisassembler::reset(const FormatOpts &opts, const void *bits,
+                               size_t bitsLen) {
+  IGA_ASSERT(&opts.model == &m_scratch->getModel(),
+             "a stream disassembler is for one model");
+  m_opts = &opts;
+  m_bits = (const uint8_t *)bits;
+  m_bitsLen = bitsLen;
+  m_labels.clear();
+}
+
+int32_t StreamDisassembler::instructionLength(int32_t pc) const {
+  // need the first dword for the compaction control bit
+  if (pc < 0 || (size_t)pc + 4 > m_bitsLen)
+    return 0;
+  uint32_t dw0;
+  memcpy(&dw0, m_bits + pc, sizeof(dw0));
+  int32_t iLen = ((dw0 >> 29) & 1) ? 8 : 16;
+  return (size_t)pc + iLen <= m_bitsLen ? iLen : 0;
+}
+
+Instruction *StreamDisassembler::decodeAt(Decoder &d, int32_t pc) {
+  if (m_scratchInsts == STREAM_SCRATCH_INSTS) {
+    m_scratch.reset(new Kernel(m_opts->model));
+    m_scratchInsts = 0;
+  }
+  m_scratchInsts++;
+  return d.decodeInstructionAt(*m_scratch, m_bits, m_bitsLen, pc);
+}
+
+void StreamDisassembler::release(Instruction *inst) {
+  // the arena reclaims the memory, but members such as the comment
+  // need their destructors (c.f. ~Block)
+  inst->~Instruction();
+}
+
+void StreamDisassembler::scanLabels() {
+  m_labels.clear();
+  if (m_bitsLen == 0)
+    return;
+  m_labels.push_back(0);
+
+  // decode errors are reported when the instruction is formatted
+  ErrorHandler scanErrors;
+  Decoder scanner(m_opts->model, scanErrors);
+
+  struct Target {
+    int32_t targetPc, pc;
+    int srcIx;
+  };
+  std::vector<Target> targets;
+  int32_t pc = 0, iLen;
+  while ((iLen = instructionLength(pc)) != 0) {
+    OpSpecMissInfo missInfo = {0};
+    const OpSpec &os =
+        m_opts->model.lookupOpSpecFromBits(m_bits + pc, missInfo);
+    if (os.isValid() && (os.isBranching() || os.isAnySendFormat())) {
+      Instruction *inst = decodeAt(scanner, pc);
+      if (inst->getOpSpec().isBranching()) {
+        m_labels.push_back(pc + iLen);
+        int srcs = inst->getSourceCount() > 1 ? 2 : 1;
+        for (int srcIx = 0; srcIx < srcs; srcIx++) {
+          const Operand &src = inst->getSource(srcIx);
+          if (src.getKind() != Operand::Kind::LABEL)
+            continue;
+          int32_t targetPc = src.getImmediateValue().s32;
+          if (!inst->getOpSpec().isJipAbsolute())
+            targetPc += pc;
+          m_labels.push_back(targetPc);
+          targets.push_back({targetPc, pc, srcIx});
+        }
+      } else if (inst->hasInstOpt(InstOpt::EOT)) {
+        m_labels.push_back(pc + iLen);
+      }
+      release(inst);
+    }
+    pc += iLen;
+  }
+  const int32_t binaryLength = pc;
+
+  // same checks as Block::inferBlocks
+  std::vector<const Target *> midInst;
+  std::vector<const Target *> byTarget;
+  for (const Target &t : targets) {
+    if (t.targetPc < 0 || t.targetPc > binaryLength) {
+      std::stringstream ss;
+      ss << "src" << t.srcIx << " targets";
+      if (t.targetPc < 0) {
+        ss << " before kernel start";
+      } else {
+        ss << " after kernel end";
+      }
+      ss << ": PC " << t.targetPc;
+      Loc loc(0, 0, (uint32_t)t.pc, (uint32_t)instructionLength(t.pc));
+      m_errorHandler.reportError(loc, ss.str());
+    } else {
+      byTarget.push_back(&t);
+    }
+  }
+  std::sort(byTarget.begin(), byTarget.end(),
+            [](const Target *t1, const Target *t2) {
+              return t1->targetPc < t2->targetPc;
+            });
+  int32_t instPc = 0;
+  for (const Target *t : byTarget) {
+    while (instPc < t->targetPc && (iLen = instructionLength(instPc)) != 0)
+      instPc += iLen;
+    if (t->targetPc != instPc)
+      midInst.push_back(t);
+  }
+  std::sort(midInst.begin(), midInst.end(),
+            [](const Target *t1, const Target *t2) {
+              return t1->pc < t2->pc ||
+                     (t1->pc == t2->pc && t1->srcIx < t2->srcIx);
+            });
+  for (const Target *t : midInst) {
+    std::stringstream ss;
+    ss << "src" << t->srcIx
+       << ": numeric label targets the middle of an instruction";
+    m_errorHandler.reportError(Loc((PC)t->pc), ss.str());
+  }
+
+  std::sort(m_labels.begin(), m_labels.end());
+  m_labels.erase(std::unique(m_labels.begin(), m_labels.end()),
+                 m_labels.end());
+}
+
+const char *StreamDisassembler::formatInstructionAt(int32_t pc,
+                                                    size_t &textLen, int id) {
+  textLen = 0;
+  if (instructionLength(pc) == 0)
+    return nullptr;
+  Instruction *inst = decodeAt(*m_decoder, pc);
+  inst->setID(id);
+  if (!m_opts->numericLabels || m_opts->printJson) {
+    // a full decode points labels at blocks; absolute PCs format the same
+    // (JSON always names the target)
+    for (int srcIx = 0; srcIx < (int)inst->getSourceCount(); srcIx++) {
+      const Operand &src = inst->getSource(srcIx);
+      if (src.getKind() != Operand::Kind::LABEL)
+        continue;
+      int32_t targetPc = src.getImmediateValue().s32;
+      if (!inst->getOpSpec().isJipAbsolute())
+        targetPc += pc;
+      inst->setLabelSource((SourceIndex)srcIx, targetPc, src.getType());
+    }
+  }
+  m_instText.chars.clear();
+  if (m_opts->printJson) {
+    FormatInstructionJSON(m_instStream, *m_opts, *inst, m_bits + pc);
+  } else {
+    Formatter f(m_errorHandler, m_instStream, *m_opts);
+    f.formatInstruction(*inst, m_bits + pc);
+  }
+  m_instStream.flush();
+  release(inst);
+  return m_instText.terminate(textLen);
+}
+
+const char *StreamDisassembler::formatLabel(int32_t pc, size_t &textLen) {
+  m_labelText.chars.clear();
+  if (m_opts->printJson) {
+    FormatLabelJSON(m_labelStream, *m_opts, pc);
+  } else {
+    Formatter f(m_errorHandler, m_labelStream, *m_opts);
+    f.formatLabel(pc);
+  }
+  m_labelStream.flush();
+  return m_labelText.terminate(textLen);
+}
 #endif
 
 void GetDefaultLabelName(std::ostream &o, int32_t pc) {
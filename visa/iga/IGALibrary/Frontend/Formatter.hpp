@@ -16,9 +16,11 @@ SPDX-License-Identifier: MIT
 #include "Floats.hpp"
 
 #include <iomanip>
+#include <memory>
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace iga {
 //////////////////////////////////////////////////////////////////////////
@@ -83,6 +85,74 @@ void FormatInstruction(ErrorHandler &e, std::ostream &o, const FormatOpts &opts,
                        bool useNativeDecoder = false);
 void FormatInstruction(ErrorHandler &e, std::ostream &o, const FormatOpts &opts,
                        const void *bits);
+
+class Decoder;
+
+// Disassembles a kernel one instruction at a time without building the
+// kernel IR.  Each instruction is decoded into a scratch arena that is
+// recycled as we go, so memory use doesn't grow with the kernel; the only
+// per-kernel state is the label table built by scanLabels().
+//
+// Text returned stays valid until the next call of the same method.
+// A disassembler can be reset() to another kernel of the same model, which
+// keeps its decoder, arena and buffers; opts and bits are not copied and
+// must stay valid until then.
+class StreamDisassembler {
+public:
+  StreamDisassembler(ErrorHandler &e, const FormatOpts &opts, const void *bits,
+                     size_t bitsLen);
+  ~StreamDisassembler();
+
+  // Starts over on other bits (and options) for the same model; the labels
+  // from scanLabels() are dropped.
+  void reset(const FormatOpts &opts, const void *bits, size_t bitsLen);
+
+  // Finds the PCs a full decode would label (0, the instruction after each
+  // branch or EOT and all branch targets), decoding only the branches and
+  // sends.  Target errors are reported as a full decode would.
+  void scanLabels();
+  // sorted label PCs found by scanLabels()
+  const std::vector<int32_t> &getLabels() const { return m_labels; }
+
+  // The length of the instruction at pc or 0 if there isn't a whole one.
+  int32_t instructionLength(int32_t pc) const;
+
+  // Formats the instruction at pc (without a newline); returns nullptr if
+  // there isn't a whole instruction at pc.  The id is what JSON output
+  // reports for the instruction.
+  const char *formatInstructionAt(int32_t pc, size_t &textLen, int id = 1);
+
+  // Formats a label name for pc (without the ':')
+  const char *formatLabel(int32_t pc, size_t &textLen);
+
+private:
+  // reused across calls; clear() keeps the capacity
+  struct TextBuffer : std::streambuf {
+    std::vector<char> chars;
+    int overflow(int c) override;
+    std::streamsize xsputn(const char *s, std::streamsize n) override;
+    // only for tellp(), which column alignment uses
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                     std::ios_base::openmode which) override;
+    const char *terminate(size_t &len);
+  };
+
+  ErrorHandler &m_errorHandler;
+  const FormatOpts *m_opts;
+  const uint8_t *m_bits;
+  size_t m_bitsLen;
+
+  std::unique_ptr<Kernel> m_scratch;
+  size_t m_scratchInsts = 0;
+  std::unique_ptr<Decoder> m_decoder;
+  std::vector<int32_t> m_labels;
+
+  TextBuffer m_instText, m_labelText;
+  std::ostream m_instStream, m_labelStream;
+
+  Instruction *decodeAt(Decoder &d, int32_t pc);
+  void release(Instruction *inst);
+};
 #endif // IGA_DISABLE_ENCODER_EXCEPTIONS
 
 void GetDefaultLabelName(std::ostream &o, int32_t pc);
@@ -58,15 +58,9 @@ public:
       case '\t':
         emit("\\t");
         break;
-      case '\v':
-        emit("\\v");
-        break;
       case '\f':
         emit("\\f");
         break;
-      case '\a':
-        emit("\\a");
-        break;
       case '\"':
         emit("\\\"");
         break;
@@ -74,7 +68,13 @@ public:
         emit("\\\\");
         break;
       default:
-        emit(s[i]);
+        if ((unsigned char)s[i] < 0x20) {
+          // JSON has no \v or \a
+          emit("\\u00");
+          emitHexDigits((unsigned char)s[i], 2);
+        } else {
+          emit(s[i]);
+        }
         break;
       }
     }
@@ -108,7 +108,8 @@ public:
 
   void emitKernel(const Kernel &k) {
     emit("{\n");
-    emit("  \"version\":\"1.0\",");
+    emit("  \"version\":\"", JSON_VERSION_MAJOR, ".", JSON_VERSION_MINOR,
+         "\",");
     emit("  \"platform\":\"", model.names[0].str(), "\",");
     emit("  \"insts\":[\n");
     currIndent += 2;
@@ -221,9 +222,9 @@ public:
       subfunc = ToSyntax(i.getSubfunction().math);
       break;
     case Op::SEND:
-      subfunc = ToSyntax(i.getSubfunction().send);
-      break;
     case Op::SENDC:
+    case Op::SENDS:
+    case Op::SENDSC:
       subfunc = ToSyntax(i.getSubfunction().send);
       break;
     case Op::SYNC:
@@ -247,6 +248,10 @@ public:
       subfunc = ToSyntax(i.getDpasFc());
       break;
     default:
+      if (i.getOpSpec().supportsBranchCtrl() &&
+          i.getBranchCtrl() == BranchCntrl::ON) {
+        subfunc = "b";
+      }
       break;
     }
 
@@ -450,7 +455,9 @@ public:
   // {flag:{reg:...}}
   void emitFlagReg(const Instruction &i) {
     emit(", \"freg\":");
-    if (i.hasPredication() || (i.hasFlagModifier() && !i.is(Op::SEL))) {
+    // sel's condition modifier doesn't write the flag, but the flag
+    // register is still encoded (and needed to reassemble it)
+    if (i.hasPredication() || i.hasFlagModifier()) {
       emitReg(RegName::ARF_F, i.getFlagReg());
     } else {
       emit("null");
@@ -549,6 +556,8 @@ public:
       emit(", \"areg\":");
       emitReg(RegName::ARF_A, src.getIndAddrReg());
       emit(", \"aoff\":", src.getIndImmAddr());
+      emit(", \"rgn\":");
+      emitSrcRgn(i, srcIx);
       break;
     case Operand::Kind::IMMEDIATE: {
       emit(", \"value\":\"");
@@ -735,7 +744,7 @@ public:
       emitSendPayloadSrc(i, 1, "DA");
     } else {
       // old send operand (treat as raw direct register access)
-      emit("\"kind\":\"RD\"");
+      emit("{\"kind\":\"RD\"");
       emit(", \"reg\":");
       emitReg(src.getDirRegName(), src.getDirRegRef());
       emit(", \"rgn\":null");
@@ -745,6 +754,7 @@ public:
       rs.addSourceOperandInput(i, srcIx);
       emitSendPayloadDeps(i, rs, src.getDirRegName(), src.getDirRegRef().regNum,
                           1, true);
+      emit("}");
     }
   }
 
@@ -1017,7 +1027,7 @@ public:
       IGA_ASSERT(!di.hasDist() && !di.hasToken(), "malformed SWSB IR");
       if (di.spToken == SWSB::SpecialToken::NOACCSBSET) {
         emitSeparator();
-        emit("NoAccSBSet");
+        emit("\"NoAccSBSet\"");
       }
     }
     emit("]");
@@ -1120,3 +1130,8 @@ void iga::FormatInstructionJSON(std::ostream &o, const FormatOpts &opts,
                                 const Instruction &i, const void *bits) {
   JSONFormatter(o, opts, bits).emitInst(i);
 }
+
+void iga::FormatLabelJSON(std::ostream &o, const FormatOpts &opts,
+                          int32_t pc) {
+  JSONFormatter(o, opts, nullptr).emitLabel(pc);
+}
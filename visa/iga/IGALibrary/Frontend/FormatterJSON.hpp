@@ -12,11 +12,19 @@ SPDX-License-Identifier: MIT
 #include "Formatter.hpp"
 
 namespace iga {
+// The version of the JSON format ("major.minor"); IGAJSON.md describes the
+// schema and when each number changes.
+static const int JSON_VERSION_MAJOR = 1;
+static const int JSON_VERSION_MINOR = 1;
+
 void FormatJSON(std::ostream &o, const FormatOpts &opts, const Kernel &k,
                 const void *bits);
 
 void FormatInstructionJSON(std::ostream &o, const FormatOpts &opts,
                            const Instruction &i, const void *bits);
+
+// the name FormatJSON gives the label at pc
+void FormatLabelJSON(std::ostream &o, const FormatOpts &opts, int32_t pc);
 } // namespace iga
 
 #endif // _IGA_FORMATTER_JSON
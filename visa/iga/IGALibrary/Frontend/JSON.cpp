@@ -0,0 +1,673 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "JSON.hpp"
+#include "Floats.hpp"
+
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+using namespace iga;
+
+// deeper than any listing needs; bounds the recursion on bad input
+static const int MAX_JSON_DEPTH = 256;
+
+const JSONValue *JSONValue::find(const char *key) const {
+  for (const auto &m : members) {
+    if (m.first == key)
+      return &m.second;
+  }
+  return nullptr;
+}
+
+JSONReader::JSONReader(const char *text, size_t len)
+    : m_text(text), m_len(len) {}
+
+Loc JSONReader::loc() const {
+  return Loc(m_line, (uint32_t)(m_off - m_lineStart + 1), (uint32_t)m_off, 1);
+}
+
+Loc JSONReader::extentFrom(const Loc &start) const {
+  Loc l = start;
+  l.extent = (uint32_t)(m_off - (size_t)start.offset);
+  return l;
+}
+
+void JSONReader::fail(const Loc &at, const std::string &msg) const {
+  throw SyntaxError(at, msg);
+}
+
+void JSONReader::advance() {
+  if (m_text[m_off++] == '\n') {
+    m_line++;
+    m_lineStart = m_off;
+  }
+}
+
+void JSONReader::skipSpace() {
+  while (m_off < m_len) {
+    char c = m_text[m_off];
+    if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+      break;
+    advance();
+  }
+}
+
+bool JSONReader::consumeIf(char c) {
+  skipSpace();
+  if (peek() != c || atEnd())
+    return false;
+  advance();
+  return true;
+}
+
+void JSONReader::consume(char c, const char *what) {
+  if (!consumeIf(c))
+    fail(loc(), std::string("expected ") + what);
+}
+
+bool JSONReader::nextElement(bool first, char close) {
+  if (consumeIf(close))
+    return false;
+  if (!first)
+    consume(',', close == ']' ? "',' or ']'" : "',' or '}'");
+  return true;
+}
+
+void JSONReader::enter(const Loc &at) {
+  if (m_depth >= MAX_JSON_DEPTH)
+    fail(at, "JSON nesting is too deep");
+}
+
+static void appendUTF8(std::string &s, uint32_t cp) {
+  if (cp < 0x80) {
+    s += (char)cp;
+  } else if (cp < 0x800) {
+    s += (char)(0xC0 | (cp >> 6));
+    s += (char)(0x80 | (cp & 0x3F));
+  } else if (cp < 0x10000) {
+    s += (char)(0xE0 | (cp >> 12));
+    s += (char)(0x80 | ((cp >> 6) & 0x3F));
+    s += (char)(0x80 | (cp & 0x3F));
+  } else {
+    s += (char)(0xF0 | (cp >> 18));
+    s += (char)(0x80 | ((cp >> 12) & 0x3F));
+    s += (char)(0x80 | ((cp >> 6) & 0x3F));
+    s += (char)(0x80 | (cp & 0x3F));
+  }
+}
+
+std::string JSONReader::parseString() {
+  skipSpace();
+  if (peek() != '"' || atEnd())
+    fail(loc(), "expected string");
+  advance();
+
+  std::string s;
+  auto parseHex4 = [&]() {
+    uint32_t cp = 0;
+    for (int k = 0; k < 4; k++) {
+      char c = peek();
+      if (atEnd() || !isxdigit((unsigned char)c))
+        fail(loc(), "expected four hex digits after \\u");
+      cp = 16 * cp + (isdigit((unsigned char)c) ? c - '0'
+                                                 : (tolower(c) - 'a' + 10));
+      advance();
+    }
+    return cp;
+  };
+  while (true) {
+    if (atEnd())
+      fail(loc(), "unterminated string");
+    char c = m_text[m_off];
+    if (c == '"') {
+      advance();
+      break;
+    } else if ((unsigned char)c < 0x20) {
+      fail(loc(), "control character in string");
+    } else if (c != '\\') {
+      s += c;
+      advance();
+      continue;
+    }
+    Loc escLoc = loc();
+    advance();
+    if (atEnd())
+      fail(loc(), "unterminated string");
+    char e = m_text[m_off];
+    advance();
+    switch (e) {
+    case '"':
+    case '\\':
+    case '/':
+      s += e;
+      break;
+    case 'b':
+      s += '\b';
+      break;
+    case 'f':
+      s += '\f';
+      break;
+    case 'n':
+      s += '\n';
+      break;
+    case 'r':
+      s += '\r';
+      break;
+    case 't':
+      s += '\t';
+      break;
+    // not JSON, but older IGA versions emitted these in comments
+    case 'v':
+      s += '\v';
+      break;
+    case 'a':
+      s += '\a';
+      break;
+    case 'u': {
+      uint32_t cp = parseHex4();
+      if (cp >= 0xD800 && cp < 0xDC00) {
+        // surrogate pair
+        if (!(peek() == '\\' && m_off + 1 < m_len &&
+              m_text[m_off + 1] == 'u'))
+          fail(escLoc, "unpaired UTF-16 surrogate");
+        advance();
+        advance();
+        uint32_t lo = parseHex4();
+        if (lo < 0xDC00 || lo > 0xDFFF)
+          fail(escLoc, "unpaired UTF-16 surrogate");
+        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+      } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+        fail(escLoc, "unpaired UTF-16 surrogate");
+      }
+      appendUTF8(s, cp);
+      break;
+    }
+    default:
+      fail(escLoc, "invalid escape sequence");
+    }
+  }
+  return s;
+}
+
+void JSONReader::parseNumber(JSONValue &v) {
+  size_t start = m_off;
+  auto digits = [&]() {
+    size_t n = 0;
+    while (!atEnd() && isdigit((unsigned char)peek())) {
+      advance();
+      n++;
+    }
+    return n;
+  };
+  bool isReal = false;
+  if (peek() == '-')
+    advance();
+  if (peek() == '0' && !atEnd()) {
+    advance();
+  } else if (digits() == 0) {
+    fail(v.loc, "malformed number");
+  }
+  if (peek() == '.' && !atEnd()) {
+    isReal = true;
+    advance();
+    if (digits() == 0)
+      fail(v.loc, "malformed number");
+  }
+  if ((peek() == 'e' || peek() == 'E') && !atEnd()) {
+    isReal = true;
+    advance();
+    if ((peek() == '+' || peek() == '-') && !atEnd())
+      advance();
+    if (digits() == 0)
+      fail(v.loc, "malformed number");
+  }
+
+  std::string text(m_text + start, m_off - start);
+  if (!isReal) {
+    errno = 0;
+    long long i = strtoll(text.c_str(), nullptr, 10);
+    if (errno == 0) {
+      v.kind = JSONValue::Kind::INT;
+      v.i = (int64_t)i;
+      v.d = (double)i;
+      return;
+    }
+    // too big for an integer; keep it as a real
+  }
+  v.kind = JSONValue::Kind::REAL;
+  v.d = strtod(text.c_str(), nullptr);
+}
+
+void JSONReader::parseValue(JSONValue &v) {
+  skipSpace();
+  v = JSONValue();
+  v.loc = loc();
+  if (atEnd())
+    fail(v.loc, "expected value");
+
+  auto keyword = [&](const char *kw) {
+    size_t n = strlen(kw);
+    if (m_len - m_off < n || strncmp(m_text + m_off, kw, n) != 0)
+      fail(v.loc, "expected value");
+    for (size_t k = 0; k < n; k++)
+      advance();
+  };
+
+  char c = peek();
+  switch (c) {
+  case '{': {
+    enter(v.loc);
+    m_depth++;
+    advance();
+    v.kind = JSONValue::Kind::OBJECT;
+    for (bool first = true; nextElement(first, '}'); first = false) {
+      std::string key = parseString();
+      consume(':', "':'");
+      v.members.emplace_back(std::move(key), JSONValue());
+      parseValue(v.members.back().second);
+    }
+    m_depth--;
+    break;
+  }
+  case '[': {
+    enter(v.loc);
+    m_depth++;
+    advance();
+    v.kind = JSONValue::Kind::ARRAY;
+    for (bool first = true; nextElement(first, ']'); first = false) {
+      v.elems.emplace_back();
+      parseValue(v.elems.back());
+    }
+    m_depth--;
+    break;
+  }
+  case '"':
+    v.kind = JSONValue::Kind::STRING;
+    v.s = parseString();
+    break;
+  case 't':
+    keyword("true");
+    v.kind = JSONValue::Kind::BOOL;
+    v.b = true;
+    break;
+  case 'f':
+    keyword("false");
+    v.kind = JSONValue::Kind::BOOL;
+    break;
+  case 'n':
+    keyword("null");
+    break;
+  default:
+    if (c == '-' || isdigit((unsigned char)c)) {
+      parseNumber(v);
+    } else {
+      fail(v.loc, "expected value");
+    }
+  }
+  v.loc = extentFrom(v.loc);
+}
+
+void JSONReader::skipValue() {
+  JSONValue v;
+  parseValue(v);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CBOR
+namespace {
+enum CBORMajor : uint8_t {
+  CBOR_UINT = 0,
+  CBOR_NINT = 1,
+  CBOR_BYTES = 2,
+  CBOR_TEXT = 3,
+  CBOR_ARRAY = 4,
+  CBOR_MAP = 5,
+  CBOR_TAG = 6,
+  CBOR_SIMPLE = 7,
+};
+static const uint8_t CBOR_FALSE = 0xF4, CBOR_TRUE = 0xF5, CBOR_NULL = 0xF6,
+                     CBOR_UNDEFINED = 0xF7, CBOR_HALF = 0xF9,
+                     CBOR_FLOAT = 0xFA, CBOR_DOUBLE = 0xFB, CBOR_BREAK = 0xFF;
+// the additional information of an indefinite length item
+static const uint8_t CBOR_INDEFINITE = 31;
+
+static void cborHead(std::vector<uint8_t> &out, uint8_t major, uint64_t val) {
+  uint8_t mt = (uint8_t)(major << 5);
+  if (val < 24) {
+    out.push_back(mt | (uint8_t)val);
+    return;
+  }
+  int bytes = val <= 0xFF ? 1 : val <= 0xFFFF ? 2 : val <= 0xFFFFFFFF ? 4 : 8;
+  out.push_back(mt | (uint8_t)(bytes == 1   ? 24
+                               : bytes == 2 ? 25
+                               : bytes == 4 ? 26
+                                            : 27));
+  for (int k = bytes - 1; k >= 0; k--)
+    out.push_back((uint8_t)(val >> (8 * k)));
+}
+} // namespace
+
+void JSONReader::transcodeToCBOR(std::vector<uint8_t> &out) {
+  skipSpace();
+  Loc at = loc();
+  switch (peek()) {
+  case '{':
+    enter(at);
+    m_depth++;
+    advance();
+    out.push_back((CBOR_MAP << 5) | CBOR_INDEFINITE);
+    for (bool first = true; nextElement(first, '}'); first = false) {
+      std::string key = parseString();
+      cborHead(out, CBOR_TEXT, key.size());
+      out.insert(out.end(), key.begin(), key.end());
+      consume(':', "':'");
+      transcodeToCBOR(out);
+    }
+    out.push_back(CBOR_BREAK);
+    m_depth--;
+    break;
+  case '[':
+    enter(at);
+    m_depth++;
+    advance();
+    out.push_back((CBOR_ARRAY << 5) | CBOR_INDEFINITE);
+    for (bool first = true; nextElement(first, ']'); first = false) {
+      transcodeToCBOR(out);
+    }
+    out.push_back(CBOR_BREAK);
+    m_depth--;
+    break;
+  default: {
+    JSONValue v;
+    parseValue(v);
+    switch (v.kind) {
+    case JSONValue::Kind::NUL:
+      out.push_back(CBOR_NULL);
+      break;
+    case JSONValue::Kind::BOOL:
+      out.push_back(v.b ? CBOR_TRUE : CBOR_FALSE);
+      break;
+    case JSONValue::Kind::INT:
+      if (v.i >= 0)
+        cborHead(out, CBOR_UINT, (uint64_t)v.i);
+      else
+        cborHead(out, CBOR_NINT, (uint64_t)(-1 - v.i));
+      break;
+    case JSONValue::Kind::REAL: {
+      uint64_t bits;
+      memcpy(&bits, &v.d, sizeof(bits));
+      out.push_back(CBOR_DOUBLE);
+      for (int k = 7; k >= 0; k--)
+        out.push_back((uint8_t)(bits >> (8 * k)));
+      break;
+    }
+    case JSONValue::Kind::STRING:
+      cborHead(out, CBOR_TEXT, v.s.size());
+      out.insert(out.end(), v.s.begin(), v.s.end());
+      break;
+    default:
+      break; // arrays and objects are handled above
+    }
+  }
+  }
+}
+
+void iga::JSONToCBOR(const char *json, size_t len, std::vector<uint8_t> &out) {
+  JSONReader r(json, len);
+  r.transcodeToCBOR(out);
+  r.skipSpace();
+  if (!r.atEnd())
+    r.fail(r.loc(), "unexpected text after JSON value");
+}
+
+namespace {
+struct CBORDecoder {
+  const uint8_t *bits;
+  size_t len;
+  size_t off = 0;
+  std::ostream &out;
+  std::string &err;
+  int depth = 0;
+
+  CBORDecoder(const uint8_t *b, size_t n, std::ostream &o, std::string &e)
+      : bits(b), len(n), out(o), err(e) {}
+
+  bool error(const char *what) {
+    std::stringstream ss;
+    ss << "CBOR offset " << off << ": " << what;
+    err = ss.str();
+    return false;
+  }
+
+  bool readBytes(size_t n, uint64_t &val) {
+    if (len - off < n)
+      return error("truncated data item");
+    val = 0;
+    for (size_t k = 0; k < n; k++)
+      val = (val << 8) | bits[off++];
+    return true;
+  }
+
+  // reads the head of a data item; indefinite is set for lengths of 31
+  bool readHead(uint8_t &major, uint8_t &info, uint64_t &val,
+                bool &indefinite) {
+    if (off >= len)
+      return error("truncated data item");
+    uint8_t ib = bits[off++];
+    major = ib >> 5;
+    info = ib & 0x1F;
+    indefinite = false;
+    val = info;
+    if (info < 24)
+      return true;
+    switch (info) {
+    case 24:
+      return readBytes(1, val);
+    case 25:
+      return readBytes(2, val);
+    case 26:
+      return readBytes(4, val);
+    case 27:
+      return readBytes(8, val);
+    case CBOR_INDEFINITE:
+      indefinite = true;
+      return major == CBOR_BYTES || major == CBOR_TEXT ||
+                     major == CBOR_ARRAY || major == CBOR_MAP ||
+                     major == CBOR_SIMPLE
+                 ? true
+                 : error("invalid indefinite length");
+    default:
+      return error("reserved additional information");
+    }
+  }
+
+  bool atBreak() {
+    if (off < len && bits[off] == CBOR_BREAK) {
+      off++;
+      return true;
+    }
+    return false;
+  }
+
+  void emitString(const std::string &s) {
+    static const char HEX[] = "0123456789abcdef";
+    out << '"';
+    for (char c : s) {
+      switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      default:
+        if ((unsigned char)c < 0x20) {
+          out << "\\u00" << HEX[(c >> 4) & 0xF] << HEX[c & 0xF];
+        } else {
+          out << c;
+        }
+      }
+    }
+    out << '"';
+  }
+
+  bool readText(uint64_t n, bool indefinite, std::string &s) {
+    if (!indefinite) {
+      if (len - off < n)
+        return error("truncated string");
+      s.append((const char *)bits + off, (size_t)n);
+      off += (size_t)n;
+      return true;
+    }
+    // chunks of definite length text strings
+    while (!atBreak()) {
+      uint8_t major, info;
+      uint64_t chunk;
+      bool chunkIndef;
+      if (!readHead(major, info, chunk, chunkIndef))
+        return false;
+      if (major != CBOR_TEXT || chunkIndef)
+        return error("invalid text string chunk");
+      if (!readText(chunk, false, s))
+        return false;
+    }
+    return true;
+  }
+
+  bool emitReal(double d) {
+    if (!std::isfinite(d))
+      return error("non-finite float has no JSON form");
+    std::stringstream ss;
+    ss.precision(17);
+    ss << d;
+    std::string s = ss.str();
+    out << s;
+    if (s.find_first_of(".eE") == std::string::npos)
+      out << ".0";
+    return true;
+  }
+
+  bool decodeItem() {
+    uint8_t major, info;
+    uint64_t val;
+    bool indefinite;
+    if (!readHead(major, info, val, indefinite))
+      return false;
+    // tags add meaning JSON can't carry; keep the tagged item (a loop, as
+    // a run of tags nests no deeper)
+    while (major == CBOR_TAG) {
+      if (!readHead(major, info, val, indefinite))
+        return false;
+    }
+    switch (major) {
+    case CBOR_UINT:
+      out << val;
+      return true;
+    case CBOR_NINT:
+      if (val > (uint64_t)std::numeric_limits<int64_t>::max())
+        return error("negative integer is out of range");
+      out << (-1 - (int64_t)val);
+      return true;
+    case CBOR_BYTES:
+      return error("byte strings have no JSON form");
+    case CBOR_TEXT: {
+      std::string s;
+      if (!readText(val, indefinite, s))
+        return false;
+      emitString(s);
+      return true;
+    }
+    case CBOR_ARRAY:
+    case CBOR_MAP: {
+      if (depth >= MAX_JSON_DEPTH)
+        return error("nesting is too deep");
+      depth++;
+      bool isMap = major == CBOR_MAP;
+      out << (isMap ? '{' : '[');
+      for (uint64_t n = 0; indefinite ? !atBreak() : n < val; n++) {
+        if (n > 0)
+          out << ',';
+        if (isMap) {
+          uint8_t keyMajor, keyInfo;
+          uint64_t keyLen;
+          bool keyIndef;
+          if (!readHead(keyMajor, keyInfo, keyLen, keyIndef))
+            return false;
+          if (keyMajor != CBOR_TEXT)
+            return error("map keys must be text strings");
+          std::string key;
+          if (!readText(keyLen, keyIndef, key))
+            return false;
+          emitString(key);
+          out << ':';
+        }
+        if (!decodeItem())
+          return false;
+      }
+      out << (isMap ? '}' : ']');
+      depth--;
+      return true;
+    }
+    default: // CBOR_SIMPLE
+      if (indefinite)
+        return error("unexpected break");
+      switch (info) {
+      case CBOR_FALSE & 0x1F:
+        out << "false";
+        return true;
+      case CBOR_TRUE & 0x1F:
+        out << "true";
+        return true;
+      case CBOR_NULL & 0x1F:
+      case CBOR_UNDEFINED & 0x1F:
+        out << "null";
+        return true;
+      case CBOR_HALF & 0x1F:
+        return emitReal(ConvertHalfToFloat((uint16_t)val));
+      case CBOR_FLOAT & 0x1F: {
+        uint32_t u32 = (uint32_t)val;
+        float f;
+        memcpy(&f, &u32, sizeof(f));
+        return emitReal(f);
+      }
+      case CBOR_DOUBLE & 0x1F: {
+        double d;
+        memcpy(&d, &val, sizeof(d));
+        return emitReal(d);
+      }
+      default:
+        return error("unsupported simple value");
+      }
+    }
+  }
+};
+} // namespace
+
+bool iga::CBORToJSON(const uint8_t *cbor, size_t len, std::ostream &out,
+                     std::string &err) {
+  CBORDecoder d(cbor, len, out, err);
+  if (!d.decodeItem())
+    return false;
+  if (d.off != len) {
+    err = "unexpected data after the CBOR data item";
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,108 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#ifndef IGA_FRONTEND_JSON_HPP
+#define IGA_FRONTEND_JSON_HPP
+
+#include "../IR/Loc.hpp"
+#include "Parser.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A small JSON reader and a transcoder between JSON text and CBOR
+// (RFC 8949), the compact binary form of the same data model.
+//
+// The reader is incremental so that the instruction list of a large kernel
+// can be read one element at a time.  Errors throw SyntaxError.
+namespace iga {
+struct JSONValue {
+  enum class Kind { NUL, BOOL, INT, REAL, STRING, ARRAY, OBJECT };
+
+  Kind kind = Kind::NUL;
+  Loc loc;
+
+  bool b = false;
+  int64_t i = 0;
+  double d = 0.0;
+  std::string s;
+  std::vector<JSONValue> elems;
+  // members are kept in their input order
+  std::vector<std::pair<std::string, JSONValue>> members;
+
+  bool isNull() const { return kind == Kind::NUL; }
+  bool isBool() const { return kind == Kind::BOOL; }
+  bool isInt() const { return kind == Kind::INT; }
+  bool isString() const { return kind == Kind::STRING; }
+  bool isArray() const { return kind == Kind::ARRAY; }
+  bool isObject() const { return kind == Kind::OBJECT; }
+
+  // returns nullptr if the member is absent
+  const JSONValue *find(const char *key) const;
+};
+
+class JSONReader {
+public:
+  JSONReader(const char *text, size_t len);
+
+  // reads a whole value
+  void parseValue(JSONValue &v);
+  // skips a whole value without keeping it
+  void skipValue();
+  std::string parseString();
+
+  // for walking arrays and objects one element at a time
+  void skipSpace();
+  bool atEnd() { return m_off >= m_len; }
+  char peek() { return m_off < m_len ? m_text[m_off] : 0; }
+  bool consumeIf(char c);
+  void consume(char c, const char *what);
+  // called after '[' or '{' and after each element; true if another
+  // element follows (the ',' is consumed)
+  bool nextElement(bool first, char close);
+
+  Loc loc() const;
+  Loc extentFrom(const Loc &start) const;
+  NORETURN_DECLSPEC void NORETURN_ATTRIBUTE fail(const Loc &at,
+                                                const std::string &msg) const;
+
+  // streams JSON text to CBOR without building the values
+  void transcodeToCBOR(std::vector<uint8_t> &out);
+
+private:
+  const char *m_text;
+  size_t m_len;
+  size_t m_off = 0;
+  uint32_t m_line = 1;
+  size_t m_lineStart = 0;
+  int m_depth = 0;
+
+  void advance();
+  void parseNumber(JSONValue &v);
+  void enter(const Loc &at);
+};
+
+// Converts one JSON value (e.g. a whole listing) to CBOR; throws SyntaxError.
+void JSONToCBOR(const char *json, size_t len, std::vector<uint8_t> &out);
+
+// Converts one CBOR data item to compact JSON text.  Returns false and sets
+// err if the input is malformed or uses something JSON can't hold (byte
+// strings, non-string keys, non-finite floats).
+bool CBORToJSON(const uint8_t *cbor, size_t len, std::ostream &out,
+                std::string &err);
+
+// CBOR input starts with a map head; JSON text can't start with these bytes.
+static inline bool LooksLikeCBORMap(const void *bits, size_t len) {
+  return len > 0 && (*(const uint8_t *)bits & 0xE0) == 0xA0;
+}
+} // namespace iga
+
+#endif // IGA_FRONTEND_JSON_HPP
@@ -0,0 +1,1428 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "KernelParserJSON.hpp"
+#include "../IR/InstBuilder.hpp"
+#include "../IR/Messages.hpp"
+#include "../strings.hpp"
+#include "Floats.hpp"
+#include "FormatterJSON.hpp"
+#include "IRToString.hpp"
+#include "JSON.hpp"
+
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+using namespace iga;
+
+// Reads the listing FormatJSON emits.  The instruction list is walked one
+// element at a time so that we never hold more than one instruction's JSON
+// in memory; each one is replayed through the InstBuilder in the same order
+// KernelParser calls it in, with the same defaults for anything omitted.
+class JSONKernelParser {
+  const Model &m_model;
+  InstBuilder &m_builder;
+  ErrorHandler &m_errorHandler;
+  const ParseOpts &m_opts;
+  JSONReader m_reader;
+
+  std::unordered_map<std::string, const OpSpec *> m_opmap;
+  std::unordered_map<std::string, Type> m_types;
+  std::unordered_map<std::string, RegName> m_regNames;
+  std::unordered_map<std::string, InstOpt> m_instOpts;
+
+  // per instruction state
+  const OpSpec *m_opSpec = nullptr;
+  ExecSize m_execSize = ExecSize::SIMD1;
+
+public:
+  JSONKernelParser(const Model &model, InstBuilder &builder, const char *inp,
+                   ErrorHandler &eh, const ParseOpts &popts)
+      : m_model(model), m_builder(builder), m_errorHandler(eh),
+        m_opts(popts), m_reader(inp, strlen(inp)) {
+    for (const OpSpec *os : m_model.ops()) {
+      if (os->isValid()) {
+        m_opmap[os->mnemonic] = os;
+      }
+    }
+    for (int t = (int)Type::INVALID + 1; t <= (int)Type::VF; t++) {
+      m_types[ToSyntax((Type)t).substr(1)] = (Type)t; // ":ud" => "ud"
+    }
+    for (int rn = (int)RegName::INVALID + 1; rn <= (int)RegName::GRF_R;
+         rn++) {
+      m_regNames[ToSyntax((RegName)rn)] = (RegName)rn;
+    }
+    static const InstOpt ALL_INST_OPTS[]{
+        InstOpt::ACCWREN,     InstOpt::ATOMIC,  InstOpt::BREAKPOINT,
+        InstOpt::COMPACTED,   InstOpt::EOT,     InstOpt::NOCOMPACT,
+        InstOpt::NODDCHK,     InstOpt::NODDCLR, InstOpt::NOPREEMPT,
+        InstOpt::NOSRCDEPSET, InstOpt::SWITCH,  InstOpt::SERIALIZE,
+        InstOpt::EXBSO,       InstOpt::CPS,
+    };
+    for (InstOpt io : ALL_INST_OPTS) {
+      m_instOpts[ToSyntax(io)] = io;
+    }
+  }
+
+  Platform platform() const { return m_model.platform; }
+
+  // Listing = '{' ("version" | "platform" | "insts" | other)* '}'
+  void ParseListing() {
+    m_builder.ProgramStart();
+
+    m_reader.consume('{', "'{' (start of JSON listing)");
+    bool sawVersion = false, sawInsts = false;
+    for (bool first = true; m_reader.nextElement(first, '}'); first = false) {
+      m_reader.skipSpace();
+      const Loc keyLoc = m_reader.loc();
+      std::string key = m_reader.parseString();
+      m_reader.consume(':', "':'");
+      if (key == "version") {
+        JSONValue v;
+        m_reader.parseValue(v);
+        CheckVersion(v);
+        sawVersion = true;
+      } else if (key == "platform") {
+        JSONValue v;
+        m_reader.parseValue(v);
+        CheckPlatform(v);
+      } else if (key == "insts") {
+        if (!sawVersion) {
+          Fail(keyLoc, "\"version\" must precede \"insts\"");
+        }
+        ParseInsts();
+        sawInsts = true;
+      } else {
+        m_reader.skipValue();
+      }
+    }
+    m_reader.skipSpace();
+    if (!m_reader.atEnd()) {
+      Fail(m_reader.loc(), "unexpected text after JSON listing");
+    }
+    if (!sawInsts) {
+      Fail(m_reader.loc(), "JSON listing has no \"insts\" array");
+    }
+
+    m_builder.ProgramEnd();
+  }
+
+private:
+  template <typename... Ts>
+  NORETURN_DECLSPEC void NORETURN_ATTRIBUTE Fail(const Loc &loc,
+                                                 Ts... ts) const {
+    throw SyntaxError(loc, iga::format(ts...));
+  }
+  template <typename... Ts> void Warning(const Loc &loc, Ts... ts) {
+    m_errorHandler.reportWarning(loc, iga::format(ts...));
+  }
+
+  void RecoverFromSyntaxError(const SyntaxError &s) {
+    m_errorHandler.reportError(s.loc, s.message);
+    if (m_errorHandler.getErrors().size() >= m_opts.maxSyntaxErrors) {
+      throw s;
+    }
+    // JSON delimits each element, so there's nothing to resync
+  }
+
+  static uint32_t ExtentTo(const Loc &start, const Loc &end) {
+    return end.offset + end.extent - start.offset;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+  // field accessors
+  const JSONValue &Member(const JSONValue &obj, const char *key) const {
+    const JSONValue *v = obj.find(key);
+    if (v == nullptr) {
+      Fail(obj.loc, "missing \"", key, "\"");
+    }
+    return *v;
+  }
+  // null is the same as absent
+  const JSONValue *OptMember(const JSONValue &obj, const char *key) const {
+    const JSONValue *v = obj.find(key);
+    return v && !v->isNull() ? v : nullptr;
+  }
+  const JSONValue &MemberObject(const JSONValue &obj, const char *key) const {
+    const JSONValue &v = Member(obj, key);
+    if (!v.isObject()) {
+      Fail(v.loc, "\"", key, "\" must be an object");
+    }
+    return v;
+  }
+  const std::string &MemberString(const JSONValue &obj,
+                                  const char *key) const {
+    const JSONValue &v = Member(obj, key);
+    if (!v.isString()) {
+      Fail(v.loc, "\"", key, "\" must be a string");
+    }
+    return v.s;
+  }
+  int64_t MemberInt(const JSONValue &obj, const char *key) const {
+    const JSONValue &v = Member(obj, key);
+    if (!v.isInt()) {
+      Fail(v.loc, "\"", key, "\" must be an integer");
+    }
+    return v.i;
+  }
+  bool OptMemberBool(const JSONValue &obj, const char *key) const {
+    const JSONValue *v = OptMember(obj, key);
+    if (v && !v->isBool()) {
+      Fail(v->loc, "\"", key, "\" must be true or false");
+    }
+    return v && v->b;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+  // header
+  void CheckVersion(const JSONValue &v) {
+    int major = -1, minor = -1;
+    if (v.isString()) {
+      const char *s = v.s.c_str();
+      char *end = nullptr;
+      major = (int)strtol(s, &end, 10);
+      if (end != s && *end == '.' && isdigit((unsigned char)end[1])) {
+        minor = (int)strtol(end + 1, &end, 10);
+      }
+      if (*end != 0) {
+        minor = -1;
+      }
+    }
+    if (major < 0 || minor < 0) {
+      Fail(v.loc, "\"version\" must be a string of the form "
+                  "\"MAJOR.MINOR\"");
+    } else if (major != JSON_VERSION_MAJOR) {
+      Fail(v.loc, "unsupported JSON listing version ", v.s,
+               " (expected version ", JSON_VERSION_MAJOR, ".x)");
+    } else if (minor > JSON_VERSION_MINOR) {
+      Warning(v.loc, "JSON listing version ", v.s, " is newer than ",
+              JSON_VERSION_MAJOR, ".", JSON_VERSION_MINOR,
+              "; unknown fields are ignored");
+    }
+  }
+
+  void CheckPlatform(const JSONValue &v) {
+    if (!v.isString()) {
+      Fail(v.loc, "\"platform\" must be a string");
+    }
+    auto eqIgnoreCase = [](const std::string &a, const char *b) {
+      size_t n = strlen(b);
+      if (a.size() != n)
+        return false;
+      for (size_t k = 0; k < n; k++) {
+        if (tolower((unsigned char)a[k]) != tolower((unsigned char)b[k]))
+          return false;
+      }
+      return true;
+    };
+    for (const auto &name : m_model.names) {
+      if (*name.text && eqIgnoreCase(v.s, name.text))
+        return;
+    }
+    Fail(v.loc, "listing is for platform ", v.s, ", but assembling for ",
+         m_model.names[0].str());
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+  // Insts = '[' (Label | Inst)* ']'
+  void ParseInsts() {
+    m_reader.consume('[', "'[' (start of instruction list)");
+    bool inBlock = false;
+    Loc blockLoc, lastLoc;
+    for (bool first = true; m_reader.nextElement(first, ']'); first = false) {
+      // malformed JSON is fatal; a bad instruction is recoverable
+      JSONValue elem;
+      m_reader.parseValue(elem);
+      try {
+        if (!elem.isObject()) {
+          Fail(elem.loc, "expected instruction or label object");
+        }
+        const std::string &kind = MemberString(elem, "kind");
+        if (kind == "L") {
+          if (inBlock) {
+            m_builder.BlockEnd(ExtentTo(blockLoc, lastLoc));
+          }
+          m_builder.BlockStart(elem.loc, MemberString(elem, "value"));
+          inBlock = true;
+          blockLoc = elem.loc;
+        } else if (kind == "I") {
+          // first block doesn't need a label
+          if (!inBlock) {
+            m_builder.BlockStart(elem.loc, "");
+            inBlock = true;
+            blockLoc = elem.loc;
+          }
+          ParseInst(elem);
+        } else {
+          Fail(Member(elem, "kind").loc, "unknown element kind ", kind);
+        }
+      } catch (const SyntaxError &s) {
+        RecoverFromSyntaxError(s);
+      }
+      lastLoc = elem.loc;
+    }
+    if (inBlock) {
+      m_builder.BlockEnd(ExtentTo(blockLoc, lastLoc));
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+  // instructions
+  void ParseInst(const JSONValue &inst) {
+    m_builder.InstStart(inst.loc);
+    m_opSpec = nullptr;
+
+    // predication and flag register
+    bool hasWrEn = OptMemberBool(inst, "wren");
+    if (hasWrEn) {
+      m_builder.InstNoMask(inst.loc);
+    }
+    RegRef flagReg = REGREF_INVALID;
+    const JSONValue *fregVal = OptMember(inst, "freg");
+    if (fregVal) {
+      RegName rn;
+      const RegInfo *ri = ParseReg(*fregVal, rn, flagReg);
+      if (ri->regName != RegName::ARF_F) {
+        Fail(fregVal->loc, "\"freg\" must be a flag register");
+      }
+    }
+    const JSONValue *pred = OptMember(inst, "pred");
+    if (pred) {
+      if (!fregVal) {
+        Fail(pred->loc, "predication needs \"freg\"");
+      }
+      ParsePred(*pred, flagReg);
+    }
+
+    // op and subfunction
+    const JSONValue &opVal = Member(inst, "op");
+    if (!opVal.isString()) {
+      Fail(opVal.loc, "\"op\" must be a string");
+    }
+    auto itr = m_opmap.find(opVal.s);
+    if (itr == m_opmap.end()) {
+      Fail(opVal.loc, "invalid mnemonic ", opVal.s,
+           " (load/store syntax is not supported in JSON input)");
+    }
+    m_opSpec = itr->second;
+    m_builder.InstOp(m_opSpec);
+    // GED will reject this otherwise
+    if (!hasWrEn && m_opSpec->op == Op::JMPI) {
+      Warning(opVal.loc,
+              "jmpi must have (W) specified (automatically adding)");
+      m_builder.InstNoMask(opVal.loc);
+    }
+    ParseSubfunction(inst);
+
+    ParseExecInfo(inst);
+
+    const JSONValue *fm = OptMember(inst, "fm");
+    if (fm) {
+      if (!fregVal) {
+        Fail(fm->loc, "flag modifier needs \"freg\"");
+      }
+      m_builder.InstFlagModifier(flagReg, ParseFlagModifier(*fm));
+    }
+
+    // operands
+    const JSONValue &srcs = Member(inst, "srcs");
+    if (!srcs.isArray()) {
+      Fail(srcs.loc, "\"srcs\" must be an array");
+    }
+    const JSONValue *dst = OptMember(inst, "dst");
+    if (m_opSpec->isAnySendFormat()) {
+      ParseSendOperands(inst, dst, srcs);
+    } else {
+      if (m_opSpec->supportsDestination()) {
+        if (!dst) {
+          Fail(inst.loc, m_opSpec->mnemonic.str(), " needs a destination");
+        }
+        if (m_opSpec->isDpasFormat())
+          ParseDpasOp(-1, *dst);
+        else
+          ParseDstOp(*dst);
+      } else if (dst) {
+        Fail(dst->loc, m_opSpec->mnemonic.str(), " has no destination");
+      }
+      if (srcs.elems.size() > 3) {
+        Fail(srcs.loc, "too many source operands");
+      }
+      for (int srcIx = 0; srcIx < (int)srcs.elems.size(); srcIx++) {
+        if (m_opSpec->isDpasFormat())
+          ParseDpasOp(srcIx, srcs.elems[srcIx]);
+        else
+          ParseSrcOp(srcIx, srcs.elems[srcIx]);
+      }
+    }
+
+    ParseInstOpts(inst);
+    ParseDepInfo(inst);
+
+    m_builder.InstEnd(inst.loc.extent);
+  }
+
+  // pred:{inv:T|F, func:""|".any4h"|...}
+  void ParsePred(const JSONValue &pred, RegRef flagReg) {
+    if (!pred.isObject()) {
+      Fail(pred.loc, "\"pred\" must be an object or null");
+    }
+    bool inv = OptMemberBool(pred, "inv");
+    const JSONValue *funcVal = OptMember(pred, "func");
+    PredCtrl pc = PredCtrl::SEQ;
+    if (funcVal) {
+      if (!funcVal->isString()) {
+        Fail(funcVal->loc, "\"func\" must be a string");
+      }
+      bool found = funcVal->s.empty();
+      for (int k = (int)PredCtrl::ANYV; !found && k <= (int)PredCtrl::ALL;
+           k++) {
+        if (ToSyntax((PredCtrl)k) == funcVal->s ||
+            ToSyntax((PredCtrl)k).substr(1) == funcVal->s) {
+          pc = (PredCtrl)k;
+          found = true;
+        }
+      }
+      if (!found) {
+        Fail(funcVal->loc, "invalid predication control");
+      }
+    }
+    m_builder.InstPredication(pred.loc, inv, flagReg, pc);
+  }
+
+  FlagModifier ParseFlagModifier(const JSONValue &fm) {
+    if (!fm.isObject()) {
+      Fail(fm.loc, "\"fm\" must be an object or null");
+    }
+    const std::string &cond = MemberString(fm, "cond");
+    static const FlagModifier FLAGMODS[]{
+        FlagModifier::EQ, FlagModifier::NE, FlagModifier::GT,
+        FlagModifier::GE, FlagModifier::LT, FlagModifier::LE,
+        FlagModifier::OV, FlagModifier::UN, FlagModifier::EO,
+    };
+    for (FlagModifier f : FLAGMODS) {
+      if (ToSyntax(f) == cond)
+        return f;
+    }
+    Fail(Member(fm, "cond").loc, "invalid flag modifier function");
+  }
+
+  void ParseSubfunction(const JSONValue &inst) {
+    const JSONValue *sfVal = OptMember(inst, "subop");
+    if (sfVal && !sfVal->isString()) {
+      Fail(sfVal->loc, "\"subop\" must be a string or null");
+    }
+    const OpSpec &os = *m_opSpec;
+    auto requireSubop = [&]() -> const std::string & {
+      if (!sfVal) {
+        Fail(inst.loc, "expected operation subfunction");
+      }
+      return sfVal->s;
+    };
+    auto fromSyntax = [&](auto invalid) {
+      using T = decltype(invalid);
+      T x = FromSyntax<T>(requireSubop());
+      if (x == T::INVALID) {
+        Fail(sfVal->loc, "invalid subfunction");
+      }
+      return x;
+    };
+
+    if (os.supportsBranchCtrl()) {
+      BranchCntrl brctl = BranchCntrl::OFF;
+      if (sfVal) {
+        if (sfVal->s != "b") {
+          Fail(sfVal->loc, "expected 'b' (branch control)");
+        }
+        brctl = BranchCntrl::ON;
+      }
+      m_builder.InstSubfunction(brctl);
+    } else if (os.is(Op::MATH)) {
+      m_builder.InstSubfunction(fromSyntax(MathFC::INVALID));
+    } else if (os.is(Op::SYNC)) {
+      m_builder.InstSubfunction(fromSyntax(SyncFC::INVALID));
+    } else if (platform() >= Platform::XE && os.isAnySendFormat()) {
+      m_builder.InstSubfunction(fromSyntax(SFID::INVALID));
+    } else if (os.is(Op::BFN)) {
+      m_builder.InstSubfunction(ParseBfnFC(*sfVal, requireSubop()));
+    } else if (os.isDpasFormat()) {
+      m_builder.InstSubfunction(fromSyntax(DpasFC::INVALID));
+    } else if (sfVal && !os.isAnySendFormat()) {
+      // pre XE sends take theirs from ExDesc
+      Fail(sfVal->loc, "unexpected subfunction for op");
+    }
+  }
+
+  // a raw value (0x96) or the expression FormatJSON emits (s0&~s1|s2)
+  BfnFC ParseBfnFC(const JSONValue &at, const std::string &s) {
+    size_t off = 0;
+    auto skipWs = [&]() {
+      while (off < s.size() && isspace((unsigned char)s[off]))
+        off++;
+    };
+    auto lookingAt = [&](char c) {
+      skipWs();
+      return off < s.size() && s[off] == c;
+    };
+    if (!lookingAt('(')) {
+      uint64_t val = 0;
+      if (!ParseInteger(s, val) || val > 0xFF) {
+        Fail(at.loc, "invalid BFN subfunction");
+      }
+      return BfnFC((uint8_t)val);
+    }
+    // regular boolean precedence: ~ > & > ^ > |
+    std::function<uint32_t()> parseOr;
+    std::function<uint32_t()> parseUnary = [&]() -> uint32_t {
+      if (lookingAt('~')) {
+        off++;
+        return ~parseUnary() & 0xFF;
+      } else if (lookingAt('(')) {
+        off++;
+        uint32_t v = parseOr();
+        if (!lookingAt(')'))
+          Fail(at.loc, "invalid BFN expression (expected ')')");
+        off++;
+        return v;
+      }
+      static const std::pair<const char *, uint32_t> ATOMS[]{
+          {"s0", 0xAA},    {"s1", 0xCC}, {"s2", 0xF0}, {"zeros", 0x00},
+          {"ones", 0xFF}, {"0", 0x00},  {"1", 0xFF},
+      };
+      for (const auto &a : ATOMS) {
+        size_t n = strlen(a.first);
+        if (s.compare(off, n, a.first) == 0) {
+          off += n;
+          return a.second;
+        }
+      }
+      Fail(at.loc, "invalid BFN expression (expected s0, s1, or s2)");
+    };
+    auto parseBinary = [&](char op, const std::function<uint32_t()> &next) {
+      uint32_t v = next();
+      while (lookingAt(op)) {
+        off++;
+        uint32_t r = next();
+        v = op == '&' ? (v & r) : op == '^' ? (v ^ r) : (v | r);
+      }
+      return v;
+    };
+    std::function<uint32_t()> parseAnd = [&]() {
+      return parseBinary('&', parseUnary);
+    };
+    std::function<uint32_t()> parseXor = [&]() {
+      return parseBinary('^', parseAnd);
+    };
+    parseOr = [&]() { return parseBinary('|', parseXor); };
+
+    uint32_t val = parseUnary();
+    skipWs();
+    if (off != s.size()) {
+      Fail(at.loc, "invalid BFN expression");
+    }
+    return BfnFC((uint8_t)val);
+  }
+
+  // es: 1|2|4|...|32, eo: 0|4|...|28
+  void ParseExecInfo(const JSONValue &inst) {
+    const JSONValue &esVal = Member(inst, "es");
+    switch (esVal.isInt() ? esVal.i : 0) {
+    case 1:
+      m_execSize = ExecSize::SIMD1;
+      break;
+    case 2:
+      m_execSize = ExecSize::SIMD2;
+      break;
+    case 4:
+      m_execSize = ExecSize::SIMD4;
+      break;
+    case 8:
+      m_execSize = ExecSize::SIMD8;
+      break;
+    case 16:
+      m_execSize = ExecSize::SIMD16;
+      break;
+    case 32:
+      m_execSize = ExecSize::SIMD32;
+      break;
+    default:
+      Fail(esVal.loc, "invalid SIMD width");
+    }
+    const JSONValue *eoVal = OptMember(inst, "eo");
+    ChannelOffset chOff = ChannelOffset::M0;
+    if (eoVal) {
+      if (!eoVal->isInt() || eoVal->i < 0 || eoVal->i > 28 || eoVal->i % 4) {
+        Fail(eoVal->loc, "invalid ChOff");
+      }
+      chOff = (ChannelOffset)(eoVal->i / 4);
+    }
+    m_builder.InstExecInfo(esVal.loc, m_execSize,
+                           eoVal ? eoVal->loc : esVal.loc, chOff);
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+  // operands
+  //
+  // reg:{rn:"r", r:13, sr:4}
+  const RegInfo *ParseReg(const JSONValue &reg, RegName &rn, RegRef &rr) {
+    if (!reg.isObject()) {
+      Fail(reg.loc, "expected register object");
+    }
+    const JSONValue &rnVal = Member(reg, "rn");
+    auto itr = rnVal.isString() ? m_regNames.find(rnVal.s) : m_regNames.end();
+    if (itr == m_regNames.end()) {
+      Fail(rnVal.loc, "invalid register name");
+    }
+    rn = itr->second;
+    const RegInfo *ri = m_model.lookupRegInfoByRegName(rn);
+    if (ri == nullptr) {
+      Fail(rnVal.loc, "register not supported on this platform");
+    }
+    int64_t r = MemberInt(reg, "r");
+    const JSONValue *srVal = OptMember(reg, "sr");
+    int64_t sr = srVal && srVal->isInt() ? srVal->i : 0;
+    if (!ri->isRegNumberValid((int)r) || r > 0xFFFF) {
+      Fail(reg.loc, "invalid register number (", ri->syntax, " only has ",
+           ri->numRegs, " registers on this platform)");
+    } else if (sr < 0 || sr > 0xFFFF) {
+      Fail(reg.loc, "invalid subregister");
+    }
+    rr = RegRef((uint16_t)r, (uint16_t)sr);
+    return ri;
+  }
+
+  Type LookupType(const JSONValue &tyVal) const {
+    auto itr = tyVal.isString() ? m_types.find(tyVal.s) : m_types.end();
+    if (itr == m_types.end()) {
+      Fail(tyVal.loc, "invalid operand type");
+    }
+    return itr->second;
+  }
+
+  // the defaults KernelParser uses for a missing type
+  Type DefaultType(const Loc &loc, const char *expectedErr) const {
+    if (m_opSpec->isAnySendFormat()) {
+      return Type::UD;
+    } else if (m_opSpec->isBranching() &&
+               m_model.supportsSimplifiedBranches()) {
+      // no more types for branching
+      return Type::UD;
+    } else if (m_opSpec->is(Op::SYNC)) {
+      // we allow implicit type for sync reg32 (grf or null)
+      return Type::UB;
+    }
+    Fail(loc, expectedErr);
+  }
+
+  Type ParseDstType(const JSONValue &dst) {
+    if (m_opSpec->hasImplicitDstType()) {
+      return m_opSpec->implicitDstType();
+    }
+    const JSONValue *tyVal = OptMember(dst, "type");
+    return tyVal ? LookupType(*tyVal)
+                 : DefaultType(dst.loc, "expected destination type");
+  }
+
+  Type ParseSrcType(int srcIx, const JSONValue &src, bool immOrLbl,
+                    bool isLabel = false) {
+    if (m_opSpec->hasImplicitSrcType(srcIx, immOrLbl)) {
+      return m_opSpec->implicitSrcType(srcIx, immOrLbl);
+    }
+    const JSONValue *tyVal = OptMember(src, "type");
+    if (tyVal) {
+      return LookupType(*tyVal);
+    } else if (m_opSpec->op == Op::MOV && isLabel) {
+      // support mov label without giving label's type
+      return Type::UD;
+    } else if (immOrLbl && !isLabel) {
+      if (m_opSpec->isBranching() && !m_model.supportsSimplifiedBranches())
+        return Type::INVALID;
+      Fail(src.loc, "expected source type");
+    }
+    return DefaultType(src.loc, "expected source type");
+  }
+
+  SrcModifier ParseSrcModifier(const JSONValue &src) {
+    const JSONValue *modsVal = OptMember(src, "mods");
+    SrcModifier sm = SrcModifier::NONE;
+    if (modsVal) {
+      const std::string &mods = modsVal->isString() ? modsVal->s : "?";
+      if (mods == "n") {
+        sm = SrcModifier::NEG;
+      } else if (mods == "a") {
+        sm = SrcModifier::ABS;
+      } else if (mods == "na") {
+        sm = SrcModifier::NEG_ABS;
+      } else if (!mods.empty()) {
+        Fail(modsVal->loc, "invalid source modifier");
+      }
+    }
+    if (sm != SrcModifier::NONE && !m_opSpec->supportsSourceModifiers()) {
+      Fail(src.loc, "source modifier not supported");
+    }
+    return sm;
+  }
+
+  MathMacroExt ParseMathMacroExt(const JSONValue &op) {
+    const std::string &mme = MemberString(op, "mme");
+    for (int k = (int)MathMacroExt::MME0; k <= (int)MathMacroExt::NOMME;
+         k++) {
+      if (ToSyntax((MathMacroExt)k).substr(1) == mme) // ".mme2" => "mme2"
+        return (MathMacroExt)k;
+    }
+    Fail(Member(op, "mme").loc, "invalid math macro register");
+  }
+
+  // rgn:{Hz:1}
+  Region::Horz ParseDstRegion(const JSONValue &dst) {
+    const JSONValue *rgnVal = OptMember(dst, "rgn");
+    if (!rgnVal) {
+      if (m_opSpec->hasImplicitDstRegion(m_builder.isMacroOp())) {
+        return m_opSpec->implicitDstRegion(m_builder.isMacroOp()).getHz();
+      }
+      return Region::Horz::HZ_1;
+    }
+    if (!rgnVal->isObject()) {
+      Fail(rgnVal->loc, "\"rgn\" must be an object or null");
+    }
+    switch (MemberInt(*rgnVal, "Hz")) {
+    case 1:
+      return Region::Horz::HZ_1;
+    case 2:
+      return Region::Horz::HZ_2;
+    case 4:
+      return Region::Horz::HZ_4;
+    default:
+      Fail(rgnVal->loc, "invalid destination region");
+    }
+  }
+
+  // rgn:{Vt:V, Wi:W, Hz:H} with Vt:null for <W,H> (VxH)
+  Region ParseSrcRegion(const JSONValue &rgnVal) {
+    if (!rgnVal.isObject()) {
+      Fail(rgnVal.loc, "\"rgn\" must be an object or null");
+    }
+    Region rgn;
+    rgn.bits = 0;
+    const JSONValue &vt = Member(rgnVal, "Vt");
+    if (vt.isNull()) {
+      rgn.set(Region::Vert::VT_VxH);
+    } else if (vt.isInt() &&
+               (vt.i == 0 || vt.i == 1 || vt.i == 2 || vt.i == 4 ||
+                vt.i == 8 || vt.i == 16 || vt.i == 32)) {
+      rgn.v = (unsigned)vt.i;
+    } else {
+      Fail(vt.loc, "invalid region vertical stride");
+    }
+    int64_t wi = MemberInt(rgnVal, "Wi");
+    if (wi != 1 && wi != 2 && wi != 4 && wi != 8 && wi != 16) {
+      Fail(Member(rgnVal, "Wi").loc, "invalid region width");
+    }
+    rgn.w = (unsigned)wi;
+    int64_t hz = MemberInt(rgnVal, "Hz");
+    if (hz != 0 && hz != 1 && hz != 2 && hz != 4) {
+      Fail(Member(rgnVal, "Hz").loc, "invalid region horizontal stride");
+    }
+    rgn.h = (unsigned)hz;
+    return rgn;
+  }
+
+  // dst:{kind:"RD"|"RM"|"RI", reg|areg+aoff, mme?, sat, rgn, type}
+  void ParseDstOp(const JSONValue &dst) {
+    if (!dst.isObject()) {
+      Fail(dst.loc, "\"dst\" must be an object");
+    }
+    if (OptMemberBool(dst, "sat")) {
+      m_builder.InstDstOpSaturate();
+    }
+    const std::string &kind = MemberString(dst, "kind");
+    Region::Horz rgnHz = ParseDstRegion(dst);
+    Type dty = ParseDstType(dst);
+    if (kind == "RD" || kind == "RM") {
+      RegName rn;
+      RegRef reg;
+      ParseReg(Member(dst, "reg"), rn, reg);
+      if (kind == "RM" || m_builder.isMacroOp()) {
+        m_builder.InstDstOpRegMathMacroExtReg(
+            dst.loc, rn, reg.regNum, ParseMathMacroExt(dst), rgnHz, dty);
+      } else {
+        m_builder.InstDstOpRegDirect(dst.loc, rn, reg, rgnHz, dty);
+      }
+    } else if (kind == "RI") {
+      int addrOff;
+      RegRef addrReg = ParseIndAddr(dst, addrOff);
+      m_builder.InstDstOpRegIndirect(dst.loc, addrReg, addrOff, rgnHz, dty);
+    } else {
+      Fail(Member(dst, "kind").loc, "invalid destination operand kind");
+    }
+  }
+
+  // areg:{rn:"a",...}, aoff:16
+  RegRef ParseIndAddr(const JSONValue &op, int &addrOff) {
+    RegName rn;
+    RegRef addrReg;
+    ParseReg(Member(op, "areg"), rn, addrReg);
+    if (rn != RegName::ARF_A) {
+      Fail(Member(op, "areg").loc, "expected address subregister");
+    }
+    int64_t off = MemberInt(op, "aoff");
+    int64_t offMin = platform() >= Platform::XE_HPC ? -1024 : -512;
+    int64_t offMax = platform() >= Platform::XE_HPC ? 1023 : 511;
+    if (off < offMin || off > offMax) {
+      Fail(Member(op, "aoff").loc,
+           "immediate offset is out of range; must be in [", offMin, ",",
+           offMax, "]");
+    }
+    addrOff = (int)off;
+    return addrReg;
+  }
+
+  // src:{kind:"RD"|"RM"|"RI"|"IM"|"LB", ...}
+  void ParseSrcOp(int srcIx, const JSONValue &src) {
+    if (!src.isObject()) {
+      Fail(src.loc, "source operand must be an object");
+    }
+    const std::string &kind = MemberString(src, "kind");
+    if (kind == "RD" || kind == "RM") {
+      SrcModifier sm = ParseSrcModifier(src);
+      RegName rn;
+      RegRef reg;
+      const RegInfo *ri = ParseReg(Member(src, "reg"), rn, reg);
+      Region rgn = ParseSrcOpRegion(srcIx, src, *ri, reg.subRegNum != 0);
+      Type sty = ParseSrcType(srcIx, src, false);
+      if (kind == "RM" || m_builder.isMacroOp()) {
+        m_builder.InstSrcOpRegMathMacroExtReg(srcIx, src.loc, sm, rn,
+                                              reg.regNum,
+                                              ParseMathMacroExt(src), rgn,
+                                              sty);
+      } else {
+        m_builder.InstSrcOpRegDirect(srcIx, src.loc, sm, rn, reg, rgn, sty);
+      }
+    } else if (kind == "RI") {
+      SrcModifier sm = ParseSrcModifier(src);
+      int addrOff;
+      RegRef addrReg = ParseIndAddr(src, addrOff);
+      Region rgn;
+      const JSONValue *rgnVal = OptMember(src, "rgn");
+      if (m_opSpec->hasImplicitSrcRegion(srcIx, m_execSize,
+                                         m_builder.isMacroOp())) {
+        rgn = m_opSpec->implicitSrcRegion(srcIx, m_execSize,
+                                          m_builder.isMacroOp());
+      } else if (rgnVal) {
+        rgn = ParseSrcRegion(*rgnVal);
+      } else {
+        rgn = Region::SRC110;
+      }
+      Type sty = ParseSrcType(srcIx, src, true);
+      m_builder.InstSrcOpRegIndirect(srcIx, src.loc, sm, RegName::GRF_R,
+                                     addrReg, addrOff, rgn, sty);
+    } else if (kind == "IM") {
+      Type sty = ParseSrcType(srcIx, src, true);
+      const JSONValue &valVal = Member(src, "value");
+      ImmVal val = ParseImmValue(valVal, sty);
+      if (m_opSpec->isBranching()) {
+        if (m_opSpec->isJipAbsolute()) {
+          m_builder.InstSrcOpImmLabelAbsolute(srcIx, src.loc, val.s64, sty);
+        } else {
+          m_builder.InstSrcOpImmLabelRelative(srcIx, src.loc, val.s64, sty);
+        }
+      } else {
+        m_builder.InstSrcOpImmValue(srcIx, src.loc, val, sty);
+      }
+    } else if (kind == "LB") {
+      if (!m_opSpec->isBranching() && m_opSpec->op != Op::MOV) {
+        Fail(src.loc, "labels are only allowed on branches and mov");
+      }
+      Type sty = ParseSrcType(srcIx, src, true, true);
+      m_builder.InstSrcOpImmLabel(srcIx, src.loc,
+                                  MemberString(src, "target"), sty);
+    } else {
+      Fail(Member(src, "kind").loc, "invalid source operand kind");
+    }
+  }
+
+  // c.f. KernelParser::ParseSrcOpRegion{VWH,VH,H}
+  Region ParseSrcOpRegion(int srcIx, const JSONValue &src, const RegInfo &ri,
+                          bool hasSubreg) {
+    if (m_opSpec->hasImplicitSrcRegion(srcIx, m_execSize,
+                                       m_builder.isMacroOp())) {
+      return m_opSpec->implicitSrcRegion(srcIx, m_execSize,
+                                         m_builder.isMacroOp());
+    }
+    const JSONValue *rgnVal = OptMember(src, "rgn");
+    bool scalarAccess = hasSubreg || m_execSize == ExecSize::SIMD1;
+    if (m_opSpec->isTernary()) {
+      // FormatJSON normalizes ternary regions to <V;W,H>:
+      // src0 and src1 are <V;H> and src2 <H> is <H;1,0>
+      Region rgn;
+      rgn.bits = 0;
+      if (!rgnVal) {
+        if (srcIx < 2)
+          rgn = scalarAccess               ? Region::SRC0X0
+                : platform() >= Platform::XE ? Region::SRC1X0
+                                             : Region::SRC2X1;
+        else
+          rgn = scalarAccess ? Region::SRCXX0 : Region::SRCXX1;
+      } else {
+        Region vwh = ParseSrcRegion(*rgnVal);
+        if (vwh.getVt() == Region::Vert::VT_VxH) {
+          Fail(rgnVal->loc, "invalid region for ternary operand");
+        }
+        if (srcIx < 2) {
+          rgn.set(vwh.getVt(), Region::Width::WI_INVALID, vwh.getHz());
+        } else {
+          if (vwh.v != 0 && vwh.v != 1 && vwh.v != 2 && vwh.v != 4) {
+            Fail(rgnVal->loc, "invalid region for src2");
+          }
+          rgn.set(Region::Vert::VT_INVALID, Region::Width::WI_INVALID,
+                  (Region::Horz)vwh.v);
+        }
+      }
+      return rgn;
+    }
+    if (rgnVal) {
+      return ParseSrcRegion(*rgnVal);
+    } else if (m_builder.isMacroOp()) {
+      return Region::SRC110;
+    } else if (ri.supportsRegioning()) {
+      // N.B. <1;1,0> won't coissue on PreGEN11
+      return scalarAccess ? Region::SRC010 : Region::SRC110;
+    }
+    return Region::SRC010;
+  }
+
+  // dpas operands are GRFs (or null src0) with implicit regions
+  void ParseDpasOp(int opIx, const JSONValue &op) {
+    if (!op.isObject()) {
+      Fail(op.loc, "operand must be an object");
+    }
+    if (MemberString(op, "kind") != "RD") {
+      Fail(Member(op, "kind").loc, "dpas operands must be registers");
+    }
+    if (opIx < 0 && OptMemberBool(op, "sat")) {
+      m_builder.InstDstOpSaturate();
+    }
+    RegName rn;
+    RegRef reg;
+    ParseReg(Member(op, "reg"), rn, reg);
+    if (rn != RegName::GRF_R && (opIx != 0 || rn != RegName::ARF_NULL)) {
+      Fail(op.loc, "src", opIx, ": invalid register",
+           opIx == 0 ? " (must be GRF or null)" : " (must be GRF)");
+    }
+    const JSONValue *tyVal = OptMember(op, "type");
+    if (!tyVal) {
+      Fail(op.loc, "invalid type");
+    }
+    Type ty = LookupType(*tyVal);
+    if (opIx == 1 && reg.subRegNum != 0) {
+      Warning(op.loc, "src1 subregister must be GRF aligned for this op");
+    }
+    if (opIx < 0) {
+      m_builder.InstDpasDstOp(op.loc, rn, reg, ty);
+    } else {
+      m_builder.InstDpasSrcOp(opIx, op.loc, rn, reg, ty);
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+  // immediates
+  //
+  // decimal (with an optional '-') or 0x hex; returns two's complement bits
+  static bool ParseInteger(const std::string &s, uint64_t &val) {
+    const char *p = s.c_str();
+    bool neg = *p == '-';
+    if (neg)
+      p++;
+    if (!isdigit((unsigned char)*p))
+      return false;
+    int base = 10;
+    if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+      base = 16;
+      p += 2;
+      if (!isxdigit((unsigned char)*p))
+        return false;
+    }
+    char *end = nullptr;
+    errno = 0;
+    val = strtoull(p, &end, base);
+    if (*end != 0 || errno != 0)
+      return false;
+    if (neg)
+      val = (uint64_t)(-(int64_t)val);
+    return true;
+  }
+
+  // FormatFloat's output: decimal, [-]inf, [-](q|s)nan(0x..); F is the
+  // fp format's bit pattern type
+  template <typename F>
+  bool ParseFloatBits(const std::string &s, int mantBits, int expBits,
+                      double &d, F &bits, bool &isBits) {
+    const char *p = s.c_str();
+    bool neg = *p == '-';
+    const char *q = neg ? p + 1 : p;
+    const F SIGN = (F)1 << (mantBits + expBits);
+    const F EXP = (((F)1 << expBits) - 1) << mantBits;
+    const F QNAN = (F)1 << (mantBits - 1);
+    isBits = true;
+    if (strcmp(q, "inf") == 0) {
+      bits = (neg ? SIGN : 0) | EXP;
+      return true;
+    } else if (strncmp(q, "qnan(", 5) == 0 || strncmp(q, "snan(", 5) == 0) {
+      std::string payload(q + 5);
+      uint64_t pl = 0;
+      if (payload.empty() || payload.back() != ')' ||
+          !ParseInteger(payload.substr(0, payload.size() - 1), pl) ||
+          pl >= (uint64_t)QNAN) {
+        return false;
+      }
+      bool quiet = q[0] == 'q';
+      if (!quiet && pl == 0) {
+        return false; // snan needs a payload (else it's inf)
+      }
+      bits = (neg ? SIGN : 0) | EXP | (quiet ? QNAN : 0) | (F)pl;
+      return true;
+    }
+    isBits = false;
+    return ParseFLTLIT(s, d);
+  }
+
+  ImmVal ParseImmValue(const JSONValue &valVal, Type sty) {
+    if (!valVal.isString()) {
+      Fail(valVal.loc, "immediate \"value\" must be a string");
+    }
+    const std::string &s = valVal.s;
+    ImmVal val;
+    uint64_t bits = 0;
+    bool isInt = ParseInteger(s, bits);
+    switch (sty) {
+    case Type::HF: {
+      uint16_t f16 = 0;
+      double d = 0.0;
+      bool isBits = false;
+      if (isInt) {
+        if (bits & ~0xFFFFull)
+          Fail(valVal.loc, "hex literal too big for type");
+        f16 = (uint16_t)bits;
+      } else if (!ParseFloatBits<uint16_t>(s, 10, 5, d, f16, isBits)) {
+        Fail(valVal.loc, "invalid floating point literal");
+      } else if (!isBits) {
+        f16 = ConvertDoubleToHalf(d);
+      }
+      val.u64 = f16;
+      val.kind = ImmVal::Kind::F16;
+      break;
+    }
+    case Type::F:
+    case Type::TF32: {
+      uint32_t f32 = 0;
+      double d = 0.0;
+      bool isBits = false;
+      if (isInt) {
+        f32 = (uint32_t)bits;
+      } else if (!ParseFloatBits<uint32_t>(s, 23, 8, d, f32, isBits)) {
+        Fail(valVal.loc, "invalid floating point literal");
+      } else if (!isBits) {
+        f32 = ConvertDoubleToFloatBits(d);
+      }
+      val.u64 = f32;
+      val.kind = ImmVal::Kind::F32;
+      break;
+    }
+    case Type::DF: {
+      uint64_t f64 = 0;
+      double d = 0.0;
+      bool isBits = false;
+      if (isInt) {
+        f64 = bits;
+      } else if (!ParseFloatBits<uint64_t>(s, 52, 11, d, f64, isBits)) {
+        Fail(valVal.loc, "invalid floating point literal");
+      } else if (!isBits) {
+        f64 = FloatToBits(d);
+      }
+      val.u64 = f64;
+      val.kind = ImmVal::Kind::F64;
+      break;
+    }
+    case Type::BF:
+      // KernelParser rejects these too
+      Fail(valVal.loc, "Imm operand with BF type is not allowed");
+    default:
+      if (!isInt) {
+        Fail(valVal.loc, "literal must be integral for type ",
+             ToSyntax(sty));
+      }
+      val.u64 = bits;
+      val.kind = ImmVal::Kind::S64;
+      break;
+    }
+
+    // narrow integers as KernelParser does
+    switch (sty) {
+    case Type::B:
+      val.s64 = val.s8;
+      val.kind = ImmVal::Kind::S8;
+      break;
+    case Type::UB:
+      val.u64 = val.u8;
+      val.kind = ImmVal::Kind::U8;
+      break;
+    case Type::W:
+      val.s64 = val.s16;
+      val.kind = ImmVal::Kind::S16;
+      break;
+    case Type::UW:
+      val.u64 = val.u16;
+      val.kind = ImmVal::Kind::U16;
+      break;
+    case Type::D:
+      val.s64 = val.s32;
+      val.kind = ImmVal::Kind::S32;
+      break;
+    case Type::UD:
+    case Type::UV:
+    case Type::V:
+    case Type::VF:
+      val.u64 = val.u32;
+      val.kind = ImmVal::Kind::U32;
+      break;
+    case Type::UQ:
+      val.kind = ImmVal::Kind::U64;
+      break;
+    default:
+      break;
+    }
+    return val;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+  // sends
+  //
+  // srcs holds the payloads followed by ExDesc and Desc
+  void ParseSendOperands(const JSONValue &inst, const JSONValue *dst,
+                         const JSONValue &srcs) {
+    int nSrcs = m_opSpec->format == OpSpec::SEND_UNARY ? 1 : 2;
+    if ((int)srcs.elems.size() != nSrcs + 2) {
+      Fail(srcs.loc, m_opSpec->mnemonic.str(), " expects ", nSrcs,
+           " payload operands followed by ExDesc and Desc");
+    }
+    if (!dst) {
+      Fail(inst.loc, "send needs a destination");
+    }
+    ParseSendDstOp(*dst);
+
+    int src1Len = -1;
+    for (int srcIx = 0; srcIx < nSrcs; srcIx++) {
+      ParseSendSrcOp(srcIx, srcs.elems[srcIx], src1Len);
+    }
+
+    const JSONValue &exDescVal = srcs.elems[nSrcs];
+    const JSONValue &descVal = srcs.elems[nSrcs + 1];
+    SendDesc exDesc = ParseSendDesc(exDescVal);
+    SendDesc desc = ParseSendDesc(descVal);
+
+    bool hasExBSO = false;
+    if (const JSONValue *opts = OptMember(inst, "opts")) {
+      for (const JSONValue &o : opts->elems)
+        hasExBSO |= o.isString() && o.s == "ExBSO";
+    }
+    bool needsSrc1Len = false;
+    if (platform() >= Platform::XE_HP) {
+      if (exDesc.isReg()) {
+        needsSrc1Len = hasExBSO;
+      } else if (platform() >= Platform::XE_HPG) {
+        // XeHPG+: Src1.Length is not part of ExDesc for ExDesc.IsImm,
+        // but are explicit bits in the EU ISA.
+        needsSrc1Len = true;
+        if (src1Len < 0) {
+          Warning(exDescVal.loc, "Src1.Length should be given on src1 "
+                                 "(e.g. {\"kind\":\"DA\", ..., \"len\":4})");
+          src1Len = (int)(exDesc.imm >> 6) & 0x1F;
+        }
+        if (exDesc.imm & 0x7FF) {
+          Warning(exDescVal.loc, "ExDesc[10:0] must be zero");
+          exDesc.imm &= ~0x7FF; // [10:0] MBZ
+        }
+      }
+    }
+    if (exDesc.isImm() && platform() >= Platform::XE && (exDesc.imm & 0xF)) {
+      Fail(exDescVal.loc, "ExDesc[3:0] must be 0's; SFID is expressed "
+                          "as a function control value (e.g. \"subop\":"
+                          "\"dc0\")");
+    }
+    if (hasExBSO && src1Len < 0) {
+      Fail(srcs.elems[nSrcs - 1].loc,
+           "send with ExBSO option should have Src1.Length");
+    } else if (hasExBSO && exDesc.isImm()) {
+      Fail(exDescVal.loc, "send with immediate exdesc forbids ExBSO");
+    }
+    if (platform() < Platform::XE) {
+      // the SFID lives in ExDesc
+      m_builder.InstSubfunction(exDesc.isReg()
+                                    ? SFID::A0REG
+                                    : sfidFromEncoding(platform(),
+                                                       exDesc.imm & 0xF));
+    }
+
+    m_builder.InstSendDescs(exDescVal.loc, exDesc, descVal.loc, desc);
+    if (needsSrc1Len) {
+      m_builder.InstSendSrc1Length(src1Len);
+    }
+  }
+
+  Type SendOperandDefaultType(int srcIx) const {
+    auto t = srcIx == 1 ? Type::INVALID : Type::UD;
+    if (srcIx < 0) {
+      if (m_opSpec->hasImplicitDstType())
+        t = m_opSpec->implicitDstType();
+    } else {
+      if (m_opSpec->hasImplicitSrcType(srcIx, false))
+        t = m_opSpec->implicitSrcType(srcIx, false);
+    }
+    return t;
+  }
+
+  // dst:{kind:"DA", reg, len} or {kind:"RD", reg}
+  void ParseSendDstOp(const JSONValue &dst) {
+    if (!dst.isObject()) {
+      Fail(dst.loc, "\"dst\" must be an object");
+    }
+    const std::string &kind = MemberString(dst, "kind");
+    if (kind != "DA" && kind != "RD") {
+      Fail(Member(dst, "kind").loc, "invalid send destination kind");
+    }
+    RegName rn;
+    RegRef reg;
+    ParseReg(Member(dst, "reg"), rn, reg);
+    Region::Horz rgnHz = ParseDstRegion(dst);
+    m_builder.InstDstOpRegDirect(dst.loc, rn, reg, rgnHz,
+                                 SendOperandDefaultType(-1));
+  }
+
+  // src0: {kind:"AD", addr:{reg,len}, ...} or {kind:"RD", reg}
+  // src1: {kind:"DA", reg, len} or {kind:"RD", reg}
+  void ParseSendSrcOp(int srcIx, const JSONValue &src, int &src1Len) {
+    if (!src.isObject()) {
+      Fail(src.loc, "send operand must be an object");
+    }
+    const std::string &kind = MemberString(src, "kind");
+    const JSONValue *payload = &src;
+    if (kind == "AD") {
+      payload = &MemberObject(src, "addr");
+    } else if (kind != "DA" && kind != "RD") {
+      Fail(Member(src, "kind").loc, "invalid send operand kind");
+    }
+    RegName rn;
+    RegRef reg;
+    ParseReg(Member(*payload, "reg"), rn, reg);
+    if (srcIx == 1 && kind == "DA") {
+      int64_t len = MemberInt(*payload, "len");
+      if (len < 0 || len > 0x1F) {
+        Fail(Member(*payload, "len").loc, "Src1.Length is out of range");
+      } else if (reg.regNum + len - 1 > 255) {
+        Fail(Member(*payload, "len").loc, "Src1.Length extends past GRF end");
+      }
+      src1Len = (int)len;
+    }
+
+    Region rgn;
+    bool xeHpSrc1 = srcIx == 1 && platform() >= Platform::XE_HP;
+    if (xeHpSrc1 && rn != RegName::ARF_NULL && rn != RegName::GRF_R) {
+      Fail(src.loc, "invalid src1 register");
+    }
+    if (m_opSpec->hasImplicitSrcRegion(srcIx, m_execSize, false)) {
+      rgn = m_opSpec->implicitSrcRegion(srcIx, m_execSize, false);
+    } else if (xeHpSrc1 || rn == RegName::ARF_NULL) {
+      rgn = Region::SRC010;
+    } else {
+      rgn = Region::SRC110;
+    }
+    m_builder.InstSrcOpRegDirect(srcIx, src.loc, SrcModifier::NONE, rn, reg,
+                                 rgn, SendOperandDefaultType(srcIx));
+  }
+
+  // {kind:"IM", value:"0x..."} or {kind:"RD", reg:{rn:"a",...}}
+  SendDesc ParseSendDesc(const JSONValue &descVal) {
+    if (!descVal.isObject()) {
+      Fail(descVal.loc, "send descriptor must be an object");
+    }
+    const std::string &kind = MemberString(descVal, "kind");
+    SendDesc sd;
+    if (kind == "IM") {
+      uint64_t imm = 0;
+      const JSONValue &v = Member(descVal, "value");
+      if (!v.isString() || !ParseInteger(v.s, imm) || imm > 0xFFFFFFFFull) {
+        Fail(v.loc, "invalid send descriptor");
+      }
+      sd.type = SendDesc::Kind::IMM;
+      sd.imm = (uint32_t)imm;
+    } else if (kind == "RD") {
+      RegName rn;
+      RegRef reg;
+      ParseReg(Member(descVal, "reg"), rn, reg);
+      if (rn != RegName::ARF_A) {
+        Fail(descVal.loc, "send descriptor register must be a0");
+      }
+      sd.type = SendDesc::Kind::REG32A;
+      sd.reg = reg;
+    } else {
+      Fail(Member(descVal, "kind").loc, "invalid send descriptor kind");
+    }
+    return sd;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+  // instruction options and SWSB
+  //
+  // opts:["AccWrEn","NoAccSBSet",...]
+  void ParseInstOpts(const JSONValue &inst) {
+    const JSONValue *opts = OptMember(inst, "opts");
+    if (!opts)
+      return;
+    if (!opts->isArray()) {
+      Fail(opts->loc, "\"opts\" must be an array");
+    }
+    InstOptSet instOpts;
+    instOpts.clear();
+    for (const JSONValue &o : opts->elems) {
+      if (o.isString() && o.s == "NoAccSBSet") {
+        m_builder.InstDepInfoSpecialToken(o.loc,
+                                          SWSB::SpecialToken::NOACCSBSET);
+        continue;
+      }
+      auto itr = o.isString() ? m_instOpts.find(o.s) : m_instOpts.end();
+      if (itr == m_instOpts.end()) {
+        Fail(o.loc, "invalid instruction option");
+      }
+      InstOpt io = itr->second;
+      if ((io == InstOpt::EOT || io == InstOpt::EXBSO ||
+           io == InstOpt::CPS) &&
+          !m_opSpec->isAnySendFormat()) {
+        Fail(o.loc, o.s, " is only allowed on send instructions");
+      } else if (io == InstOpt::ACCWREN && platform() >= Platform::XE_HPC) {
+        Fail(o.loc, "AccWrEn not supported on this platform");
+      }
+      if (!instOpts.add(io)) {
+        Fail(o.loc, "duplicate instruction options");
+      }
+    }
+    if (instOpts.contains(InstOpt::COMPACTED) &&
+        instOpts.contains(InstOpt::NOCOMPACT)) {
+      Fail(opts->loc, "Compacted mutually exclusive with NoCompact");
+    }
+    m_builder.InstOptsAdd(instOpts);
+  }
+
+  // regDist:"@3"|"A@1"|"F@2"|..., sbid:"$4"|"$4.dst"|"$4.src"
+  void ParseDepInfo(const JSONValue &inst) {
+    const JSONValue *regDist = OptMember(inst, "regDist");
+    const JSONValue *sbid = OptMember(inst, "sbid");
+    if ((regDist || sbid) && m_model.supportsHwDeps()) {
+      Fail(regDist ? regDist->loc : sbid->loc,
+           "software dependencies not supported on this platform");
+    }
+    if (regDist) {
+      const std::string &s = regDist->isString() ? regDist->s : "";
+      size_t at = s.find('@');
+      uint64_t dist = 0;
+      if (at == std::string::npos || at > 1 ||
+          !ParseInteger(s.substr(at + 1), dist) || dist == 0 || dist > 7) {
+        Fail(regDist->loc, "invalid register distance");
+      }
+      SWSB::DistType dt = SWSB::DistType::REG_DIST;
+      if (at == 1) {
+        switch (s[0]) {
+        case 'A':
+          dt = SWSB::DistType::REG_DIST_ALL;
+          break;
+        case 'F':
+          dt = SWSB::DistType::REG_DIST_FLOAT;
+          break;
+        case 'I':
+          dt = SWSB::DistType::REG_DIST_INT;
+          break;
+        case 'L':
+          dt = SWSB::DistType::REG_DIST_LONG;
+          break;
+        case 'M':
+          dt = SWSB::DistType::REG_DIST_MATH;
+          break;
+        default:
+          Fail(regDist->loc, "invalid register distance pipe");
+        }
+        if (m_opts.swsbEncodeMode < SWSB_ENCODE_MODE::ThreeDistPipe) {
+          Fail(regDist->loc, "register distance pipes are not supported "
+                             "on this platform");
+        }
+      }
+      m_builder.InstDepInfoDist(regDist->loc, dt, (uint32_t)dist);
+    }
+    if (sbid) {
+      const std::string &s = sbid->isString() ? sbid->s : "";
+      size_t dot = s.find('.');
+      uint64_t id = 0;
+      if (s.empty() || s[0] != '$' ||
+          !ParseInteger(s.substr(1, dot == std::string::npos ? dot : dot - 1),
+                        id) ||
+          id >= 32) {
+        Fail(sbid->loc, "invalid SBID");
+      }
+      std::string sfx = dot == std::string::npos ? "" : s.substr(dot);
+      if (sfx.empty()) {
+        m_builder.InstDepInfoSBidAlloc(sbid->loc, (int32_t)id);
+      } else if (sfx == ".dst") {
+        m_builder.InstDepInfoSBidDst(sbid->loc, (int32_t)id);
+      } else if (sfx == ".src") {
+        m_builder.InstDepInfoSBidSrc(sbid->loc, (int32_t)id);
+      } else {
+        Fail(sbid->loc, "invalid SBID directive expecting 'dst' or 'src'");
+      }
+    }
+  }
+}; // class JSONKernelParser
+
+Kernel *iga::ParseJSONKernel(const Model &m, const char *inp,
+                             iga::ErrorHandler &e, const ParseOpts &popts) {
+  Kernel *k = new Kernel(m);
+
+  InstBuilder h(k, e);
+  if (popts.swsbEncodeMode != SWSB_ENCODE_MODE::SWSBInvalidMode)
+    h.setSWSBEncodingMode(popts.swsbEncodeMode);
+
+  JSONKernelParser p(m, h, inp, e, popts);
+  try {
+    p.ParseListing();
+  } catch (const SyntaxError &s) {
+    // errors in the JSON itself haven't been reported yet
+    bool reported = false;
+    for (const auto &d : e.getErrors())
+      reported |= d.at.offset == s.loc.offset && d.message == s.message;
+    if (!reported)
+      e.reportError(s.loc, s.message);
+    delete k;
+    return nullptr;
+  }
+
+  auto &insts = h.getInsts();
+  auto blockStarts = Block::inferBlocks(e, k->getMemManager(), insts);
+  int id = 0;
+  for (auto bitr : blockStarts) {
+    bitr.second->setID(id++);
+    k->appendBlock(bitr.second);
+  }
+
+  return k;
+}
+
+bool iga::LooksLikeJSONKernel(const char *inp) {
+  while (isspace((unsigned char)*inp))
+    inp++;
+  return *inp == '{';
+}
@@ -0,0 +1,26 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#ifndef IGA_FRONTEND_KERNELPARSERJSON_HPP
+#define IGA_FRONTEND_KERNELPARSERJSON_HPP
+
+#include "KernelParser.hpp"
+
+namespace iga {
+// Parses a listing in the format FormatJSON emits (c.f. IGAJSON.md) back
+// into a kernel.  The analysis fields (defs, comments, encodings, ...)
+// are ignored.  Like ParseGenKernel, returns nullptr if parsing gives up.
+Kernel *ParseJSONKernel(const Model &model, const char *inp, ErrorHandler &e,
+                        const ParseOpts &popts);
+
+// true if the input should be parsed as a JSON listing: the first
+// non-space character opens an object, which assembly can't start with
+bool LooksLikeJSONKernel(const char *inp);
+} // namespace iga
+
+#endif // IGA_FRONTEND_KERNELPARSERJSON_HPP
@@ -26,6 +26,9 @@ Kernel::~Kernel() {
   for (Block *bb : m_blocks) {
     bb->~Block();
   }
+  for (Kernel *k : m_adopted) {
+    delete k;
+  }
 }
 
 void Kernel::resetIds() {
@@ -58,6 +61,11 @@ Block *Kernel::createBlock() { return new (&m_mem) Block(); }
 
 void Kernel::appendBlock(Block *blk) { m_blocks.push_back(blk); }
 
+void Kernel::adoptMemory(Kernel *k) {
+  IGA_ASSERT(k->m_blocks.empty(), "adopted kernel must have no blocks");
+  m_adopted.push_back(k);
+}
+
 Instruction *
 Kernel::createBasicInstruction(const OpSpec &os, const Predication &predOpnd,
                                const RegRef &freg, ExecSize execSize,
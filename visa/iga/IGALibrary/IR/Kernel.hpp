@@ -20,6 +20,7 @@ SPDX-License-Identifier: MIT
 #include "Instruction.hpp"
 
 #include <list>
+#include <vector>
 
 namespace iga {
 typedef std::list<iga::Block *, std_arena_based_allocator<iga::Block *>>
@@ -51,6 +52,12 @@ public:
   Block *createBlock();
   void appendBlock(Block *blk);
 
+  // Takes ownership of a kernel that created some of the instructions of
+  // this one (e.g. one per thread in a parallel decode) so that their
+  // memory lives as long as this kernel. The other kernel must have no
+  // blocks; the instructions are destroyed with the blocks of this one.
+  void adoptMemory(Kernel *k);
+
   // Instruction constructors, the instruction returned must be appended
   // to a block or some other storage
   Instruction *createBasicInstruction(const OpSpec &op, const Predication &pred,
@@ -86,6 +93,7 @@ private:
   MemManager m_mem;
 
   BlockList m_blocks;
+  std::vector<Kernel *> m_adopted;
 };
 } // namespace iga
 
@@ -15,6 +15,7 @@ SPDX-License-Identifier: MIT
 #include "../ErrorHandler.hpp"
 #include "../Frontend/Formatter.hpp"
 #include "../Frontend/KernelParser.hpp"
+#include "../Frontend/KernelParserJSON.hpp"
 #include "../IR/Checker/IRChecker.hpp"
 #include "../IR/DUAnalysis.hpp"
 #include "../Models/Models.hpp"
@@ -27,6 +28,7 @@ SPDX-License-Identifier: MIT
 #include <algorithm>
 #include <cstring>
 #include <map>
+#include <memory>
 #include <ostream>
 #include <sstream>
 #include <unordered_map>
@@ -198,6 +200,11 @@ private:
   char *m_disassemble_text;
   // a reusable empty string to return on errors
   char m_empty_string[4];
+  // the disassembler of the streaming calls and the handler it reports to;
+  // kept so repeated calls (e.g. one per instruction) reuse its decoder,
+  // scratch kernel and buffers
+  iga::ErrorHandler m_streamErrors;
+  std::unique_ptr<StreamDisassembler> m_streamDisassembler;
 
   // diagnostics from the last compile
   bool m_errorsValid, m_warningsValid;
@@ -320,7 +327,10 @@ public:
     ParseOpts popts(m_model);
     popts.supportLegacyDirectives =
         (aopts.syntax_opts & IGA_SYNTAX_OPT_LEGACY_SYNTAX) != 0;
-    Kernel *pKernel = iga::ParseGenKernel(m_model, inp, errHandler, popts);
+    Kernel *pKernel =
+        iga::LooksLikeJSONKernel(inp)
+            ? iga::ParseJSONKernel(m_model, inp, errHandler, popts)
+            : iga::ParseGenKernel(m_model, inp, errHandler, popts);
     if (pKernel && !errHandler.hasErrors() && aopts.enabled_warnings) {
       // check semantics if we parsed without error && they haven't
       // disabled all checking (-Wnone)
@@ -565,6 +575,111 @@ public:
     return st;
   }
 
+  // the cached stream disassembler reset to new bits
+  StreamDisassembler &streamDisassembler(const FormatOpts &fopts,
+                                         const void *bits, uint32_t bitsLen) {
+    if (!m_streamDisassembler) {
+      m_streamDisassembler.reset(
+          new StreamDisassembler(m_streamErrors, fopts, bits, bitsLen));
+    } else {
+      m_streamDisassembler->reset(fopts, bits, bitsLen);
+    }
+    return *m_streamDisassembler;
+  }
+
+  // the streaming calls have no kernel IR for these to work on
+  static bool isStreamable(const iga_disassemble_options_t &dopts) {
+    return (dopts.formatting_opts & IGA_FORMATTING_OPT_PRINT_DEFS) == 0 &&
+           (dopts.decoder_opts & IGA_DECODING_OPT_NATIVE) == 0;
+  }
+
+  iga_status_t disassembleStream(iga_disassemble_options_t &dopts,
+                                 const void *bits, uint32_t bitsLen,
+                                 const char *(*formatLbl)(int32_t, void *),
+                                 void *formatLblEnv,
+                                 iga_disassemble_stream_callback_t callback,
+                                 void *env) {
+    iga::ErrorHandler &errHandler = m_streamErrors;
+    errHandler = iga::ErrorHandler();
+    checkForLegacyFields(dopts, errHandler);
+    if (!isStreamable(dopts))
+      return IGA_INVALID_ARG;
+
+    bool stopped = false;
+    if (bitsLen != 0 && bitsLen < 8) {
+      // as iga::Decoder::decodeKernel
+      errHandler.reportError(Loc((PC)0), "binary size is too small");
+    } else {
+      FormatOpts fopts = formatterOpts(dopts, formatLbl, formatLblEnv);
+      StreamDisassembler &sd = streamDisassembler(fopts, bits, bitsLen);
+      if (!fopts.numericLabels)
+        sd.scanLabels();
+      const std::vector<int32_t> &labels = sd.getLabels();
+      auto lbl = labels.begin();
+      size_t len = 0;
+      auto emitLabelsUpTo = [&](int64_t pc) {
+        for (; !stopped && lbl != labels.end() && *lbl <= pc; lbl++) {
+          const char *name = sd.formatLabel(*lbl, len);
+          stopped = callback(env, *lbl, name, nullptr) != 0;
+        }
+      };
+
+      int32_t pc = 0, iLen;
+      int id = 1; // as a full decode numbers them
+      while (!stopped && (iLen = sd.instructionLength(pc)) != 0) {
+        emitLabelsUpTo(pc);
+        if (!stopped) {
+          const char *text = sd.formatInstructionAt(pc, len, id++);
+          stopped = callback(env, pc, nullptr, text) != 0;
+        }
+        pc += iLen;
+      }
+      if (!stopped && (uint32_t)pc < bitsLen) {
+        errHandler.reportWarning(Loc((PC)pc),
+                                 "unexpected padding at end of kernel");
+      }
+      // labels at the end of (or beyond) the kernel
+      emitLabelsUpTo(INT64_MAX);
+    }
+
+    iga_status_t st = translateDiagnostics(errHandler);
+    if (stopped)
+      return IGA_ERROR;
+    if (errHandler.hasErrors())
+      return IGA_DECODE_ERROR;
+    return st;
+  }
+
+  iga_status_t disassembleInstructionAt(
+      iga_disassemble_options_t &dopts, const void *bits, uint32_t bitsLen,
+      uint32_t pc, const char *(*formatLbl)(int32_t, void *),
+      void *formatLblEnv, char *buf, size_t bufLen, size_t *textLen) {
+    iga::ErrorHandler &errHandler = m_streamErrors;
+    errHandler = iga::ErrorHandler();
+    checkForLegacyFields(dopts, errHandler);
+    if (!isStreamable(dopts))
+      return IGA_INVALID_ARG;
+
+    FormatOpts fopts = formatterOpts(dopts, formatLbl, formatLblEnv);
+    StreamDisassembler &sd = streamDisassembler(fopts, bits, bitsLen);
+    if (pc > (uint32_t)INT32_MAX || sd.instructionLength((int32_t)pc) == 0)
+      return IGA_INVALID_ARG;
+    size_t len = 0;
+    const char *text = sd.formatInstructionAt((int32_t)pc, len);
+    if (textLen)
+      *textLen = len;
+    if (bufLen > 0) {
+      size_t copyLen = std::min(len, bufLen - 1);
+      memcpy_s(buf, bufLen, text, copyLen);
+      buf[copyLen] = 0;
+    }
+
+    iga_status_t st = translateDiagnostics(errHandler);
+    if (errHandler.hasErrors())
+      return IGA_DECODE_ERROR;
+    return st;
+  }
+
   iga_status_t getErrors(const iga_diagnostic_t **ds, uint32_t *ds_len) const {
     if (!m_errorsValid) {
       *ds = nullptr;
@@ -733,6 +848,50 @@ iga_status_t iga_context_disassemble_instruction(
                                          fmt_label_ctx, kernel_text);
 }
 
+iga_status_t iga_context_disassemble_stream(
+    iga_context_t ctx, const iga_disassemble_options_t *dopts,
+    const void *input, uint32_t input_size,
+    const char *(*fmt_label_name)(int32_t, void *), void *fmt_label_ctx,
+    iga_disassemble_stream_callback_t callback, void *env) {
+  RETURN_INVALID_ARG_ON_NULL(ctx);
+  RETURN_INVALID_ARG_ON_NULL(dopts);
+  if (input == nullptr && input_size != 0)
+    return IGA_INVALID_ARG;
+  RETURN_INVALID_ARG_ON_NULL(callback);
+  if (dopts->cb > sizeof(*dopts)) {
+    return IGA_VERSION_ERROR;
+  }
+  iga_disassemble_options_t doptsInternal = IGA_DISASSEMBLE_OPTIONS_INIT();
+  memcpy_s(&doptsInternal, dopts->cb, dopts, dopts->cb);
+
+  CAST_CONTEXT(ctx_obj, ctx);
+  return ctx_obj->disassembleStream(doptsInternal, input, input_size,
+                                    fmt_label_name, fmt_label_ctx, callback,
+                                    env);
+}
+
+iga_status_t iga_context_disassemble_instruction_at(
+    iga_context_t ctx, const iga_disassemble_options_t *dopts,
+    const void *input, uint32_t input_size, uint32_t pc,
+    const char *(*fmt_label_name)(int32_t, void *), void *fmt_label_ctx,
+    char *buf, size_t buf_len, size_t *text_len) {
+  RETURN_INVALID_ARG_ON_NULL(ctx);
+  RETURN_INVALID_ARG_ON_NULL(dopts);
+  RETURN_INVALID_ARG_ON_NULL(input);
+  if (buf == nullptr && buf_len != 0)
+    return IGA_INVALID_ARG;
+  if (dopts->cb > sizeof(*dopts)) {
+    return IGA_VERSION_ERROR;
+  }
+  iga_disassemble_options_t doptsInternal = IGA_DISASSEMBLE_OPTIONS_INIT();
+  memcpy_s(&doptsInternal, dopts->cb, dopts, dopts->cb);
+
+  CAST_CONTEXT(ctx_obj, ctx);
+  return ctx_obj->disassembleInstructionAt(doptsInternal, input, input_size,
+                                           pc, fmt_label_name, fmt_label_ctx,
+                                           buf, buf_len, text_len);
+}
+
 iga_status_t iga_context_get_errors(iga_context_t ctx,
                                     const iga_diagnostic_t **ds,
                                     uint32_t *ds_len) {
@@ -331,7 +331,9 @@ static_assert(sizeof(iga_assemble_options_t) == 8 * 4,
  *  ctx           the iga context
  *  opts          the assemble options
  *  kernel_text   a NUL-terminated string containing the kernel text
- *                to assemble
+ *                to assemble; text starting with '{' is read as a JSON
+ *                listing (IGA_FORMATTING_OPT_PRINT_JSON output; see
+ *                IGAJSON.md)
  *  output        the output assembly binary; upon failure, this is
  *                assigned NULL; this memory should not be modified
  *                or deallocated externally
@@ -527,6 +529,107 @@ IGA_API iga_status_t iga_disassemble_instruction(
     const void *input, const char *(*fmt_label_name)(int32_t, void *),
     void *fmt_label_ctx, char **kernel_text);
 
+/*
+ * A callback for 'iga_context_disassemble_stream'; called once per output
+ * line in PC order: for a label definition and then for the instruction.
+ *
+ *  env         the 'env' argument passed to 'iga_context_disassemble_stream'
+ *  pc          the PC of the label or instruction (relative to 'input')
+ *  label       the NUL-terminated label name (without ':') or NULL if this
+ *              call is for an instruction
+ *  inst_text   the NUL-terminated instruction text (without a newline) or
+ *              NULL if this call is for a label
+ *
+ * The strings are only valid during the call, and the callback must not
+ * disassemble with the same context.
+ * Return 0 to continue or non-zero to stop the disassembly.
+ */
+typedef int (*iga_disassemble_stream_callback_t)(void *env, int32_t pc,
+                                                 const char *label,
+                                                 const char *inst_text);
+
+/*
+ * Disassembles kernel bits one instruction at a time through a callback.
+ * Unlike 'iga_context_disassemble' this does not build the kernel in memory;
+ * each instruction is decoded, formatted and handed to 'callback' before the
+ * next is decoded.  Labels are found by a pre-scan that only decodes the
+ * branches and sends (skipped with IGA_FORMATTING_OPT_NUMERIC_LABELS).
+ * Emitting "label:" for label calls and the text of instruction calls, one
+ * per line, gives the same text as 'iga_context_disassemble'.
+ *
+ * With IGA_FORMATTING_OPT_PRINT_JSON each instruction call gets one JSON
+ * instruction object and each label call the label's name.  Emitting
+ * {"kind":"L","value":"<label>"} for labels and the instruction objects,
+ * comma separated, within {"version":...,"platform":...,"insts":[...]}
+ * rebuilds the listing; it can be assembled again as is.
+ *
+ * PARAMETERS:
+ *  ctx             an iga context
+ *  dopts           the disassemble options; IGA_FORMATTING_OPT_PRINT_DEFS
+ *                  and IGA_DECODING_OPT_NATIVE are not supported
+ *  input           the instructions to disassemble
+ *  input_size      the size of the 'input' in bytes
+ *  fmt_label_name  optional callback to resolve a PC to specific label
+ *                  (see 'iga_context_disassemble')
+ *  fmt_label_ctx   A callback context (environment) forwarded to 'fmt_label'
+ *  callback        called for each instruction (see above)
+ *  env             forwarded to 'callback'
+ *
+ * RETURNS:
+ *  IGA_SUCCESS         upon successful disassembly; 'iga_get_warnings' may
+ *                      contain warning diagnostics even upon success
+ *  IGA_INVALID_ARG     if an argument is NULL or an unsupported option is set;
+ *                      'input' may be NULL only if 'input_size' is also 0
+ *  IGA_INVALID_OBJECT  if ctx has already been destroyed
+ *  IGA_DECODE_ERROR    upon failure to decode error; specific error messages
+ *                      may be retrieved via 'iga_context_get_errors'; the
+ *                      callback has still seen all the instructions
+ *  IGA_ERROR           if the callback stopped the disassembly
+ */
+IGA_API iga_status_t iga_context_disassemble_stream(
+    iga_context_t ctx, const iga_disassemble_options_t *dopts,
+    const void *input, uint32_t input_size,
+    const char *(*fmt_label_name)(int32_t, void *), void *fmt_label_ctx,
+    iga_disassemble_stream_callback_t callback, void *env);
+
+/*
+ * Formats the instruction at a given PC of a kernel into a caller buffer
+ * without decoding the rest of the kernel.  Label operands are formatted
+ * as PCs relative to the start of 'input' (or the default label names
+ * for those PCs unless IGA_FORMATTING_OPT_NUMERIC_LABELS is set).
+ * The context keeps the decoder and buffers from one call to the next,
+ * so calling this for each instruction of a kernel in turn is cheap.
+ *
+ * PARAMETERS:
+ *  ctx             an iga context
+ *  dopts           the disassemble options (see
+ *                  'iga_context_disassemble_stream')
+ *  input           the kernel
+ *  input_size      the size of the 'input' in bytes
+ *  pc              the offset of the instruction in 'input'
+ *  fmt_label_name  optional callback to resolve a PC to specific label
+ *  fmt_label_ctx   A callback context (environment) forwarded to 'fmt_label'
+ *  buf             the buffer for the NUL-terminated text; it is truncated
+ *                  if the buffer is too small; may be NULL if 'buf_len' is 0
+ *  buf_len         the size of 'buf' in bytes
+ *  text_len        optional; receives the length of the whole text (without
+ *                  the NUL), which may exceed 'buf_len - 1'
+ *
+ * RETURNS:
+ *  IGA_SUCCESS         upon success; 'iga_get_warnings' may contain warning
+ *                      diagnostics even upon success
+ *  IGA_INVALID_ARG     if an argument is NULL, an unsupported option is set
+ *                      or there is no whole instruction at 'pc'
+ *  IGA_INVALID_OBJECT  if ctx has already been destroyed
+ *  IGA_DECODE_ERROR    upon failure to decode error; specific error messages
+ *                      may be retrieved via 'iga_context_get_errors'
+ */
+IGA_API iga_status_t iga_context_disassemble_instruction_at(
+    iga_context_t ctx, const iga_disassemble_options_t *dopts,
+    const void *input, uint32_t input_size, uint32_t pc,
+    const char *(*fmt_label_name)(int32_t, void *), void *fmt_label_ctx,
+    char *buf, size_t buf_len, size_t *text_len);
+
 /*****************************************************************************/
 /*             Diagnostic Processing Functions                               */
 /*****************************************************************************/
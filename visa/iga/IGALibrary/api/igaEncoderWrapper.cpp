@@ -18,6 +18,7 @@ iga_status_t KernelEncoder::encode(std::ostream &errStr) {
   EncoderOpts enc_opt(m_autoCompact, true);
   enc_opt.autoDepSet = m_enableAutoDeps;
   enc_opt.swsbEncodeMode = m_swsbEncodeMode;
+  enc_opt.compactionCache = m_compactionCache;
 
   Encoder enc(m_kernel->getModel(), errHandler, enc_opt);
   enc.encodeKernel(*m_kernel, m_kernel->getMemManager(), m_buf, m_binarySize);
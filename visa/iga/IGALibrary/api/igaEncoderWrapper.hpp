@@ -9,6 +9,7 @@ SPDX-License-Identifier: MIT
 #ifndef _IGA_ENCODER_WRAPPER_HPP
 #define _IGA_ENCODER_WRAPPER_HPP
 
+#include "../Backend/CompactionCache.hpp"
 #include "../IR/Kernel.hpp"
 #include "iga.h"
 
@@ -25,6 +26,8 @@ class KernelEncoder {
   // swsb encoding mode
   iga::SWSB_ENCODE_MODE m_swsbEncodeMode =
       iga::SWSB_ENCODE_MODE::SWSBInvalidMode;
+  // memoized compaction results, shared across encodes
+  iga::CompactionCache *m_compactionCache = nullptr;
 
 public:
   // @param compact: auto compact instructions if applicable
@@ -59,6 +62,11 @@ public:
   // enable IGA swsb set. When enabled, the original swsb in the input
   // instructions will be obsoleted
   void enableIGAAutoDeps(bool enable = true) { m_enableAutoDeps = enable; }
+
+  // reuse the compaction results in cache, which must outlive encode()
+  void setCompactionCache(iga::CompactionCache *cache) {
+    m_compactionCache = cache;
+  }
 };
 
 #endif // _IGA_ENCODER_WRAPPER_HPP
@@ -82,6 +82,21 @@ typedef iga_status_t(CDECLATTRIBUTE *pIGADisassembleInstruction)(
     const void *input, const char *(*fmt_label_name)(int32_t, void *),
     void *fmt_label_ctx, char **kernel_text);
 
+#define IGA_CONTEXT_DISASSEMBLE_STREAM_STR "iga_context_disassemble_stream"
+typedef iga_status_t(CDECLATTRIBUTE *pIGAContextDisassembleStream)(
+    iga_context_t ctx, const iga_disassemble_options_t *dopts,
+    const void *input, uint32_t input_size,
+    const char *(*fmt_label_name)(int32_t, void *), void *fmt_label_ctx,
+    iga_disassemble_stream_callback_t callback, void *env);
+
+#define IGA_CONTEXT_DISASSEMBLE_INSTRUCTION_AT_STR                             \
+  "iga_context_disassemble_instruction_at"
+typedef iga_status_t(CDECLATTRIBUTE *pIGAContextDisassembleInstructionAt)(
+    iga_context_t ctx, const iga_disassemble_options_t *dopts,
+    const void *input, uint32_t input_size, uint32_t pc,
+    const char *(*fmt_label_name)(int32_t, void *), void *fmt_label_ctx,
+    char *buf, size_t buf_len, size_t *text_len);
+
 #define IGA_CONTEXT_GET_ERRORS_STR "iga_context_get_errors"
 typedef iga_status_t(CDECLATTRIBUTE *pIGAContextGetErrors)(
     iga_context_t ctx, const iga_diagnostic_t **ds, uint32_t *ds_len);
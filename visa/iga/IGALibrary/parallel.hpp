@@ -0,0 +1,77 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#ifndef IGA_PARALLEL_HPP
+#define IGA_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace iga {
+// The process-wide number of threads a job may use (up to 16); 0 means as
+// many as the hardware has and 1 means every job runs on the calling
+// thread.  It starts out as the IGA_THREADS environment variable.
+// (Not static: all translation units must share the one setting.)
+inline std::atomic<unsigned> &ParallelMaxThreadsSetting() {
+  static std::atomic<unsigned> maxThreads([] {
+    const char *env = std::getenv("IGA_THREADS");
+    return env ? (unsigned)std::strtoul(env, nullptr, 10) : 0u;
+  }());
+  return maxThreads;
+}
+static inline void SetParallelMaxThreads(unsigned maxThreads) {
+  ParallelMaxThreadsSetting() = maxThreads;
+}
+
+// The number of threads to split a job of the given number of items
+// across so that each gets at least minItemsPerThread; 1 means the job
+// should just run on the calling thread.
+static inline unsigned ParallelThreadCount(size_t items,
+                                           size_t minItemsPerThread) {
+  // cap it: the jobs are memory bound and each thread has its own arena
+  const unsigned MAX_THREADS = 16;
+  unsigned maxThreads = ParallelMaxThreadsSetting();
+  if (maxThreads == 0)
+    maxThreads = std::max(1u, std::thread::hardware_concurrency());
+  size_t n = std::min<size_t>(std::min(maxThreads, MAX_THREADS),
+                              items / std::max<size_t>(minItemsPerThread, 1));
+  return (unsigned)std::max<size_t>(n, 1);
+}
+
+// Runs func(0), ..., func(n - 1) concurrently and waits for all of them;
+// func(0) runs on the calling thread. If a thread cannot be created, the
+// calling thread runs the rest of the items itself. func must not throw.
+template <typename F> void ParallelFor(unsigned n, F func) {
+  std::vector<std::thread> threads;
+  threads.reserve(n > 0 ? n - 1 : 0);
+  unsigned started = 1;
+  try {
+    for (; started < n; started++) {
+      threads.emplace_back(func, started);
+    }
+  } catch (const std::system_error &) {
+    // out of threads: fall back to sequential for what is left
+  }
+  if (n > 0) {
+    func(0u);
+  }
+  for (unsigned i = started; i < n; i++) {
+    func(i);
+  }
+  for (std::thread &t : threads) {
+    t.join();
+  }
+}
+} // namespace iga
+
+#endif // IGA_PARALLEL_HPP
@@ -0,0 +1,112 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2022 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#ifndef _COMPILETRACE_H_
+#define _COMPILETRACE_H_
+
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <utility>
+
+// Timeline of the compilation, shared by IGC and vISA.
+//
+// Spans are begun and ended by name on the current thread and need not be
+// properly nested. Each span records the thread it ran on and the tag of that
+// thread at the time it began; IGC sets the tag to the kernel and SIMD being
+// compiled. Completed spans are written in the Chrome trace event format
+// (JSON array of complete "X" events), which can be loaded into
+// chrome://tracing or the Perfetto UI.
+//
+// Recording is off by default. It is turned on by IGC's CompileTraceFile
+// regkey or vISA's -compileTrace option and is available in release builds.
+// When it is off, every entry point costs a single relaxed atomic load.
+namespace vISA {
+namespace CompileTrace {
+
+extern std::atomic<bool> Enabled;
+
+inline bool isEnabled() { return Enabled.load(std::memory_order_relaxed); }
+
+// enable - start recording. Completed spans are appended to fileName on each
+// flush() and at process exit. Only the first call has an effect.
+void enable(const char *fileName);
+
+// begin/end - start and finish the span with the given name on the current
+// thread. end() finishes the most recent open span of that name.
+void begin(const char *category, const char *name);
+void begin(const char *category, const std::string &name);
+void end(const char *name);
+void end(const std::string &name);
+
+// swapThreadTag - set the tag of the current thread and return the previous
+// one.
+std::string swapThreadTag(std::string tag);
+
+// write - write the spans completed so far in all threads to os as a JSON
+// array and drop them.
+void write(std::ostream &os);
+
+// flush - append the spans completed so far to the file given to enable()
+// and drop them. The array in the file is closed at process exit.
+void flush();
+
+} // namespace CompileTrace
+
+// CompileTraceScope - record a span for the duration of the scope.
+class CompileTraceScope {
+  std::string name;
+  bool active = false;
+
+public:
+  CompileTraceScope(const char *category, const char *spanName) {
+    if (CompileTrace::isEnabled()) {
+      name = spanName;
+      active = true;
+      CompileTrace::begin(category, name);
+    }
+  }
+  CompileTraceScope(const char *category, std::string spanName) {
+    if (CompileTrace::isEnabled()) {
+      name = std::move(spanName);
+      active = true;
+      CompileTrace::begin(category, name);
+    }
+  }
+  ~CompileTraceScope() {
+    if (active)
+      CompileTrace::end(name);
+  }
+  CompileTraceScope(const CompileTraceScope &) = delete;
+  CompileTraceScope &operator=(const CompileTraceScope &) = delete;
+};
+
+// CompileTraceTag - tag the spans begun on this thread until the end of the
+// scope. The tag is only built when recording is on.
+class CompileTraceTag {
+  std::string prevTag;
+  bool active = false;
+
+public:
+  template <typename MakeTag> explicit CompileTraceTag(MakeTag makeTag) {
+    if (CompileTrace::isEnabled()) {
+      prevTag = CompileTrace::swapThreadTag(makeTag());
+      active = true;
+    }
+  }
+  ~CompileTraceTag() {
+    if (active)
+      CompileTrace::swapThreadTag(std::move(prevTag));
+  }
+  CompileTraceTag(const CompileTraceTag &) = delete;
+  CompileTraceTag &operator=(const CompileTraceTag &) = delete;
+};
+
+} // namespace vISA
+
+#endif // _COMPILETRACE_H_
@@ -40,6 +40,9 @@ public:
   uint32_t numGRFTotal = 0;
   uint32_t numThreads = 0;
 
+  // Dispatch SIMD size of the kernel. Stats collection only.
+  uint32_t simdSize = 0;
+
   // Un-weighted asm instructions count. Used by IGC for spill
   // cost calculation
   uint32_t numAsmCountUnweighted = 0;
@@ -71,6 +74,16 @@ public:
   uint32_t loopNestedStallCycle = 0;
   uint32_t loopNestedCycle = 0;
 
+  // Whether the compile budget (vISA_CompileBudget) ran out, so that the
+  // remaining passes used their fast variants. Stats collection only.
+  bool compileBudgetExceeded = false;
+
+  // Lookups in the IGA compaction cache (vISA_CompactionCacheFile) while
+  // encoding this kernel: hits reuse an earlier compaction, misses search
+  // the compaction tables. Stats collection only.
+  uint32_t compactionCacheHits = 0;
+  uint32_t compactionCacheMisses = 0;
+
 public:
   llvm::json::Value toJSON();
 };
@@ -1163,6 +1163,19 @@ public:
   VISA_BUILDER_API virtual std::string
   getVarName(VISA_SamplerVar *decl) const = 0;
 
+  // Makes decl visible as name to the next vISA assembly snippet parsed into
+  // this kernel with VISABuilder::ParseVISAAsmSnippet.
+  VISA_BUILDER_API virtual int BindVISAAsmOperand(const char *name,
+                                                  VISA_GenVar *decl) = 0;
+  VISA_BUILDER_API virtual int BindVISAAsmOperand(const char *name,
+                                                  VISA_PredVar *decl) = 0;
+  VISA_BUILDER_API virtual int BindVISAAsmOperand(const char *name,
+                                                  VISA_AddrVar *decl) = 0;
+  VISA_BUILDER_API virtual int BindVISAAsmOperand(const char *name,
+                                                  VISA_SurfaceVar *decl) = 0;
+  VISA_BUILDER_API virtual int BindVISAAsmOperand(const char *name,
+                                                  VISA_SamplerVar *decl) = 0;
+
   // Gets the VISA string format for the operand
   VISA_BUILDER_API virtual std::string
   getVectorOperandName(VISA_VectorOpnd *opnd, bool showRegion) const = 0;
@@ -1232,6 +1245,12 @@ public:
   ParseVISAText(const std::string &visaText,
                 const std::string &visaTextFile) = 0;
   VISA_BUILDER_API virtual int ParseVISAText(const std::string &visaFile) = 0;
+  // Parses a list of vISA instructions and declarations, without the .version
+  // and .kernel header, and appends them to kernel. The snippet sees the
+  // predefined variables and the operands bound with
+  // VISAKernel::BindVISAAsmOperand; the bindings are dropped afterwards.
+  VISA_BUILDER_API virtual int
+  ParseVISAAsmSnippet(VISAKernel *kernel, const std::string &asmText) = 0;
   VISA_BUILDER_API virtual std::stringstream &GetAsmTextStream() = 0;
   VISA_BUILDER_API virtual VISAKernel *
   GetVISAKernel(const std::string &kernelName = "") const = 0;
@@ -237,6 +237,9 @@ DEF_VISA_OPTION(vISA_FlagSpillCodeCleanup, ET_BOOL, "-disableFlagSpillClean",
                 UNUSED, true)
 DEF_VISA_OPTION(vISA_GRFSpillCodeCleanup, ET_BOOL, "-spillCleanup", UNUSED,
                 true)
+DEF_VISA_OPTION(vISA_DeadSpillRemoval, ET_BOOL, "-noDeadSpillRemoval",
+                "do not remove the spills that no fill reads on any path",
+                true)
 DEF_VISA_OPTION(vISA_SpillSpaceCompression, ET_BOOL, "-nospillcompression",
                 UNUSED, true)
 DEF_VISA_OPTION(vISA_ConsiderLoopInfoInRA, ET_BOOL, "-noloopra", UNUSED, true)
@@ -276,6 +279,22 @@ DEF_VISA_OPTION(vISA_NewSpillCostFunction, ET_BOOL, "-newspillcost", UNUSED,
                 false)
 DEF_VISA_OPTION(vISA_NewSpillCostFunctionISPC, ET_BOOL, "-newspillcostispc", UNUSED,
                 false)
+DEF_VISA_OPTION(vISA_SpillCostTrials, ET_BOOL, "-spillCostTrials",
+                "when GRF coloring spills, color again with the other spill "
+                "cost function and keep the cheaper spills",
+                false)
+DEF_VISA_OPTION(vISA_FreqSpillCost, ET_BOOL, "-freqSpillCost",
+                "price spills, fills and remat in cycles weighted by the "
+                "estimated execution frequency of each BB",
+                false)
+DEF_VISA_OPTION(vISA_FreqLoopIterations, ET_INT32, "-freqLoopIterations",
+                "USAGE: -freqLoopIterations <n>: iterations assumed for every "
+                "loop by -freqSpillCost\n",
+                10)
+DEF_VISA_OPTION(vISA_FreqBranchPercent, ET_INT32, "-freqBranchPercent",
+                "USAGE: -freqBranchPercent <n>: percentage of the paths assumed "
+                "to run a conditional BB by -freqSpillCost\n",
+                50)
 
 DEF_VISA_OPTION(vISA_VerifyAugmentation, ET_BOOL, "-verifyaugmentation", UNUSED,
                 false)
@@ -501,6 +520,22 @@ DEF_VISA_OPTION(vISA_skipFenceCommit, ET_BOOL, "-skipFenceCommit", UNUSED,
                 false)
 DEF_VISA_OPTION(vISA_removeFence, ET_BOOL, "-removeFence",
                 "Remove fence if no write in a kernel", false)
+// compile-time budget in ms counted from the builder creation, 0 means no
+// budget. Once exceeded, RA, pre-RA scheduling and SWSB use their fast variant.
+DEF_VISA_OPTION(vISA_CompileBudget, ET_INT32, "-compileBudget",
+                "USAGE: -compileBudget <ms>\n", 0)
+DEF_VISA_OPTION(
+    vISA_CompileBudgetExpireAt, ET_CSTR, "-compileBudgetExpireAt",
+    "For testing the compile budget. The budget counts as exceeded from the "
+    "given pass on, whatever the compile time.", NULL)
+// write the timeline of the compilation to the given file, see CompileTrace.h
+DEF_VISA_OPTION(vISA_CompileTrace, ET_CSTR, "-compileTrace",
+                "USAGE: -compileTrace <file>\n", NULL)
+// load the IGA compaction cache from the given file before the first encode
+// and write it back when the builder is destroyed; -dumpVISAJsonStats
+// reports the cache hits and misses of each kernel
+DEF_VISA_OPTION(vISA_CompactionCacheFile, ET_CSTR, "-compactionCacheFile",
+                "USAGE: -compactionCacheFile <file>\n", NULL)
 
 
 //=== HW Workarounds ===